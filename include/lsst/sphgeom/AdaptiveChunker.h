@@ -0,0 +1,161 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_ADAPTIVECHUNKER_H_
+#define LSST_SPHGEOM_ADAPTIVECHUNKER_H_
+
+/// \file
+/// \brief This file declares a class for partitioning the sky into chunks
+///        containing similar amounts of data.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Angle.h"
+#include "Pixelization.h"
+#include "RangeSet.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+class Region;
+class UnitVector3d;
+
+/// `AdaptiveChunker` partitions the unit sphere into chunks holding at most
+/// a given number of rows, according to a density histogram.
+///
+/// Unlike Chunker, whose chunks have similar areas, an adaptive chunker
+/// divides the pixel indexes of an HtmPixelization, Q3cPixelization or
+/// Mq3cPixelization into contiguous ranges, one per chunk. Chunks in dense
+/// parts of the sky are small, and chunks in sparse parts are large.
+///
+/// Chunks are contiguous in pixel index, but need not be spatially compact:
+/// a range of indexes can span several HTM root triangles or Q3C cube
+/// faces, whose pixels may be far apart on the sky. Likewise, the number of
+/// rows in each chunk is bounded rather than balanced, so the last chunk
+/// before a dense pixel, or at the end of the index range, may hold far
+/// fewer rows than the others.
+///
+/// Chunk IDs are consecutive integers starting at 0, assigned in pixel
+/// index order. Every pixel belongs to exactly one chunk.
+class AdaptiveChunker {
+public:
+    /// This constructor partitions the pixels of `pixelization` from a
+    /// histogram giving the number of rows `counts[i]` in pixel
+    /// `indexes[i]`. The histogram need not be sorted, and may contain
+    /// several entries for a pixel, which are summed.
+    ///
+    /// Consecutive pixels are grouped greedily into chunks of at most
+    /// `maxRowsPerChunk` rows. A pixel with more rows than that forms a
+    /// chunk of its own, since pixels are never split.
+    ///
+    /// A std::invalid_argument is thrown if the pixelization is of another
+    /// type, if the histogram arrays have different sizes or contain invalid
+    /// pixel indexes, or if `maxRowsPerChunk` is zero.
+    AdaptiveChunker(Pixelization const & pixelization,
+                    std::vector<uint64_t> const & indexes,
+                    std::vector<uint64_t> const & counts,
+                    uint64_t maxRowsPerChunk);
+
+    bool operator==(AdaptiveChunker const & c) const;
+    bool operator!=(AdaptiveChunker const & c) const { return !(*this == c); }
+
+    /// `getPixelization` returns the pixelization divided by this chunker.
+    Pixelization const & getPixelization() const { return *_pixelization; }
+
+    /// `getNumChunks` returns the number of chunks.
+    int32_t getNumChunks() const {
+        return static_cast<int32_t>(_rowCounts.size());
+    }
+
+    /// `valid` returns true if `chunkId` is a valid chunk ID.
+    bool valid(int32_t chunkId) const {
+        return chunkId >= 0 && chunkId < getNumChunks();
+    }
+
+    /// `getRowCount` returns the number of histogram rows in a chunk.
+    uint64_t getRowCount(int32_t chunkId) const;
+
+    /// `getPixels` returns the indexes of the pixels in a chunk.
+    RangeSet getPixels(int32_t chunkId) const;
+
+    /// `getAllChunks` returns the IDs of all chunks.
+    std::vector<int32_t> getAllChunks() const;
+
+    /// `getChunk` returns the ID of the chunk containing v.
+    int32_t getChunk(UnitVector3d const & v) const;
+
+    /// `getChunksIntersecting` returns, in increasing order, the IDs of
+    /// the chunks that potentially intersect r.
+    ///
+    /// The `maxRanges` argument is passed to Pixelization::envelope(), and
+    /// bounds the cost of the search at the expense of returning more
+    /// chunks.
+    std::vector<int32_t> getChunksIntersecting(Region const & r,
+                                               size_t maxRanges = 0) const;
+
+    /// `getChunksNear` returns, in increasing order, the IDs of the chunks
+    /// that potentially contain points within angular separation `overlap`
+    /// of v. These are the chunks whose overlap regions contain v when
+    /// partitioning with overlap.
+    std::vector<int32_t> getChunksNear(UnitVector3d const & v,
+                                       Angle overlap) const;
+
+    /// `encode` serializes this chunker as a byte string. The encoding
+    /// consists of the type code 'A', the pixelization type ('h', 'q' or
+    /// 'm') and level, the number of chunks, and for each chunk its first
+    /// pixel index and row count, with all integers stored as little-endian
+    /// 64 bit values.
+    std::vector<uint8_t> encode() const;
+
+    ///@{
+    /// `decode` deserializes an AdaptiveChunker from a byte string produced
+    /// by encode. A std::runtime_error is thrown if the byte string is
+    /// invalid.
+    static AdaptiveChunker decode(std::vector<uint8_t> const & s) {
+        return decode(s.data(), s.size());
+    }
+
+    static AdaptiveChunker decode(uint8_t const * buffer, size_t n);
+    ///@}
+
+private:
+    AdaptiveChunker() = default;
+
+    size_t _chunkOf(uint64_t index) const;
+    std::vector<int32_t> _chunksOf(RangeSet const & pixels) const;
+
+    std::shared_ptr<Pixelization const> _pixelization;
+    uint8_t _type = 0;
+    int _level = 0;
+    // Chunk i consists of the pixels [_begin[i], _begin[i + 1]), where the
+    // last entry of _begin is the end of the pixel index range.
+    std::vector<uint64_t> _begin;
+    std::vector<uint64_t> _rowCounts;
+};
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_ADAPTIVECHUNKER_H_
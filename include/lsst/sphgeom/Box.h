@@ -55,6 +55,9 @@ class Box : public Region {
 public:
     static constexpr uint8_t TYPE_CODE = 'b';
 
+    /// `ENCODED_SIZE` is the length in bytes of a Box encoding.
+    static constexpr size_t ENCODED_SIZE = 33;
+
     // Factory functions
     static Box fromDegrees(double lon1, double lat1, double lon2, double lat2) {
         return Box(NormalizedAngleInterval::fromDegrees(lon1, lon2),
@@ -330,6 +333,8 @@ public:
     Relationship relate(Circle const &) const override;
     Relationship relate(ConvexPolygon const &) const override;
     Relationship relate(Ellipse const &) const override;
+    Relationship relate(Polygon const &) const override;
+    Relationship relate(CompoundRegion const &) const override;
 
     std::vector<uint8_t> encode() const override;
 
@@ -342,7 +347,10 @@ public:
     ///@}
 
 private:
-    static constexpr size_t ENCODED_SIZE = 33;
+    friend class RegionValue;
+
+    // `_decode` sets this object from the n byte encoding in `buffer`.
+    void _decode(uint8_t const * buffer, size_t n);
 
     void _enforceInvariants() {
         // Make sure that _lat ⊆ [-π/2, π/2].
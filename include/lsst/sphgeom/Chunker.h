@@ -32,6 +32,8 @@
 
 #include "Angle.h"
 #include "Box.h"
+#include "RangeSet.h"
+#include "TraversalStats.h"
 
 
 namespace lsst {
@@ -92,12 +94,80 @@ public:
 
     /// `getChunksIntersecting` returns all the chunks that potentially
     /// intersect the given region.
-    std::vector<int32_t> getChunksIntersecting(Region const & r) const;
+    ///
+    /// If `stats` is not null, counts of the chunks examined and of their
+    /// relationships to the region are added to it.
+    std::vector<int32_t> getChunksIntersecting(
+        Region const & r,
+        TraversalStats * stats = nullptr) const;
 
     /// `getSubChunksIntersecting` returns all the sub-chunks that potentially
     /// intersect the given region.
     std::vector<SubChunks> getSubChunksIntersecting(Region const & r) const;
 
+    ///@{
+    /// `getChunksIntersecting` returns, for each of the n given regions, the
+    /// set of IDs of the chunks that potentially intersect it.
+    ///
+    /// The result for a region is the same as that of the single region
+    /// overload. If `numThreads` is greater than 1, the regions are divided
+    /// into that many slices that are processed concurrently, so the regions
+    /// must be safe to relate from several threads at once.
+    std::vector<RangeSet> getChunksIntersecting(
+        Region const * const * regions,
+        size_t n,
+        unsigned numThreads = 1) const;
+
+    std::vector<RangeSet> getChunksIntersecting(
+        std::vector<Region const *> const & regions,
+        unsigned numThreads = 1) const
+    {
+        return getChunksIntersecting(regions.data(), regions.size(),
+                                     numThreads);
+    }
+    ///@}
+
+    ///@{
+    /// `getSubChunksIntersecting` returns, for each of the n given regions,
+    /// the set of keys (see getSubChunkKey()) of the sub-chunks that
+    /// potentially intersect it.
+    ///
+    /// Since the sub-chunk IDs of a sub-stripe are consecutive, these sets
+    /// consist of few ranges, and are much more compact than the equivalent
+    /// SubChunks vectors. The `numThreads` argument is handled as for the
+    /// batch version of getChunksIntersecting().
+    std::vector<RangeSet> getSubChunksIntersecting(
+        Region const * const * regions,
+        size_t n,
+        unsigned numThreads = 1) const;
+
+    std::vector<RangeSet> getSubChunksIntersecting(
+        std::vector<Region const *> const & regions,
+        unsigned numThreads = 1) const
+    {
+        return getSubChunksIntersecting(regions.data(), regions.size(),
+                                        numThreads);
+    }
+    ///@}
+
+    /// `getSubChunkKey` packs a chunk ID and the ID of one of its sub-chunks
+    /// into a 64 bit key. Keys sort by chunk ID first, then by sub-chunk ID.
+    static uint64_t getSubChunkKey(int32_t chunkId, int32_t subChunkId) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(chunkId)) << 32) |
+               static_cast<uint32_t>(subChunkId);
+    }
+
+    /// `getChunkIdFromKey` returns the chunk ID packed into a sub-chunk key.
+    static int32_t getChunkIdFromKey(uint64_t key) {
+        return static_cast<int32_t>(key >> 32);
+    }
+
+    /// `getSubChunkIdFromKey` returns the sub-chunk ID packed into a
+    /// sub-chunk key.
+    static int32_t getSubChunkIdFromKey(uint64_t key) {
+        return static_cast<int32_t>(key & 0xffffffff);
+    }
+
     /// `getAllChunks` returns the complete set of chunk IDs for the unit
     /// sphere.
     std::vector<int32_t> getAllChunks() const;
@@ -110,13 +180,18 @@ public:
     bool valid(int32_t chunkId) const;
 
 private:
+    // The longitude dilations of the chunk and sub-chunk bounding boxes
+    // only depend on their latitudes, and are precomputed so that building
+    // a bounding box involves no trigonometry.
     struct Stripe {
         Angle chunkWidth;
+        Angle chunkDilation;
         int32_t numChunksPerStripe;
         int32_t numSubChunksPerChunk;
 
         Stripe() :
             chunkWidth(0),
+            chunkDilation(0),
             numChunksPerStripe(0),
             numSubChunksPerChunk(0)
         {}
@@ -124,9 +199,14 @@ private:
 
     struct SubStripe {
         Angle subChunkWidth;
+        Angle subChunkDilation;
         int32_t numSubChunksPerChunk;
 
-        SubStripe() : subChunkWidth(), numSubChunksPerChunk(0) {}
+        SubStripe() :
+            subChunkWidth(),
+            subChunkDilation(0),
+            numSubChunksPerChunk(0)
+        {}
     };
 
     int32_t _getStripe(int32_t chunkId) const {
@@ -149,13 +229,26 @@ private:
         return y * _maxSubChunksPerSubStripeChunk + x;
     }
 
-    void _getSubChunks(std::vector<SubChunks> & subChunks,
-                       Region const & r,
-                       NormalizedAngleInterval const & lon,
-                       int32_t stripe,
-                       int32_t chunk,
-                       int32_t minSS,
-                       int32_t maxSS) const;
+    AngleInterval _getStripeLatitudes(int32_t stripe) const;
+    AngleInterval _getSubStripeLatitudes(int32_t subStripe) const;
+
+    // `_forEachChunk` calls f(stripe, chunk, minSS, maxSS) for each chunk
+    // overlapping the bounding box b, where [minSS, maxSS] are the
+    // sub-stripes overlapping b.
+    template <typename F>
+    void _forEachChunk(Box const & b, F f) const;
+
+    // `_forEachSubChunk` calls f(subChunkId) for each sub-chunk of the given
+    // chunk that potentially intersects r, whose longitude bounds are lon.
+    template <typename F>
+    void _forEachSubChunk(Region const & r,
+                          NormalizedAngleInterval const & lon,
+                          int32_t stripe,
+                          int32_t chunk,
+                          int32_t minSS,
+                          int32_t maxSS,
+                          F f) const;
+
     Box _getChunkBoundingBox(int32_t stripe, int32_t chunk) const;
     Box _getSubChunkBoundingBox(int32_t subStripe, int32_t subChunk) const;
 
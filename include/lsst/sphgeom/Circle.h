@@ -28,6 +28,7 @@
 ///        regions on the unit sphere.
 
 #include <iosfwd>
+#include <vector>
 
 #include "Region.h"
 #include "UnitVector3d.h"
@@ -47,10 +48,23 @@ class Circle : public Region {
 public:
     static constexpr uint8_t TYPE_CODE = 'c';
 
+    /// `ENCODED_SIZE` is the length in bytes of a Circle encoding.
+    static constexpr size_t ENCODED_SIZE = 41;
+
     static Circle empty() { return Circle(); }
 
     static Circle full() { return Circle(UnitVector3d::Z(), 4.0); }
 
+    /// `minimalEnclosingCircle` returns the smallest circle containing all
+    /// the given points, padded by twice the maximum squared chord length
+    /// error so that it reliably contains them. The circle is computed with
+    /// Welzl's algorithm, in expected linear time. It is only guaranteed to
+    /// be minimal if the points lie in an open hemisphere; otherwise, it is
+    /// merely some circle containing them. The circle is empty if there are
+    /// no points.
+    static Circle minimalEnclosingCircle(
+        std::vector<UnitVector3d> const & points);
+
     /// `squaredChordLengthFor` computes and returns the squared chord length
     /// between points in S² that are separated by the given angle. The squared
     /// chord length l² and angle θ are related by l² = 4 sin²(θ/2).
@@ -241,6 +255,8 @@ public:
     Relationship relate(Circle const &) const override;
     Relationship relate(ConvexPolygon const &) const override;
     Relationship relate(Ellipse const &) const override;
+    Relationship relate(Polygon const &) const override;
+    Relationship relate(CompoundRegion const &) const override;
 
     std::vector<uint8_t> encode() const override;
 
@@ -253,7 +269,10 @@ public:
     ///@}
 
 private:
-    static constexpr size_t ENCODED_SIZE = 41;
+    friend class RegionValue;
+
+    // `_decode` sets this object from the n byte encoding in `buffer`.
+    void _decode(uint8_t const * buffer, size_t n);
 
     UnitVector3d _center;
     double _squaredChordLength;
@@ -0,0 +1,407 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_COMPOUNDREGION_H_
+#define LSST_SPHGEOM_COMPOUNDREGION_H_
+
+/// \file
+/// \brief This file declares classes for representing unions,
+///        intersections and differences of regions.
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Box.h"
+#include "Box3d.h"
+#include "Circle.h"
+#include "Region.h"
+#include "UnitVector3d.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+class CompoundRegion;
+
+namespace detail {
+
+class CompoundRelater;
+
+// `compoundRelate` computes the relationship between the convex polygon
+// with the n counter-clockwise vertices v and the compound region c.
+Relationship compoundRelate(UnitVector3d const * v, size_t n,
+                            CompoundRegion const & c);
+
+} // namespace detail
+
+
+/// `CompoundRegion` is an intermediate base class for regions formed by
+/// set operations on other regions, called operands.
+///
+/// The spatial relationships of a compound region are computed from those
+/// of its operands, and are conservative even when the relationships of the
+/// operands are exact. The computation stops as soon as the result is
+/// decided, so that operands which do not influence it are never related.
+class CompoundRegion : public Region {
+public:
+    CompoundRegion(CompoundRegion const & r);
+    CompoundRegion & operator=(CompoundRegion const &) = delete;
+
+    /// `getNumOperands` returns the number of operands of this region.
+    size_t getNumOperands() const { return _operands.size(); }
+
+    /// `getOperand` returns the i-th operand of this region.
+    Region const & getOperand(size_t i) const { return *_operands[i]; }
+
+    // Region interface
+    Relationship relate(Region const & r) const override {
+        // Dispatch on the type of r.
+        return invert(r.relate(*this));
+    }
+
+    Relationship relate(Box const &) const override;
+    Relationship relate(Circle const &) const override;
+    Relationship relate(ConvexPolygon const &) const override;
+    Relationship relate(Ellipse const &) const override;
+    Relationship relate(Polygon const &) const override;
+    Relationship relate(CompoundRegion const &) const override;
+
+    /// `encode` serializes this region as its type code, followed by the
+    /// length in bytes (as a little-endian 64 bit integer) and encoding of
+    /// each operand.
+    std::vector<uint8_t> encode() const override;
+
+    ///@{
+    /// `decode` deserializes a CompoundRegion from a byte string produced by
+    /// encode.
+    static std::unique_ptr<CompoundRegion> decode(
+        std::vector<uint8_t> const & s)
+    {
+        return decode(s.data(), s.size());
+    }
+
+    static std::unique_ptr<CompoundRegion> decode(uint8_t const * buffer,
+                                                  size_t n);
+    ///@}
+
+protected:
+    /// An `OperandRelation` returns the relationship between the operand
+    /// with the given index and some other region.
+    typedef std::function<Relationship(size_t)> OperandRelation;
+
+    /// This constructor takes ownership of the given operands. It throws a
+    /// std::invalid_argument if any of them is null.
+    explicit CompoundRegion(std::vector<std::unique_ptr<Region>> operands);
+
+    /// `decodeOperands` returns the operands of the region with the given
+    /// type code encoded in buffer.
+    static std::vector<std::unique_ptr<Region>> decodeOperands(
+        uint8_t typeCode, uint8_t const * buffer, size_t n);
+
+    /// `getTypeCode` returns the encoding type code of this region.
+    virtual uint8_t getTypeCode() const = 0;
+
+    /// `relateOperands` computes the relationship between this region and
+    /// some other region R, given a function returning the relationship
+    /// between the i-th of n operands and R. The n operands are either all
+    /// operands, in order, or a subset omitting operands with the neutral
+    /// relationship, in which case only the DISJOINT and CONTAINS bits of
+    /// the result are meaningful.
+    ///
+    /// Unless the result is DISJOINT or CONTAINS, f must be called for
+    /// every operand.
+    virtual Relationship relateOperands(OperandRelation const & f,
+                                        size_t n) const = 0;
+
+    /// `getNeutralRelationship` returns the relationship with R of the
+    /// operands that do not change whether this region is disjoint from or
+    /// contains R. It is INTERSECTS if there are no such operands.
+    virtual Relationship getNeutralRelationship() const = 0;
+
+private:
+    friend Relationship detail::compoundRelate(UnitVector3d const *, size_t,
+                                               CompoundRegion const &);
+    friend class detail::CompoundRelater;
+
+    // A `Bound` is a bounding circle, described by the cosine and sine of
+    // its opening angle so that it can be tested for disjointness from
+    // another such circle without trigonometry.
+    struct Bound {
+        UnitVector3d center;
+        double cosRadius;
+        double sinRadius;
+
+        explicit Bound(Circle const & c);
+        Bound(UnitVector3d const & c, double cr);
+        // This constructor bounds the convex polygon with the n vertices v.
+        Bound(UnitVector3d const * v, size_t n);
+
+        bool isDisjointFrom(Bound const & b) const;
+    };
+
+    std::vector<std::unique_ptr<Region>> _operands;
+    // The operand bounds allow operands that are far from a region to be
+    // skipped without relating them.
+    std::vector<Bound> _bounds;
+
+    template <typename RegionType>
+    Relationship _relate(RegionType const & r) const;
+};
+
+
+namespace detail {
+
+// `CompoundRelater` relates the convex polygons visited by a depth-first
+// traversal of a polygon hierarchy, such as the pixels visited by a
+// PixelFinder, to a compound region.
+//
+// Every polygon lies inside its parent, so an operand that is disjoint
+// from or contains the parent has the same relationship with its
+// descendants. Such operands are not related again: those that cannot change
+// the relationship of their compound region (see
+// CompoundRegion::getNeutralRelationship) are dropped from the operands that
+// are still undecided, and the relationships of the others are remembered.
+// Only the DISJOINT and WITHIN bits of the results are computed.
+//
+// The bounding circle of a polygon is only computed once an operand for
+// which the bounding circle test pays off must be related. Circles are not
+// among them, since relating a polygon to a circle is hardly more costly.
+class CompoundRelater {
+public:
+    CompoundRelater() = default;
+    explicit CompoundRelater(CompoundRegion const & c);
+
+    // `relate` computes the relationship between the convex polygon with
+    // the n counter-clockwise vertices v and the compound region. The depth
+    // of a polygon is its number of ancestors, and its parent must be the
+    // polygon last related at depth - 1.
+    Relationship relate(UnitVector3d const * v, size_t n, size_t depth);
+
+    // `setBound` supplies a bounding circle of the next polygon to relate,
+    // already enlarged to account for rounding errors, so that it need not
+    // be computed again. It is forgotten once the polygon is related.
+    void setBound(UnitVector3d const & center, double cosRadius,
+                  double sinRadius)
+    {
+        _bound.center = center;
+        _bound.cosRadius = cosRadius;
+        _bound.sinRadius = sinRadius;
+        _hasBound = true;
+    }
+
+private:
+    // A `Node` is a compound region in the operand tree, along with its
+    // neutral relationship and the offset of its operands in the per-operand
+    // vectors.
+    struct Node {
+        CompoundRegion const * region;
+        Relationship neutral;
+        size_t first;
+    };
+
+    // A `PolygonRelation` relates a convex polygon to an operand of a
+    // specific type, so that operand types are determined only once.
+    typedef Relationship (*PolygonRelation)(UnitVector3d const *, size_t,
+                                            Region const &);
+
+    std::vector<Node> _nodes;
+    // The node index of each compound operand, or 0 for other operands.
+    std::vector<size_t> _children;
+    // The function relating polygons to each operand that is not compound.
+    std::vector<PolygonRelation> _relations;
+    // Whether the bound of each operand is tested before relating it.
+    std::vector<uint8_t> _testBounds;
+    // For each depth, the relationship between every operand and the
+    // polygon last related at that depth, where INTERSECTS means unknown,
+    // the indexes of the operands of each node that are still undecided,
+    // and their number. The entries for depth 0 describe the parent of the
+    // root polygons, about which nothing is known.
+    std::vector<Relationship> _relationships;
+    std::vector<uint32_t> _undecided;
+    std::vector<uint32_t> _counts;
+    // The polygon being related, and its bound once computed.
+    UnitVector3d const * _vertices = nullptr;
+    size_t _numVertices = 0;
+    bool _hasBound = false;
+    CompoundRegion::Bound _bound{UnitVector3d::Z(), -1.0};
+
+    void _add(CompoundRegion const & c);
+    CompoundRegion::Bound const & _getBound();
+    Relationship _relate(size_t node, size_t depth);
+};
+
+} // namespace detail
+
+
+/// `UnionRegion` is the union of its operands. A union of no operands
+/// is empty.
+class UnionRegion : public CompoundRegion {
+public:
+    static constexpr uint8_t TYPE_CODE = 'u';
+
+    explicit UnionRegion(std::vector<std::unique_ptr<Region>> operands) :
+        CompoundRegion(std::move(operands))
+    {}
+
+    // Region interface
+    std::unique_ptr<Region> clone() const override {
+        return std::unique_ptr<UnionRegion>(new UnionRegion(*this));
+    }
+
+    Box getBoundingBox() const override;
+    Box3d getBoundingBox3d() const override;
+    Circle getBoundingCircle() const override;
+
+    bool contains(UnitVector3d const & v) const override;
+
+    ///@{
+    /// `decode` deserializes a UnionRegion from a byte string produced by
+    /// encode.
+    static std::unique_ptr<UnionRegion> decode(std::vector<uint8_t> const & s) {
+        return decode(s.data(), s.size());
+    }
+
+    static std::unique_ptr<UnionRegion> decode(uint8_t const * buffer,
+                                               size_t n)
+    {
+        return std::unique_ptr<UnionRegion>(
+            new UnionRegion(decodeOperands(TYPE_CODE, buffer, n)));
+    }
+    ///@}
+
+protected:
+    uint8_t getTypeCode() const override { return TYPE_CODE; }
+    Relationship relateOperands(OperandRelation const & f,
+                                size_t n) const override;
+    // Operands disjoint from R do not contribute to a union.
+    Relationship getNeutralRelationship() const override { return DISJOINT; }
+};
+
+
+/// `IntersectionRegion` is the intersection of its operands. An
+/// intersection of no operands is the entire unit sphere.
+class IntersectionRegion : public CompoundRegion {
+public:
+    static constexpr uint8_t TYPE_CODE = 'i';
+
+    explicit IntersectionRegion(std::vector<std::unique_ptr<Region>> operands) :
+        CompoundRegion(std::move(operands))
+    {}
+
+    // Region interface
+    std::unique_ptr<Region> clone() const override {
+        return std::unique_ptr<IntersectionRegion>(
+            new IntersectionRegion(*this));
+    }
+
+    Box getBoundingBox() const override;
+    Box3d getBoundingBox3d() const override;
+    Circle getBoundingCircle() const override;
+
+    bool contains(UnitVector3d const & v) const override;
+
+    ///@{
+    /// `decode` deserializes an IntersectionRegion from a byte string
+    /// produced by encode.
+    static std::unique_ptr<IntersectionRegion> decode(
+        std::vector<uint8_t> const & s)
+    {
+        return decode(s.data(), s.size());
+    }
+
+    static std::unique_ptr<IntersectionRegion> decode(uint8_t const * buffer,
+                                                      size_t n)
+    {
+        return std::unique_ptr<IntersectionRegion>(
+            new IntersectionRegion(decodeOperands(TYPE_CODE, buffer, n)));
+    }
+    ///@}
+
+protected:
+    uint8_t getTypeCode() const override { return TYPE_CODE; }
+    Relationship relateOperands(OperandRelation const & f,
+                                size_t n) const override;
+    // Operands containing R do not restrict an intersection.
+    Relationship getNeutralRelationship() const override { return CONTAINS; }
+};
+
+
+/// `DifferenceRegion` contains the points of its first operand that are not
+/// in its second operand.
+class DifferenceRegion : public CompoundRegion {
+public:
+    static constexpr uint8_t TYPE_CODE = 'd';
+
+    /// This constructor creates the region containing the points of `a`
+    /// that are not in `b`.
+    DifferenceRegion(std::unique_ptr<Region> a, std::unique_ptr<Region> b);
+
+    // Region interface
+    std::unique_ptr<Region> clone() const override {
+        return std::unique_ptr<DifferenceRegion>(new DifferenceRegion(*this));
+    }
+
+    Box getBoundingBox() const override {
+        return getOperand(0).getBoundingBox();
+    }
+
+    Box3d getBoundingBox3d() const override {
+        return getOperand(0).getBoundingBox3d();
+    }
+
+    Circle getBoundingCircle() const override {
+        return getOperand(0).getBoundingCircle();
+    }
+
+    bool contains(UnitVector3d const & v) const override {
+        return getOperand(0).contains(v) && !getOperand(1).contains(v);
+    }
+
+    ///@{
+    /// `decode` deserializes a DifferenceRegion from a byte string produced
+    /// by encode.
+    static std::unique_ptr<DifferenceRegion> decode(
+        std::vector<uint8_t> const & s)
+    {
+        return decode(s.data(), s.size());
+    }
+
+    static std::unique_ptr<DifferenceRegion> decode(uint8_t const * buffer,
+                                                    size_t n);
+    ///@}
+
+protected:
+    uint8_t getTypeCode() const override { return TYPE_CODE; }
+    Relationship relateOperands(OperandRelation const & f,
+                                size_t n) const override;
+    // Both operands of a difference always matter.
+    Relationship getNeutralRelationship() const override {
+        return INTERSECTS;
+    }
+};
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_COMPOUNDREGION_H_
@@ -66,6 +66,25 @@ public:
         return ConvexPolygon(points);
     }
 
+    /// `fastConvexHull` returns the same polygon as convexHull, in
+    /// O(n log n) rather than O(nh) time for n points with h hull vertices.
+    ///
+    /// The points are projected onto the plane tangent to the sphere at
+    /// their normalized centroid, and their hull is computed with a monotone
+    /// chain that uses the exact orientation() predicate. The result is then
+    /// checked with exact predicates. If the points do not fit in an open
+    /// hemisphere, the check fails, or some point lies exactly on the hull
+    /// boundary without being a hull vertex, convexHull is called instead.
+    /// The vertices therefore always have the same cyclic order as those of
+    /// convexHull, though the first vertex can differ.
+    ///
+    /// If `numThreads` is greater than 1, large inputs are divided into that
+    /// many parts, whose hulls are computed and checked in parallel before
+    /// being merged.
+    static ConvexPolygon fastConvexHull(
+        std::vector<UnitVector3d> const & points,
+        unsigned numThreads = 1);
+
     /// This constructor creates a convex polygon that is the convex hull of
     /// the given set of points.
     explicit ConvexPolygon(std::vector<UnitVector3d> const & points);
@@ -113,6 +132,12 @@ public:
     Box3d getBoundingBox3d() const override;
     Circle getBoundingCircle() const override;
 
+    /// `getMinimalBoundingCircle` returns the smallest circle containing
+    /// this polygon. It is never larger, and is often much smaller than the
+    /// circle returned by getBoundingCircle, which is centered on the
+    /// polygon centroid, but takes longer to compute.
+    Circle getMinimalBoundingCircle() const;
+
     ///@{
     /// `contains` returns true if the intersection of this convex polygon and x
     /// is equal to x.
@@ -147,6 +172,8 @@ public:
     Relationship relate(Circle const &) const override;
     Relationship relate(ConvexPolygon const &) const override;
     Relationship relate(Ellipse const &) const override;
+    Relationship relate(Polygon const &) const override;
+    Relationship relate(CompoundRegion const &) const override;
 
     std::vector<uint8_t> encode() const override;
 
@@ -159,10 +186,18 @@ public:
     ///@}
 
 private:
+    friend class Polygon;
+    friend class RegionValue;
+    template <size_t N> friend class FixedConvexPolygon;
+
     typedef std::vector<UnitVector3d>::const_iterator VertexIterator;
 
     ConvexPolygon() : _vertices() {}
 
+    // `_decode` sets this polygon from the n byte encoding in `buffer`,
+    // reusing its vertex storage where possible.
+    void _decode(uint8_t const * buffer, size_t n);
+
     std::vector<UnitVector3d> _vertices;
 };
 
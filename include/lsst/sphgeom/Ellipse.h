@@ -170,6 +170,9 @@ class Ellipse : public Region {
 public:
     static constexpr uint8_t TYPE_CODE = 'e';
 
+    /// `ENCODED_SIZE` is the length in bytes of an Ellipse encoding.
+    static constexpr size_t ENCODED_SIZE = 113;
+
     static Ellipse empty() { return Ellipse(); }
 
     static Ellipse full() { return Ellipse().complement(); }
@@ -292,6 +295,8 @@ public:
     Relationship relate(Circle const &) const override;
     Relationship relate(ConvexPolygon const &) const override;
     Relationship relate(Ellipse const &) const override;
+    Relationship relate(Polygon const &) const override;
+    Relationship relate(CompoundRegion const &) const override;
 
     std::vector<uint8_t> encode() const override;
 
@@ -304,7 +309,10 @@ public:
     ///@}
 
 private:
-    static constexpr size_t ENCODED_SIZE = 113;
+    friend class RegionValue;
+
+    // `_decode` sets this object from the n byte encoding in `buffer`.
+    void _decode(uint8_t const * buffer, size_t n);
 
     Matrix3d _S;
     Angle _a; // α - π/2
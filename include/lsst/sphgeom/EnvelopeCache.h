@@ -0,0 +1,165 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_ENVELOPECACHE_H_
+#define LSST_SPHGEOM_ENVELOPECACHE_H_
+
+/// \file
+/// \brief This file declares a cache for pixelization search results.
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "Pixelization.h"
+#include "RangeSet.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+class Region;
+
+/// `EnvelopeCache` is a thread-safe, size-bounded cache of the pixel index
+/// sets computed by Pixelization::envelope() and Pixelization::interior().
+///
+/// Results are keyed by the pixelization type and level, the `maxRanges`
+/// and `coarsening` arguments, and the encoding of the region, so that
+/// regions which are equal but distinct objects share entries. The memory
+/// footprint of each entry is estimated from the sizes of its key and
+/// result, and least recently used entries are evicted to keep the total
+/// under a fixed budget. Results that do not fit in the budget by
+/// themselves are never cached.
+///
+/// A cache can optionally be backed by a file. Entries found in the file
+/// are loaded on construction, and new entries are appended to it as they
+/// are computed, so that the file survives the process. A truncated final
+/// record, left by a process that died while appending it, is dropped when
+/// the file is loaded. Since evicted entries remain in the file until
+/// it is compacted, the file is rewritten, on construction or after
+/// appending to it, whenever it has grown to more than twice the size of
+/// the live entries. Its size is therefore bounded by about twice the
+/// memory budget. It can also be rewritten on demand with compact().
+///
+/// Searches run without holding the cache lock, so concurrent misses on the
+/// same key may compute the same result more than once.
+class EnvelopeCache {
+public:
+    /// This constructor creates an empty in-memory cache holding at most
+    /// `maxBytes` bytes of entries.
+    explicit EnvelopeCache(size_t maxBytes);
+
+    /// This constructor creates a cache backed by the file at `path`, which
+    /// is created if it does not exist or is empty. A std::runtime_error is
+    /// thrown if the file cannot be opened, or is not an envelope cache file.
+    EnvelopeCache(size_t maxBytes, std::string const & path);
+
+    EnvelopeCache(EnvelopeCache const &) = delete;
+    EnvelopeCache & operator=(EnvelopeCache const &) = delete;
+
+    ///@{
+    /// `envelope` and `interior` return `pixelization.envelope(r, maxRanges,
+    /// coarsening)` and `pixelization.interior(r, maxRanges, coarsening)`,
+    /// computing them only if they are not already cached.
+    ///
+    /// The pixelization must be an HtmPixelization, Q3cPixelization or
+    /// Mq3cPixelization; for other types, a std::invalid_argument is thrown.
+    RangeSet envelope(Pixelization const & pixelization,
+                      Region const & r,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL);
+
+    RangeSet interior(Pixelization const & pixelization,
+                      Region const & r,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL);
+    ///@}
+
+    /// `getMaxBytes` returns the memory budget of this cache.
+    size_t getMaxBytes() const { return _maxBytes; }
+
+    /// `getBytes` returns the estimated memory footprint of the entries
+    /// in this cache.
+    size_t getBytes() const;
+
+    /// `getSize` returns the number of entries in this cache.
+    size_t getSize() const;
+
+    ///@{
+    /// `getHits`, `getMisses` and `getEvictions` return the number of
+    /// lookups that found a cached result, the number that did not, and the
+    /// number of entries evicted to make room for others.
+    uint64_t getHits() const;
+    uint64_t getMisses() const;
+    uint64_t getEvictions() const;
+    ///@}
+
+    /// `resetCounters` sets the hit, miss and eviction counters to zero.
+    void resetCounters();
+
+    /// `clear` removes all entries from this cache, and from its file.
+    void clear();
+
+    /// `compact` rewrites the backing file of this cache so that it only
+    /// contains the entries currently in memory. It does nothing for
+    /// in-memory caches.
+    void compact();
+
+private:
+    struct Entry {
+        RangeSet ranges;
+        size_t bytes;
+        std::list<std::string const *>::iterator lru;
+    };
+
+    size_t const _maxBytes;
+    std::string const _path;
+    mutable std::mutex _mutex;
+    // Entries are ordered from most to least recently used in `_lru`, which
+    // points at the keys of `_entries`.
+    std::unordered_map<std::string, Entry> _entries;
+    std::list<std::string const *> _lru;
+    size_t _bytes = 0;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+    uint64_t _evictions = 0;
+    // `_fileBytes` is the total size of the records in `_file`.
+    size_t _fileBytes = 0;
+    std::ofstream _file;
+
+    RangeSet _lookup(Pixelization const & pixelization,
+                     Region const & r,
+                     size_t maxRanges,
+                     Coarsening coarsening,
+                     bool interior);
+    bool _insert(std::string const & key, RangeSet const & ranges);
+    void _load();
+    void _rewrite();
+};
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_ENVELOPECACHE_H_
@@ -0,0 +1,205 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_FIXEDCONVEXPOLYGON_H_
+#define LSST_SPHGEOM_FIXEDCONVEXPOLYGON_H_
+
+/// \file
+/// \brief This file declares a convex polygon class with inline
+///        vertex storage.
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "Box.h"
+#include "Box3d.h"
+#include "Circle.h"
+#include "ConvexPolygon.h"
+#include "Ellipse.h"
+#include "Relationship.h"
+#include "UnitVector3d.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+namespace detail {
+
+// These functions run the ConvexPolygon algorithms on an array of n
+// counter-clockwise vertices.
+UnitVector3d polygonCentroid(UnitVector3d const * v, size_t n);
+Box polygonBoundingBox(UnitVector3d const * v, size_t n);
+Box3d polygonBoundingBox3d(UnitVector3d const * v, size_t n);
+Circle polygonBoundingCircle(UnitVector3d const * v, size_t n);
+bool polygonContains(UnitVector3d const * v, size_t n, UnitVector3d const & p);
+Relationship polygonRelate(UnitVector3d const * v, size_t n, Box const & b);
+Relationship polygonRelate(UnitVector3d const * v, size_t n, Circle const & c);
+Relationship polygonRelate(UnitVector3d const * v, size_t n,
+                           ConvexPolygon const & p);
+Relationship polygonRelate(UnitVector3d const * v, size_t n,
+                           Ellipse const & e);
+Relationship polygonRelate(UnitVector3d const * v, size_t n,
+                           Region const & r);
+Relationship polygonRelate(UnitVector3d const * v1, size_t n1,
+                           UnitVector3d const * v2, size_t n2);
+std::vector<uint8_t> polygonEncode(UnitVector3d const * v, size_t n);
+
+} // namespace detail
+
+
+/// `FixedConvexPolygon` is a convex polygon with at most N vertices, which
+/// are stored inline rather than on the heap. It is intended for small
+/// polygons such as pixel boundaries and CCD footprints, which are often
+/// created in large numbers and discarded right away.
+///
+/// FixedConvexPolygon is not a Region, but offers the same geometric
+/// functionality as ConvexPolygon with identical results, and produces the
+/// same encoding. It can be converted to a ConvexPolygon where a Region is
+/// required.
+template <size_t N>
+class FixedConvexPolygon {
+public:
+    static_assert(N >= 3, "A convex polygon has at least 3 vertices");
+
+    /// `MAX_VERTICES` is the maximum number of vertices of this polygon type.
+    static constexpr size_t MAX_VERTICES = N;
+
+    /// This constructor creates a triangle with the given vertices.
+    ///
+    /// It is assumed that orientation(v0, v1, v2) = 1. Use with caution -
+    /// for performance reasons, this is not verified!
+    FixedConvexPolygon(UnitVector3d const & v0,
+                       UnitVector3d const & v1,
+                       UnitVector3d const & v2) :
+        _vertices{v0, v1, v2},
+        _n(3)
+    {}
+
+    /// This constructor creates a quadrilateral with the given vertices.
+    ///
+    /// It is assumed that orientation(v0, v1, v2), orientation(v1, v2, v3),
+    /// orientation(v2, v3, v0), and orientation (v3, v0, v1) are all 1.
+    /// Use with caution - for performance reasons, this is not verified!
+    FixedConvexPolygon(UnitVector3d const & v0,
+                       UnitVector3d const & v1,
+                       UnitVector3d const & v2,
+                       UnitVector3d const & v3) :
+        _vertices{v0, v1, v2, v3},
+        _n(4)
+    {
+        static_assert(N >= 4, "Polygon capacity is less than 4 vertices");
+    }
+
+    /// This constructor copies the given polygon. If it has more than N
+    /// vertices, a std::length_error is thrown.
+    explicit FixedConvexPolygon(ConvexPolygon const & p) :
+        _n(p.getVertices().size())
+    {
+        if (_n > N) {
+            throw std::length_error("Too many vertices for FixedConvexPolygon");
+        }
+        for (size_t i = 0; i < _n; ++i) {
+            _vertices[i] = p.getVertices()[i];
+        }
+    }
+
+    size_t getNumVertices() const { return _n; }
+
+    /// `getVertices` returns a pointer to the getNumVertices() vertices of
+    /// this polygon, in counter-clockwise order.
+    UnitVector3d const * getVertices() const { return _vertices; }
+
+    /// `toConvexPolygon` returns a ConvexPolygon with the same vertices.
+    ConvexPolygon toConvexPolygon() const {
+        ConvexPolygon p;
+        p._vertices.assign(_vertices, _vertices + _n);
+        return p;
+    }
+
+    /// The centroid of a polygon is its center of mass projected onto
+    /// S², assuming a uniform mass distribution over the polygon surface.
+    UnitVector3d getCentroid() const {
+        return detail::polygonCentroid(_vertices, _n);
+    }
+
+    Box getBoundingBox() const {
+        return detail::polygonBoundingBox(_vertices, _n);
+    }
+
+    Box3d getBoundingBox3d() const {
+        return detail::polygonBoundingBox3d(_vertices, _n);
+    }
+
+    Circle getBoundingCircle() const {
+        return detail::polygonBoundingCircle(_vertices, _n);
+    }
+
+    bool contains(UnitVector3d const & v) const {
+        return detail::polygonContains(_vertices, _n, v);
+    }
+
+    ///@{
+    /// `relate` computes the spatial relationships between this polygon
+    /// and another region. See Region::relate for details.
+    Relationship relate(Box const & b) const {
+        return detail::polygonRelate(_vertices, _n, b);
+    }
+
+    Relationship relate(Circle const & c) const {
+        return detail::polygonRelate(_vertices, _n, c);
+    }
+
+    Relationship relate(ConvexPolygon const & p) const {
+        return detail::polygonRelate(_vertices, _n, p);
+    }
+
+    Relationship relate(Ellipse const & e) const {
+        return detail::polygonRelate(_vertices, _n, e);
+    }
+
+    Relationship relate(Region const & r) const {
+        return detail::polygonRelate(_vertices, _n, r);
+    }
+
+    template <size_t M>
+    Relationship relate(FixedConvexPolygon<M> const & p) const {
+        return detail::polygonRelate(_vertices, _n,
+                                     p.getVertices(), p.getNumVertices());
+    }
+    ///@}
+
+    /// `encode` serializes this polygon into the byte string produced by
+    /// ConvexPolygon::encode for the same vertices.
+    std::vector<uint8_t> encode() const {
+        return detail::polygonEncode(_vertices, _n);
+    }
+
+private:
+    UnitVector3d _vertices[N];
+    size_t _n;
+};
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_FIXEDCONVEXPOLYGON_H_
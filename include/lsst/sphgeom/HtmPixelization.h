@@ -31,6 +31,8 @@
 #include <stdexcept>
 
 #include "ConvexPolygon.h"
+#include "FixedConvexPolygon.h"
+#include "MultiOrderCoverage.h"
 #include "Pixelization.h"
 
 
@@ -46,7 +48,8 @@ namespace sphgeom {
 /// a non-zero value below 6 can result in very poor region pixelizations
 /// regardless of region size. For instance, if `maxRanges` is 1, a non-empty
 /// circle centered on an axis will be approximated by a hemisphere or the
-/// entire unit sphere, even as its radius tends to 0.
+/// entire unit sphere, even as its radius tends to 0. Coarsening::OPTIMAL
+/// avoids this, at the cost of a full resolution search.
 class HtmPixelization : public Pixelization {
 public:
     /// `MAX_LEVEL` is the maximum supported HTM subdivision level.
@@ -62,6 +65,12 @@ public:
     /// If i is not a valid HTM index, a std::invalid_argument is thrown.
     static ConvexPolygon triangle(uint64_t i);
 
+    /// `fixedTriangle` returns the triangle corresponding to the given HTM
+    /// index without allocating memory.
+    ///
+    /// If i is not a valid HTM index, a std::invalid_argument is thrown.
+    static FixedConvexPolygon<3> fixedTriangle(uint64_t i);
+
     /// `asString` converts the given HTM index to a human readable string.
     ///
     /// The first character in the return value is always 'N' or 'S',
@@ -96,11 +105,71 @@ public:
 
     std::string toString(uint64_t i) const override { return asString(i); }
 
+    using Pixelization::envelope;
+    using Pixelization::interior;
+
+    ///@{
+    /// These overloads of envelope() and interior() accept regions of a
+    /// known type. They skip the run-time type identification and virtual
+    /// function calls of the generic versions, and return the same results.
+    RangeSet envelope(Box const & r,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL,
+                      TraversalStats * stats = nullptr) const;
+    RangeSet envelope(Circle const & r,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL,
+                      TraversalStats * stats = nullptr) const;
+    RangeSet envelope(ConvexPolygon const & r,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL,
+                      TraversalStats * stats = nullptr) const;
+    RangeSet interior(Box const & r,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL,
+                      TraversalStats * stats = nullptr) const;
+    RangeSet interior(Circle const & r,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL,
+                      TraversalStats * stats = nullptr) const;
+    RangeSet interior(ConvexPolygon const & r,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL,
+                      TraversalStats * stats = nullptr) const;
+    ///@}
+
+    ///@{
+    /// `envelopeCoverage` and `interiorCoverage` return the pixels of
+    /// envelope(r) and interior(r) as multi-order coverages. Pixels found
+    /// to lie inside r at coarser subdivision levels are kept as cells of
+    /// those levels, rather than being expanded into ranges of level
+    /// getLevel() pixels.
+    MultiOrderCoverage envelopeCoverage(Region const & r,
+                                        TraversalStats * stats = nullptr) const;
+    MultiOrderCoverage interiorCoverage(Region const & r,
+                                        TraversalStats * stats = nullptr) const;
+    ///@}
+
 private:
     int _level;
 
-    RangeSet _envelope(Region const &, size_t) const override;
-    RangeSet _interior(Region const &, size_t) const override;
+    RangeSet _envelope(Region const & r,
+                       size_t maxRanges,
+                       Coarsening coarsening,
+                       TraversalStats * stats) const override;
+    RangeSet _interior(Region const & r,
+                       size_t maxRanges,
+                       Coarsening coarsening,
+                       TraversalStats * stats) const override;
+    std::pair<RangeSet, RangeSet> _envelopeAndInterior(
+        Region const & r,
+        size_t maxRanges,
+        Coarsening coarsening,
+        TraversalStats * stats) const override;
+    void _streamEnvelope(Region const & r,
+                         RangeCallback const & callback) const override;
+    void _streamInterior(Region const & r,
+                         RangeCallback const & callback) const override;
 };
 
 }} // namespace lsst::sphgeom
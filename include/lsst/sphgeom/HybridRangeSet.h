@@ -0,0 +1,356 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_HYBRIDRANGESET_H_
+#define LSST_SPHGEOM_HYBRIDRANGESET_H_
+
+/// \file
+/// \brief This file provides a compressed bitmap type for representing
+///        fragmented integer sets.
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+#include "RangeSet.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+/// A `HybridRangeSet` is a set of unsigned 64 bit integers, like a RangeSet,
+/// that is optimized for sets consisting of many short ranges.
+///
+/// A RangeSet costs 16 bytes per range, so a pixelization of a region
+/// with a ragged boundary at a high subdivision level (e.g. a depth map
+/// footprint) can require hundreds of megabytes. `HybridRangeSet` follows
+/// the approach of Roaring bitmaps:
+///
+/// > Better bitmap performance with Roaring bitmaps
+/// > S. Chambi, D. Lemire, O. Kaser, R. Godin
+/// > Software: Practice and Experience, Volume 46, Issue 5, pp. 709-719
+/// >
+/// > https://arxiv.org/abs/1402.6407
+///
+/// The universe [0, 2^64) is partitioned into blocks of 2^16 consecutive
+/// integers. Each non-empty block that is not entirely contained in the
+/// set is stored in a container using whichever of the following encodings
+/// is smallest:
+///
+/// - a run container, storing the first and last element of each maximal
+///   run of consecutive integers in the block (4 bytes per run),
+/// - an array container, storing a sorted array of 16 bit block offsets
+///   (2 bytes per integer),
+/// - a bitmap container, storing one bit per block offset (8 KiB).
+///
+/// Consecutive blocks that are entirely contained in the set are stored as
+/// a single full-block run, so that the coarse ranges produced for region
+/// interiors by hierarchical pixelizations remain cheap.
+///
+/// The encoding of a given set is unique, so equality comparison is a
+/// container-by-container comparison. Membership tests cost a binary search
+/// over containers followed by a bit test or a binary search inside a block.
+/// Set operations are implemented by a merge of the ranges in both operands,
+/// with word-parallel evaluation for pairs of bitmap containers, and run in
+/// time linear in the size of the operands.
+///
+/// As for RangeSet, methods accepting a range of integers [first, last)
+/// consider a range with first == last to be full, and a range with
+/// first > last to wrap around.
+class HybridRangeSet {
+public:
+    /// `BLOCK_BITS` is the base-2 logarithm of the number of integers in
+    /// a container block.
+    static constexpr int BLOCK_BITS = 16;
+
+    HybridRangeSet(HybridRangeSet const &) = default;
+    HybridRangeSet(HybridRangeSet &&) = default;
+    HybridRangeSet & operator=(HybridRangeSet const &) = default;
+    HybridRangeSet & operator=(HybridRangeSet &&) = default;
+
+    /// The default constructor creates an empty set.
+    HybridRangeSet() = default;
+
+    ///@{
+    /// This constructor creates a set containing the given integer(s).
+    explicit HybridRangeSet(uint64_t u) { insert(u); }
+
+    HybridRangeSet(uint64_t first, uint64_t last) { insert(first, last); }
+    ///@}
+
+    /// This constructor creates a set containing the same integers
+    /// as the given RangeSet.
+    explicit HybridRangeSet(RangeSet const & s);
+
+    /// `toRangeSet` returns a RangeSet containing the same integers as
+    /// this set.
+    RangeSet toRangeSet() const;
+
+    ///@{
+    /// Two HybridRangeSet instances are equal iff they contain the same
+    /// integers.
+    bool operator==(HybridRangeSet const & s) const {
+        return _containers == s._containers;
+    }
+
+    bool operator!=(HybridRangeSet const & s) const {
+        return !(*this == s);
+    }
+    ///@}
+
+    ///@{
+    /// `insert` adds the given integer(s) to this set.
+    ///
+    /// If the given integers follow every integer in this set, only the last
+    /// container is modified. Otherwise, the worst case run time is O(N),
+    /// where N is the number of ranges in the set. Prefer building large
+    /// sets in ascending order, or converting them from a RangeSet.
+    void insert(uint64_t u) { insert(u, u + 1); }
+
+    void insert(uint64_t first, uint64_t last);
+    ///@}
+
+    ///@{
+    /// `erase` removes the given integers from this set.
+    void erase(uint64_t u) { erase(u, u + 1); }
+
+    void erase(uint64_t first, uint64_t last) {
+        *this = difference(HybridRangeSet(first, last));
+    }
+    ///@}
+
+    /// \name Set operations
+    ///@{
+
+    /// `complement` replaces this set S with U ∖ S, where U is the universe
+    /// of integers [0, 2^64). Unlike RangeSet::complement, it runs in
+    /// linear time.
+    HybridRangeSet & complement();
+
+    /// `complemented` returns a complemented copy of this set.
+    HybridRangeSet complemented() const {
+        HybridRangeSet s(*this);
+        s.complement();
+        return s;
+    }
+
+    /// `intersection` returns the intersection of this set and s.
+    HybridRangeSet intersection(HybridRangeSet const & s) const;
+
+    /// `join` returns the union of this set and s.
+    HybridRangeSet join(HybridRangeSet const & s) const;
+
+    /// `difference` returns the difference between this set and s.
+    HybridRangeSet difference(HybridRangeSet const & s) const;
+
+    /// `symmetricDifference` returns the symmetric difference of
+    /// this set and s.
+    HybridRangeSet symmetricDifference(HybridRangeSet const & s) const;
+
+    HybridRangeSet operator~() const { return complemented(); }
+
+    HybridRangeSet operator&(HybridRangeSet const & s) const {
+        return intersection(s);
+    }
+
+    HybridRangeSet operator|(HybridRangeSet const & s) const {
+        return join(s);
+    }
+
+    HybridRangeSet operator-(HybridRangeSet const & s) const {
+        return difference(s);
+    }
+
+    HybridRangeSet operator^(HybridRangeSet const & s) const {
+        return symmetricDifference(s);
+    }
+
+    HybridRangeSet & operator&=(HybridRangeSet const & s) {
+        if (this != &s) {
+            HybridRangeSet r = intersection(s);
+            swap(r);
+        }
+        return *this;
+    }
+
+    HybridRangeSet & operator|=(HybridRangeSet const & s) {
+        if (this != &s) {
+            HybridRangeSet r = join(s);
+            swap(r);
+        }
+        return *this;
+    }
+
+    HybridRangeSet & operator-=(HybridRangeSet const & s) {
+        HybridRangeSet r = difference(s);
+        swap(r);
+        return *this;
+    }
+
+    HybridRangeSet & operator^=(HybridRangeSet const & s) {
+        HybridRangeSet r = symmetricDifference(s);
+        swap(r);
+        return *this;
+    }
+    ///@}
+
+    ///@{
+    /// `intersects` returns true iff the intersection of this set
+    /// and the given integers is non-empty.
+    bool intersects(uint64_t u) const { return contains(u); }
+
+    bool intersects(uint64_t first, uint64_t last) const;
+
+    bool intersects(HybridRangeSet const & s) const;
+    ///@}
+
+    ///@{
+    /// `contains` returns true iff every one of the given integers is in
+    /// this set.
+    bool contains(uint64_t u) const;
+
+    bool contains(uint64_t first, uint64_t last) const;
+
+    bool contains(HybridRangeSet const & s) const;
+    ///@}
+
+    ///@{
+    /// `isWithin` returns true iff every integer in this set is also one of
+    /// the given integers.
+    bool isWithin(uint64_t u) const { return isWithin(u, u + 1); }
+
+    bool isWithin(uint64_t first, uint64_t last) const {
+        return HybridRangeSet(first, last).contains(*this);
+    }
+
+    bool isWithin(HybridRangeSet const & s) const { return s.contains(*this); }
+    ///@}
+
+    ///@{
+    /// `isDisjointFrom` returns true iff the intersection of this set
+    /// and the given integers is empty.
+    bool isDisjointFrom(uint64_t u) const { return !intersects(u); }
+
+    bool isDisjointFrom(uint64_t first, uint64_t last) const {
+        return !intersects(first, last);
+    }
+
+    bool isDisjointFrom(HybridRangeSet const & s) const {
+        return !intersects(s);
+    }
+    ///@}
+
+    /// `clear` removes all integers from this set.
+    void clear() { _containers.clear(); }
+
+    /// `fill` adds all the unsigned 64 bit integers to this set.
+    void fill();
+
+    /// `empty` checks whether there are any integers in this set.
+    bool empty() const { return _containers.empty(); }
+
+    /// `full` checks whether all integers in the universe of range sets,
+    /// [0, 2^64), are in this set.
+    bool full() const;
+
+    /// `cardinality` returns the number of integers in this set.
+    ///
+    /// Note that 0 is returned both for full and empty sets (a full set
+    /// contains 2^64 integers, which is 0 modulo 2^64).
+    uint64_t cardinality() const;
+
+    /// `getNumRanges` returns the number of disjoint, non-adjacent ranges
+    /// in this set; that is, the size of the equivalent RangeSet.
+    size_t getNumRanges() const;
+
+    /// `getMemoryUsage` returns the approximate number of bytes of heap
+    /// memory used by this set.
+    size_t getMemoryUsage() const;
+
+    void swap(HybridRangeSet & s) { _containers.swap(s._containers); }
+
+    /// `isValid` checks that this HybridRangeSet is in a valid state.
+    ///
+    /// It is intended for use by unit tests, but calling it in other contexts
+    /// is harmless. A return value of false means the HybridRangeSet
+    /// implementation isn't preserving its invariants, i.e. has a bug.
+    bool isValid() const;
+
+private:
+    friend std::ostream & operator<<(std::ostream &, HybridRangeSet const &);
+
+    class Builder;
+    class Cursor;
+
+    enum class Kind : uint8_t { FULL, RUN, ARRAY, BITMAP };
+
+    // A `Container` stores the elements of the set in the blocks
+    // [key, key + numBlocks). Only FULL containers span more than one block.
+    struct Container {
+        uint64_t key = 0;
+        uint64_t numBlocks = 1;
+        // The number of elements in a RUN, ARRAY or BITMAP block.
+        uint32_t cardinality = 0;
+        Kind kind = Kind::FULL;
+        // Inclusive (first, last) offset pairs for RUN containers, and
+        // sorted offsets for ARRAY containers.
+        std::vector<uint16_t> values;
+        // Bits for BITMAP containers.
+        std::vector<uint64_t> words;
+
+        bool operator==(Container const & c) const {
+            return key == c.key && numBlocks == c.numBlocks &&
+                   kind == c.kind && values == c.values && words == c.words;
+        }
+
+        bool contains(uint16_t offset) const;
+    };
+
+    std::vector<Container> _containers;
+
+    template <typename Op>
+    static void _combine(std::vector<Container> &,
+                         HybridRangeSet const &, HybridRangeSet const &,
+                         Op op);
+
+    template <typename Op>
+    static bool _any(Container const *, Container const *,
+                     Container const *, Container const *,
+                     Op op);
+
+    // `_slice` returns the containers overlapping the blocks that contain
+    // the integers in [first, last].
+    void _slice(uint64_t first, uint64_t last,
+                Container const ** begin, Container const ** end) const;
+};
+
+
+inline void swap(HybridRangeSet & a, HybridRangeSet & b) {
+    a.swap(b);
+}
+
+std::ostream & operator<<(std::ostream &, HybridRangeSet const &);
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_HYBRIDRANGESET_H_
@@ -0,0 +1,61 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_INSTRUCTIONSET_H_
+#define LSST_SPHGEOM_INSTRUCTIONSET_H_
+
+/// \file
+/// \brief This file declares functions for selecting the vector
+///        instruction set used by batch computations.
+
+
+namespace lsst {
+namespace sphgeom {
+
+/// `InstructionSet` enumerates the vector instruction sets that batch
+/// computations (e.g. those declared in separation.h) can use. They are
+/// ordered from least to most capable.
+enum class InstructionSet {
+    SCALAR = 0,
+    AVX2 = 1,
+    AVX512 = 2
+};
+
+/// `getSupportedInstructionSet` returns the most capable instruction set
+/// supported by both this build and the CPU it runs on. Vector kernels are
+/// only compiled for x86-64 with GCC compatible compilers; elsewhere, this
+/// is always InstructionSet::SCALAR.
+InstructionSet getSupportedInstructionSet();
+
+/// `getInstructionSet` returns the instruction set used by batch
+/// computations. It is initially the supported instruction set.
+InstructionSet getInstructionSet();
+
+/// `setInstructionSet` limits batch computations to the given instruction
+/// set, or to the supported one if it is less capable, and returns the
+/// instruction set in effect. It is intended for testing and benchmarking,
+/// since results do not depend on the instruction set.
+InstructionSet setInstructionSet(InstructionSet s);
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_INSTRUCTIONSET_H_
@@ -0,0 +1,205 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_MULTIORDERCOVERAGE_H_
+#define LSST_SPHGEOM_MULTIORDERCOVERAGE_H_
+
+/// \file
+/// \brief This file declares a class for representing sets of pixels of
+///        mixed subdivision levels.
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "RangeSet.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+/// A `MultiOrderCoverage` is a set of pixels of a hierarchical pixelization
+/// (HtmPixelization, Q3cPixelization or Mq3cPixelization) with possibly
+/// different subdivision levels, similar to an IVOA MOC. Pixels are
+/// identified by (level, index) pairs called cells.
+///
+/// Coverages are always normalized: a cell is never covered by another
+/// cell, and 4 sibling cells are always replaced by their parent. Two
+/// coverages are therefore equal if and only if they cover the same
+/// area, and the cells of the interior of a region found by a pixelization
+/// search are those that the search identified, at their own levels.
+///
+/// Internally, the covered pixels are stored as a RangeSet of level
+/// MAX_LEVEL pixel indexes, from which the normalized cells are derived
+/// on demand. This makes set operations as fast as for RangeSet, and
+/// conversions to and from single level RangeSets linear in the number of
+/// ranges. Cell indexes at level L must be less than 16·4ᴸ.
+class MultiOrderCoverage {
+public:
+    /// A `Cell` is a (level, index) pair.
+    using Cell = std::pair<int, uint64_t>;
+
+    /// `MAX_LEVEL` is the maximum supported cell level.
+    static constexpr int MAX_LEVEL = 30;
+
+    /// `fromRangeSet` returns the coverage of the level `level` pixels in
+    /// s. A std::invalid_argument is thrown if `level` or an index in s is
+    /// invalid.
+    static MultiOrderCoverage fromRangeSet(RangeSet const & s, int level);
+
+    /// This constructor creates an empty coverage.
+    MultiOrderCoverage() = default;
+
+    /// This constructor creates a coverage consisting of a single cell. A
+    /// std::invalid_argument is thrown if the cell is invalid.
+    MultiOrderCoverage(int level, uint64_t index) { insert(level, index); }
+
+    bool operator==(MultiOrderCoverage const & c) const {
+        return _ranges == c._ranges;
+    }
+
+    bool operator!=(MultiOrderCoverage const & c) const {
+        return _ranges != c._ranges;
+    }
+
+    /// `insert` adds a cell to this coverage. A std::invalid_argument is
+    /// thrown if the cell is invalid. It runs in amortized constant time if
+    /// cells are inserted in increasing order of their level MAX_LEVEL
+    /// descendants.
+    void insert(int level, uint64_t index);
+
+    /// `empty` returns true if this coverage contains no cells.
+    bool empty() const { return _ranges.empty(); }
+
+    /// `getMaxLevel` returns the maximum cell level, or -1 if this coverage
+    /// is empty.
+    int getMaxLevel() const;
+
+    /// `getCells` returns the normalized cells of this coverage, sorted by
+    /// the indexes of their level MAX_LEVEL descendants.
+    std::vector<Cell> getCells() const;
+
+    /// `getNumCells` returns the number of normalized cells.
+    size_t getNumCells() const;
+
+    /// `getRanges` returns the level MAX_LEVEL pixel indexes covered.
+    RangeSet const & getRanges() const { return _ranges; }
+
+    ///@{
+    /// `contains` and `intersects` compare this coverage to a cell or to
+    /// another coverage.
+    bool contains(int level, uint64_t index) const;
+    bool contains(MultiOrderCoverage const & c) const {
+        return _ranges.contains(c._ranges);
+    }
+    bool intersects(int level, uint64_t index) const;
+    bool intersects(MultiOrderCoverage const & c) const {
+        return _ranges.intersects(c._ranges);
+    }
+    ///@}
+
+    /// `toRangeSet` returns the indexes of the level `level` pixels that
+    /// intersect this coverage. Cells finer than `level` are replaced by
+    /// their ancestors.
+    RangeSet toRangeSet(int level) const;
+
+    /// `toInteriorRangeSet` returns the indexes of the level `level` pixels
+    /// within this coverage. Cells finer than `level` are dropped unless all
+    /// of their siblings are present.
+    RangeSet toInteriorRangeSet(int level) const;
+
+    /// `degradedTo` returns the smallest coverage with a maximum level of
+    /// at most `level` that contains this one.
+    MultiOrderCoverage degradedTo(int level) const {
+        return fromRangeSet(toRangeSet(level), level);
+    }
+
+    /// \name Set operations
+    ///@{
+    MultiOrderCoverage operator|(MultiOrderCoverage const & c) const {
+        return MultiOrderCoverage(_ranges | c._ranges);
+    }
+
+    MultiOrderCoverage operator&(MultiOrderCoverage const & c) const {
+        return MultiOrderCoverage(_ranges & c._ranges);
+    }
+
+    MultiOrderCoverage operator-(MultiOrderCoverage const & c) const {
+        return MultiOrderCoverage(_ranges - c._ranges);
+    }
+
+    MultiOrderCoverage operator^(MultiOrderCoverage const & c) const {
+        return MultiOrderCoverage(_ranges ^ c._ranges);
+    }
+
+    MultiOrderCoverage & operator|=(MultiOrderCoverage const & c) {
+        _ranges |= c._ranges;
+        return *this;
+    }
+
+    MultiOrderCoverage & operator&=(MultiOrderCoverage const & c) {
+        _ranges &= c._ranges;
+        return *this;
+    }
+
+    MultiOrderCoverage & operator-=(MultiOrderCoverage const & c) {
+        _ranges -= c._ranges;
+        return *this;
+    }
+
+    MultiOrderCoverage & operator^=(MultiOrderCoverage const & c) {
+        _ranges ^= c._ranges;
+        return *this;
+    }
+    ///@}
+
+    /// `encode` serializes this coverage as a byte string. The encoding
+    /// consists of the type code 'M', followed by the cells of each
+    /// non-empty level in increasing level order: the level, the number of
+    /// cells, the first cell index and the differences between consecutive
+    /// cell indexes, with all integers but the level stored as LEB128
+    /// variable length integers. Nearby cells therefore take 1 or 2 bytes.
+    std::vector<uint8_t> encode() const;
+
+    ///@{
+    /// `decode` deserializes a MultiOrderCoverage from a byte string
+    /// produced by encode. A std::runtime_error is thrown if the byte
+    /// string is invalid.
+    static MultiOrderCoverage decode(std::vector<uint8_t> const & s) {
+        return decode(s.data(), s.size());
+    }
+
+    static MultiOrderCoverage decode(uint8_t const * buffer, size_t n);
+    ///@}
+
+private:
+    explicit MultiOrderCoverage(RangeSet && ranges) :
+        _ranges(std::move(ranges))
+    {}
+
+    RangeSet _ranges;
+};
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_MULTIORDERCOVERAGE_H_
@@ -0,0 +1,150 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_PIXELAGGREGATES_H_
+#define LSST_SPHGEOM_PIXELAGGREGATES_H_
+
+/// \file
+/// \brief This file declares a class for aggregating point data by pixel.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Pixelization.h"
+#include "UnitVector3d.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+/// `PixelAggregates` holds the number of points in each pixel of an
+/// HtmPixelization, Q3cPixelization or Mq3cPixelization, along with the sum,
+/// minimum and maximum of the weights of those points. It can be used to
+/// build count, density and depth maps of point catalogs.
+///
+/// Aggregates are stored sparsely, as parallel arrays sorted by pixel index
+/// that only include non-empty pixels. Dense arrays covering all pixels can
+/// be obtained for low subdivision levels.
+class PixelAggregates {
+public:
+    /// This constructor creates aggregates with no points. It throws a
+    /// std::invalid_argument if the pixelization is of another type.
+    explicit PixelAggregates(Pixelization const & pixelization);
+
+    ///@{
+    /// This constructor aggregates the n given points by pixel. If weights
+    /// is null or empty, all points have a weight of 1.
+    ///
+    /// If `numThreads` is greater than 1, the points are divided into that
+    /// many slices, which are aggregated concurrently and then merged.
+    /// Weight sums can then differ from those obtained with fewer threads
+    /// by a few units in the last place, since they are computed in a
+    /// different order.
+    ///
+    /// A std::invalid_argument is thrown if the pixelization is of another
+    /// type, or if the number of weights is different from the number of
+    /// points.
+    PixelAggregates(Pixelization const & pixelization,
+                    UnitVector3d const * points,
+                    double const * weights,
+                    size_t n,
+                    unsigned numThreads = 1);
+
+    PixelAggregates(Pixelization const & pixelization,
+                    std::vector<UnitVector3d> const & points,
+                    std::vector<double> const & weights = {},
+                    unsigned numThreads = 1);
+    ///@}
+
+    /// `getPixelization` returns the pixelization of these aggregates.
+    Pixelization const & getPixelization() const { return *_pixelization; }
+
+    /// `getLevel` returns the subdivision level of the pixelization.
+    int getLevel() const { return _level; }
+
+    /// `size` returns the number of non-empty pixels.
+    size_t size() const { return _indexes.size(); }
+
+    /// `empty` returns true if there are no points.
+    bool empty() const { return _indexes.empty(); }
+
+    /// `getTotalCount` returns the total number of points.
+    uint64_t getTotalCount() const;
+
+    ///@{
+    /// These methods return the sparse aggregates: the indexes of the
+    /// non-empty pixels in increasing order, and for each of them the
+    /// number of points, and the sum, minimum and maximum of their weights.
+    std::vector<uint64_t> const & getIndexes() const { return _indexes; }
+    std::vector<uint64_t> const & getCounts() const { return _counts; }
+    std::vector<double> const & getSums() const { return _sums; }
+    std::vector<double> const & getMins() const { return _mins; }
+    std::vector<double> const & getMaxs() const { return _maxs; }
+    ///@}
+
+    ///@{
+    /// These methods return dense aggregates, with one element per pixel.
+    /// Element i corresponds to the pixel with index `first + i`, where
+    /// `first` is the smallest index in the pixelization universe. Empty
+    /// pixels have a count and sum of 0, and a minimum and maximum of NaN.
+    ///
+    /// A dense array has 6·4ᴸ to 8·4ᴸ elements for subdivision level L, so
+    /// these methods are only practical for low levels.
+    std::vector<uint64_t> getDenseCounts() const;
+    std::vector<double> getDenseSums() const;
+    std::vector<double> getDenseMins() const;
+    std::vector<double> getDenseMaxs() const;
+    ///@}
+
+    /// `coarsened` returns these aggregates rolled up to the given
+    /// subdivision level, which must not exceed the current one.
+    PixelAggregates coarsened(int level) const;
+
+    /// `merged` returns the aggregates of the points of both this object and
+    /// `a`, which must have the same pixelization.
+    PixelAggregates merged(PixelAggregates const & a) const;
+
+private:
+    struct Cell;
+
+    PixelAggregates() = default;
+
+    Cell _cell(size_t i) const;
+    void _assign(std::vector<std::pair<uint64_t, Cell>> & cells);
+    template <typename T>
+    std::vector<T> _dense(std::vector<T> const & values, T fill) const;
+
+    std::shared_ptr<Pixelization const> _pixelization;
+    uint8_t _type = 0;
+    int _level = 0;
+    std::vector<uint64_t> _indexes;
+    std::vector<uint64_t> _counts;
+    std::vector<double> _sums;
+    std::vector<double> _mins;
+    std::vector<double> _maxs;
+};
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_PIXELAGGREGATES_H_
@@ -0,0 +1,138 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_PIXELTRANSLATOR_H_
+#define LSST_SPHGEOM_PIXELTRANSLATOR_H_
+
+/// \file
+/// \brief This file declares a class for translating pixel index sets
+///        between pixelizations.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Pixelization.h"
+#include "RangeSet.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+class Chunker;
+
+/// `PixelTranslator` maps sets of pixel indexes in a source HtmPixelization,
+/// Q3cPixelization or Mq3cPixelization to sets of pixel indexes in a target
+/// pixelization, or to sets of Chunker chunk IDs or sub-chunk keys (see
+/// Chunker::getSubChunkKey()), without going back to the regions the
+/// source indexes were computed from.
+///
+/// A source index set is decomposed into the smallest number of pixels of
+/// any level, e.g. a range covering all the children of a level 3 pixel
+/// becomes that pixel. The target envelope of each of these pixels is
+/// computed from its region, and the results are combined. For Chunker
+/// targets, source pixels are no coarser than the level at which they are
+/// about as large as a chunk (or sub-chunk), since chunks are related to
+/// regions via bounding boxes. Envelopes of
+/// pixels at or below a maximum cache level are cached, since coarse
+/// pixels are expensive to map and recur across translations.
+///
+/// Translators can be used concurrently from several threads.
+class PixelTranslator {
+public:
+    /// `DEFAULT_MAX_CACHE_LEVEL` is the default maximum level of the source
+    /// pixels whose target envelopes are cached.
+    static constexpr int DEFAULT_MAX_CACHE_LEVEL = 6;
+
+    /// `MAX_CACHE_LEVEL` is the largest supported maximum cache level.
+    static constexpr int MAX_CACHE_LEVEL = 24;
+
+    /// This constructor creates a translator between two pixelizations.
+    /// A std::invalid_argument is thrown if the source pixelization is not
+    /// an HtmPixelization, Q3cPixelization or Mq3cPixelization, if the
+    /// target pixelization is not one either, or if `maxCacheLevel` exceeds
+    /// MAX_CACHE_LEVEL. A negative `maxCacheLevel` disables caching.
+    PixelTranslator(Pixelization const & source,
+                    Pixelization const & target,
+                    int maxCacheLevel = DEFAULT_MAX_CACHE_LEVEL);
+
+    /// This constructor creates a translator from a pixelization to the
+    /// chunk IDs of a Chunker, or to its sub-chunk keys if `subChunks` is
+    /// true. Arguments are otherwise handled as for the pixelization
+    /// constructor.
+    PixelTranslator(Pixelization const & source,
+                    Chunker const & target,
+                    bool subChunks = false,
+                    int maxCacheLevel = DEFAULT_MAX_CACHE_LEVEL);
+
+    PixelTranslator(PixelTranslator const &) = delete;
+    PixelTranslator & operator=(PixelTranslator const &) = delete;
+
+    /// `envelope` returns a superset of the target indexes of the pixels
+    /// or chunks intersecting the given source pixels.
+    ///
+    /// If `numThreads` is greater than 1, the decomposed source pixels are
+    /// divided into that many slices that are mapped concurrently. A
+    /// std::invalid_argument is thrown if `pixels` contains indexes that
+    /// are not valid in the source pixelization.
+    RangeSet envelope(RangeSet const & pixels, unsigned numThreads = 1) const;
+
+    /// `interior` returns a subset of the target indexes of the pixels or
+    /// chunks within the given source pixels. These are the indexes in the
+    /// envelope of `pixels` that are not in the envelope of its complement.
+    /// The arguments are handled as for envelope().
+    RangeSet interior(RangeSet const & pixels, unsigned numThreads = 1) const;
+
+    /// `getCacheSize` returns the number of cached source pixel envelopes.
+    size_t getCacheSize() const;
+
+    /// `clearCache` removes all cached source pixel envelopes.
+    void clearCache();
+
+private:
+    PixelTranslator(Pixelization const & source, int maxCacheLevel);
+
+    RangeSet _envelope(int level, uint64_t index) const;
+    std::vector<RangeSet> _envelopes(
+        std::vector<std::pair<int, uint64_t>> const & cells,
+        unsigned numThreads) const;
+
+    // Source pixelizations for levels 0 through the source level.
+    std::vector<std::shared_ptr<Pixelization const>> _levels;
+    RangeSet _sourceUniverse;
+    int _maxCacheLevel;
+    // Source pixels coarser than this level are split before mapping.
+    int _minLevel = 0;
+    std::shared_ptr<Pixelization const> _target;
+    std::shared_ptr<Chunker const> _chunker;
+    bool _subChunks = false;
+    mutable std::mutex _mutex;
+    mutable std::unordered_map<uint64_t, RangeSet> _cache;
+};
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_PIXELTRANSLATOR_H_
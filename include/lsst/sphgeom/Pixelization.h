@@ -26,9 +26,13 @@
 /// \file
 /// \brief This file defines an interface for pixelizations of the sphere.
 
+#include <functional>
+#include <memory>
 #include <string>
+#include <utility>
 
 #include "RangeSet.h"
+#include "TraversalStats.h"
 
 
 namespace lsst {
@@ -37,6 +41,23 @@ namespace sphgeom {
 class Region;
 class UnitVector3d;
 
+/// `Coarsening` enumerates the strategies that hierarchical pixelizations
+/// use to meet the `maxRanges` limit of Pixelization::envelope() and
+/// Pixelization::interior().
+enum class Coarsening {
+    /// Lower the subdivision level whenever too many ranges have been found.
+    /// This bounds the cost of the search, but can give up much more
+    /// precision than necessary.
+    LEVEL,
+
+    /// Search at the full subdivision level, and return the closest set of
+    /// at most `maxRanges` ranges: envelope ranges separated by the smallest
+    /// gaps are merged, and the smallest interior ranges are removed. This
+    /// uses O(maxRanges) memory and O(n log maxRanges) time for n full
+    /// resolution ranges, but does not reduce the cost of the search itself.
+    OPTIMAL
+};
+
 
 /// A `Pixelization` (or partitioning) of the sphere is a mapping between
 /// points on the sphere and a set of pixels (a.k.a. cells or partitions)
@@ -76,6 +97,11 @@ class UnitVector3d;
 ///                          pixelization.envelope(r);
 class Pixelization {
 public:
+    /// A `RangeCallback` is passed the beginning and end of a half-open
+    /// range of pixel indexes [first, last). As for RangeSet, an end point
+    /// of 0 corresponds to 2^64.
+    using RangeCallback = std::function<void(uint64_t, uint64_t)>;
+
     virtual ~Pixelization() {}
 
     /// `universe` returns the set of all pixel indexes for this pixelization.
@@ -127,26 +153,118 @@ public:
     /// In practice, the implementation of this method for a hierarchical
     /// pixelization like Q3C or HTM will lower the subdivision level when
     /// too many ranges have been found. Each coarse pixel I at level L - n
-    /// corresponds to pixels [I*4ⁿ, (I + 1)*4ⁿ) at level L.
-    RangeSet envelope(Region const & r, size_t maxRanges = 0) const {
-        return _envelope(r, maxRanges);
+    /// corresponds to pixels [I*4ⁿ, (I + 1)*4ⁿ) at level L. Passing
+    /// Coarsening::OPTIMAL instead merges the ranges separated by the
+    /// smallest gaps, which gives the smallest superset with at most
+    /// `maxRanges` ranges.
+    ///
+    /// If `stats` is not null, hierarchical pixelizations add counts of the
+    /// work done by the search to it.
+    RangeSet envelope(Region const & r,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL,
+                      TraversalStats * stats = nullptr) const
+    {
+        return _envelope(r, maxRanges, coarsening, stats);
     }
 
     /// `interior` returns the indexes of the pixels within the spherical
     /// region r.
     ///
-    /// The `maxRanges` argument is analogous to the identically named
-    /// envelope() argument. The only difference is that implementations must
-    /// remove interior pixels to keep the number of ranges at or below the
-    /// maximum. The return value is therefore always a subset of the interior
-    /// pixels.
-    RangeSet interior(Region const & r, size_t maxRanges = 0) const {
-        return _interior(r, maxRanges);
+    /// The `maxRanges` and `stats` arguments are analogous to the identically
+    /// named envelope() arguments. The only difference is that
+    /// implementations must remove interior pixels to keep the number of
+    /// ranges at or below the maximum. The return value is therefore always
+    /// a subset of the interior pixels. With Coarsening::OPTIMAL, the
+    /// smallest ranges are removed, which gives the largest subset with at
+    /// most `maxRanges` ranges.
+    RangeSet interior(Region const & r,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL,
+                      TraversalStats * stats = nullptr) const
+    {
+        return _interior(r, maxRanges, coarsening, stats);
     }
 
+    /// `envelopeAndInterior` returns the pair (envelope(r), interior(r)).
+    ///
+    /// Hierarchical pixelizations compute both sets with a single tree
+    /// traversal, so that every pixel-region relationship is computed once.
+    /// The pixels intersecting the boundary of r, which are the ones that
+    /// require per-point containment checks, are given by the difference
+    /// of the two sets.
+    std::pair<RangeSet, RangeSet> envelopeAndInterior(
+        Region const & r,
+        size_t maxRanges = 0,
+        Coarsening coarsening = Coarsening::LEVEL,
+        TraversalStats * stats = nullptr) const
+    {
+        return _envelopeAndInterior(r, maxRanges, coarsening, stats);
+    }
+
+    ///@{
+    /// `streamEnvelope` and `streamInterior` pass the ranges of pixel
+    /// indexes in envelope(r) and interior(r) to a callback, in ascending
+    /// order, as soon as they are known.
+    ///
+    /// Hierarchical pixelizations generate ranges during the tree traversal,
+    /// merging adjacent ranges on the fly, so that working memory is
+    /// proportional to the subdivision level rather than to the size of
+    /// the output. This allows consumers (e.g. database range scans) to
+    /// start before the search completes. Since the output is not
+    /// accumulated, there is no limit on the number of ranges.
+    void streamEnvelope(Region const & r,
+                        RangeCallback const & callback) const
+    {
+        _streamEnvelope(r, callback);
+    }
+
+    void streamInterior(Region const & r,
+                        RangeCallback const & callback) const
+    {
+        _streamInterior(r, callback);
+    }
+    ///@}
+
 private:
-    virtual RangeSet _envelope(Region const & r, size_t maxRanges) const = 0;
-    virtual RangeSet _interior(Region const & r, size_t maxRanges) const = 0;
+    virtual RangeSet _envelope(Region const & r,
+                               size_t maxRanges,
+                               Coarsening coarsening,
+                               TraversalStats * stats) const = 0;
+    virtual RangeSet _interior(Region const & r,
+                               size_t maxRanges,
+                               Coarsening coarsening,
+                               TraversalStats * stats) const = 0;
+
+    // The default implementation of _envelopeAndInterior performs two
+    // independent searches.
+    virtual std::pair<RangeSet, RangeSet> _envelopeAndInterior(
+        Region const & r,
+        size_t maxRanges,
+        Coarsening coarsening,
+        TraversalStats * stats) const
+    {
+        return std::make_pair(_envelope(r, maxRanges, coarsening, stats),
+                              _interior(r, maxRanges, coarsening, stats));
+    }
+
+    // The default implementations of _streamEnvelope and _streamInterior
+    // compute the full result before invoking the callback.
+    virtual void _streamEnvelope(Region const & r,
+                                 RangeCallback const & callback) const
+    {
+        for (auto const & t: _envelope(r, 0, Coarsening::LEVEL, nullptr)) {
+            callback(std::get<0>(t), std::get<1>(t));
+        }
+    }
+
+    virtual void _streamInterior(Region const & r,
+                                 RangeCallback const & callback) const
+    {
+        for (auto const & t: _interior(r, 0, Coarsening::LEVEL, nullptr)) {
+            callback(std::get<0>(t), std::get<1>(t));
+        }
+    }
 };
 
 }} // namespace lsst::sphgeom
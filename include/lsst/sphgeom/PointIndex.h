@@ -0,0 +1,158 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_POINTINDEX_H_
+#define LSST_SPHGEOM_POINTINDEX_H_
+
+/// \file
+/// \brief This file declares a container of points sorted by pixel index.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Pixelization.h"
+#include "RangeSet.h"
+#include "UnitVector3d.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+class Region;
+
+/// `PointIndex` stores a set of points sorted by the index of the pixel
+/// containing them in an HtmPixelization, Q3cPixelization or
+/// Mq3cPixelization, so that the points in a set of pixels can be found
+/// by scanning contiguous position ranges.
+///
+/// Points are identified by their position in the input of the
+/// constructor. A directory maps each non-empty pixel to the positions of
+/// its points in sorted order, and occupies 16 bytes per non-empty pixel.
+///
+/// An index can be saved to a file and memory-mapped back, so that large
+/// catalogs can be searched without reading them in their entirety.
+/// Indexes are immutable, and may be queried concurrently.
+class PointIndex {
+public:
+    /// A `Span` is a half-open range [first, second) of sorted positions.
+    using Span = std::pair<size_t, size_t>;
+
+    /// This constructor creates an empty index. It throws a
+    /// std::invalid_argument if the pixelization is of another type.
+    explicit PointIndex(Pixelization const & pixelization);
+
+    ///@{
+    /// This constructor indexes the n given points. If `numThreads` is
+    /// greater than 1, pixel indexes are computed and sorted by that many
+    /// threads. A std::invalid_argument is thrown if the pixelization is of
+    /// another type.
+    PointIndex(Pixelization const & pixelization,
+               UnitVector3d const * points,
+               size_t n,
+               unsigned numThreads = 1);
+
+    PointIndex(Pixelization const & pixelization,
+               std::vector<UnitVector3d> const & points,
+               unsigned numThreads = 1) :
+        PointIndex(pixelization, points.data(), points.size(), numThreads)
+    {}
+    ///@}
+
+    /// `getPixelization` returns the pixelization used to sort points.
+    Pixelization const & getPixelization() const { return *_pixelization; }
+
+    /// `size` returns the number of points.
+    size_t size() const { return _size; }
+
+    /// `empty` returns true if there are no points.
+    bool empty() const { return _size == 0; }
+
+    /// `getNumPixels` returns the number of non-empty pixels.
+    size_t getNumPixels() const { return _numPixels; }
+
+    ///@{
+    /// `getPoints` and `getIds` return arrays of size() points and point
+    /// IDs in sorted order, where the ID of a point is its position in the
+    /// input of the constructor. Points in the same pixel are sorted by ID.
+    UnitVector3d const * getPoints() const { return _points; }
+    uint64_t const * getIds() const { return _ids; }
+    ///@}
+
+    /// `getSpans` returns the increasing, disjoint and non-adjacent
+    /// ranges of sorted positions holding the points in the given pixels.
+    std::vector<Span> getSpans(RangeSet const & pixels) const;
+
+    /// `find` returns the IDs of the points in the given pixels, in
+    /// sorted order.
+    std::vector<uint64_t> find(RangeSet const & pixels) const;
+
+    /// `find` returns the IDs of the points in r, in sorted order.
+    ///
+    /// All points in pixels of the interior of r are returned, and only
+    /// the points in pixels intersecting the boundary of r, i.e. those of
+    /// the envelope but not the interior, are tested for containment.
+    std::vector<uint64_t> find(Region const & r) const;
+
+    /// `save` writes this index to a file, which can be memory-mapped with
+    /// open(). The file stores points, IDs and the pixel directory in the
+    /// native byte order, preceded by a small header. A std::runtime_error
+    /// is thrown if the file cannot be written.
+    void save(std::string const & path) const;
+
+    /// `open` memory-maps an index saved with save(). The mapping is
+    /// read-only, and is released when the returned index and all copies
+    /// of it are destroyed. A std::runtime_error is thrown if the file
+    /// cannot be mapped, or is not a valid index file.
+    static PointIndex open(std::string const & path);
+
+private:
+    struct Storage;
+    class Mapping;
+
+    PointIndex() = default;
+
+    void _attach(std::shared_ptr<Storage const> storage);
+    Span _span(uint64_t first, uint64_t last) const;
+
+    std::shared_ptr<Pixelization const> _pixelization;
+    uint8_t _type = 0;
+    int _level = 0;
+    // The arrays below either belong to a Storage object or lie in a file
+    // mapping, and are kept alive by _owner.
+    std::shared_ptr<void const> _owner;
+    UnitVector3d const * _points = nullptr;
+    uint64_t const * _ids = nullptr;
+    // The points in pixel _pixels[i] have positions
+    // [_offsets[i], _offsets[i + 1]).
+    uint64_t const * _pixels = nullptr;
+    uint64_t const * _offsets = nullptr;
+    size_t _size = 0;
+    size_t _numPixels = 0;
+};
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_POINTINDEX_H_
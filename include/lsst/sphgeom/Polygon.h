@@ -0,0 +1,179 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_POLYGON_H_
+#define LSST_SPHGEOM_POLYGON_H_
+
+/// \file
+/// \brief This file declares a class for representing polygons with
+///        great circle edges that need not be convex.
+
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+#include "Box.h"
+#include "Circle.h"
+#include "ConvexPolygon.h"
+#include "Region.h"
+#include "UnitVector3d.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+class Polygon;
+
+namespace detail {
+
+// `polygonRelate` computes the relationship between the convex polygon
+// with the n counter-clockwise vertices v and the polygon p.
+Relationship polygonRelate(UnitVector3d const * v, size_t n,
+                           Polygon const & p);
+
+} // namespace detail
+
+
+/// `Polygon` is a polygon on the unit sphere with great circle edges, which
+/// need not be convex, and which may have holes.
+///
+/// A polygon is the closed region bounded by a simple closed curve, its
+/// boundary, from which zero or more holes, also bounded by simple closed
+/// curves, are removed. Each curve is given by its vertices in either order,
+/// and must lie in an open hemisphere; it bounds the part of the sphere
+/// inside its convex hull. Holes must be disjoint from each other and lie
+/// inside the boundary.
+///
+/// Holes are closed, so the polygon does not contain the points on their
+/// edges, and regions that lie in a hole but touch its edges are disjoint
+/// from the polygon. A polygon with holes is therefore not closed.
+///
+/// The boundary is stored in counter-clockwise and holes in clockwise order,
+/// so that the polygon interior is to the left of every edge. Internally, the
+/// polygon is split into convex pieces, as are holes and the parts of the
+/// convex hull of the boundary outside of it. Spatial relationships are
+/// computed from those of the pieces, and containment tests use a grid index
+/// over them.
+class Polygon : public Region {
+public:
+    static constexpr uint8_t TYPE_CODE = 'P';
+
+    ///@{
+    /// This constructor creates a polygon with the given boundary and holes.
+    /// It throws a std::invalid_argument if a boundary curve has less than
+    /// 3 distinct, non-coplanar vertices, does not lie in an open
+    /// hemisphere, or is found not to be simple. Simplicity is not fully
+    /// verified, and neither is the placement of holes.
+    explicit Polygon(std::vector<UnitVector3d> const & boundary);
+
+    Polygon(std::vector<UnitVector3d> const & boundary,
+            std::vector<std::vector<UnitVector3d>> const & holes);
+    ///@}
+
+    /// Two polygons are equal if their boundaries and holes have the same
+    /// vertices in the same order.
+    bool operator==(Polygon const & p) const;
+    bool operator!=(Polygon const & p) const { return !(*this == p); }
+
+    /// `getBoundary` returns the vertices of the polygon boundary, in
+    /// counter-clockwise order.
+    std::vector<UnitVector3d> const & getBoundary() const { return _boundary; }
+
+    /// `getHoles` returns the vertices of the polygon holes, in clockwise
+    /// order.
+    std::vector<std::vector<UnitVector3d>> const & getHoles() const {
+        return _holes;
+    }
+
+    /// `getConvexHull` returns the convex hull of the polygon boundary.
+    ConvexPolygon const & getConvexHull() const { return _hull; }
+
+    // Region interface
+    std::unique_ptr<Region> clone() const override {
+        return std::unique_ptr<Polygon>(new Polygon(*this));
+    }
+
+    Box getBoundingBox() const override;
+    Box3d getBoundingBox3d() const override;
+    Circle getBoundingCircle() const override;
+
+    bool contains(UnitVector3d const & v) const override;
+
+    Relationship relate(Region const & r) const override;
+    Relationship relate(Box const &) const override;
+    Relationship relate(Circle const &) const override;
+    Relationship relate(ConvexPolygon const &) const override;
+    Relationship relate(Ellipse const &) const override;
+    Relationship relate(Polygon const &) const override;
+    Relationship relate(CompoundRegion const &) const override;
+
+    std::vector<uint8_t> encode() const override;
+
+    ///@{
+    /// `decode` deserializes a Polygon from a byte string produced by encode.
+    static std::unique_ptr<Polygon> decode(std::vector<uint8_t> const & s) {
+        return decode(s.data(), s.size());
+    }
+    static std::unique_ptr<Polygon> decode(uint8_t const * buffer, size_t n);
+    ///@}
+
+private:
+    friend Relationship detail::polygonRelate(UnitVector3d const *, size_t,
+                                              Polygon const &);
+
+    // A `Part` is a convex piece of the polygon with its holes filled in,
+    // of a hole, or of a pocket - a region between the polygon boundary and
+    // its convex hull.
+    struct Part {
+        ConvexPolygon polygon;
+        Circle boundingCircle;
+    };
+
+    std::vector<UnitVector3d> _boundary;
+    std::vector<std::vector<UnitVector3d>> _holes;
+    ConvexPolygon _hull;
+    std::vector<Part> _pieces;
+    std::vector<Part> _pockets;
+    std::vector<Part> _holeParts;
+    // The containment index is a grid of longitude/latitude cells covering
+    // the bounding box of the convex hull. Each cell lists the pieces and
+    // hole pieces with bounding boxes overlapping it, where hole pieces are
+    // numbered after polygon pieces. Small polygons have no index.
+    Box _box;
+    int _numLon = 0;
+    int _numLat = 0;
+    std::vector<std::vector<uint32_t>> _cells;
+
+    void _build();
+    void _buildIndex();
+    int _lonCell(NormalizedAngle lon) const;
+    int _latCell(Angle lat) const;
+
+    template <typename RegionType>
+    Relationship _relate(RegionType const & r) const;
+};
+
+std::ostream & operator<<(std::ostream &, Polygon const &);
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_POLYGON_H_
@@ -0,0 +1,115 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_PREPAREDBOX_H_
+#define LSST_SPHGEOM_PREPAREDBOX_H_
+
+/// \file
+/// \brief This file declares a class for fast point-in-box tests.
+
+#include <cstddef>
+
+#include "Box.h"
+#include "UnitVector3d.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+/// `PreparedBox` is a Box preprocessed for fast point containment tests.
+///
+/// Box::contains(UnitVector3d const &) converts its argument to spherical
+/// coordinates, which costs an `atan2` and a `sqrt` per point. A prepared box
+/// instead stores its latitude bounds as thresholds on the z component of
+/// unit vectors, and its longitude bounds as the normals of two meridian
+/// planes. Testing a point then takes two dot products and a few
+/// comparisons. Points for which these tests are too close to call, i.e.
+/// that lie within `EPSILON` of a bounding plane, fall back to the exact
+/// test, so that results are always identical to those of Box::contains.
+class PreparedBox {
+public:
+    /// `EPSILON` bounds the absolute difference between the fast tests and
+    /// the ones performed in spherical coordinates, and controls when the
+    /// exact test is used.
+    static constexpr double EPSILON = 1.0e-14;
+
+    explicit PreparedBox(Box const & box);
+
+    Box const & getBox() const { return _box; }
+
+    ///@{
+    /// `contains` returns true if the box contains the given point(s).
+    ///
+    /// The batch variants store the result for the i-th point in
+    /// `results[i]`. They accept arrays of unit vectors, or arrays of unit
+    /// vector components (which must be normalized), and are written so
+    /// that the compiler can vectorize the fast tests.
+    bool contains(UnitVector3d const & v) const {
+        bool result;
+        contains(&v, 1, &result);
+        return result;
+    }
+
+    void contains(UnitVector3d const * v, size_t n, bool * results) const;
+
+    void contains(double const * x,
+                  double const * y,
+                  double const * z,
+                  size_t n,
+                  bool * results) const;
+    ///@}
+
+private:
+    // The longitude test performed for a box.
+    enum class LonTest {
+        NARROW, // inside both meridian half-spaces (width <= π)
+        WIDE,   // inside either meridian half-space (width > π)
+        FULL    // no longitude test
+    };
+
+    template <typename Vectors>
+    void _contains(Vectors const & v, size_t n, bool * results) const;
+
+    template <LonTest Test, typename Vectors>
+    void _containsBlock(Vectors const & v,
+                        size_t begin,
+                        size_t end,
+                        bool * results,
+                        bool * uncertain) const;
+
+    Box _box;
+    bool _empty;
+    LonTest _lonTest;
+    double _zMin;
+    double _zMax;
+    // A point v is on the inside of the meridian plane at the minimum
+    // longitude if dot(v, (_ax, _ay, 0)) >= 0, and on the inside of the
+    // meridian plane at the maximum longitude if dot(v, (_bx, _by, 0)) >= 0.
+    double _ax;
+    double _ay;
+    double _bx;
+    double _by;
+};
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_PREPAREDBOX_H_
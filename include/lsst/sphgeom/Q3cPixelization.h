@@ -31,6 +31,8 @@
 #include <vector>
 
 #include "ConvexPolygon.h"
+#include "FixedConvexPolygon.h"
+#include "MultiOrderCoverage.h"
 #include "Pixelization.h"
 
 
@@ -46,7 +48,8 @@ namespace sphgeom {
 /// to a non-zero value below 4 can result in very poor region pixelizations
 /// regardless of region size. For instance, if `maxRanges` is 1, a non-empty
 /// circle centered on an axis will be approximated by the indexes for an
-/// entire cube face, even as the circle radius tends to 0.
+/// entire cube face, even as the circle radius tends to 0. Coarsening::OPTIMAL
+/// avoids this, at the cost of a full resolution search.
 class Q3cPixelization : public Pixelization {
 public:
     /// The maximum supported cube-face grid resolution is 2^30 by 2^30.
@@ -66,6 +69,10 @@ public:
     /// If `i` is not a valid Q3C index, a std::invalid_argument is thrown.
     ConvexPolygon quad(uint64_t i) const;
 
+    /// `fixedQuad` returns the quadrilateral corresponding to the Q3C pixel
+    /// with index `i` without allocating memory.
+    FixedConvexPolygon<4> fixedQuad(uint64_t i) const;
+
     /// `neighborhood` returns the indexes of all pixels that share a vertex
     /// with pixel `i` (including `i` itself). A Q3C pixel has 8 - k adjacent
     /// pixels, where k is the number of vertices that are also root pixel
@@ -94,11 +101,71 @@ public:
     /// If i is not a valid Q3C index, a std::invalid_argument is thrown.
     std::string toString(uint64_t i) const override;
 
+    using Pixelization::envelope;
+    using Pixelization::interior;
+
+    ///@{
+    /// These overloads of envelope() and interior() accept regions of a
+    /// known type. They skip the run-time type identification and virtual
+    /// function calls of the generic versions, and return the same results.
+    RangeSet envelope(Box const & r,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL,
+                      TraversalStats * stats = nullptr) const;
+    RangeSet envelope(Circle const & r,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL,
+                      TraversalStats * stats = nullptr) const;
+    RangeSet envelope(ConvexPolygon const & r,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL,
+                      TraversalStats * stats = nullptr) const;
+    RangeSet interior(Box const & r,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL,
+                      TraversalStats * stats = nullptr) const;
+    RangeSet interior(Circle const & r,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL,
+                      TraversalStats * stats = nullptr) const;
+    RangeSet interior(ConvexPolygon const & r,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL,
+                      TraversalStats * stats = nullptr) const;
+    ///@}
+
+    ///@{
+    /// `envelopeCoverage` and `interiorCoverage` return the pixels of
+    /// envelope(r) and interior(r) as multi-order coverages. Pixels found
+    /// to lie inside r at coarser subdivision levels are kept as cells of
+    /// those levels, rather than being expanded into ranges of level
+    /// getLevel() pixels.
+    MultiOrderCoverage envelopeCoverage(Region const & r,
+                                        TraversalStats * stats = nullptr) const;
+    MultiOrderCoverage interiorCoverage(Region const & r,
+                                        TraversalStats * stats = nullptr) const;
+    ///@}
+
 private:
     int _level;
 
-    RangeSet _envelope(Region const & r, size_t maxRanges) const override;
-    RangeSet _interior(Region const & r, size_t maxRanges) const override;
+    RangeSet _envelope(Region const & r,
+                       size_t maxRanges,
+                       Coarsening coarsening,
+                       TraversalStats * stats) const override;
+    RangeSet _interior(Region const & r,
+                       size_t maxRanges,
+                       Coarsening coarsening,
+                       TraversalStats * stats) const override;
+    std::pair<RangeSet, RangeSet> _envelopeAndInterior(
+        Region const & r,
+        size_t maxRanges,
+        Coarsening coarsening,
+        TraversalStats * stats) const override;
+    void _streamEnvelope(Region const & r,
+                         RangeCallback const & callback) const override;
+    void _streamInterior(Region const & r,
+                         RangeCallback const & callback) const override;
 };
 
 }} // namespace lsst::sphgeom
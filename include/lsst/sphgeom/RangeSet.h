@@ -142,7 +142,7 @@ public:
         Iterator operator--(int) { Iterator i(*this); p -= 2; return i; }
 
         Iterator operator+(ptrdiff_t n) const { return Iterator(p + 2 * n); }
-        Iterator operator-(ptrdiff_t n) const { return Iterator(p + 2 * n); }
+        Iterator operator-(ptrdiff_t n) const { return Iterator(p - 2 * n); }
 
         Iterator & operator+=(ptrdiff_t n) { p += 2 * n; return *this; }
         Iterator & operator-=(ptrdiff_t n) { p -= 2 * n; return *this; }
@@ -347,6 +347,55 @@ public:
     /// this set and s.
     RangeSet symmetricDifference(RangeSet const & s) const;
 
+    ///@{
+    /// `unionOf` returns the union of the n given sets.
+    ///
+    /// Rather than folding the sets into an accumulator two at a time, which
+    /// copies the accumulator once per input, the range end points of all
+    /// the sets are merged with a heap. The run time is O(N log n), where N
+    /// is the total number of ranges in the inputs. If `numThreads` is
+    /// greater than 1, the universe is split into that many slices with
+    /// similar numbers of end points, and slices are merged in parallel.
+    static RangeSet unionOf(RangeSet const * sets, size_t n,
+                            unsigned numThreads = 1) {
+        return coveredBy(sets, n, 1, numThreads);
+    }
+
+    static RangeSet unionOf(std::vector<RangeSet> const & sets,
+                            unsigned numThreads = 1) {
+        return unionOf(sets.data(), sets.size(), numThreads);
+    }
+    ///@}
+
+    ///@{
+    /// `intersectionOf` returns the intersection of the n given sets, with
+    /// the same complexity as `unionOf`. The intersection of zero sets is
+    /// the full set.
+    static RangeSet intersectionOf(RangeSet const * sets, size_t n,
+                                   unsigned numThreads = 1) {
+        return coveredBy(sets, n, n, numThreads);
+    }
+
+    static RangeSet intersectionOf(std::vector<RangeSet> const & sets,
+                                   unsigned numThreads = 1) {
+        return intersectionOf(sets.data(), sets.size(), numThreads);
+    }
+    ///@}
+
+    ///@{
+    /// `coveredBy` returns the set of integers contained in at least k
+    /// of the n given sets, with the same complexity as `unionOf`.
+    /// A threshold of 0 gives the full set, and a threshold greater than n
+    /// gives the empty set.
+    static RangeSet coveredBy(RangeSet const * sets, size_t n, size_t k,
+                              unsigned numThreads = 1);
+
+    static RangeSet coveredBy(std::vector<RangeSet> const & sets, size_t k,
+                              unsigned numThreads = 1) {
+        return coveredBy(sets.data(), sets.size(), k, numThreads);
+    }
+    ///@}
+
     /// The ~ operator returns the complement of this set.
     RangeSet operator~() const {
         RangeSet s(*this);
@@ -602,6 +651,10 @@ private:
 
     static bool _intersects(uint64_t const *, uint64_t const *,
                             uint64_t const *, uint64_t const *);
+
+    static void _coveredBy(std::vector<uint64_t> &,
+                           RangeSet const *, size_t, size_t,
+                           uint64_t, uint64_t);
 };
 
 
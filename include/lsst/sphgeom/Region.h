@@ -39,8 +39,10 @@ namespace sphgeom {
 class Box;
 class Box3d;
 class Circle;
+class CompoundRegion;
 class ConvexPolygon;
 class Ellipse;
+class Polygon;
 class UnitVector3d;
 
 /// `Region` is a minimal interface for 2-dimensional regions on the unit
@@ -118,6 +120,8 @@ public:
     virtual Relationship relate(Circle const &) const = 0;
     virtual Relationship relate(ConvexPolygon const &) const = 0;
     virtual Relationship relate(Ellipse const &) const = 0;
+    virtual Relationship relate(Polygon const &) const = 0;
+    virtual Relationship relate(CompoundRegion const &) const = 0;
     ///@}
 
     /// `encode` serializes this region into an opaque byte string. Byte strings
@@ -0,0 +1,365 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_REGIONVALUE_H_
+#define LSST_SPHGEOM_REGIONVALUE_H_
+
+/// \file
+/// \brief This file declares a value type holding any concrete region.
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Box.h"
+#include "Box3d.h"
+#include "Circle.h"
+#include "ConvexPolygon.h"
+#include "Ellipse.h"
+#include "Pixelization.h"
+#include "RangeSet.h"
+#include "Relationship.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+/// `RegionValue` holds a Box, Circle, ConvexPolygon or Ellipse by value.
+///
+/// It is a tagged union over the concrete Region types. Unlike a
+/// `std::unique_ptr<Region>`, a RegionValue requires no heap allocation
+/// (other than for polygon vertices), and its member functions dispatch on
+/// the type tag with a switch, calling the concrete region implementations
+/// directly instead of through virtual functions. In particular, relating
+/// two RegionValue objects costs no virtual calls at all, whereas
+/// `Region::relate` costs two.
+///
+/// RegionValue objects can be decoded directly from the byte strings
+/// produced by Region::encode. Decoding into an existing value with
+/// decodeInPlace() reuses its storage, so that a loop over many encoded
+/// regions need not allocate memory once polygon vertex storage is large
+/// enough.
+///
+/// A RegionValue can be constructed from any Region, and exposes the region
+/// it holds as a `Region const &` for use with APIs that accept one.
+class RegionValue {
+public:
+    /// `Type` identifies the kind of region held by a RegionValue.
+    enum class Type : uint8_t {
+        BOX,
+        CIRCLE,
+        CONVEX_POLYGON,
+        ELLIPSE
+    };
+
+    ///@{
+    /// `decode` deserializes a RegionValue from a byte string produced by
+    /// Region::encode.
+    static RegionValue decode(std::vector<uint8_t> const & s) {
+        return decode(s.data(), s.size());
+    }
+
+    static RegionValue decode(uint8_t const * buffer, size_t n) {
+        RegionValue v;
+        v.decodeInPlace(buffer, n);
+        return v;
+    }
+    ///@}
+
+    /// The default constructor creates a value holding an empty Box.
+    RegionValue() : _type(Type::BOX) { new (&_box) Box(); }
+
+    RegionValue(Box const & b) : _type(Type::BOX) { new (&_box) Box(b); }
+
+    RegionValue(Circle const & c) : _type(Type::CIRCLE) {
+        new (&_circle) Circle(c);
+    }
+
+    RegionValue(ConvexPolygon const & p) : _type(Type::CONVEX_POLYGON) {
+        new (&_polygon) ConvexPolygon(p);
+    }
+
+    RegionValue(ConvexPolygon && p) : _type(Type::CONVEX_POLYGON) {
+        new (&_polygon) ConvexPolygon(std::move(p));
+    }
+
+    RegionValue(Ellipse const & e) : _type(Type::ELLIPSE) {
+        new (&_ellipse) Ellipse(e);
+    }
+
+    /// This constructor copies the given region. If it is not a Box,
+    /// Circle, ConvexPolygon or Ellipse, a std::invalid_argument is thrown.
+    explicit RegionValue(Region const & r);
+
+    RegionValue(RegionValue const & v) : _type(v._type) {
+        v.visit([this](auto const & r) { this->_construct(r); });
+    }
+
+    RegionValue(RegionValue && v) noexcept : _type(v._type) {
+        v.visit([this](auto & r) { this->_construct(std::move(r)); });
+    }
+
+    ~RegionValue() { _destroy(); }
+
+    RegionValue & operator=(RegionValue const & v) {
+        if (this != &v) {
+            if (_type == v._type) {
+                v.visit([this](auto const & r) { this->_get(r) = r; });
+            } else {
+                // Copying a polygon can throw, so copy before destroying
+                // the current value.
+                *this = RegionValue(v);
+            }
+        }
+        return *this;
+    }
+
+    RegionValue & operator=(RegionValue && v) noexcept {
+        if (this != &v) {
+            if (_type == v._type) {
+                v.visit([this](auto & r) { this->_get(r) = std::move(r); });
+            } else {
+                _destroy();
+                _type = v._type;
+                v.visit([this](auto & r) { this->_construct(std::move(r)); });
+            }
+        }
+        return *this;
+    }
+
+    /// `getType` returns the kind of region held by this value.
+    Type getType() const { return _type; }
+
+    ///@{
+    /// `getIf` returns a pointer to the region held by this value if it has
+    /// type T, and nullptr otherwise.
+    template <typename T> T const * getIf() const {
+        return const_cast<RegionValue *>(this)->_getIf(
+            static_cast<T *>(nullptr));
+    }
+
+    template <typename T> T * getIf() {
+        return _getIf(static_cast<T *>(nullptr));
+    }
+    ///@}
+
+    /// `getRegion` returns the region held by this value.
+    Region const & getRegion() const {
+        return visit([](Region const & r) -> Region const & { return r; });
+    }
+
+    /// `clone` returns a heap allocated copy of the region held by this value.
+    std::unique_ptr<Region> clone() const {
+        return getRegion().clone();
+    }
+
+    ///@{
+    /// `visit` calls `f` with a reference to the concrete region held by
+    /// this value, and returns the result. `f` must be callable with a Box,
+    /// Circle, ConvexPolygon and Ellipse, and return the same type for all
+    /// of them; a generic lambda is the usual choice.
+    template <typename F>
+    auto visit(F && f) const -> decltype(f(std::declval<Box const &>())) {
+        switch (_type) {
+            case Type::BOX: return f(_box);
+            case Type::CIRCLE: return f(_circle);
+            case Type::CONVEX_POLYGON: return f(_polygon);
+            default: return f(_ellipse);
+        }
+    }
+
+    template <typename F>
+    auto visit(F && f) -> decltype(f(std::declval<Box &>())) {
+        switch (_type) {
+            case Type::BOX: return f(_box);
+            case Type::CIRCLE: return f(_circle);
+            case Type::CONVEX_POLYGON: return f(_polygon);
+            default: return f(_ellipse);
+        }
+    }
+    ///@}
+
+    Box getBoundingBox() const {
+        return visit([](auto const & r) {
+            using R = typename std::decay<decltype(r)>::type;
+            return r.R::getBoundingBox();
+        });
+    }
+
+    Box3d getBoundingBox3d() const {
+        return visit([](auto const & r) {
+            using R = typename std::decay<decltype(r)>::type;
+            return r.R::getBoundingBox3d();
+        });
+    }
+
+    Circle getBoundingCircle() const {
+        return visit([](auto const & r) {
+            using R = typename std::decay<decltype(r)>::type;
+            return r.R::getBoundingCircle();
+        });
+    }
+
+    /// `contains` tests whether the given unit vector is inside the
+    /// region held by this value.
+    bool contains(UnitVector3d const & v) const {
+        return visit([&v](auto const & r) {
+            using R = typename std::decay<decltype(r)>::type;
+            return r.R::contains(v);
+        });
+    }
+
+    ///@{
+    /// `relate` computes the spatial relationships between the region held
+    /// by this value and another region. See Region::relate for details.
+    Relationship relate(RegionValue const & v) const {
+        return visit([&v](auto const & r) {
+            return v.visit([&r](auto const & s) {
+                using R = typename std::decay<decltype(r)>::type;
+                return r.R::relate(s);
+            });
+        });
+    }
+
+    Relationship relate(Region const & s) const {
+        return visit([&s](auto const & r) {
+            using R = typename std::decay<decltype(r)>::type;
+            return r.R::relate(s);
+        });
+    }
+    ///@}
+
+    ///@{
+    /// `envelope` and `interior` compute the pixels of the given
+    /// pixelization that intersect or lie within the region held by this
+    /// value. For concrete pixelization types with overloads for specific
+    /// region types, these skip the run-time type identification of the
+    /// generic Pixelization functions. See Pixelization::envelope and
+    /// Pixelization::interior for a description of the arguments.
+    template <typename PixelizationType>
+    RangeSet envelope(PixelizationType const & pixelization,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL,
+                      TraversalStats * stats = nullptr) const
+    {
+        return visit([&](auto const & r) {
+            return pixelization.envelope(r, maxRanges, coarsening, stats);
+        });
+    }
+
+    template <typename PixelizationType>
+    RangeSet interior(PixelizationType const & pixelization,
+                      size_t maxRanges = 0,
+                      Coarsening coarsening = Coarsening::LEVEL,
+                      TraversalStats * stats = nullptr) const
+    {
+        return visit([&](auto const & r) {
+            return pixelization.interior(r, maxRanges, coarsening, stats);
+        });
+    }
+    ///@}
+
+    /// `encode` serializes the region held by this value. The result is
+    /// identical to that of Region::encode.
+    std::vector<uint8_t> encode() const {
+        return visit([](auto const & r) {
+            using R = typename std::decay<decltype(r)>::type;
+            return r.R::encode();
+        });
+    }
+
+    /// `decodeInPlace` sets this value from a byte string produced by
+    /// Region::encode. If the byte string encodes a region of the type
+    /// already held by this value, its storage is reused. If the byte
+    /// string is invalid, a std::runtime_error is thrown, and this value
+    /// holds some unspecified region of a valid type.
+    void decodeInPlace(uint8_t const * buffer, size_t n);
+
+    bool operator==(RegionValue const & v) const {
+        if (_type != v._type) {
+            return false;
+        }
+        return visit([&v](auto const & r) {
+            using R = typename std::decay<decltype(r)>::type;
+            return r == *v.getIf<R>();
+        });
+    }
+
+    bool operator!=(RegionValue const & v) const { return !(*this == v); }
+
+private:
+    Box * _getIf(Box *) { return _type == Type::BOX ? &_box : nullptr; }
+
+    Circle * _getIf(Circle *) {
+        return _type == Type::CIRCLE ? &_circle : nullptr;
+    }
+
+    ConvexPolygon * _getIf(ConvexPolygon *) {
+        return _type == Type::CONVEX_POLYGON ? &_polygon : nullptr;
+    }
+
+    Ellipse * _getIf(Ellipse *) {
+        return _type == Type::ELLIPSE ? &_ellipse : nullptr;
+    }
+
+    Box & _get(Box const &) { return _box; }
+    Circle & _get(Circle const &) { return _circle; }
+    ConvexPolygon & _get(ConvexPolygon const &) { return _polygon; }
+    Ellipse & _get(Ellipse const &) { return _ellipse; }
+
+    // `_construct` creates a copy of r in the storage of this value,
+    // which must not hold a region. It does not set `_type`.
+    template <typename R>
+    void _construct(R && r) {
+        using T = typename std::decay<R>::type;
+        new (&_get(r)) T(std::forward<R>(r));
+    }
+
+    // `_emplace` makes this value hold a region of the given type,
+    // replacing the current region with a default constructed one if
+    // its type differs. It must not be used for polygons, since a default
+    // constructed polygon is not a valid region.
+    void _emplace(Type type);
+
+    void _destroy() {
+        switch (_type) {
+            case Type::BOX: _box.~Box(); break;
+            case Type::CIRCLE: _circle.~Circle(); break;
+            case Type::CONVEX_POLYGON: _polygon.~ConvexPolygon(); break;
+            default: _ellipse.~Ellipse(); break;
+        }
+    }
+
+    Type _type;
+    union {
+        Box _box;
+        Circle _circle;
+        ConvexPolygon _polygon;
+        Ellipse _ellipse;
+    };
+};
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_REGIONVALUE_H_
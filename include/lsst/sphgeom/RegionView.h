@@ -0,0 +1,129 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_REGIONVIEW_H_
+#define LSST_SPHGEOM_REGIONVIEW_H_
+
+/// \file
+/// \brief This file declares a read-only view of an encoded region.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Region.h"
+#include "RegionValue.h"
+#include "Relationship.h"
+#include "UnitVector3d.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+/// `RegionView` is a read-only view of a region encoded as a byte string
+/// by Region::encode.
+///
+/// A view does not own or copy the bytes it refers to, which must outlive
+/// it. Spatial predicates never allocate heap memory: views of polygons read
+/// vertices straight from the encoded bytes (small polygons are first
+/// copied to a stack array), and views of other regions decode them into
+/// stack storage.
+///
+/// fromColumn() creates views of all the values in a column of byte
+/// strings stored in the Apache Arrow binary layout: a contiguous data
+/// buffer, plus an array of n + 1 offsets where value i occupies bytes
+/// [offsets[i], offsets[i + 1]) of the buffer.
+class RegionView {
+public:
+    ///@{
+    /// `fromColumn` returns views of the `n` encoded regions in the given
+    /// binary column. Zero length values (e.g. nulls) produce null views.
+    /// If any other value is not a valid encoded region, a
+    /// std::runtime_error is thrown.
+    static std::vector<RegionView> fromColumn(uint8_t const * data,
+                                              int32_t const * offsets,
+                                              size_t n);
+
+    static std::vector<RegionView> fromColumn(uint8_t const * data,
+                                              int64_t const * offsets,
+                                              size_t n);
+    ///@}
+
+    /// The default constructor creates a null view, which refers to no
+    /// region. A null view may only be tested with isNull().
+    RegionView() : _data(nullptr), _size(0) {}
+
+    /// This constructor creates a view of the `n` byte encoded region in
+    /// `buffer`. The type code and length of the encoding are checked, and a
+    /// std::runtime_error is thrown if they are invalid.
+    RegionView(uint8_t const * buffer, size_t n);
+
+    bool isNull() const { return _data == nullptr; }
+
+    /// `getTypeCode` returns the TYPE_CODE of the encoded region type.
+    uint8_t getTypeCode() const { return _data[0]; }
+
+    uint8_t const * data() const { return _data; }
+    size_t size() const { return _size; }
+
+    /// `getNumVertices` returns the number of vertices of an encoded
+    /// ConvexPolygon, and 0 for other region types.
+    size_t getNumVertices() const {
+        return getTypeCode() == ConvexPolygon::TYPE_CODE ?
+            (_size - 1) / 24 : 0;
+    }
+
+    /// `getVertex` returns the i-th vertex of an encoded ConvexPolygon.
+    UnitVector3d getVertex(size_t i) const;
+
+    /// `decode` returns the region viewed by this object.
+    RegionValue decode() const { return RegionValue::decode(_data, _size); }
+
+    Box getBoundingBox() const;
+    Box3d getBoundingBox3d() const;
+    Circle getBoundingCircle() const;
+
+    /// `contains` tests whether the given unit vector is inside the region
+    /// viewed by this object.
+    bool contains(UnitVector3d const & v) const;
+
+    ///@{
+    /// `relate` computes the spatial relationships between the region
+    /// viewed by this object and another region. The results are identical
+    /// to those of Region::relate.
+    Relationship relate(Region const & r) const;
+    Relationship relate(Box const & b) const;
+    Relationship relate(Circle const & c) const;
+    Relationship relate(ConvexPolygon const & p) const;
+    Relationship relate(Ellipse const & e) const;
+    Relationship relate(RegionValue const & r) const;
+    Relationship relate(RegionView const & r) const;
+    ///@}
+
+private:
+    uint8_t const * _data;
+    size_t _size;
+};
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_REGIONVIEW_H_
@@ -0,0 +1,110 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_TRAVERSALSTATS_H_
+#define LSST_SPHGEOM_TRAVERSALSTATS_H_
+
+/// \file
+/// \brief This file declares a struct for pixel search statistics.
+
+#include <cstdint>
+
+
+namespace lsst {
+namespace sphgeom {
+
+/// `TraversalStats` counts the work done by hierarchical pixelizations
+/// when searching for the pixels intersecting or inside a region, and by
+/// Chunker when searching for the chunks intersecting a region.
+///
+/// Each pixel visited during the search is compared to the region in
+/// stages. For boxes and polygons, cheap conservative tests based on
+/// bounding circles, 3-dimensional bounding boxes and polygon edge planes
+/// come first, and the exact (and for polygons, much more expensive)
+/// relationship test is only run for pixels that they cannot decide. The
+/// stage counters record which stage decided each pixel.
+///
+/// Counts accumulate over searches until `reset` is called. Searches only
+/// update the statistics they are given, so a TraversalStats object must not
+/// be shared by concurrent searches. If the library is built with
+/// NO_TRAVERSAL_STATS defined, the instrumentation is compiled out and all
+/// counts remain zero.
+struct TraversalStats {
+    /// `MAX_LEVEL` is the largest level for which visits are counted.
+    static constexpr int MAX_LEVEL = 30;
+
+    /// The number of nodes compared to the region at each level. For
+    /// pixelizations these are pixels, and for a Chunker, they are the
+    /// chunks, all of which are at level 0.
+    uint64_t nodesVisited[MAX_LEVEL + 1] = {};
+
+    /// The number of nodes found to be disjoint from the region.
+    uint64_t disjoint = 0;
+
+    /// The number of nodes found to be within the region.
+    uint64_t within = 0;
+
+    /// The number of nodes that may intersect, but may not be within,
+    /// the region.
+    uint64_t intersects = 0;
+
+    /// The number of pixels found to be disjoint from the region because
+    /// their bounding circles do not intersect.
+    uint64_t capRejected = 0;
+
+    /// The number of pixels found to be disjoint from the region because
+    /// their 3-dimensional bounding boxes do not intersect.
+    uint64_t boxRejected = 0;
+
+    /// The number of pixels found to be disjoint from a polygonal region
+    /// because their bounding circles are outside one of its edge planes.
+    uint64_t edgeRejected = 0;
+
+    /// The number of pixels found to be within a polygonal region because
+    /// their bounding circles are inside all of its edge planes.
+    uint64_t capAccepted = 0;
+
+    /// The number of pixels compared to the region with the exact test.
+    uint64_t exactRelated = 0;
+
+    /// The number of orientation tests that could not be decided with
+    /// floating point arithmetic, and fell back to exact arithmetic.
+    uint64_t exactOrientations = 0;
+
+    /// The number of RangeSet::simplify calls made to keep the number
+    /// of ranges in a result within the requested limit.
+    uint64_t simplifications = 0;
+
+    /// The number of times the subdivision level of a result was reduced
+    /// to keep its number of ranges within the requested limit.
+    uint64_t levelReductions = 0;
+
+    /// The number of times the storage of a RangeSet was reallocated.
+    uint64_t rangeSetReallocations = 0;
+
+    /// `reset` sets all counters to zero.
+    void reset() { *this = TraversalStats(); }
+};
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_TRAVERSALSTATS_H_
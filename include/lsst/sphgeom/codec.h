@@ -74,6 +74,24 @@ inline double decodeDouble(uint8_t const * buffer) {
 #endif
 }
 
+/// `encodeU64` appends an unsigned 64 bit integer in little-endian byte
+/// order to the end of buffer.
+inline void encodeU64(uint64_t item, std::vector<uint8_t> & buffer) {
+    for (int i = 0; i < 8; ++i) {
+        buffer.push_back(static_cast<uint8_t>(item >> (8 * i)));
+    }
+}
+
+/// `decodeU64` extracts an unsigned 64 bit integer from the 8 byte
+/// little-endian byte sequence in buffer.
+inline uint64_t decodeU64(uint8_t const * buffer) {
+    uint64_t u = 0;
+    for (int i = 0; i < 8; ++i) {
+        u |= static_cast<uint64_t>(buffer[i]) << (8 * i);
+    }
+    return u;
+}
+
 }} // namespace lsst::sphgeom
 
 #endif // LSST_SPHGEOM_CODEC_H_
\ No newline at end of file
@@ -0,0 +1,92 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_COORDINATES_H_
+#define LSST_SPHGEOM_COORDINATES_H_
+
+/// \file
+/// \brief This file declares functions for converting arrays of points
+///        between spherical coordinates and unit vectors.
+///
+/// Points are given as separate arrays of longitudes and latitudes in
+/// radians, or of unit vector components. The result for the i-th point
+/// is stored in the i-th element of the output arrays, which must not
+/// overlap the input arrays.
+///
+/// By default, sines, cosines and arc tangents are evaluated with
+/// polynomial approximations, using the vector instruction set returned
+/// by getInstructionSet(). Every version, including the scalar one, is
+/// compiled without contracting multiplies and adds into fused
+/// multiply-adds, so the results do not depend on the instruction set or
+/// on compiler flags such as -march=native. They differ from the exact
+/// values by at most MAX_CONVERSION_ERROR.
+/// Exact mode instead gives results identical to those of the scalar
+/// conversions, noted below for each function.
+
+#include <cstddef>
+
+
+namespace lsst {
+namespace sphgeom {
+
+/// `ConversionMode` selects how batch coordinate conversions evaluate
+/// trigonometric functions.
+enum class ConversionMode {
+    /// Use vectorized polynomial approximations.
+    FAST,
+    /// Use the C++ standard library, one point at a time.
+    EXACT
+};
+
+/// `MAX_CONVERSION_ERROR` bounds the absolute error of fast conversions,
+/// i.e. of unit vector components and of angles in radians. It is about
+/// 0.0004 µas, and more than twice the largest measured error, which is
+/// dominated by the rounding of longitudes close to 2π.
+constexpr double MAX_CONVERSION_ERROR = 2.0e-15;
+
+/// `toUnitVectors` converts longitudes and latitudes to unit vectors,
+/// i.e. `UnitVector3d(Angle(lon[i]), Angle(lat[i]))`. In fast mode,
+/// angles with magnitudes above 1e6 radians, which are rare enough not to
+/// matter for performance, are converted exactly.
+void toUnitVectors(double const * lon,
+                   double const * lat,
+                   size_t n,
+                   double * x,
+                   double * y,
+                   double * z,
+                   ConversionMode mode = ConversionMode::FAST);
+
+/// `toLonLats` converts vectors to longitudes in [0, 2π] and latitudes in
+/// [-π/2, π/2], i.e. the angles of `LonLat(Vector3d(x[i], y[i], z[i]))`.
+/// The vectors need not be normalized. In fast mode, vectors with
+/// non-finite squared norms are converted exactly.
+void toLonLats(double const * x,
+               double const * y,
+               double const * z,
+               size_t n,
+               double * lon,
+               double * lat,
+               ConversionMode mode = ConversionMode::FAST);
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_COORDINATES_H_
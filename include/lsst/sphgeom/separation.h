@@ -0,0 +1,125 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_SEPARATION_H_
+#define LSST_SPHGEOM_SEPARATION_H_
+
+/// \file
+/// \brief This file declares functions for computing the separations
+///        between arrays of points.
+///
+/// Points are given as separate arrays of unit vector components (which
+/// must be normalized), and are compared either to a single center or
+/// pairwise, in which case the i-th point of the first array is compared
+/// to the i-th point of the second. The result for the i-th point is
+/// stored in `results[i]`.
+///
+/// The computations use the vector instruction set returned by
+/// getInstructionSet(), but their results do not depend on it, and are
+/// identical to those of the corresponding scalar code, noted below for
+/// each function, if that code is compiled with -ffp-contract=off. When
+/// targeting CPUs with fused multiply-add instructions (e.g. with
+/// -march=native), compilers otherwise contract multiplies and adds in the
+/// scalar code, which the batch functions never do. Squared chord lengths
+/// then differ from the scalar ones by at most 1.0e-15 relative, angles by
+/// at most 1.0e-15 radians, and isWithinRadius can only disagree for points
+/// that close to the circle boundary.
+///
+/// Squared chord lengths are much cheaper to compute than angles, so
+/// thresholds should be converted with Circle::squaredChordLengthFor when
+/// possible.
+
+#include <cstddef>
+
+#include "Angle.h"
+#include "UnitVector3d.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+///@{
+/// `getSquaredChordLengths` computes the squared chord lengths between
+/// points, i.e. `(v - center).getSquaredNorm()`.
+void getSquaredChordLengths(UnitVector3d const & center,
+                            double const * x,
+                            double const * y,
+                            double const * z,
+                            size_t n,
+                            double * results);
+
+void getSquaredChordLengths(double const * x1,
+                            double const * y1,
+                            double const * z1,
+                            double const * x2,
+                            double const * y2,
+                            double const * z2,
+                            size_t n,
+                            double * results);
+///@}
+
+///@{
+/// `getAngularSeparations` computes the angular separations in radians
+/// between points, i.e. `NormalizedAngle(center, v).asRadians()`. This is
+/// accurate for all separations, but dominated by the cost of `atan2`.
+void getAngularSeparations(UnitVector3d const & center,
+                           double const * x,
+                           double const * y,
+                           double const * z,
+                           size_t n,
+                           double * results);
+
+void getAngularSeparations(double const * x1,
+                           double const * y1,
+                           double const * z1,
+                           double const * x2,
+                           double const * y2,
+                           double const * z2,
+                           size_t n,
+                           double * results);
+///@}
+
+///@{
+/// `isWithinRadius` determines which points are within the given angular
+/// radius of each other, i.e. `Circle(center, radius).contains(v)`.
+void isWithinRadius(UnitVector3d const & center,
+                    Angle radius,
+                    double const * x,
+                    double const * y,
+                    double const * z,
+                    size_t n,
+                    bool * results);
+
+void isWithinRadius(double const * x1,
+                    double const * y1,
+                    double const * z1,
+                    double const * x2,
+                    double const * y2,
+                    double const * z2,
+                    Angle radius,
+                    size_t n,
+                    bool * results);
+///@}
+
+}} // namespace lsst::sphgeom
+
+#endif // LSST_SPHGEOM_SEPARATION_H_
@@ -25,23 +25,31 @@
 
 from .region import *
 from .pixelization import *
+from .adaptiveChunker import *
 from .angle import *
 from .angleInterval import *
 from .box import *
 from .box3d import *
 from .chunker import *
 from .circle import *
+from .compoundRegion import *
 from .convexPolygon import *
 from .curve import *
 from .ellipse import *
+from .envelopeCache import *
 from .htmPixelization import *
 from .interval1d import *
 from .lonLat import *
 from .matrix3d import *
 from .mq3cPixelization import *
+from .multiOrderCoverage import *
 from .normalizedAngle import *
 from .normalizedAngleInterval import *
 from .orientation import *
+from .pixelAggregates import *
+from .pixelTranslator import *
+from .pointIndex import *
+from .polygon import *
 from .q3cPixelization import *
 from .rangeSet import *
 from .relationship import *
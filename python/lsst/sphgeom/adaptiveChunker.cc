@@ -0,0 +1,90 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+#include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
+
+#include <vector>
+
+#include "lsst/sphgeom/AdaptiveChunker.h"
+#include "lsst/sphgeom/Pixelization.h"
+#include "lsst/sphgeom/Region.h"
+#include "lsst/sphgeom/UnitVector3d.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst {
+namespace sphgeom {
+namespace {
+
+py::bytes encode(AdaptiveChunker const &self) {
+    std::vector<uint8_t> bytes = self.encode();
+    return py::bytes(reinterpret_cast<char const *>(bytes.data()),
+                     bytes.size());
+}
+
+AdaptiveChunker decode(py::bytes bytes) {
+    uint8_t const *buffer = reinterpret_cast<uint8_t const *>(
+            PYBIND11_BYTES_AS_STRING(bytes.ptr()));
+    size_t n = static_cast<size_t>(PYBIND11_BYTES_SIZE(bytes.ptr()));
+    return AdaptiveChunker::decode(buffer, n);
+}
+
+PYBIND11_MODULE(adaptiveChunker, mod) {
+    py::module::import("lsst.sphgeom.angle");
+    py::module::import("lsst.sphgeom.pixelization");
+    py::module::import("lsst.sphgeom.rangeSet");
+    py::module::import("lsst.sphgeom.region");
+
+    py::class_<AdaptiveChunker> cls(mod, "AdaptiveChunker");
+
+    cls.def(py::init<Pixelization const &, std::vector<uint64_t> const &,
+                     std::vector<uint64_t> const &, uint64_t>(),
+            "pixelization"_a, "indexes"_a, "counts"_a, "maxRowsPerChunk"_a);
+
+    cls.def("__eq__", &AdaptiveChunker::operator==, py::is_operator());
+    cls.def("__ne__", &AdaptiveChunker::operator!=, py::is_operator());
+
+    cls.def_property_readonly("numChunks", &AdaptiveChunker::getNumChunks);
+    cls.def_property_readonly("pixelization",
+                              &AdaptiveChunker::getPixelization,
+                              py::return_value_policy::reference_internal);
+
+    cls.def("valid", &AdaptiveChunker::valid, "chunkId"_a);
+    cls.def("getRowCount", &AdaptiveChunker::getRowCount, "chunkId"_a);
+    cls.def("getPixels", &AdaptiveChunker::getPixels, "chunkId"_a);
+    cls.def("getAllChunks", &AdaptiveChunker::getAllChunks);
+    cls.def("getChunk", &AdaptiveChunker::getChunk, "v"_a);
+    cls.def("getChunksIntersecting", &AdaptiveChunker::getChunksIntersecting,
+            "region"_a, "maxRanges"_a = 0);
+    cls.def("getChunksNear", &AdaptiveChunker::getChunksNear, "v"_a,
+            "overlap"_a);
+
+    cls.def("encode", &encode);
+    cls.def_static("decode", &decode, "bytes"_a);
+
+    cls.def(py::pickle(&encode, &decode));
+}
+
+}  // <anonymous>
+}  // sphgeom
+}  // lsst
@@ -25,6 +25,8 @@
 #include <memory>
 
 #include "lsst/sphgeom/Chunker.h"
+#include "lsst/sphgeom/Region.h"
+#include "lsst/sphgeom/TraversalStats.h"
 
 namespace py = pybind11;
 using namespace pybind11::literals;
@@ -40,6 +42,10 @@ py::str toString(Chunker const & self) {
 
 
 PYBIND11_MODULE(chunker, mod) {
+    py::module::import("lsst.sphgeom.pixelization");
+    py::module::import("lsst.sphgeom.rangeSet");
+    py::module::import("lsst.sphgeom.region");
+
     py::class_<Chunker, std::shared_ptr<Chunker>> cls(mod, "Chunker");
 
     cls.def(py::init<int32_t, int32_t>(), "numStripes"_a,
@@ -52,8 +58,10 @@ PYBIND11_MODULE(chunker, mod) {
     cls.def_property_readonly("numSubStripesPerStripe",
                               &Chunker::getNumSubStripesPerStripe);
 
-    cls.def("getChunksIntersecting", &Chunker::getChunksIntersecting,
-            "region"_a);
+    cls.def("getChunksIntersecting",
+            (std::vector<int32_t>(Chunker::*)(Region const &, TraversalStats *)
+                     const) &Chunker::getChunksIntersecting,
+            "region"_a, "stats"_a = nullptr);
     cls.def("getSubChunksIntersecting",
             [](Chunker const &self, Region const &region) {
                 py::list results;
@@ -63,6 +71,23 @@ PYBIND11_MODULE(chunker, mod) {
                 return results;
             },
             "region"_a);
+    cls.def("getChunksIntersectingBatch",
+            [](Chunker const &self, std::vector<Region const *> const &regions,
+               unsigned numThreads) {
+                return self.getChunksIntersecting(regions, numThreads);
+            },
+            "regions"_a, "numThreads"_a = 1);
+    cls.def("getSubChunksIntersectingBatch",
+            [](Chunker const &self, std::vector<Region const *> const &regions,
+               unsigned numThreads) {
+                return self.getSubChunksIntersecting(regions, numThreads);
+            },
+            "regions"_a, "numThreads"_a = 1);
+    cls.def_static("getSubChunkKey", &Chunker::getSubChunkKey,
+                   "chunkId"_a, "subChunkId"_a);
+    cls.def_static("getChunkIdFromKey", &Chunker::getChunkIdFromKey, "key"_a);
+    cls.def_static("getSubChunkIdFromKey", &Chunker::getSubChunkIdFromKey,
+                   "key"_a);
     cls.def("getAllChunks", &Chunker::getAllChunks);
     cls.def("getAllSubChunks", &Chunker::getAllSubChunks, "chunkId"_a);
 
@@ -20,6 +20,7 @@
  * see <https://www.lsstcorp.org/LegalNotices/>.
  */
 #include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
 
 #include <memory>
 
@@ -60,6 +61,8 @@ PYBIND11_MODULE(circle, mod) {
                    "openingAngle"_a);
     cls.def_static("openingAngleFor", &Circle::openingAngleFor,
                    "squaredChordLength"_a);
+    cls.def_static("minimalEnclosingCircle", &Circle::minimalEnclosingCircle,
+                   "points"_a);
 
     cls.def(py::init<>());
     cls.def(py::init<UnitVector3d const &>(), "center"_a);
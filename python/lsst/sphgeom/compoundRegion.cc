@@ -0,0 +1,122 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+#include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
+
+#include <memory>
+#include <vector>
+
+#include "lsst/sphgeom/CompoundRegion.h"
+#include "lsst/sphgeom/Region.h"
+
+#include "lsst/sphgeom/python/relationship.h"
+#include "lsst/sphgeom/python/utils.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst {
+namespace sphgeom {
+namespace {
+
+// `cloneOperands` returns deep copies of the given regions, so that
+// compound regions never share operands with Python objects.
+std::vector<std::unique_ptr<Region>> cloneOperands(py::iterable operands) {
+    std::vector<std::unique_ptr<Region>> result;
+    for (py::handle h: operands) {
+        result.push_back(h.cast<Region const &>().clone());
+    }
+    return result;
+}
+
+template <typename RegionType>
+std::unique_ptr<RegionType> decode(py::bytes bytes) {
+    uint8_t const *buffer = reinterpret_cast<uint8_t const *>(
+            PYBIND11_BYTES_AS_STRING(bytes.ptr()));
+    size_t n = static_cast<size_t>(PYBIND11_BYTES_SIZE(bytes.ptr()));
+    return RegionType::decode(buffer, n);
+}
+
+template <typename RegionType, typename Class>
+void defineCommon(Class &cls) {
+    cls.attr("TYPE_CODE") = py::int_(RegionType::TYPE_CODE);
+    // The lambda is necessary for now; returning the unique pointer
+    // directly leads to incorrect results and crashes.
+    cls.def_static("decode",
+                   [](py::bytes bytes) {
+                       return decode<RegionType>(bytes).release();
+                   },
+                   "bytes"_a);
+    cls.def(py::pickle(
+            [](RegionType const &self) { return python::encode(self); },
+            [](py::bytes bytes) {
+                return decode<RegionType>(bytes).release();
+            }));
+}
+
+PYBIND11_MODULE(compoundRegion, mod) {
+    py::module::import("lsst.sphgeom.region");
+
+    py::class_<CompoundRegion, std::unique_ptr<CompoundRegion>, Region> cls(
+            mod, "CompoundRegion");
+    cls.def("getNumOperands", &CompoundRegion::getNumOperands);
+    cls.def("__len__", &CompoundRegion::getNumOperands);
+    cls.def("getOperand",
+            [](CompoundRegion const &self, size_t i) {
+                if (i >= self.getNumOperands()) {
+                    throw py::index_error();
+                }
+                return self.getOperand(i).clone().release();
+            },
+            "i"_a);
+
+    py::class_<UnionRegion, std::unique_ptr<UnionRegion>, CompoundRegion>
+            unionCls(mod, "UnionRegion");
+    unionCls.def(py::init([](py::iterable operands) {
+                     return new UnionRegion(cloneOperands(operands));
+                 }),
+                 "operands"_a);
+    defineCommon<UnionRegion>(unionCls);
+
+    py::class_<IntersectionRegion, std::unique_ptr<IntersectionRegion>,
+               CompoundRegion>
+            intersectionCls(mod, "IntersectionRegion");
+    intersectionCls.def(py::init([](py::iterable operands) {
+                            return new IntersectionRegion(
+                                    cloneOperands(operands));
+                        }),
+                        "operands"_a);
+    defineCommon<IntersectionRegion>(intersectionCls);
+
+    py::class_<DifferenceRegion, std::unique_ptr<DifferenceRegion>,
+               CompoundRegion>
+            differenceCls(mod, "DifferenceRegion");
+    differenceCls.def(py::init([](Region const &a, Region const &b) {
+                          return new DifferenceRegion(a.clone(), b.clone());
+                      }),
+                      "a"_a, "b"_a);
+    defineCommon<DifferenceRegion>(differenceCls);
+}
+
+}  // <anonymous>
+}  // sphgeom
+}  // lsst
@@ -68,6 +68,8 @@ PYBIND11_MODULE(convexPolygon, mod) {
 
     cls.def("getVertices", &ConvexPolygon::getVertices);
     cls.def("getCentroid", &ConvexPolygon::getCentroid);
+    cls.def("getMinimalBoundingCircle",
+            &ConvexPolygon::getMinimalBoundingCircle);
 
     // Note that much of the Region interface has already been wrapped. Here are bits that have not:
     cls.def("contains", py::overload_cast<UnitVector3d const &>(&ConvexPolygon::contains, py::const_));
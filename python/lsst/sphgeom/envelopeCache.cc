@@ -0,0 +1,68 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+#include "pybind11/pybind11.h"
+
+#include <memory>
+#include <string>
+
+#include "lsst/sphgeom/EnvelopeCache.h"
+#include "lsst/sphgeom/Region.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst {
+namespace sphgeom {
+namespace {
+
+PYBIND11_MODULE(envelopeCache, mod) {
+    py::module::import("lsst.sphgeom.pixelization");
+    py::module::import("lsst.sphgeom.rangeSet");
+    py::module::import("lsst.sphgeom.region");
+
+    py::class_<EnvelopeCache, std::shared_ptr<EnvelopeCache>> cls(
+            mod, "EnvelopeCache");
+
+    cls.def(py::init<size_t>(), "maxBytes"_a);
+    cls.def(py::init<size_t, std::string const &>(), "maxBytes"_a, "path"_a);
+
+    cls.def("envelope", &EnvelopeCache::envelope, "pixelization"_a,
+            "region"_a, "maxRanges"_a = 0,
+            "coarsening"_a = Coarsening::LEVEL);
+    cls.def("interior", &EnvelopeCache::interior, "pixelization"_a,
+            "region"_a, "maxRanges"_a = 0,
+            "coarsening"_a = Coarsening::LEVEL);
+
+    cls.def_property_readonly("maxBytes", &EnvelopeCache::getMaxBytes);
+    cls.def_property_readonly("bytes", &EnvelopeCache::getBytes);
+    cls.def_property_readonly("hits", &EnvelopeCache::getHits);
+    cls.def_property_readonly("misses", &EnvelopeCache::getMisses);
+    cls.def_property_readonly("evictions", &EnvelopeCache::getEvictions);
+    cls.def("__len__", &EnvelopeCache::getSize);
+
+    cls.def("resetCounters", &EnvelopeCache::resetCounters);
+    cls.def("clear", &EnvelopeCache::clear);
+    cls.def("compact", &EnvelopeCache::compact);
+}
+
+}  // <anonymous>
+}  // sphgeom
+}  // lsst
@@ -31,6 +31,7 @@ namespace sphgeom {
 namespace {
 
 PYBIND11_MODULE(htmPixelization, mod) {
+    py::module::import("lsst.sphgeom.multiOrderCoverage");
     py::module::import("lsst.sphgeom.pixelization");
     py::module::import("lsst.sphgeom.region");
 
@@ -46,6 +47,10 @@ PYBIND11_MODULE(htmPixelization, mod) {
     cls.def(py::init<HtmPixelization const &>(), "htmPixelization"_a);
 
     cls.def("getLevel", &HtmPixelization::getLevel);
+    cls.def("envelopeCoverage", &HtmPixelization::envelopeCoverage,
+            "region"_a, "stats"_a = nullptr);
+    cls.def("interiorCoverage", &HtmPixelization::interiorCoverage,
+            "region"_a, "stats"_a = nullptr);
 
     cls.def("__eq__",
             [](HtmPixelization const &self, HtmPixelization const &other) {
@@ -31,6 +31,7 @@ namespace sphgeom {
 namespace {
 
 PYBIND11_MODULE(mq3cPixelization, mod) {
+    py::module::import("lsst.sphgeom.multiOrderCoverage");
     py::module::import("lsst.sphgeom.pixelization");
     py::module::import("lsst.sphgeom.region");
 
@@ -47,6 +48,10 @@ PYBIND11_MODULE(mq3cPixelization, mod) {
     cls.def(py::init<Mq3cPixelization const &>(), "mq3cPixelization"_a);
 
     cls.def("getLevel", &Mq3cPixelization::getLevel);
+    cls.def("envelopeCoverage", &Mq3cPixelization::envelopeCoverage,
+            "region"_a, "stats"_a = nullptr);
+    cls.def("interiorCoverage", &Mq3cPixelization::interiorCoverage,
+            "region"_a, "stats"_a = nullptr);
 
     cls.def("__eq__",
             [](Mq3cPixelization const &self, Mq3cPixelization const &other) {
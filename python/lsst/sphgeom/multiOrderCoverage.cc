@@ -0,0 +1,111 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+#include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
+
+#include <vector>
+
+#include "lsst/sphgeom/MultiOrderCoverage.h"
+#include "lsst/sphgeom/RangeSet.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst {
+namespace sphgeom {
+namespace {
+
+py::bytes encode(MultiOrderCoverage const &self) {
+    std::vector<uint8_t> bytes = self.encode();
+    return py::bytes(reinterpret_cast<char const *>(bytes.data()),
+                     bytes.size());
+}
+
+MultiOrderCoverage decode(py::bytes bytes) {
+    uint8_t const *buffer = reinterpret_cast<uint8_t const *>(
+            PYBIND11_BYTES_AS_STRING(bytes.ptr()));
+    size_t n = static_cast<size_t>(PYBIND11_BYTES_SIZE(bytes.ptr()));
+    return MultiOrderCoverage::decode(buffer, n);
+}
+
+PYBIND11_MODULE(multiOrderCoverage, mod) {
+    py::module::import("lsst.sphgeom.rangeSet");
+
+    py::class_<MultiOrderCoverage> cls(mod, "MultiOrderCoverage");
+
+    cls.attr("MAX_LEVEL") = py::int_(MultiOrderCoverage::MAX_LEVEL);
+
+    cls.def_static("fromRangeSet", &MultiOrderCoverage::fromRangeSet, "s"_a,
+                   "level"_a);
+
+    cls.def(py::init<>());
+    cls.def(py::init<int, uint64_t>(), "level"_a, "index"_a);
+    cls.def(py::init<MultiOrderCoverage const &>(), "coverage"_a);
+
+    cls.def("__eq__", &MultiOrderCoverage::operator==, py::is_operator());
+    cls.def("__ne__", &MultiOrderCoverage::operator!=, py::is_operator());
+
+    cls.def("insert", &MultiOrderCoverage::insert, "level"_a, "index"_a);
+    cls.def("empty", &MultiOrderCoverage::empty);
+    cls.def("getMaxLevel", &MultiOrderCoverage::getMaxLevel);
+    cls.def("getCells", &MultiOrderCoverage::getCells);
+    cls.def("getNumCells", &MultiOrderCoverage::getNumCells);
+    cls.def("getRanges", &MultiOrderCoverage::getRanges);
+    cls.def("contains",
+            (bool (MultiOrderCoverage::*)(int, uint64_t) const) &
+                    MultiOrderCoverage::contains,
+            "level"_a, "index"_a);
+    cls.def("contains",
+            (bool (MultiOrderCoverage::*)(MultiOrderCoverage const &) const) &
+                    MultiOrderCoverage::contains,
+            "coverage"_a);
+    cls.def("intersects",
+            (bool (MultiOrderCoverage::*)(int, uint64_t) const) &
+                    MultiOrderCoverage::intersects,
+            "level"_a, "index"_a);
+    cls.def("intersects",
+            (bool (MultiOrderCoverage::*)(MultiOrderCoverage const &) const) &
+                    MultiOrderCoverage::intersects,
+            "coverage"_a);
+    cls.def("toRangeSet", &MultiOrderCoverage::toRangeSet, "level"_a);
+    cls.def("toInteriorRangeSet", &MultiOrderCoverage::toInteriorRangeSet,
+            "level"_a);
+    cls.def("degradedTo", &MultiOrderCoverage::degradedTo, "level"_a);
+
+    cls.def("__and__", &MultiOrderCoverage::operator&, py::is_operator());
+    cls.def("__or__", &MultiOrderCoverage::operator|, py::is_operator());
+    cls.def("__sub__", &MultiOrderCoverage::operator-, py::is_operator());
+    cls.def("__xor__", &MultiOrderCoverage::operator^, py::is_operator());
+    cls.def("__iand__", &MultiOrderCoverage::operator&=);
+    cls.def("__ior__", &MultiOrderCoverage::operator|=);
+    cls.def("__isub__", &MultiOrderCoverage::operator-=);
+    cls.def("__ixor__", &MultiOrderCoverage::operator^=);
+
+    cls.def("encode", &encode);
+    cls.def_static("decode", &decode, "bytes"_a);
+
+    cls.def(py::pickle(&encode, &decode));
+}
+
+}  // <anonymous>
+}  // sphgeom
+}  // lsst
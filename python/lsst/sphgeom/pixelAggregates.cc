@@ -0,0 +1,74 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+#include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
+
+#include <vector>
+
+#include "lsst/sphgeom/PixelAggregates.h"
+#include "lsst/sphgeom/Pixelization.h"
+#include "lsst/sphgeom/UnitVector3d.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst {
+namespace sphgeom {
+namespace {
+
+PYBIND11_MODULE(pixelAggregates, mod) {
+    py::module::import("lsst.sphgeom.pixelization");
+    py::module::import("lsst.sphgeom.unitVector3d");
+
+    py::class_<PixelAggregates> cls(mod, "PixelAggregates");
+
+    cls.def(py::init<Pixelization const &>(), "pixelization"_a);
+    cls.def(py::init<Pixelization const &, std::vector<UnitVector3d> const &,
+                     std::vector<double> const &, unsigned>(),
+            "pixelization"_a, "points"_a,
+            "weights"_a = std::vector<double>(), "numThreads"_a = 1);
+
+    cls.def("__len__", &PixelAggregates::size);
+
+    cls.def_property_readonly("pixelization",
+                              &PixelAggregates::getPixelization,
+                              py::return_value_policy::reference_internal);
+    cls.def_property_readonly("level", &PixelAggregates::getLevel);
+
+    cls.def("empty", &PixelAggregates::empty);
+    cls.def("getTotalCount", &PixelAggregates::getTotalCount);
+    cls.def("getIndexes", &PixelAggregates::getIndexes);
+    cls.def("getCounts", &PixelAggregates::getCounts);
+    cls.def("getSums", &PixelAggregates::getSums);
+    cls.def("getMins", &PixelAggregates::getMins);
+    cls.def("getMaxs", &PixelAggregates::getMaxs);
+    cls.def("getDenseCounts", &PixelAggregates::getDenseCounts);
+    cls.def("getDenseSums", &PixelAggregates::getDenseSums);
+    cls.def("getDenseMins", &PixelAggregates::getDenseMins);
+    cls.def("getDenseMaxs", &PixelAggregates::getDenseMaxs);
+    cls.def("coarsened", &PixelAggregates::coarsened, "level"_a);
+    cls.def("merged", &PixelAggregates::merged, "aggregates"_a);
+}
+
+}  // <anonymous>
+}  // sphgeom
+}  // lsst
@@ -0,0 +1,64 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+#include "pybind11/pybind11.h"
+
+#include "lsst/sphgeom/Chunker.h"
+#include "lsst/sphgeom/Pixelization.h"
+#include "lsst/sphgeom/PixelTranslator.h"
+#include "lsst/sphgeom/RangeSet.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst {
+namespace sphgeom {
+namespace {
+
+PYBIND11_MODULE(pixelTranslator, mod) {
+    py::module::import("lsst.sphgeom.chunker");
+    py::module::import("lsst.sphgeom.pixelization");
+    py::module::import("lsst.sphgeom.rangeSet");
+
+    py::class_<PixelTranslator> cls(mod, "PixelTranslator");
+
+    cls.attr("DEFAULT_MAX_CACHE_LEVEL") =
+            py::int_(PixelTranslator::DEFAULT_MAX_CACHE_LEVEL);
+    cls.attr("MAX_CACHE_LEVEL") = py::int_(PixelTranslator::MAX_CACHE_LEVEL);
+
+    cls.def(py::init<Pixelization const &, Pixelization const &, int>(),
+            "source"_a, "target"_a,
+            "maxCacheLevel"_a = PixelTranslator::DEFAULT_MAX_CACHE_LEVEL);
+    cls.def(py::init<Pixelization const &, Chunker const &, bool, int>(),
+            "source"_a, "target"_a, "subChunks"_a = false,
+            "maxCacheLevel"_a = PixelTranslator::DEFAULT_MAX_CACHE_LEVEL);
+
+    cls.def("envelope", &PixelTranslator::envelope, "pixels"_a,
+            "numThreads"_a = 1);
+    cls.def("interior", &PixelTranslator::interior, "pixels"_a,
+            "numThreads"_a = 1);
+    cls.def("getCacheSize", &PixelTranslator::getCacheSize);
+    cls.def("clearCache", &PixelTranslator::clearCache);
+}
+
+}  // <anonymous>
+}  // sphgeom
+}  // lsst
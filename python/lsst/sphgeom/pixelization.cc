@@ -20,9 +20,12 @@
  * see <https://www.lsstcorp.org/LegalNotices/>.
  */
 #include "pybind11/pybind11.h"
+#include "pybind11/functional.h"
+#include "pybind11/stl.h"
 
 #include "lsst/sphgeom/Pixelization.h"
 #include "lsst/sphgeom/Region.h"
+#include "lsst/sphgeom/TraversalStats.h"
 #include "lsst/sphgeom/UnitVector3d.h"
 
 namespace py = pybind11;
@@ -33,14 +36,51 @@ namespace sphgeom {
 namespace {
 
 PYBIND11_MODULE(pixelization, mod) {
+    py::enum_<Coarsening>(mod, "Coarsening")
+            .value("LEVEL", Coarsening::LEVEL)
+            .value("OPTIMAL", Coarsening::OPTIMAL);
+
+    py::class_<TraversalStats> stats(mod, "TraversalStats");
+
+    stats.def(py::init<>());
+    stats.def_property_readonly("nodesVisited", [](TraversalStats const & self) {
+        return std::vector<uint64_t>(
+            self.nodesVisited,
+            self.nodesVisited + TraversalStats::MAX_LEVEL + 1);
+    });
+    stats.def_readonly("disjoint", &TraversalStats::disjoint);
+    stats.def_readonly("within", &TraversalStats::within);
+    stats.def_readonly("intersects", &TraversalStats::intersects);
+    stats.def_readonly("capRejected", &TraversalStats::capRejected);
+    stats.def_readonly("boxRejected", &TraversalStats::boxRejected);
+    stats.def_readonly("edgeRejected", &TraversalStats::edgeRejected);
+    stats.def_readonly("capAccepted", &TraversalStats::capAccepted);
+    stats.def_readonly("exactRelated", &TraversalStats::exactRelated);
+    stats.def_readonly("exactOrientations",
+                       &TraversalStats::exactOrientations);
+    stats.def_readonly("simplifications", &TraversalStats::simplifications);
+    stats.def_readonly("levelReductions", &TraversalStats::levelReductions);
+    stats.def_readonly("rangeSetReallocations",
+                       &TraversalStats::rangeSetReallocations);
+    stats.def("reset", &TraversalStats::reset);
+
     py::class_<Pixelization> cls(mod, "Pixelization");
 
     cls.def("universe", &Pixelization::universe);
     cls.def("pixel", &Pixelization::pixel, "i"_a);
     cls.def("index", &Pixelization::index, "i"_a);
     cls.def("toString", &Pixelization::toString, "i"_a);
-    cls.def("envelope", &Pixelization::envelope, "region"_a, "maxRanges"_a = 0);
-    cls.def("interior", &Pixelization::interior, "region"_a, "maxRanges"_a = 0);
+    cls.def("envelope", &Pixelization::envelope, "region"_a, "maxRanges"_a = 0,
+            "coarsening"_a = Coarsening::LEVEL, "stats"_a = nullptr);
+    cls.def("interior", &Pixelization::interior, "region"_a, "maxRanges"_a = 0,
+            "coarsening"_a = Coarsening::LEVEL, "stats"_a = nullptr);
+    cls.def("envelopeAndInterior", &Pixelization::envelopeAndInterior,
+            "region"_a, "maxRanges"_a = 0, "coarsening"_a = Coarsening::LEVEL,
+            "stats"_a = nullptr);
+    cls.def("streamEnvelope", &Pixelization::streamEnvelope,
+            "region"_a, "callback"_a);
+    cls.def("streamInterior", &Pixelization::streamInterior,
+            "region"_a, "callback"_a);
 }
 
 }  // <anonymous>
@@ -0,0 +1,83 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+#include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
+
+#include <vector>
+
+#include "lsst/sphgeom/Pixelization.h"
+#include "lsst/sphgeom/PointIndex.h"
+#include "lsst/sphgeom/RangeSet.h"
+#include "lsst/sphgeom/Region.h"
+#include "lsst/sphgeom/UnitVector3d.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst {
+namespace sphgeom {
+namespace {
+
+PYBIND11_MODULE(pointIndex, mod) {
+    py::module::import("lsst.sphgeom.pixelization");
+    py::module::import("lsst.sphgeom.rangeSet");
+    py::module::import("lsst.sphgeom.region");
+    py::module::import("lsst.sphgeom.unitVector3d");
+
+    py::class_<PointIndex> cls(mod, "PointIndex");
+
+    cls.def(py::init<Pixelization const &>(), "pixelization"_a);
+    cls.def(py::init<Pixelization const &, std::vector<UnitVector3d> const &,
+                     unsigned>(),
+            "pixelization"_a, "points"_a, "numThreads"_a = 1);
+
+    cls.def("__len__", &PointIndex::size);
+
+    cls.def_property_readonly("pixelization", &PointIndex::getPixelization,
+                              py::return_value_policy::reference_internal);
+
+    cls.def("empty", &PointIndex::empty);
+    cls.def("getNumPixels", &PointIndex::getNumPixels);
+    cls.def("getIds", [](PointIndex const &self) {
+        return std::vector<uint64_t>(self.getIds(),
+                                     self.getIds() + self.size());
+    });
+    cls.def("getPoints", [](PointIndex const &self) {
+        return std::vector<UnitVector3d>(self.getPoints(),
+                                         self.getPoints() + self.size());
+    });
+    cls.def("getSpans", &PointIndex::getSpans, "pixels"_a);
+    cls.def("find",
+            (std::vector<uint64_t>(PointIndex::*)(RangeSet const &) const) &
+                    PointIndex::find,
+            "pixels"_a);
+    cls.def("find",
+            (std::vector<uint64_t>(PointIndex::*)(Region const &) const) &
+                    PointIndex::find,
+            "region"_a);
+    cls.def("save", &PointIndex::save, "path"_a);
+    cls.def_static("open", &PointIndex::open, "path"_a);
+}
+
+}  // <anonymous>
+}  // sphgeom
+}  // lsst
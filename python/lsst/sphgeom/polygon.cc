@@ -0,0 +1,90 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+#include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
+
+#include <memory>
+
+#include "lsst/sphgeom/Box.h"
+#include "lsst/sphgeom/Box3d.h"
+#include "lsst/sphgeom/Circle.h"
+#include "lsst/sphgeom/ConvexPolygon.h"
+#include "lsst/sphgeom/Polygon.h"
+#include "lsst/sphgeom/Region.h"
+#include "lsst/sphgeom/UnitVector3d.h"
+
+#include "lsst/sphgeom/python/relationship.h"
+#include "lsst/sphgeom/python/utils.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst {
+namespace sphgeom {
+namespace {
+
+std::unique_ptr<Polygon> decode(py::bytes bytes) {
+    uint8_t const *buffer = reinterpret_cast<uint8_t const *>(
+            PYBIND11_BYTES_AS_STRING(bytes.ptr()));
+    size_t n = static_cast<size_t>(PYBIND11_BYTES_SIZE(bytes.ptr()));
+    return Polygon::decode(buffer, n);
+}
+
+PYBIND11_MODULE(polygon, mod) {
+    py::module::import("lsst.sphgeom.region");
+    py::module::import("lsst.sphgeom.convexPolygon");
+
+    py::class_<Polygon, std::unique_ptr<Polygon>, Region> cls(mod, "Polygon");
+
+    cls.attr("TYPE_CODE") = py::int_(Polygon::TYPE_CODE);
+
+    cls.def(py::init<std::vector<UnitVector3d> const &>(), "boundary"_a);
+    cls.def(py::init<std::vector<UnitVector3d> const &,
+                     std::vector<std::vector<UnitVector3d>> const &>(),
+            "boundary"_a, "holes"_a);
+    cls.def(py::init<Polygon const &>(), "polygon"_a);
+
+    cls.def("__eq__", &Polygon::operator==, py::is_operator());
+    cls.def("__ne__", &Polygon::operator!=, py::is_operator());
+
+    cls.def("getBoundary", &Polygon::getBoundary);
+    cls.def("getHoles", &Polygon::getHoles);
+    cls.def("getConvexHull", &Polygon::getConvexHull);
+
+    // The lambda is necessary for now; returning the unique pointer
+    // directly leads to incorrect results and crashes.
+    cls.def_static("decode",
+                   [](py::bytes bytes) { return decode(bytes).release(); },
+                   "bytes"_a);
+
+    cls.def("__repr__", [](Polygon const &self) {
+        return py::str("Polygon({!r}, {!r})").format(self.getBoundary(),
+                                                     self.getHoles());
+    });
+    cls.def(py::pickle(
+            [](const Polygon &self) { return python::encode(self); },
+            [](py::bytes bytes) { return decode(bytes).release(); }));
+}
+
+}  // <anonymous>
+}  // sphgeom
+}  // lsst
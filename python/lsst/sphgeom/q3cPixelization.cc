@@ -31,6 +31,7 @@ namespace sphgeom {
 namespace {
 
 PYBIND11_MODULE(q3cPixelization, mod) {
+    py::module::import("lsst.sphgeom.multiOrderCoverage");
     py::module::import("lsst.sphgeom.pixelization");
     py::module::import("lsst.sphgeom.region");
 
@@ -42,6 +43,10 @@ PYBIND11_MODULE(q3cPixelization, mod) {
     cls.def(py::init<Q3cPixelization const &>(), "q3cPixelization"_a);
 
     cls.def("getLevel", &Q3cPixelization::getLevel);
+    cls.def("envelopeCoverage", &Q3cPixelization::envelopeCoverage,
+            "region"_a, "stats"_a = nullptr);
+    cls.def("interiorCoverage", &Q3cPixelization::interiorCoverage,
+            "region"_a, "stats"_a = nullptr);
     cls.def("quad", &Q3cPixelization::quad);
     cls.def("neighborhood", &Q3cPixelization::neighborhood);
 
@@ -20,6 +20,7 @@
  * see <https://www.lsstcorp.org/LegalNotices/>.
  */
 #include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
 
 #include <stdexcept>
 
@@ -115,6 +116,19 @@ PYBIND11_MODULE(rangeSet, mod) {
     cls.def("difference", &RangeSet::difference, "rangeSet"_a);
     cls.def("symmetricDifference", &RangeSet::symmetricDifference,
             "rangeSet"_a);
+    cls.def_static("unionOf",
+                   (RangeSet(*)(std::vector<RangeSet> const &, unsigned)) &
+                           RangeSet::unionOf,
+                   "rangeSets"_a, "numThreads"_a = 1);
+    cls.def_static("intersectionOf",
+                   (RangeSet(*)(std::vector<RangeSet> const &, unsigned)) &
+                           RangeSet::intersectionOf,
+                   "rangeSets"_a, "numThreads"_a = 1);
+    cls.def_static("coveredBy",
+                   (RangeSet(*)(std::vector<RangeSet> const &, size_t,
+                                unsigned)) &
+                           RangeSet::coveredBy,
+                   "rangeSets"_a, "k"_a, "numThreads"_a = 1);
     cls.def("__invert__", &RangeSet::operator~, py::is_operator());
     cls.def("__and__", &RangeSet::operator&, py::is_operator());
     cls.def("__or__", &RangeSet::operator|, py::is_operator());
@@ -0,0 +1,225 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains the AdaptiveChunker class implementation.
+
+#include "lsst/sphgeom/AdaptiveChunker.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "lsst/sphgeom/Circle.h"
+#include "lsst/sphgeom/codec.h"
+
+#include "PixelizationType.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+namespace {
+
+char const * const NOT_ENCODED =
+    "Byte-string is not an encoded AdaptiveChunker";
+
+constexpr uint8_t TYPE_CODE = 'A';
+
+} // unnamed namespace
+
+
+AdaptiveChunker::AdaptiveChunker(Pixelization const & pixelization,
+                                 std::vector<uint64_t> const & indexes,
+                                 std::vector<uint64_t> const & counts,
+                                 uint64_t maxRowsPerChunk)
+{
+    _type = detail::getPixelizationType(pixelization, _level,
+                                        "AdaptiveChunker");
+    if (indexes.size() != counts.size()) {
+        throw std::invalid_argument(
+            "Histogram index and count arrays must have the same size");
+    }
+    if (maxRowsPerChunk == 0) {
+        throw std::invalid_argument(
+            "The maximum number of rows per chunk must be positive");
+    }
+    _pixelization = detail::makePixelization(_type, _level);
+    uint64_t first = std::get<0>(*_pixelization->universe().begin());
+    uint64_t last = std::get<1>(*_pixelization->universe().begin());
+    std::vector<std::pair<uint64_t, uint64_t>> histogram;
+    histogram.reserve(indexes.size());
+    for (size_t i = 0; i < indexes.size(); ++i) {
+        if (indexes[i] < first || indexes[i] >= last) {
+            throw std::invalid_argument("Invalid pixel index in histogram");
+        }
+        if (counts[i] != 0) {
+            histogram.emplace_back(indexes[i], counts[i]);
+        }
+    }
+    std::sort(histogram.begin(), histogram.end());
+    // Walk the histogram in index order, starting a new chunk whenever the
+    // next pixel would overflow the current one. Empty pixels belong to the
+    // chunk preceding them.
+    _begin.push_back(first);
+    _rowCounts.push_back(0);
+    for (size_t i = 0; i < histogram.size(); ) {
+        uint64_t index = histogram[i].first;
+        uint64_t count = 0;
+        for (; i < histogram.size() && histogram[i].first == index; ++i) {
+            count += histogram[i].second;
+        }
+        if (_rowCounts.back() != 0 &&
+            count > maxRowsPerChunk - std::min(maxRowsPerChunk,
+                                               _rowCounts.back())) {
+            _begin.push_back(index);
+            _rowCounts.push_back(0);
+        }
+        _rowCounts.back() += count;
+    }
+    _begin.push_back(last);
+    if (_rowCounts.size() >
+        static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        throw std::invalid_argument("Too many chunks");
+    }
+}
+
+bool AdaptiveChunker::operator==(AdaptiveChunker const & c) const {
+    return _type == c._type && _level == c._level &&
+           _begin == c._begin && _rowCounts == c._rowCounts;
+}
+
+uint64_t AdaptiveChunker::getRowCount(int32_t chunkId) const {
+    if (!valid(chunkId)) {
+        throw std::invalid_argument("Invalid chunk ID");
+    }
+    return _rowCounts[chunkId];
+}
+
+RangeSet AdaptiveChunker::getPixels(int32_t chunkId) const {
+    if (!valid(chunkId)) {
+        throw std::invalid_argument("Invalid chunk ID");
+    }
+    return RangeSet(_begin[chunkId], _begin[chunkId + 1]);
+}
+
+std::vector<int32_t> AdaptiveChunker::getAllChunks() const {
+    std::vector<int32_t> chunkIds;
+    chunkIds.reserve(_rowCounts.size());
+    for (int32_t c = 0; c < getNumChunks(); ++c) {
+        chunkIds.push_back(c);
+    }
+    return chunkIds;
+}
+
+int32_t AdaptiveChunker::getChunk(UnitVector3d const & v) const {
+    return static_cast<int32_t>(_chunkOf(_pixelization->index(v)));
+}
+
+std::vector<int32_t> AdaptiveChunker::getChunksIntersecting(
+    Region const & r,
+    size_t maxRanges) const
+{
+    return _chunksOf(_pixelization->envelope(r, maxRanges));
+}
+
+std::vector<int32_t> AdaptiveChunker::getChunksNear(UnitVector3d const & v,
+                                                    Angle overlap) const
+{
+    return _chunksOf(_pixelization->envelope(Circle(v, overlap)));
+}
+
+std::vector<uint8_t> AdaptiveChunker::encode() const {
+    std::vector<uint8_t> buffer;
+    buffer.reserve(3 + 8 + 16 * _rowCounts.size() + 8);
+    buffer.push_back(TYPE_CODE);
+    buffer.push_back(_type);
+    buffer.push_back(static_cast<uint8_t>(_level));
+    encodeU64(_rowCounts.size(), buffer);
+    for (size_t i = 0; i < _rowCounts.size(); ++i) {
+        encodeU64(_begin[i], buffer);
+        encodeU64(_rowCounts[i], buffer);
+    }
+    return buffer;
+}
+
+AdaptiveChunker AdaptiveChunker::decode(uint8_t const * buffer, size_t n) {
+    if (buffer == nullptr || n < 11 || buffer[0] != TYPE_CODE) {
+        throw std::runtime_error(NOT_ENCODED);
+    }
+    AdaptiveChunker c;
+    c._type = buffer[1];
+    c._level = buffer[2];
+    try {
+        c._pixelization = detail::makePixelization(c._type, c._level);
+    } catch (std::invalid_argument const &) {
+        throw std::runtime_error(NOT_ENCODED);
+    }
+    uint64_t numChunks = decodeU64(buffer + 3);
+    if (numChunks == 0 ||
+        numChunks > static_cast<uint64_t>(std::numeric_limits<int32_t>::max()) ||
+        (n - 11) / 16 != numChunks || (n - 11) % 16 != 0) {
+        throw std::runtime_error(NOT_ENCODED);
+    }
+    uint64_t first = std::get<0>(*c._pixelization->universe().begin());
+    uint64_t last = std::get<1>(*c._pixelization->universe().begin());
+    buffer += 11;
+    for (uint64_t i = 0; i < numChunks; ++i, buffer += 16) {
+        uint64_t begin = decodeU64(buffer);
+        if ((i == 0 && begin != first) ||
+            (i != 0 && (begin <= c._begin.back() || begin >= last))) {
+            throw std::runtime_error(NOT_ENCODED);
+        }
+        c._begin.push_back(begin);
+        c._rowCounts.push_back(decodeU64(buffer + 8));
+    }
+    c._begin.push_back(last);
+    return c;
+}
+
+size_t AdaptiveChunker::_chunkOf(uint64_t index) const {
+    // Find the last chunk beginning at or before index.
+    auto i = std::upper_bound(_begin.begin(), _begin.end() - 1, index);
+    return static_cast<size_t>(i - _begin.begin()) - 1;
+}
+
+std::vector<int32_t> AdaptiveChunker::_chunksOf(RangeSet const & pixels) const {
+    std::vector<int32_t> chunkIds;
+    for (auto const & range: pixels) {
+        uint64_t first = std::get<0>(range);
+        uint64_t last = std::get<1>(range);
+        // The ranges of an envelope are sorted, but the chunks of two ranges
+        // may coincide.
+        size_t c = _chunkOf(first);
+        if (!chunkIds.empty() && static_cast<size_t>(chunkIds.back()) == c) {
+            ++c;
+        }
+        for (; c < _rowCounts.size() && (last == 0 || _begin[c] < last); ++c) {
+            chunkIds.push_back(static_cast<int32_t>(c));
+        }
+    }
+    return chunkIds;
+}
+
+}} // namespace lsst::sphgeom
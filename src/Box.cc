@@ -31,7 +31,9 @@
 
 #include "lsst/sphgeom/Box3d.h"
 #include "lsst/sphgeom/Circle.h"
+#include "lsst/sphgeom/CompoundRegion.h"
 #include "lsst/sphgeom/ConvexPolygon.h"
+#include "lsst/sphgeom/Polygon.h"
 #include "lsst/sphgeom/Ellipse.h"
 #include "lsst/sphgeom/codec.h"
 #include "lsst/sphgeom/utils.h"
@@ -444,6 +446,16 @@ Relationship Box::relate(Ellipse const & e) const {
     return invert(e.relate(*this));
 }
 
+Relationship Box::relate(Polygon const & p) const {
+    // Polygon-Box relations are implemented by Polygon.
+    return invert(p.relate(*this));
+}
+
+Relationship Box::relate(CompoundRegion const & c) const {
+    // CompoundRegion-Box relations are implemented by CompoundRegion.
+    return invert(c.relate(*this));
+}
+
 std::vector<uint8_t> Box::encode() const {
     std::vector<uint8_t> buffer;
     uint8_t tc = TYPE_CODE;
@@ -457,19 +469,23 @@ std::vector<uint8_t> Box::encode() const {
 }
 
 std::unique_ptr<Box> Box::decode(uint8_t const * buffer, size_t n) {
+    std::unique_ptr<Box> box(new Box);
+    box->_decode(buffer, n);
+    return box;
+}
+
+void Box::_decode(uint8_t const * buffer, size_t n) {
     if (buffer == nullptr || n != ENCODED_SIZE || *buffer != TYPE_CODE) {
         throw std::runtime_error("Byte-string is not an encoded Box");
     }
-    std::unique_ptr<Box> box(new Box);
     ++buffer;
     double a = decodeDouble(buffer); buffer += 8;
     double b = decodeDouble(buffer); buffer += 8;
-    box->_lon = NormalizedAngleInterval::fromRadians(a, b);
+    _lon = NormalizedAngleInterval::fromRadians(a, b);
     a = decodeDouble(buffer); buffer += 8;
     b = decodeDouble(buffer); buffer += 8;
-    box->_lat = AngleInterval::fromRadians(a, b);
-    box->_enforceInvariants();
-    return box;
+    _lat = AngleInterval::fromRadians(a, b);
+    _enforceInvariants();
 }
 
 std::ostream & operator<<(std::ostream & os, Box const & b) {
@@ -25,6 +25,9 @@
 
 #include "lsst/sphgeom/Chunker.h"
 
+#include "ForEachSlice.h"
+#include "TraversalStatsImpl.h"
+
 namespace lsst {
 namespace sphgeom {
 
@@ -51,6 +54,43 @@ int32_t computeNumSegments(AngleInterval const & latitudes, Angle width) {
 
 constexpr double BOX_EPSILON = 5.0e-12; // ~1 micro-arcsecond
 
+// `getDilation` returns the longitude dilation that Box::dilateBy applies
+// when dilating a box with the given latitudes by BOX_EPSILON.
+Angle getDilation(AngleInterval const & lat) {
+    AngleInterval l = lat.clippedTo(Box::allLatitudes());
+    Angle maxAbsLat = std::max(abs(l.getA()), abs(l.getB()));
+    return Box::halfWidthForCircle(Angle(BOX_EPSILON), maxAbsLat);
+}
+
+// `RunAccumulator` inserts integers into a RangeSet, coalescing runs of
+// consecutive integers so that each run is inserted at once.
+class RunAccumulator {
+public:
+    explicit RunAccumulator(RangeSet & s) : _set(s), _first(0), _last(0) {}
+
+    void add(uint64_t u) {
+        if (u == _last && _first != _last) {
+            ++_last;
+        } else {
+            flush();
+            _first = u;
+            _last = u + 1;
+        }
+    }
+
+    void flush() {
+        if (_first != _last) {
+            _set.insert(_first, _last);
+            _first = _last;
+        }
+    }
+
+private:
+    RangeSet & _set;
+    uint64_t _first;
+    uint64_t _last;
+};
+
 } // unnamed namespace
 
 
@@ -94,16 +134,17 @@ Chunker::Chunker(int32_t numStripes,
                 _maxSubChunksPerSubStripeChunk = nsc;
             }
             subStripe.subChunkWidth = Angle(2.0 * PI) / (nsc * nc);
+            subStripe.subChunkDilation = getDilation(_getSubStripeLatitudes(ss));
             _subStripes.push_back(subStripe);
         }
+        stripe.chunkDilation = getDilation(_getStripeLatitudes(s));
         _stripes.push_back(stripe);
     }
 }
 
-std::vector<int32_t> Chunker::getChunksIntersecting(Region const & r) const {
-    std::vector<int32_t> chunkIds;
-    // Find the stripes that intersect the bounding box of r.
-    Box b = r.getBoundingBox().dilatedBy(Angle(BOX_EPSILON));
+template <typename F>
+void Chunker::_forEachChunk(Box const & b, F f) const {
+    // Find the stripes that intersect b.
     double ya = std::floor((b.getLat().getA() + Angle(0.5 * PI)) / _subStripeHeight);
     double yb = std::floor((b.getLat().getB() + Angle(0.5 * PI)) / _subStripeHeight);
     int32_t minSS = std::min(static_cast<int32_t>(ya), _numSubStripes - 1);
@@ -111,7 +152,7 @@ std::vector<int32_t> Chunker::getChunksIntersecting(Region const & r) const {
     int32_t minS = minSS / _numSubStripesPerStripe;
     int32_t maxS = maxSS / _numSubStripesPerStripe;
     for (int32_t s = minS; s <= maxS; ++s) {
-        // Find the chunks of s that intersect the bounding box of r.
+        // Find the chunks of s that intersect b.
         Angle chunkWidth = _stripes[s].chunkWidth;
         int32_t nc = _stripes[s].numChunksPerStripe;
         double xa = std::floor(b.getLon().getA() / chunkWidth);
@@ -122,137 +163,174 @@ std::vector<int32_t> Chunker::getChunksIntersecting(Region const & r) const {
             ca = 0;
             cb = nc - 1;
         }
-        // Examine each chunk overlapping the bounding box of r.
         if (ca <= cb) {
             for (int32_t c = ca; c <= cb; ++c) {
-                if ((r.relate(_getChunkBoundingBox(s, c)) & DISJOINT) == 0) {
-                    chunkIds.push_back(_getChunkId(s, c));
-                }
+                f(s, c, minSS, maxSS);
             }
         } else {
             for (int32_t c = 0; c <= cb; ++c) {
-                if ((r.relate(_getChunkBoundingBox(s, c)) & DISJOINT) == 0) {
-                    chunkIds.push_back(_getChunkId(s, c));
-                }
+                f(s, c, minSS, maxSS);
             }
             for (int32_t c = ca; c < nc; ++c) {
-                if ((r.relate(_getChunkBoundingBox(s, c)) & DISJOINT) == 0) {
-                    chunkIds.push_back(_getChunkId(s, c));
-                }
+                f(s, c, minSS, maxSS);
             }
         }
     }
-    return chunkIds;
 }
 
-std::vector<SubChunks> Chunker::getSubChunksIntersecting(
-    Region const & r) const
+template <typename F>
+void Chunker::_forEachSubChunk(Region const & r,
+                               NormalizedAngleInterval const & lon,
+                               int32_t stripe,
+                               int32_t chunk,
+                               int32_t minSS,
+                               int32_t maxSS,
+                               F f) const
 {
-    std::vector<SubChunks> chunks;
-    // Find the stripes that intersect the bounding box of r.
-    Box b = r.getBoundingBox().dilatedBy(Angle(BOX_EPSILON));
-    double ya = std::floor((b.getLat().getA() + Angle(0.5 * PI)) / _subStripeHeight);
-    double yb = std::floor((b.getLat().getB() + Angle(0.5 * PI)) / _subStripeHeight);
-    int32_t minSS = std::min(static_cast<int32_t>(ya), _numSubStripes - 1);
-    int32_t maxSS = std::min(static_cast<int32_t>(yb), _numSubStripes - 1);
-    int32_t minS = minSS / _numSubStripesPerStripe;
-    int32_t maxS = maxSS / _numSubStripesPerStripe;
-    for (int32_t s = minS; s <= maxS; ++s) {
-        // Find the chunks of s that intersect the bounding box of r.
-        Angle chunkWidth = _stripes[s].chunkWidth;
-        int32_t nc = _stripes[s].numChunksPerStripe;
-        double xa = std::floor(b.getLon().getA() / chunkWidth);
-        double xb = std::floor(b.getLon().getB() / chunkWidth);
-        int32_t ca = std::min(static_cast<int32_t>(xa), nc - 1);
-        int32_t cb = std::min(static_cast<int32_t>(xb), nc - 1);
-        if (ca == cb && b.getLon().wraps()) {
-            ca = 0;
-            cb = nc - 1;
+    if ((r.relate(_getChunkBoundingBox(stripe, chunk)) & CONTAINS) != 0) {
+        // r contains the entire chunk, so there is no need to test sub-chunks
+        // for intersection with r.
+        int32_t const ssBeg = stripe * _numSubStripesPerStripe;
+        int32_t const ssEnd = ssBeg + _numSubStripesPerStripe;
+        for (int32_t ss = ssBeg; ss < ssEnd; ++ss) {
+            int32_t const scEnd = _subStripes[ss].numSubChunksPerChunk;
+            int32_t const subChunkIdBase =
+                _maxSubChunksPerSubStripeChunk * (ss - ssBeg);
+            for (int32_t sc = 0; sc < scEnd; ++sc) {
+                f(subChunkIdBase + sc);
+            }
         }
-        // Examine sub-chunks for each chunk overlapping the bounding box of r.
-        if (ca <= cb) {
-            for (int32_t c = ca; c <= cb; ++c) {
-                _getSubChunks(chunks, r, b.getLon(), s, c, minSS, maxSS);
+        return;
+    }
+    // Find the sub-stripes to iterate over.
+    minSS = std::max(minSS, stripe * _numSubStripesPerStripe);
+    maxSS = std::min(maxSS, (stripe + 1) * _numSubStripesPerStripe - 1);
+    int32_t const nc = _stripes[stripe].numChunksPerStripe;
+    for (int32_t ss = minSS; ss <= maxSS; ++ss) {
+        // Find the sub-chunks of ss to iterate over.
+        Angle subChunkWidth = _subStripes[ss].subChunkWidth;
+        int32_t const nsc = _subStripes[ss].numSubChunksPerChunk;
+        double xa = std::floor(lon.getA() / subChunkWidth);
+        double xb = std::floor(lon.getB() / subChunkWidth);
+        int32_t sca = std::min(static_cast<int32_t>(xa), nc * nsc - 1);
+        int32_t scb = std::min(static_cast<int32_t>(xb), nc * nsc - 1);
+        if (sca == scb && lon.wraps()) {
+            sca = 0;
+            scb = nc * nsc - 1;
+        }
+        int32_t minSC = chunk * nsc;
+        int32_t maxSC = (chunk + 1) * nsc - 1;
+        // Test each sub-chunk against r, and report those that intersect.
+        auto examine = [&](int32_t sc) {
+            if ((r.relate(_getSubChunkBoundingBox(ss, sc)) & DISJOINT) == 0) {
+                f(_getSubChunkId(stripe, ss, chunk, sc));
+            }
+        };
+        if (sca <= scb) {
+            minSC = std::max(sca, minSC);
+            maxSC = std::min(scb, maxSC);
+            for (int32_t sc = minSC; sc <= maxSC; ++sc) {
+                examine(sc);
             }
         } else {
-            for (int32_t c = 0; c <= cb; ++c) {
-                _getSubChunks(chunks, r, b.getLon(), s, c, minSS, maxSS);
+            sca = std::max(sca, minSC);
+            scb = std::min(scb, maxSC);
+            for (int32_t sc = sca; sc <= maxSC; ++sc) {
+                examine(sc);
             }
-            for (int32_t c = ca; c < nc; ++c) {
-                _getSubChunks(chunks, r, b.getLon(), s, c, minSS, maxSS);
+            for (int32_t sc = minSC; sc <= scb; ++sc) {
+                examine(sc);
             }
         }
     }
+}
+
+std::vector<int32_t> Chunker::getChunksIntersecting(
+    Region const & r,
+    TraversalStats * stats) const
+{
+    detail::ThreadCountersScope scope(stats);
+    std::vector<int32_t> chunkIds;
+    Box b = r.getBoundingBox().dilatedBy(Angle(BOX_EPSILON));
+    // Examine each chunk overlapping the bounding box of r.
+    _forEachChunk(b, [&](int32_t s, int32_t c, int32_t, int32_t) {
+        Relationship rel = r.relate(_getChunkBoundingBox(s, c));
+        detail::countVisit(stats, 0, invert(rel));
+        if ((rel & DISJOINT) == 0) {
+            chunkIds.push_back(_getChunkId(s, c));
+        }
+    });
+    return chunkIds;
+}
+
+std::vector<SubChunks> Chunker::getSubChunksIntersecting(
+    Region const & r) const
+{
+    std::vector<SubChunks> chunks;
+    Box b = r.getBoundingBox().dilatedBy(Angle(BOX_EPSILON));
+    // Examine sub-chunks for each chunk overlapping the bounding box of r.
+    _forEachChunk(b, [&](int32_t s, int32_t c, int32_t minSS, int32_t maxSS) {
+        SubChunks subChunks;
+        subChunks.chunkId = _getChunkId(s, c);
+        _forEachSubChunk(r, b.getLon(), s, c, minSS, maxSS,
+                         [&](int32_t subChunkId) {
+            subChunks.subChunkIds.push_back(subChunkId);
+        });
+        // If any sub-chunks of this chunk intersect r,
+        // append them to the result vector.
+        if (!subChunks.subChunkIds.empty()) {
+            chunks.push_back(SubChunks());
+            chunks.back().swap(subChunks);
+        }
+    });
     return chunks;
 }
 
-void Chunker::_getSubChunks(std::vector<SubChunks> & chunks,
-                            Region const & r,
-                            NormalizedAngleInterval const & lon,
-                            int32_t stripe,
-                            int32_t chunk,
-                            int32_t minSS,
-                            int32_t maxSS) const
+std::vector<RangeSet> Chunker::getChunksIntersecting(
+    Region const * const * regions,
+    size_t n,
+    unsigned numThreads) const
 {
-    SubChunks subChunks;
-    subChunks.chunkId = _getChunkId(stripe, chunk);
-    if ((r.relate(_getChunkBoundingBox(stripe, chunk)) & CONTAINS) != 0) {
-        // r contains the entire chunk, so there is no need to test sub-chunks
-        // for intersection with r.
-        subChunks.subChunkIds = getAllSubChunks(subChunks.chunkId);
-    } else {
-        // Find the sub-stripes to iterate over.
-        minSS = std::max(minSS, stripe * _numSubStripesPerStripe);
-        maxSS = std::min(maxSS, (stripe + 1) * _numSubStripesPerStripe - 1);
-        int32_t const nc = _stripes[stripe].numChunksPerStripe;
-        for (int32_t ss = minSS; ss <= maxSS; ++ss) {
-            // Find the sub-chunks of ss to iterate over.
-            Angle subChunkWidth = _subStripes[ss].subChunkWidth;
-            int32_t const nsc = _subStripes[ss].numSubChunksPerChunk;
-            double xa = std::floor(lon.getA() / subChunkWidth);
-            double xb = std::floor(lon.getB() / subChunkWidth);
-            int32_t sca = std::min(static_cast<int32_t>(xa), nc * nsc - 1);
-            int32_t scb = std::min(static_cast<int32_t>(xb), nc * nsc - 1);
-            if (sca == scb && lon.wraps()) {
-                sca = 0;
-                scb = nc * nsc - 1;
-            }
-            int32_t minSC = chunk * nsc;
-            int32_t maxSC = (chunk + 1) * nsc - 1;
-            // Test each sub-chunk against r, and record those that intersect.
-            if (sca <= scb) {
-                minSC = std::max(sca, minSC);
-                maxSC = std::min(scb, maxSC);
-                for (int32_t sc = minSC; sc <= maxSC; ++sc) {
-                    if ((r.relate(_getSubChunkBoundingBox(ss, sc)) & DISJOINT) == 0) {
-                        subChunks.subChunkIds.push_back(
-                            _getSubChunkId(stripe, ss, chunk, sc));
-                    }
-                }
-            } else {
-                sca = std::max(sca, minSC);
-                scb = std::min(scb, maxSC);
-                for (int32_t sc = sca; sc <= maxSC; ++sc) {
-                    if ((r.relate(_getSubChunkBoundingBox(ss, sc)) & DISJOINT) == 0) {
-                        subChunks.subChunkIds.push_back(
-                            _getSubChunkId(stripe, ss, chunk, sc));
-                    }
-                }
-                for (int32_t sc = minSC; sc <= scb; ++sc) {
-                    if ((r.relate(_getSubChunkBoundingBox(ss, sc)) & DISJOINT) == 0) {
-                        subChunks.subChunkIds.push_back(
-                            _getSubChunkId(stripe, ss, chunk, sc));
-                    }
+    std::vector<RangeSet> results(n);
+    detail::forEachSlice(n, numThreads, [&](unsigned, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Region const & r = *regions[i];
+            RunAccumulator chunkIds(results[i]);
+            Box b = r.getBoundingBox().dilatedBy(Angle(BOX_EPSILON));
+            _forEachChunk(b, [&](int32_t s, int32_t c, int32_t, int32_t) {
+                if ((r.relate(_getChunkBoundingBox(s, c)) & DISJOINT) == 0) {
+                    chunkIds.add(static_cast<uint64_t>(_getChunkId(s, c)));
                 }
-            }
+            });
+            chunkIds.flush();
         }
-    }
-    // If any sub-chunks of this chunk intersect r,
-    // append them to the result vector.
-    if (!subChunks.subChunkIds.empty()) {
-        chunks.push_back(SubChunks());
-        chunks.back().swap(subChunks);
-    }
+    });
+    return results;
+}
+
+std::vector<RangeSet> Chunker::getSubChunksIntersecting(
+    Region const * const * regions,
+    size_t n,
+    unsigned numThreads) const
+{
+    std::vector<RangeSet> results(n);
+    detail::forEachSlice(n, numThreads, [&](unsigned, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Region const & r = *regions[i];
+            RunAccumulator keys(results[i]);
+            Box b = r.getBoundingBox().dilatedBy(Angle(BOX_EPSILON));
+            _forEachChunk(b, [&](int32_t s, int32_t c,
+                                 int32_t minSS, int32_t maxSS) {
+                int32_t chunkId = _getChunkId(s, c);
+                _forEachSubChunk(r, b.getLon(), s, c, minSS, maxSS,
+                                 [&](int32_t subChunkId) {
+                    keys.add(getSubChunkKey(chunkId, subChunkId));
+                });
+            });
+            keys.flush();
+        }
+    });
+    return results;
 }
 
 std::vector<int32_t> Chunker::getAllChunks() const {
@@ -288,24 +366,32 @@ bool Chunker::valid(int32_t chunkId) const {
            _getChunk(chunkId, s) < _stripes.at(s).numChunksPerStripe;
 }
 
+AngleInterval Chunker::_getStripeLatitudes(int32_t stripe) const {
+    int32_t ss = stripe * _numSubStripesPerStripe;
+    int32_t ssEnd = ss + _numSubStripesPerStripe;
+    return AngleInterval(ss * _subStripeHeight - Angle(0.5 * PI),
+                         ssEnd * _subStripeHeight - Angle(0.5 * PI));
+}
+
+AngleInterval Chunker::_getSubStripeLatitudes(int32_t subStripe) const {
+    return AngleInterval(subStripe * _subStripeHeight - Angle(0.5 * PI),
+                         (subStripe + 1) * _subStripeHeight - Angle(0.5 * PI));
+}
+
 Box Chunker::_getChunkBoundingBox(int32_t stripe, int32_t chunk) const {
     Angle chunkWidth = _stripes[stripe].chunkWidth;
     NormalizedAngleInterval lon(chunkWidth * chunk,
                                 chunkWidth * (chunk + 1));
-    int32_t ss = stripe * _numSubStripesPerStripe;
-    int32_t ssEnd = ss + _numSubStripesPerStripe;
-    AngleInterval lat(ss * _subStripeHeight - Angle(0.5 * PI),
-                      ssEnd * _subStripeHeight - Angle(0.5 * PI));
-    return Box(lon, lat).dilatedBy(Angle(BOX_EPSILON));
+    return Box(lon, _getStripeLatitudes(stripe)).dilatedBy(
+        _stripes[stripe].chunkDilation, Angle(BOX_EPSILON));
 }
 
 Box Chunker::_getSubChunkBoundingBox(int32_t subStripe, int32_t subChunk) const {
     Angle subChunkWidth = _subStripes[subStripe].subChunkWidth;
     NormalizedAngleInterval lon(subChunkWidth * subChunk,
                                 subChunkWidth * (subChunk + 1));
-    AngleInterval lat(subStripe * _subStripeHeight - Angle(0.5 * PI),
-                      (subStripe + 1) * _subStripeHeight - Angle(0.5 * PI));
-    return Box(lon, lat).dilatedBy(Angle(BOX_EPSILON));
+    return Box(lon, _getSubStripeLatitudes(subStripe)).dilatedBy(
+        _subStripes[subStripe].subChunkDilation, Angle(BOX_EPSILON));
 }
 
 }} // namespace lsst::sphgeom
@@ -25,12 +25,16 @@
 
 #include "lsst/sphgeom/Circle.h"
 
+#include <algorithm>
 #include <ostream>
+#include <random>
 #include <stdexcept>
 
 #include "lsst/sphgeom/Box.h"
 #include "lsst/sphgeom/Box3d.h"
+#include "lsst/sphgeom/CompoundRegion.h"
 #include "lsst/sphgeom/ConvexPolygon.h"
+#include "lsst/sphgeom/Polygon.h"
 #include "lsst/sphgeom/Ellipse.h"
 #include "lsst/sphgeom/codec.h"
 
@@ -38,6 +42,102 @@
 namespace lsst {
 namespace sphgeom {
 
+namespace {
+
+// A `Cap` is a candidate enclosing circle, given by its center and squared
+// chord length.
+struct Cap {
+    UnitVector3d center;
+    double squaredChordLength;
+
+    bool contains(UnitVector3d const & v) const {
+        return (v - center).getSquaredNorm() <=
+               squaredChordLength + MAX_SQUARED_CHORD_LENGTH_ERROR;
+    }
+};
+
+// `capThrough` returns the smallest cap with a and b on its boundary.
+Cap capThrough(UnitVector3d const & a, UnitVector3d const & b) {
+    Vector3d s = a + b;
+    if (s.isZero()) {
+        return Cap{a, 4.0};
+    }
+    UnitVector3d c(s);
+    return Cap{c, std::max((a - c).getSquaredNorm(), (b - c).getSquaredNorm())};
+}
+
+// `capThrough` returns the smaller of the two caps with a, b and c on
+// their boundaries. If the points lie on a great circle, the smallest cap
+// through two of them that contains the third is returned instead.
+Cap capThrough(UnitVector3d const & a,
+               UnitVector3d const & b,
+               UnitVector3d const & c)
+{
+    Vector3d n = (b - a).cross(c - a);
+    if (n.isZero()) {
+        Cap caps[3] = {capThrough(a, b), capThrough(b, c), capThrough(c, a)};
+        Cap const * best = nullptr;
+        for (Cap const & cap: caps) {
+            if (cap.contains(a) && cap.contains(b) && cap.contains(c) &&
+                (best == nullptr ||
+                 cap.squaredChordLength < best->squaredChordLength)) {
+                best = &cap;
+            }
+        }
+        return best != nullptr ? *best : Cap{a, 4.0};
+    }
+    UnitVector3d center(n);
+    if (center.dot(a) < 0.0) {
+        center = -center;
+    }
+    double cl2 = std::max((a - center).getSquaredNorm(),
+                          (b - center).getSquaredNorm());
+    return Cap{center, std::max(cl2, (c - center).getSquaredNorm())};
+}
+
+} // unnamed namespace
+
+
+Circle Circle::minimalEnclosingCircle(std::vector<UnitVector3d> const & points) {
+    if (points.empty()) {
+        return Circle();
+    }
+    // Welzl's algorithm runs in expected linear time when the points are
+    // processed in random order. A fixed seed keeps the result repeatable.
+    std::vector<UnitVector3d> p(points);
+    std::mt19937 rng(1);
+    std::shuffle(p.begin(), p.end(), rng);
+    size_t const n = p.size();
+    Cap cap{p[0], 0.0};
+    for (size_t i = 1; i < n; ++i) {
+        if (cap.contains(p[i])) {
+            continue;
+        }
+        // p[i] is on the boundary of the minimal cap of p[0], ..., p[i].
+        cap = Cap{p[i], 0.0};
+        for (size_t j = 0; j < i; ++j) {
+            if (cap.contains(p[j])) {
+                continue;
+            }
+            // So are p[i] and p[j], for the points up to p[j].
+            cap = capThrough(p[i], p[j]);
+            for (size_t k = 0; k < j; ++k) {
+                if (!cap.contains(p[k])) {
+                    cap = capThrough(p[i], p[j], p[k]);
+                }
+            }
+        }
+    }
+    // Recompute the radius so that it covers every point, and add double
+    // the maximum squared-chord-length error, so that the circle we return
+    // reliably CONTAINS the points.
+    double cl2 = 0.0;
+    for (UnitVector3d const & v: points) {
+        cl2 = std::max(cl2, (v - cap.center).getSquaredNorm());
+    }
+    return Circle(cap.center, cl2 + 2.0 * MAX_SQUARED_CHORD_LENGTH_ERROR);
+}
+
 double Circle::squaredChordLengthFor(Angle a) {
     if (a.asRadians() < 0.0) {
         return -1.0;
@@ -321,6 +421,16 @@ Relationship Circle::relate(Ellipse const & e) const {
     return invert(e.relate(*this));
 }
 
+Relationship Circle::relate(Polygon const & p) const {
+    // Polygon-Circle relations are implemented by Polygon.
+    return invert(p.relate(*this));
+}
+
+Relationship Circle::relate(CompoundRegion const & c) const {
+    // CompoundRegion-Circle relations are implemented by CompoundRegion.
+    return invert(c.relate(*this));
+}
+
 std::vector<uint8_t> Circle::encode() const {
     std::vector<uint8_t> buffer;
     uint8_t tc = TYPE_CODE;
@@ -335,20 +445,24 @@ std::vector<uint8_t> Circle::encode() const {
 }
 
 std::unique_ptr<Circle> Circle::decode(uint8_t const * buffer, size_t n) {
+    std::unique_ptr<Circle> circle(new Circle);
+    circle->_decode(buffer, n);
+    return circle;
+}
+
+void Circle::_decode(uint8_t const * buffer, size_t n) {
     if (buffer == nullptr || n != ENCODED_SIZE || *buffer != TYPE_CODE) {
         throw std::runtime_error("Byte-string is not an encoded Circle");
     }
-    std::unique_ptr<Circle> circle(new Circle);
     ++buffer;
     double x = decodeDouble(buffer); buffer += 8;
     double y = decodeDouble(buffer); buffer += 8;
     double z = decodeDouble(buffer); buffer += 8;
     double squaredChordLength = decodeDouble(buffer); buffer += 8;
     double openingAngle = decodeDouble(buffer); buffer += 8;
-    circle->_center = UnitVector3d::fromNormalized(x, y, z);
-    circle->_squaredChordLength = squaredChordLength;
-    circle->_openingAngle = Angle(openingAngle);
-    return circle;
+    _center = UnitVector3d::fromNormalized(x, y, z);
+    _squaredChordLength = squaredChordLength;
+    _openingAngle = Angle(openingAngle);
 }
 
 std::ostream & operator<<(std::ostream & os, Circle const & c) {
@@ -0,0 +1,498 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains the CompoundRegion class implementations.
+
+#include "lsst/sphgeom/CompoundRegion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "lsst/sphgeom/ConvexPolygon.h"
+#include "lsst/sphgeom/Ellipse.h"
+#include "lsst/sphgeom/FixedConvexPolygon.h"
+#include "lsst/sphgeom/Polygon.h"
+#include "lsst/sphgeom/codec.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+namespace {
+
+// `BOUND_ERROR` bounds the absolute error of the dot products computed
+// when comparing bounds.
+constexpr double BOUND_ERROR = 1.0e-14;
+
+template <typename RegionType>
+Relationship relatePolygonTo(UnitVector3d const * v, size_t n,
+                             Region const & r)
+{
+    return detail::polygonRelate(v, n, static_cast<RegionType const &>(r));
+}
+
+} // unnamed namespace
+
+CompoundRegion::Bound::Bound(Circle const & c) : center(c.getCenter()) {
+    double cl2 = c.getSquaredChordLength();
+    if (c.isEmpty()) {
+        // Empty bounds are disjoint from everything.
+        cosRadius = 2.0;
+        sinRadius = 0.0;
+    } else {
+        cosRadius = 1.0 - 0.5 * cl2;
+        sinRadius = std::sqrt(std::max(0.0, cl2 * (1.0 - 0.25 * cl2)));
+    }
+}
+
+CompoundRegion::Bound::Bound(UnitVector3d const & c, double cr) :
+    center(c),
+    cosRadius(cr),
+    sinRadius(std::sqrt(std::max(0.0, 1.0 - cr * cr)))
+{}
+
+CompoundRegion::Bound::Bound(UnitVector3d const * v, size_t n) {
+    // Bound the polygon by the circle centered on its normalized vertex
+    // sum that contains its vertices. This is only valid for polygons
+    // smaller than a hemisphere; others get a full bound.
+    Vector3d s = v[0];
+    for (size_t i = 1; i < n; ++i) {
+        s += v[i];
+    }
+    center = UnitVector3d::fromNormalized(s * (1.0 / s.getNorm()));
+    double cr = 1.0;
+    for (size_t i = 0; i < n; ++i) {
+        cr = std::min(cr, v[i].dot(center));
+    }
+    cr -= BOUND_ERROR;
+    cosRadius = cr > 0.0 ? cr : -1.0;
+    sinRadius = std::sqrt(std::max(0.0, 1.0 - cosRadius * cosRadius));
+}
+
+bool CompoundRegion::Bound::isDisjointFrom(Bound const & b) const {
+    if (cosRadius > 1.0 || b.cosRadius > 1.0) {
+        return true;
+    }
+    // The circles are disjoint if the angle between their centers exceeds
+    // the sum of their opening angles, which must be less than π.
+    return cosRadius + b.cosRadius > 0.0 &&
+           center.dot(b.center) < cosRadius * b.cosRadius -
+                                  sinRadius * b.sinRadius - BOUND_ERROR;
+}
+
+CompoundRegion::CompoundRegion(std::vector<std::unique_ptr<Region>> operands) :
+    _operands(std::move(operands))
+{
+    _bounds.reserve(_operands.size());
+    for (std::unique_ptr<Region> const & r: _operands) {
+        if (!r) {
+            throw std::invalid_argument(
+                "Compound region operands must not be null");
+        }
+        _bounds.push_back(Bound(r->getBoundingCircle()));
+    }
+}
+
+CompoundRegion::CompoundRegion(CompoundRegion const & r) :
+    Region(r),
+    _bounds(r._bounds)
+{
+    _operands.reserve(r._operands.size());
+    for (std::unique_ptr<Region> const & o: r._operands) {
+        _operands.push_back(o->clone());
+    }
+}
+
+template <typename RegionType>
+Relationship CompoundRegion::_relate(RegionType const & r) const {
+    Bound b(r.getBoundingCircle());
+    return relateOperands([this, &r, &b](size_t i) {
+        if (_bounds[i].isDisjointFrom(b)) {
+            return DISJOINT;
+        }
+        return _operands[i]->relate(r);
+    }, getNumOperands());
+}
+
+Relationship CompoundRegion::relate(Box const & b) const {
+    return _relate(b);
+}
+
+Relationship CompoundRegion::relate(Circle const & c) const {
+    return _relate(c);
+}
+
+Relationship CompoundRegion::relate(ConvexPolygon const & p) const {
+    return _relate(p);
+}
+
+Relationship CompoundRegion::relate(Ellipse const & e) const {
+    return _relate(e);
+}
+
+Relationship CompoundRegion::relate(Polygon const & p) const {
+    return _relate(p);
+}
+
+Relationship CompoundRegion::relate(CompoundRegion const & c) const {
+    return _relate(c);
+}
+
+std::vector<uint8_t> CompoundRegion::encode() const {
+    std::vector<uint8_t> buffer;
+    buffer.push_back(getTypeCode());
+    for (std::unique_ptr<Region> const & r: _operands) {
+        std::vector<uint8_t> operand = r->encode();
+        encodeU64(operand.size(), buffer);
+        buffer.insert(buffer.end(), operand.begin(), operand.end());
+    }
+    return buffer;
+}
+
+std::vector<std::unique_ptr<Region>> CompoundRegion::decodeOperands(
+    uint8_t typeCode, uint8_t const * buffer, size_t n)
+{
+    char const * const NOT_ENCODED =
+        "Byte-string is not an encoded CompoundRegion";
+    if (buffer == nullptr || n == 0 || *buffer != typeCode) {
+        throw std::runtime_error(NOT_ENCODED);
+    }
+    std::vector<std::unique_ptr<Region>> operands;
+    uint8_t const * end = buffer + n;
+    for (++buffer; buffer != end; ) {
+        if (end - buffer < 8) {
+            throw std::runtime_error(NOT_ENCODED);
+        }
+        uint64_t size = decodeU64(buffer);
+        buffer += 8;
+        if (size > static_cast<uint64_t>(end - buffer)) {
+            throw std::runtime_error(NOT_ENCODED);
+        }
+        operands.push_back(Region::decode(buffer, size));
+        buffer += size;
+    }
+    return operands;
+}
+
+std::unique_ptr<CompoundRegion> CompoundRegion::decode(uint8_t const * buffer,
+                                                       size_t n)
+{
+    if (buffer != nullptr && n != 0) {
+        if (*buffer == UnionRegion::TYPE_CODE) {
+            return UnionRegion::decode(buffer, n);
+        } else if (*buffer == IntersectionRegion::TYPE_CODE) {
+            return IntersectionRegion::decode(buffer, n);
+        } else if (*buffer == DifferenceRegion::TYPE_CODE) {
+            return DifferenceRegion::decode(buffer, n);
+        }
+    }
+    throw std::runtime_error("Byte-string is not an encoded CompoundRegion");
+}
+
+
+Box UnionRegion::getBoundingBox() const {
+    Box b;
+    for (size_t i = 0; i < getNumOperands(); ++i) {
+        b.expandTo(getOperand(i).getBoundingBox());
+    }
+    return b;
+}
+
+Box3d UnionRegion::getBoundingBox3d() const {
+    Box3d b;
+    for (size_t i = 0; i < getNumOperands(); ++i) {
+        b.expandTo(getOperand(i).getBoundingBox3d());
+    }
+    return b;
+}
+
+Circle UnionRegion::getBoundingCircle() const {
+    Circle c;
+    for (size_t i = 0; i < getNumOperands(); ++i) {
+        c.expandTo(getOperand(i).getBoundingCircle());
+    }
+    return c;
+}
+
+bool UnionRegion::contains(UnitVector3d const & v) const {
+    for (size_t i = 0; i < getNumOperands(); ++i) {
+        if (getOperand(i).contains(v)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Relationship UnionRegion::relateOperands(OperandRelation const & f,
+                                         size_t n) const
+{
+    // A union contains a region if any operand does, is within it if all
+    // operands are, and is disjoint from it if all operands are.
+    bool disjoint = true;
+    bool within = true;
+    for (size_t i = 0; i < n; ++i) {
+        Relationship r = f(i);
+        if ((r & CONTAINS) != 0) {
+            return CONTAINS;
+        }
+        disjoint = disjoint && (r & DISJOINT) != 0;
+        within = within && (r & WITHIN) != 0;
+    }
+    return (disjoint ? DISJOINT : INTERSECTS) | (within ? WITHIN : INTERSECTS);
+}
+
+
+Box IntersectionRegion::getBoundingBox() const {
+    Box b = Box::full();
+    for (size_t i = 0; i < getNumOperands(); ++i) {
+        b.clipTo(getOperand(i).getBoundingBox());
+    }
+    return b;
+}
+
+Box3d IntersectionRegion::getBoundingBox3d() const {
+    Box3d b = Box3d::full();
+    for (size_t i = 0; i < getNumOperands(); ++i) {
+        b.clipTo(getOperand(i).getBoundingBox3d());
+    }
+    return b;
+}
+
+Circle IntersectionRegion::getBoundingCircle() const {
+    Circle c = Circle::full();
+    for (size_t i = 0; i < getNumOperands(); ++i) {
+        c.clipTo(getOperand(i).getBoundingCircle());
+    }
+    return c;
+}
+
+bool IntersectionRegion::contains(UnitVector3d const & v) const {
+    for (size_t i = 0; i < getNumOperands(); ++i) {
+        if (!getOperand(i).contains(v)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Relationship IntersectionRegion::relateOperands(
+    OperandRelation const & f, size_t n) const
+{
+    // An intersection is disjoint from a region if any operand is, within
+    // it if any operand is, and contains it if all operands do.
+    bool contains = true;
+    bool within = false;
+    for (size_t i = 0; i < n; ++i) {
+        Relationship r = f(i);
+        if ((r & DISJOINT) != 0) {
+            return DISJOINT;
+        }
+        contains = contains && (r & CONTAINS) != 0;
+        within = within || (r & WITHIN) != 0;
+    }
+    return (contains ? CONTAINS : INTERSECTS) | (within ? WITHIN : INTERSECTS);
+}
+
+
+DifferenceRegion::DifferenceRegion(std::unique_ptr<Region> a,
+                                   std::unique_ptr<Region> b) :
+    CompoundRegion([&a, &b]() {
+        std::vector<std::unique_ptr<Region>> operands;
+        operands.push_back(std::move(a));
+        operands.push_back(std::move(b));
+        return operands;
+    }())
+{}
+
+std::unique_ptr<DifferenceRegion> DifferenceRegion::decode(
+    uint8_t const * buffer, size_t n)
+{
+    std::vector<std::unique_ptr<Region>> operands =
+        decodeOperands(TYPE_CODE, buffer, n);
+    if (operands.size() != 2) {
+        throw std::runtime_error(
+            "Byte-string is not an encoded CompoundRegion");
+    }
+    return std::unique_ptr<DifferenceRegion>(new DifferenceRegion(
+        std::move(operands[0]), std::move(operands[1])));
+}
+
+Relationship DifferenceRegion::relateOperands(OperandRelation const & f,
+                                              size_t) const
+{
+    // A - B is disjoint from a region R if A is disjoint from R or B
+    // contains R, within R if A is, and contains R if A contains R and B is
+    // disjoint from it.
+    Relationship a = f(0);
+    if ((a & DISJOINT) != 0) {
+        return DISJOINT;
+    }
+    Relationship b = f(1);
+    if ((b & CONTAINS) != 0) {
+        return DISJOINT;
+    }
+    bool contains = (a & CONTAINS) != 0 && (b & DISJOINT) != 0;
+    return (a & WITHIN) | (contains ? CONTAINS : INTERSECTS);
+}
+
+
+namespace detail {
+
+Relationship compoundRelate(UnitVector3d const * v, size_t n,
+                            CompoundRegion const & c)
+{
+    CompoundRegion::Bound b(v, n);
+    return invert(c.relateOperands([v, n, &b, &c](size_t i) {
+        if (c._bounds[i].isDisjointFrom(b)) {
+            return DISJOINT;
+        }
+        return invert(polygonRelate(v, n, *c._operands[i]));
+    }, c.getNumOperands()));
+}
+
+CompoundRelater::CompoundRelater(CompoundRegion const & c) {
+    _add(c);
+    // Initially, all operands are undecided.
+    _relationships.assign(_children.size(), INTERSECTS);
+    _undecided.resize(_children.size());
+    _counts.reserve(_nodes.size());
+    for (Node const & node: _nodes) {
+        uint32_t m = static_cast<uint32_t>(node.region->getNumOperands());
+        for (uint32_t i = 0; i < m; ++i) {
+            _undecided[node.first + i] = i;
+        }
+        _counts.push_back(m);
+    }
+}
+
+void CompoundRelater::_add(CompoundRegion const & c) {
+    size_t first = _children.size();
+    _nodes.push_back(Node{&c, c.getNeutralRelationship(), first});
+    _children.resize(first + c.getNumOperands(), 0);
+    _relations.resize(first + c.getNumOperands(), nullptr);
+    _testBounds.resize(first + c.getNumOperands(), 1);
+    for (size_t i = 0; i < c.getNumOperands(); ++i) {
+        Region const * o = c._operands[i].get();
+        if (dynamic_cast<Box const *>(o)) {
+            _relations[first + i] = &relatePolygonTo<Box>;
+        } else if (dynamic_cast<Circle const *>(o)) {
+            _relations[first + i] = &relatePolygonTo<Circle>;
+            _testBounds[first + i] = 0;
+        } else if (dynamic_cast<ConvexPolygon const *>(o)) {
+            _relations[first + i] = &relatePolygonTo<ConvexPolygon>;
+        } else if (dynamic_cast<Ellipse const *>(o)) {
+            _relations[first + i] = &relatePolygonTo<Ellipse>;
+        } else if (dynamic_cast<Polygon const *>(o)) {
+            _relations[first + i] = &relatePolygonTo<Polygon>;
+        } else if (CompoundRegion const * cr =
+                   dynamic_cast<CompoundRegion const *>(o)) {
+            // The operands of a compound operand are tested instead.
+            _children[first + i] = _nodes.size();
+            _testBounds[first + i] = 0;
+            _add(*cr);
+        } else {
+            _relations[first + i] = &relatePolygonTo<Region>;
+        }
+    }
+}
+
+Relationship CompoundRelater::relate(UnitVector3d const * v, size_t n,
+                                     size_t depth)
+{
+    // Make room for the state of the polygon, which its children inherit.
+    size_t numOperands = _children.size();
+    if (_counts.size() < (depth + 2) * _nodes.size()) {
+        _relationships.resize((depth + 2) * numOperands, INTERSECTS);
+        _undecided.resize((depth + 2) * numOperands);
+        _counts.resize((depth + 2) * _nodes.size());
+    }
+    _vertices = v;
+    _numVertices = n;
+    Relationship r = invert(_relate(0, depth));
+    _hasBound = false;
+    return r;
+}
+
+CompoundRegion::Bound const & CompoundRelater::_getBound() {
+    if (!_hasBound) {
+        _bound = CompoundRegion::Bound(_vertices, _numVertices);
+        _hasBound = true;
+    }
+    return _bound;
+}
+
+Relationship CompoundRelater::_relate(size_t node, size_t depth) {
+    size_t numOperands = _children.size();
+    size_t first = _nodes[node].first;
+    size_t offset = depth * numOperands + first;
+    // The state of the parent is read from depth, and the state of the
+    // polygon is written to depth + 1. It is gathered in a single object
+    // so that the operand relation below fits in a std::function without
+    // a memory allocation.
+    struct {
+        CompoundRegion const & c;
+        size_t depth;
+        size_t first;
+        Relationship neutral;
+        Relationship const * parentRelationships;
+        Relationship * relationships;
+        uint32_t const * parentUndecided;
+        uint32_t * undecided;
+        uint32_t & count;
+    } s = {
+        *_nodes[node].region, depth, first, _nodes[node].neutral,
+        _relationships.data() + offset,
+        _relationships.data() + offset + numOperands,
+        _undecided.data() + offset,
+        _undecided.data() + offset + numOperands,
+        _counts[(depth + 1) * _nodes.size() + node]
+    };
+    s.count = 0;
+    Relationship r = s.c.relateOperands([this, &s](size_t j) {
+        uint32_t i = s.parentUndecided[j];
+        Relationship q = s.parentRelationships[i];
+        if (q == INTERSECTS) {
+            if (_testBounds[s.first + i] &&
+                s.c._bounds[i].isDisjointFrom(_getBound())) {
+                q = DISJOINT;
+            } else if (_children[s.first + i] != 0) {
+                q = _relate(_children[s.first + i], s.depth);
+            } else {
+                q = invert(_relations[s.first + i](
+                        _vertices, _numVertices, *s.c._operands[i])) &
+                    (DISJOINT | CONTAINS);
+            }
+        }
+        s.relationships[i] = q;
+        if ((q & s.neutral) == 0) {
+            s.undecided[s.count++] = i;
+        }
+        return q;
+    }, _counts[depth * _nodes.size() + node]);
+    return r & (DISJOINT | CONTAINS);
+}
+
+} // namespace detail
+
+}} // namespace lsst::sphgeom
@@ -25,13 +25,17 @@
 
 #include "lsst/sphgeom/ConvexPolygon.h"
 
+#include <algorithm>
 #include <ostream>
 #include <stdexcept>
 
+#include "lsst/sphgeom/CompoundRegion.h"
 #include "lsst/sphgeom/codec.h"
 #include "lsst/sphgeom/orientation.h"
+#include "lsst/sphgeom/Polygon.h"
 
 #include "ConvexPolygonImpl.h"
+#include "ForEachSlice.h"
 
 
 namespace lsst {
@@ -249,6 +253,242 @@ void computeHull(std::vector<UnitVector3d> & points) {
 // a fast hull merging algorithm, which could then be used to implement Chan's
 // algorithm.
 
+using detail::forEachSlice;
+
+// A `ProjectedPoint` is the gnomonic projection of an input point onto the
+// plane tangent to the unit sphere at the center of a point set.
+struct ProjectedPoint {
+    double x;
+    double y;
+    size_t index;
+
+    bool operator<(ProjectedPoint const & p) const {
+        return x < p.x || (x == p.x && y < p.y);
+    }
+};
+
+// `monotoneChain` sorts the given projected points and appends the indexes
+// of their hull vertices, in counter-clockwise order, to `hull`. The sort
+// uses the approximate projected coordinates, but turns are classified with
+// the exact orientation() of the corresponding input points, so collinear
+// points are dropped. The result must be verified by the caller.
+void monotoneChain(std::vector<UnitVector3d> const & points,
+                   std::vector<ProjectedPoint>::iterator begin,
+                   std::vector<ProjectedPoint>::iterator end,
+                   std::vector<size_t> & hull)
+{
+    std::sort(begin, end);
+    size_t const start = hull.size();
+    auto turnsLeft = [&](size_t i) {
+        size_t n = hull.size();
+        return orientation(points[hull[n - 2]], points[hull[n - 1]],
+                           points[i]) > 0;
+    };
+    // Compute the lower hull, from left to right.
+    for (auto p = begin; p != end; ++p) {
+        while (hull.size() >= start + 2 && !turnsLeft(p->index)) {
+            hull.pop_back();
+        }
+        hull.push_back(p->index);
+    }
+    // Compute the upper hull, from right to left.
+    size_t const lower = hull.size() + 1;
+    for (auto p = end - 1; p != begin; ) {
+        --p;
+        while (hull.size() >= lower && !turnsLeft(p->index)) {
+            hull.pop_back();
+        }
+        hull.push_back(p->index);
+    }
+    // The first point is also the last one.
+    hull.pop_back();
+}
+
+// `isHull` checks that the given vertices form a convex polygon with
+// counter-clockwise orientation. It requires every vertex to be strictly
+// to the left of the first and last edges, the triangle fan from vertex 0
+// to have counter-clockwise orientation, and every vertex to be a strictly
+// convex corner.
+bool isHull(std::vector<UnitVector3d> const & h) {
+    size_t const n = h.size();
+    if (n < 3) {
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        size_t j = (i + 1) % n;
+        size_t k = (i + 2) % n;
+        if (orientation(h[i], h[j], h[k]) <= 0) {
+            return false;
+        }
+    }
+    for (size_t i = 2; i < n - 1; ++i) {
+        if (orientation(h[0], h[1], h[i]) <= 0 ||
+            orientation(h[n - 1], h[0], h[i - 1]) <= 0 ||
+            orientation(h[0], h[i - 1], h[i]) <= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// `isStrictlyInside` checks whether v is in the interior of the convex
+// polygon with vertices h, and not on its boundary, by locating v in the
+// fan of triangles around vertex 0. It runs in O(log n) time.
+bool isStrictlyInside(std::vector<UnitVector3d> const & h,
+                      UnitVector3d const & v)
+{
+    size_t const n = h.size();
+    if (orientation(h[0], h[1], v) <= 0 ||
+        orientation(h[n - 1], h[0], v) <= 0) {
+        return false;
+    }
+    // Find the last i such that orientation(h[0], h[i], v) > 0.
+    size_t lo = 1;
+    size_t hi = n - 1;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (orientation(h[0], h[mid], v) > 0) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return orientation(h[lo], h[lo + 1], v) > 0;
+}
+
+// `computeFastHull` computes the hull of the given points in O(n log n)
+// time and stores it in `hull`. It returns false if it could not prove
+// that the result equals the one computed by `computeHull`.
+bool computeFastHull(std::vector<UnitVector3d> const & points,
+                     unsigned numThreads,
+                     std::vector<UnitVector3d> & hull)
+{
+    size_t const n = points.size();
+    if (n < 3) {
+        return false;
+    }
+    if (numThreads > 1 && n < 4096u * numThreads) {
+        numThreads = 1;
+    }
+    // Project the points onto the plane tangent to the sphere at their
+    // centroid. If they do not all lie well inside the corresponding
+    // hemisphere, give up.
+    Vector3d sum;
+    for (UnitVector3d const & p: points) {
+        sum += p;
+    }
+    if (sum.isZero()) {
+        return false;
+    }
+    UnitVector3d const c(sum);
+    UnitVector3d const u = UnitVector3d::orthogonalTo(c);
+    UnitVector3d const w(c.cross(u));
+    std::vector<ProjectedPoint> projected(n);
+    std::vector<char> inHemisphere(numThreads, 1);
+    forEachSlice(n, numThreads, [&](unsigned t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            UnitVector3d const & p = points[i];
+            double z = p.dot(c);
+            if (!(z > 1.0e-10)) {
+                inHemisphere[t] = 0;
+                return;
+            }
+            projected[i] = ProjectedPoint{p.dot(u) / z, p.dot(w) / z, i};
+        }
+    });
+    if (std::find(inHemisphere.begin(), inHemisphere.end(), 0) !=
+        inHemisphere.end()) {
+        return false;
+    }
+    // Points strictly inside the hull of the extreme points in 8 directions
+    // are strictly inside the overall hull, and can be discarded up front.
+    auto key = [](ProjectedPoint const & p, int j) {
+        return j == 0 ? p.x : (j == 1 ? p.y : (j == 2 ? p.x + p.y : p.x - p.y));
+    };
+    std::vector<ProjectedPoint> extremes(8, projected[0]);
+    for (ProjectedPoint const & p: projected) {
+        for (int j = 0; j < 4; ++j) {
+            double k = key(p, j);
+            if (k < key(extremes[2 * j], j)) {
+                extremes[2 * j] = p;
+            } else if (k > key(extremes[2 * j + 1], j)) {
+                extremes[2 * j + 1] = p;
+            }
+        }
+    }
+    std::vector<size_t> indexes;
+    monotoneChain(points, extremes.begin(), extremes.end(), indexes);
+    std::vector<UnitVector3d> octagon;
+    for (size_t i: indexes) {
+        octagon.push_back(points[i]);
+    }
+    if (!isHull(octagon)) {
+        octagon.clear();
+    }
+    // Gather the remaining points of each slice. In parallel mode, only
+    // the vertices of the hull of a slice can be vertices of the overall
+    // hull, so those are computed as well.
+    std::vector<std::vector<ProjectedPoint>> remaining(numThreads);
+    std::vector<std::vector<size_t>> candidates(numThreads);
+    forEachSlice(n, numThreads, [&](unsigned t, size_t begin, size_t end) {
+        std::vector<ProjectedPoint> & r = remaining[t];
+        for (size_t i = begin; i < end; ++i) {
+            if (octagon.empty() || !isStrictlyInside(octagon, points[i])) {
+                r.push_back(projected[i]);
+            }
+        }
+        if (numThreads > 1 && !r.empty()) {
+            std::vector<ProjectedPoint> sorted(r);
+            monotoneChain(points, sorted.begin(), sorted.end(), candidates[t]);
+        }
+    });
+    indexes.clear();
+    if (numThreads > 1) {
+        std::vector<ProjectedPoint> merged;
+        for (std::vector<size_t> const & slice: candidates) {
+            for (size_t i: slice) {
+                merged.push_back(projected[i]);
+            }
+        }
+        if (merged.size() < 3) {
+            return false;
+        }
+        monotoneChain(points, merged.begin(), merged.end(), indexes);
+    } else {
+        if (remaining[0].size() < 3) {
+            return false;
+        }
+        monotoneChain(points, remaining[0].begin(), remaining[0].end(),
+                      indexes);
+    }
+    hull.clear();
+    hull.reserve(indexes.size());
+    for (size_t i: indexes) {
+        hull.push_back(points[i]);
+    }
+    if (!isHull(hull)) {
+        return false;
+    }
+    // Every other remaining point must be strictly inside the hull.
+    // Otherwise, it is a duplicate of a hull vertex or lies on a hull edge,
+    // and the vertices chosen by computeHull depend on the input order.
+    std::vector<char> isVertex(n, 0);
+    for (size_t i: indexes) {
+        isVertex[i] = 1;
+    }
+    std::vector<char> inside(numThreads, 1);
+    forEachSlice(numThreads, numThreads, [&](unsigned t, size_t, size_t) {
+        for (ProjectedPoint const & p: remaining[t]) {
+            if (!isVertex[p.index] &&
+                !isStrictlyInside(hull, points[p.index])) {
+                inside[t] = 0;
+                return;
+            }
+        }
+    });
+    return std::find(inside.begin(), inside.end(), 0) == inside.end();
+}
+
 } // unnamed namespace
 
 
@@ -258,6 +498,18 @@ ConvexPolygon::ConvexPolygon(std::vector<UnitVector3d> const & points) :
     computeHull(_vertices);
 }
 
+ConvexPolygon ConvexPolygon::fastConvexHull(
+    std::vector<UnitVector3d> const & points,
+    unsigned numThreads)
+{
+    ConvexPolygon p;
+    if (!computeFastHull(points, numThreads, p._vertices)) {
+        p._vertices = points;
+        computeHull(p._vertices);
+    }
+    return p;
+}
+
 bool ConvexPolygon::operator==(ConvexPolygon const & p) const {
     if (this == &p) {
         return true;
@@ -301,6 +553,12 @@ Circle ConvexPolygon::getBoundingCircle() const {
     return detail::boundingCircle(_vertices.begin(), _vertices.end());
 }
 
+Circle ConvexPolygon::getMinimalBoundingCircle() const {
+    // Polygon vertices lie in an open hemisphere, so the minimal circle
+    // containing them is convex and contains the polygon edges too.
+    return Circle::minimalEnclosingCircle(_vertices);
+}
+
 Box ConvexPolygon::getBoundingBox() const {
     return detail::boundingBox(_vertices.begin(), _vertices.end());
 }
@@ -345,6 +603,16 @@ Relationship ConvexPolygon::relate(Ellipse const & e) const {
     return detail::relate(_vertices.begin(), _vertices.end(), e);
 }
 
+Relationship ConvexPolygon::relate(Polygon const & p) const {
+    // Polygon-ConvexPolygon relations are implemented by Polygon.
+    return invert(p.relate(*this));
+}
+
+Relationship ConvexPolygon::relate(CompoundRegion const & c) const {
+    // CompoundRegion-ConvexPolygon relations are implemented by CompoundRegion.
+    return invert(c.relate(*this));
+}
+
 std::vector<uint8_t> ConvexPolygon::encode() const {
     std::vector<uint8_t> buffer;
     uint8_t tc = TYPE_CODE;
@@ -361,22 +629,27 @@ std::vector<uint8_t> ConvexPolygon::encode() const {
 std::unique_ptr<ConvexPolygon> ConvexPolygon::decode(uint8_t const * buffer,
                                                      size_t n)
 {
+    std::unique_ptr<ConvexPolygon> poly(new ConvexPolygon);
+    poly->_decode(buffer, n);
+    return poly;
+}
+
+void ConvexPolygon::_decode(uint8_t const * buffer, size_t n) {
     if (buffer == nullptr || *buffer != TYPE_CODE ||
         n < 1 + 24*3 || (n - 1) % 24 != 0) {
         throw std::runtime_error("Byte-string is not an encoded ConvexPolygon");
     }
-    std::unique_ptr<ConvexPolygon> poly(new ConvexPolygon);
     ++buffer;
     size_t nv = (n - 1) / 24;
-    poly->_vertices.reserve(nv);
+    _vertices.clear();
+    _vertices.reserve(nv);
     for (size_t i = 0; i < nv; ++i, buffer += 24) {
-        poly->_vertices.push_back(UnitVector3d::fromNormalized(
+        _vertices.push_back(UnitVector3d::fromNormalized(
             decodeDouble(buffer),
             decodeDouble(buffer + 8),
             decodeDouble(buffer + 16)
         ));
     }
-    return poly;
 }
 
 std::ostream & operator<<(std::ostream & os, ConvexPolygon const & p) {
@@ -32,7 +32,9 @@
 #include "lsst/sphgeom/Box.h"
 #include "lsst/sphgeom/Box3d.h"
 #include "lsst/sphgeom/Circle.h"
+#include "lsst/sphgeom/CompoundRegion.h"
 #include "lsst/sphgeom/ConvexPolygon.h"
+#include "lsst/sphgeom/Polygon.h"
 #include "lsst/sphgeom/codec.h"
 
 
@@ -336,6 +338,15 @@ Relationship Ellipse::relate(Ellipse const & e) const {
     return getBoundingCircle().relate(e.getBoundingCircle()) & DISJOINT;
 }
 
+Relationship Ellipse::relate(Polygon const & p) const {
+    return getBoundingCircle().relate(p) & (DISJOINT | WITHIN);
+}
+
+Relationship Ellipse::relate(CompoundRegion const & c) const {
+    // CompoundRegion-Ellipse relations are implemented by CompoundRegion.
+    return invert(c.relate(*this));
+}
+
 std::vector<uint8_t> Ellipse::encode() const {
     std::vector<uint8_t> buffer;
     uint8_t tc = TYPE_CODE;
@@ -355,10 +366,15 @@ std::vector<uint8_t> Ellipse::encode() const {
 }
 
 std::unique_ptr<Ellipse> Ellipse::decode(uint8_t const * buffer, size_t n) {
+    std::unique_ptr<Ellipse> ellipse(new Ellipse);
+    ellipse->_decode(buffer, n);
+    return ellipse;
+}
+
+void Ellipse::_decode(uint8_t const * buffer, size_t n) {
     if (buffer == nullptr || n != ENCODED_SIZE || buffer[0] != TYPE_CODE) {
         throw std::runtime_error("Byte-string is not an encoded Ellipse");
     }
-    std::unique_ptr<Ellipse> ellipse(new Ellipse);
     ++buffer;
     double m00 = decodeDouble(buffer); buffer += 8;
     double m01 = decodeDouble(buffer); buffer += 8;
@@ -369,20 +385,19 @@ std::unique_ptr<Ellipse> Ellipse::decode(uint8_t const * buffer, size_t n) {
     double m20 = decodeDouble(buffer); buffer += 8;
     double m21 = decodeDouble(buffer); buffer += 8;
     double m22 = decodeDouble(buffer); buffer += 8;
-    ellipse->_S = Matrix3d(m00, m01, m02,
-                           m10, m11, m12,
-                           m20, m21, m22);
+    _S = Matrix3d(m00, m01, m02,
+                  m10, m11, m12,
+                  m20, m21, m22);
     double a = decodeDouble(buffer); buffer += 8;
     double b = decodeDouble(buffer); buffer += 8;
     double gamma = decodeDouble(buffer); buffer += 8;
-    ellipse->_a = Angle(a);
-    ellipse->_b = Angle(b);
-    ellipse->_gamma = Angle(gamma);
+    _a = Angle(a);
+    _b = Angle(b);
+    _gamma = Angle(gamma);
     double tana = decodeDouble(buffer); buffer += 8;
     double tanb = decodeDouble(buffer); buffer += 8;
-    ellipse->_tana = tana;
-    ellipse->_tanb = tanb;
-    return ellipse;
+    _tana = tana;
+    _tanb = tanb;
 }
 
 std::ostream & operator<<(std::ostream & os, Ellipse const & e) {
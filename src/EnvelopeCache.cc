@@ -0,0 +1,345 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains the EnvelopeCache class implementation.
+
+#include "lsst/sphgeom/EnvelopeCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "lsst/sphgeom/Region.h"
+#include "lsst/sphgeom/codec.h"
+
+#include "PixelizationType.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+namespace {
+
+// The backing file starts with `MAGIC`, followed by a sequence of records.
+// Each record consists of the key length, the key, the number of ranges,
+// and the range end points, with all integers stored as little-endian
+// 64 bit values.
+char const MAGIC[8] = {'S', 'P', 'H', 'E', 'N', 'V', '0', '1'};
+
+// `ENTRY_OVERHEAD` estimates the memory used by the hash table node, list
+// node and vector headers of an entry, in addition to its key and ranges.
+constexpr size_t ENTRY_OVERHEAD = 128;
+
+size_t entryBytes(std::string const & key, RangeSet const & ranges) {
+    return ENTRY_OVERHEAD + key.size() + 16 * ranges.size();
+}
+
+// `recordBytes` returns the size of the record for an entry.
+size_t recordBytes(std::string const & key, RangeSet const & ranges) {
+    return 16 + key.size() + 16 * ranges.size();
+}
+
+// `makeKey` returns the cache key for a search, which identifies the
+// pixelization type and level, the search parameters, and the region.
+std::string makeKey(Pixelization const & pixelization,
+                    Region const & r,
+                    size_t maxRanges,
+                    Coarsening coarsening,
+                    bool interior)
+{
+    int level;
+    uint8_t type = detail::getPixelizationType(pixelization, level,
+                                               "EnvelopeCache");
+    std::vector<uint8_t> buffer;
+    buffer.push_back(type);
+    buffer.push_back(static_cast<uint8_t>(level));
+    buffer.push_back(interior ? 'i' : 'e');
+    buffer.push_back(coarsening == Coarsening::LEVEL ? 'l' : 'o');
+    encodeU64(maxRanges, buffer);
+    std::vector<uint8_t> region = r.encode();
+    buffer.insert(buffer.end(), region.begin(), region.end());
+    return std::string(buffer.begin(), buffer.end());
+}
+
+void writeRecord(std::ostream & os,
+                 std::string const & key,
+                 RangeSet const & ranges)
+{
+    std::vector<uint8_t> buffer;
+    buffer.reserve(recordBytes(key, ranges));
+    encodeU64(key.size(), buffer);
+    buffer.insert(buffer.end(), key.begin(), key.end());
+    encodeU64(ranges.size(), buffer);
+    for (auto const & range: ranges) {
+        encodeU64(std::get<0>(range), buffer);
+        encodeU64(std::get<1>(range), buffer);
+    }
+    os.write(reinterpret_cast<char const *>(buffer.data()), buffer.size());
+}
+
+// `readU64` reads a little-endian 64 bit integer from is, and returns false
+// if the stream ends first.
+bool readU64(std::istream & is, uint64_t & u) {
+    uint8_t buffer[8];
+    if (!is.read(reinterpret_cast<char *>(buffer), 8)) {
+        return false;
+    }
+    u = decodeU64(buffer);
+    return true;
+}
+
+// `readRecord` reads a record from is, and returns false if the stream ends
+// before the record does.
+bool readRecord(std::istream & is, std::string & key, RangeSet & ranges) {
+    uint64_t keySize;
+    uint64_t numRanges;
+    if (!readU64(is, keySize) || keySize > (1u << 30)) {
+        return false;
+    }
+    key.resize(keySize);
+    if (!is.read(&key[0], keySize) || !readU64(is, numRanges)) {
+        return false;
+    }
+    ranges.clear();
+    for (uint64_t i = 0; i < numRanges; ++i) {
+        uint64_t first;
+        uint64_t last;
+        if (!readU64(is, first) || !readU64(is, last)) {
+            return false;
+        }
+        ranges.insert(first, last);
+    }
+    return true;
+}
+
+} // unnamed namespace
+
+
+EnvelopeCache::EnvelopeCache(size_t maxBytes) : _maxBytes(maxBytes) {}
+
+EnvelopeCache::EnvelopeCache(size_t maxBytes, std::string const & path) :
+    _maxBytes(maxBytes),
+    _path(path)
+{
+    _load();
+}
+
+RangeSet EnvelopeCache::envelope(Pixelization const & pixelization,
+                                 Region const & r,
+                                 size_t maxRanges,
+                                 Coarsening coarsening)
+{
+    return _lookup(pixelization, r, maxRanges, coarsening, false);
+}
+
+RangeSet EnvelopeCache::interior(Pixelization const & pixelization,
+                                 Region const & r,
+                                 size_t maxRanges,
+                                 Coarsening coarsening)
+{
+    return _lookup(pixelization, r, maxRanges, coarsening, true);
+}
+
+size_t EnvelopeCache::getBytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _bytes;
+}
+
+size_t EnvelopeCache::getSize() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+}
+
+uint64_t EnvelopeCache::getHits() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _hits;
+}
+
+uint64_t EnvelopeCache::getMisses() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _misses;
+}
+
+uint64_t EnvelopeCache::getEvictions() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _evictions;
+}
+
+void EnvelopeCache::resetCounters() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _hits = 0;
+    _misses = 0;
+    _evictions = 0;
+}
+
+void EnvelopeCache::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _lru.clear();
+    _bytes = 0;
+    _rewrite();
+}
+
+void EnvelopeCache::compact() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _rewrite();
+}
+
+RangeSet EnvelopeCache::_lookup(Pixelization const & pixelization,
+                                Region const & r,
+                                size_t maxRanges,
+                                Coarsening coarsening,
+                                bool interior)
+{
+    std::string key = makeKey(pixelization, r, maxRanges, coarsening,
+                              interior);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto i = _entries.find(key);
+        if (i != _entries.end()) {
+            ++_hits;
+            _lru.splice(_lru.begin(), _lru, i->second.lru);
+            return i->second.ranges;
+        }
+        ++_misses;
+    }
+    RangeSet ranges = interior ?
+        pixelization.interior(r, maxRanges, coarsening) :
+        pixelization.envelope(r, maxRanges, coarsening);
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_insert(key, ranges) && _file.is_open()) {
+        writeRecord(_file, key, ranges);
+        _file.flush();
+        _fileBytes += recordBytes(key, ranges);
+        // Evicted entries remain in the file, so it must be compacted as
+        // it grows to keep it bounded.
+        if (_fileBytes > 2 * _bytes) {
+            _rewrite();
+        }
+    }
+    return ranges;
+}
+
+bool EnvelopeCache::_insert(std::string const & key, RangeSet const & ranges) {
+    size_t bytes = entryBytes(key, ranges);
+    if (bytes > _maxBytes) {
+        return false;
+    }
+    auto i = _entries.find(key);
+    if (i != _entries.end()) {
+        // Another thread computed the same result first, or the backing
+        // file contains a newer copy.
+        _bytes -= i->second.bytes;
+        i->second.ranges = ranges;
+        i->second.bytes = bytes;
+        _bytes += bytes;
+        _lru.splice(_lru.begin(), _lru, i->second.lru);
+    } else {
+        i = _entries.emplace(key, Entry{ranges, bytes, _lru.end()}).first;
+        _lru.push_front(&i->first);
+        i->second.lru = _lru.begin();
+        _bytes += bytes;
+    }
+    while (_bytes > _maxBytes) {
+        auto j = _entries.find(*_lru.back());
+        _bytes -= j->second.bytes;
+        _lru.pop_back();
+        _entries.erase(j);
+        ++_evictions;
+    }
+    return true;
+}
+
+void EnvelopeCache::_load() {
+    bool truncated = false;
+    {
+        std::ifstream is(_path, std::ios::binary);
+        if (is && is.peek() != std::ifstream::traits_type::eof()) {
+            char magic[sizeof(MAGIC)];
+            if (!is.read(magic, sizeof(MAGIC)) ||
+                !std::equal(magic, magic + sizeof(MAGIC), MAGIC)) {
+                throw std::runtime_error(
+                    "File is not an envelope cache file: " + _path);
+            }
+            std::string key;
+            RangeSet ranges;
+            std::streamoff end = is.tellg();
+            while (readRecord(is, key, ranges)) {
+                _fileBytes += recordBytes(key, ranges);
+                _insert(key, ranges);
+                end = is.tellg();
+            }
+            // Anything after the last complete record belongs to a record
+            // that was only partially written.
+            is.clear();
+            is.seekg(0, std::ios::end);
+            truncated = is.tellg() != end;
+        }
+    }
+    // Rewriting the file drops the records of evicted or replaced entries.
+    // It is required if the file ends with a truncated record, since new
+    // records would otherwise be appended to it.
+    if (truncated || _fileBytes == 0 || _fileBytes > 2 * _bytes) {
+        _rewrite();
+    } else {
+        _file.open(_path, std::ios::binary | std::ios::app);
+    }
+    if (!_file) {
+        throw std::runtime_error(
+            "Cannot open envelope cache file: " + _path);
+    }
+    _evictions = 0;
+}
+
+void EnvelopeCache::_rewrite() {
+    if (_path.empty()) {
+        return;
+    }
+    _file.close();
+    std::string tmp = _path + ".tmp";
+    {
+        std::ofstream os(tmp, std::ios::binary | std::ios::trunc);
+        os.write(MAGIC, sizeof(MAGIC));
+        // Write the least recently used entries first, so that loading the
+        // file restores the order of the entries.
+        _fileBytes = 0;
+        for (auto i = _lru.rbegin(); i != _lru.rend(); ++i) {
+            RangeSet const & ranges = _entries.find(**i)->second.ranges;
+            writeRecord(os, **i, ranges);
+            _fileBytes += recordBytes(**i, ranges);
+        }
+        if (!os.flush()) {
+            throw std::runtime_error(
+                "Cannot write envelope cache file: " + tmp);
+        }
+    }
+    if (std::rename(tmp.c_str(), _path.c_str()) != 0) {
+        throw std::runtime_error(
+            "Cannot replace envelope cache file: " + _path);
+    }
+    _file.open(_path, std::ios::binary | std::ios::app);
+}
+
+}} // namespace lsst::sphgeom
@@ -0,0 +1,121 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains the out-of-line functions used by
+///        FixedConvexPolygon.
+
+#include "lsst/sphgeom/FixedConvexPolygon.h"
+
+#include "lsst/sphgeom/CompoundRegion.h"
+#include "lsst/sphgeom/Polygon.h"
+#include "lsst/sphgeom/codec.h"
+
+#include "ConvexPolygonImpl.h"
+
+
+namespace lsst {
+namespace sphgeom {
+namespace detail {
+
+UnitVector3d polygonCentroid(UnitVector3d const * v, size_t n) {
+    return centroid(v, v + n);
+}
+
+Box polygonBoundingBox(UnitVector3d const * v, size_t n) {
+    return boundingBox(v, v + n);
+}
+
+Box3d polygonBoundingBox3d(UnitVector3d const * v, size_t n) {
+    return boundingBox3d(v, v + n);
+}
+
+Circle polygonBoundingCircle(UnitVector3d const * v, size_t n) {
+    return boundingCircle(v, v + n);
+}
+
+bool polygonContains(UnitVector3d const * v, size_t n, UnitVector3d const & p) {
+    return contains(v, v + n, p);
+}
+
+Relationship polygonRelate(UnitVector3d const * v, size_t n, Box const & b) {
+    return relate(v, v + n, b);
+}
+
+Relationship polygonRelate(UnitVector3d const * v, size_t n, Circle const & c) {
+    return relate(v, v + n, c);
+}
+
+Relationship polygonRelate(UnitVector3d const * v, size_t n,
+                           ConvexPolygon const & p)
+{
+    return relate(v, v + n, p);
+}
+
+Relationship polygonRelate(UnitVector3d const * v, size_t n,
+                           Ellipse const & e)
+{
+    return relate(v, v + n, e);
+}
+
+Relationship polygonRelate(UnitVector3d const * v, size_t n,
+                           Region const & r)
+{
+    if (Box const * b = dynamic_cast<Box const *>(&r)) {
+        return relate(v, v + n, *b);
+    } else if (Circle const * c = dynamic_cast<Circle const *>(&r)) {
+        return relate(v, v + n, *c);
+    } else if (ConvexPolygon const * p =
+               dynamic_cast<ConvexPolygon const *>(&r)) {
+        return relate(v, v + n, *p);
+    } else if (Ellipse const * e = dynamic_cast<Ellipse const *>(&r)) {
+        return relate(v, v + n, *e);
+    } else if (Polygon const * q = dynamic_cast<Polygon const *>(&r)) {
+        return polygonRelate(v, n, *q);
+    } else if (CompoundRegion const * c =
+               dynamic_cast<CompoundRegion const *>(&r)) {
+        return compoundRelate(v, n, *c);
+    }
+    // Regions of other types implement their relationships with polygons.
+    return invert(r.relate(*ConvexPolygon::decode(polygonEncode(v, n))));
+}
+
+Relationship polygonRelate(UnitVector3d const * v1, size_t n1,
+                           UnitVector3d const * v2, size_t n2)
+{
+    return relate(v1, v1 + n1, v2, v2 + n2);
+}
+
+std::vector<uint8_t> polygonEncode(UnitVector3d const * v, size_t n) {
+    std::vector<uint8_t> buffer;
+    uint8_t tc = ConvexPolygon::TYPE_CODE;
+    buffer.reserve(1 + 24 * n);
+    buffer.push_back(tc);
+    for (size_t i = 0; i < n; ++i) {
+        encodeDouble(v[i].x(), buffer);
+        encodeDouble(v[i].y(), buffer);
+        encodeDouble(v[i].z(), buffer);
+    }
+    return buffer;
+}
+
+}}} // namespace lsst::sphgeom::detail
@@ -0,0 +1,74 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_FOREACHSLICE_H_
+#define LSST_SPHGEOM_FOREACHSLICE_H_
+
+/// \file
+/// \brief This file contains a helper for splitting work across threads.
+
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+
+namespace lsst {
+namespace sphgeom {
+namespace detail {
+
+// `forEachSlice` calls f(t, begin, end) for each of the numThreads
+// contiguous slices [begin, end) of [0, n), where t is the slice index.
+// Each call runs in its own thread when numThreads exceeds 1. The first
+// exception thrown by a call, if any, is rethrown once all calls are done.
+template <typename F>
+void forEachSlice(size_t n, unsigned numThreads, F f) {
+    if (numThreads <= 1) {
+        f(0u, size_t(0), n);
+        return;
+    }
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> errors(numThreads);
+    for (unsigned t = 0; t < numThreads; ++t) {
+        size_t begin = t * n / numThreads;
+        size_t end = (t + 1) * n / numThreads;
+        threads.emplace_back([&, t, begin, end]() {
+            try {
+                f(t, begin, end);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (std::thread & thread: threads) {
+        thread.join();
+    }
+    for (std::exception_ptr const & e: errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+}
+
+}}} // namespace lsst::sphgeom::detail
+
+#endif // LSST_SPHGEOM_FOREACHSLICE_H_
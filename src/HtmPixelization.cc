@@ -61,11 +61,11 @@ class HtmPixelFinder: public detail::PixelFinder<
     using Base::visit;
 
 public:
-    HtmPixelFinder(RangeSet & ranges,
-                   RegionType const & region,
-                   int level,
-                   size_t maxRanges):
-        Base(ranges, region, level, maxRanges)
+    HtmPixelFinder(RegionType const & region,
+                   detail::PixelSink<false> & envelope,
+                   detail::PixelSink<true> & interior,
+                   TraversalStats * stats):
+        Base(region, envelope, interior, stats)
     {}
 
     void operator()() {
@@ -121,6 +121,10 @@ int HtmPixelization::level(uint64_t i) {
 }
 
 ConvexPolygon HtmPixelization::triangle(uint64_t i) {
+    return fixedTriangle(i).toConvexPolygon();
+}
+
+FixedConvexPolygon<3> HtmPixelization::fixedTriangle(uint64_t i) {
     int l = level(i);
     if (l < 0 || l > MAX_LEVEL) {
         throw std::invalid_argument("Invalid HTM index");
@@ -142,7 +146,7 @@ ConvexPolygon HtmPixelization::triangle(uint64_t i) {
             case 3: v0 = m12; v1 = m20; v2 = m01; break;
         }
     }
-    return ConvexPolygon(v0, v1, v2);
+    return FixedConvexPolygon<3>(v0, v1, v2);
 }
 
 std::string HtmPixelization::asString(uint64_t i) {
@@ -216,12 +220,112 @@ uint64_t HtmPixelization::index(UnitVector3d const & v) const {
     return i;
 }
 
-RangeSet HtmPixelization::_envelope(Region const & r, size_t maxRanges) const {
-    return detail::findPixels<HtmPixelFinder, false>(r, maxRanges, _level);
+RangeSet HtmPixelization::envelope(Box const & r,
+                                   size_t maxRanges,
+                                   Coarsening coarsening,
+                                   TraversalStats * stats) const
+{
+    return detail::findPixels<HtmPixelFinder, false>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet HtmPixelization::envelope(Circle const & r,
+                                   size_t maxRanges,
+                                   Coarsening coarsening,
+                                   TraversalStats * stats) const
+{
+    return detail::findPixels<HtmPixelFinder, false>(
+        r, maxRanges, _level, coarsening, stats);
 }
 
-RangeSet HtmPixelization::_interior(Region const & r, size_t maxRanges) const {
-    return detail::findPixels<HtmPixelFinder, true>(r, maxRanges, _level);
+RangeSet HtmPixelization::envelope(ConvexPolygon const & r,
+                                   size_t maxRanges,
+                                   Coarsening coarsening,
+                                   TraversalStats * stats) const
+{
+    return detail::findPixels<HtmPixelFinder, false>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet HtmPixelization::interior(Box const & r,
+                                   size_t maxRanges,
+                                   Coarsening coarsening,
+                                   TraversalStats * stats) const
+{
+    return detail::findPixels<HtmPixelFinder, true>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet HtmPixelization::interior(Circle const & r,
+                                   size_t maxRanges,
+                                   Coarsening coarsening,
+                                   TraversalStats * stats) const
+{
+    return detail::findPixels<HtmPixelFinder, true>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet HtmPixelization::interior(ConvexPolygon const & r,
+                                   size_t maxRanges,
+                                   Coarsening coarsening,
+                                   TraversalStats * stats) const
+{
+    return detail::findPixels<HtmPixelFinder, true>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet HtmPixelization::_envelope(Region const & r,
+                                    size_t maxRanges,
+                                    Coarsening coarsening,
+                                    TraversalStats * stats) const
+{
+    return detail::findPixels<HtmPixelFinder, false>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet HtmPixelization::_interior(Region const & r,
+                                    size_t maxRanges,
+                                    Coarsening coarsening,
+                                    TraversalStats * stats) const
+{
+    return detail::findPixels<HtmPixelFinder, true>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+std::pair<RangeSet, RangeSet> HtmPixelization::_envelopeAndInterior(
+    Region const & r,
+    size_t maxRanges,
+    Coarsening coarsening,
+    TraversalStats * stats) const
+{
+    return detail::findEnvelopeAndInterior<HtmPixelFinder>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+MultiOrderCoverage HtmPixelization::envelopeCoverage(
+    Region const & r,
+    TraversalStats * stats) const
+{
+    return detail::findCoverage<HtmPixelFinder, false>(r, _level, stats);
+}
+
+MultiOrderCoverage HtmPixelization::interiorCoverage(
+    Region const & r,
+    TraversalStats * stats) const
+{
+    return detail::findCoverage<HtmPixelFinder, true>(r, _level, stats);
+}
+
+void HtmPixelization::_streamEnvelope(Region const & r,
+                                      RangeCallback const & callback) const
+{
+    detail::streamPixels<HtmPixelFinder, false>(r, _level, callback);
+}
+
+void HtmPixelization::_streamInterior(Region const & r,
+                                      RangeCallback const & callback) const
+{
+    detail::streamPixels<HtmPixelFinder, true>(r, _level, callback);
 }
 
 }} // namespace lsst::sphgeom
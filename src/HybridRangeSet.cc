@@ -0,0 +1,903 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains the HybridRangeSet implementation.
+
+#include "lsst/sphgeom/HybridRangeSet.h"
+
+#include <algorithm>
+#include <ostream>
+
+
+namespace lsst {
+namespace sphgeom {
+
+namespace {
+
+constexpr uint64_t MAX_VALUE = ~static_cast<uint64_t>(0);
+constexpr uint64_t OFFSET_MASK = 0xffff;
+constexpr uint32_t BLOCK_SIZE = 1 << HybridRangeSet::BLOCK_BITS;
+constexpr size_t NUM_WORDS = BLOCK_SIZE / 64;
+constexpr size_t BITMAP_BYTES = BLOCK_SIZE / 8;
+constexpr uint64_t NUM_BLOCKS = static_cast<uint64_t>(1)
+                                << (64 - HybridRangeSet::BLOCK_BITS);
+
+inline int countTrailingZeros(uint64_t w) { return __builtin_ctzll(w); }
+
+inline int popCount(uint64_t w) { return __builtin_popcountll(w); }
+
+// `countRuns` returns the number of maximal runs of 1 bits in a bitmap.
+size_t countRuns(uint64_t const * words) {
+    size_t n = 0;
+    uint64_t carry = 0;
+    for (size_t i = 0; i < NUM_WORDS; ++i) {
+        uint64_t w = words[i];
+        // A run starts at every 1 bit whose predecessor is a 0 bit.
+        n += popCount(w & ~((w << 1) | carry));
+        carry = w >> 63;
+    }
+    return n;
+}
+
+// The set operations below are evaluated both on membership flags and,
+// for pairs of bitmap containers, on 64 bit words. They must all map
+// (false, false) to false.
+struct IntersectionOp {
+    bool operator()(bool a, bool b) const { return a && b; }
+    uint64_t operator()(uint64_t a, uint64_t b) const { return a & b; }
+};
+
+struct UnionOp {
+    bool operator()(bool a, bool b) const { return a || b; }
+    uint64_t operator()(uint64_t a, uint64_t b) const { return a | b; }
+};
+
+struct DifferenceOp {
+    bool operator()(bool a, bool b) const { return a && !b; }
+    uint64_t operator()(uint64_t a, uint64_t b) const { return a & ~b; }
+};
+
+struct SymmetricDifferenceOp {
+    bool operator()(bool a, bool b) const { return a != b; }
+    uint64_t operator()(uint64_t a, uint64_t b) const { return a ^ b; }
+};
+
+} // unnamed namespace
+
+
+// `Cursor` iterates over the ranges of integers in a sequence of containers
+// in ascending order. Ranges are inclusive; adjacent ranges from different
+// containers are not merged.
+class HybridRangeSet::Cursor {
+public:
+    Cursor(Container const * begin, Container const * end) :
+        _c{begin}, _end{end}
+    {
+        _load();
+    }
+
+    bool valid() const { return _valid; }
+    uint64_t first() const { return _first; }
+    uint64_t last() const { return _last; }
+
+    // `container` returns the container holding the current range.
+    Container const * container() const { return _c; }
+
+    // `atContainerStart` returns true if the current range is the first
+    // range of its container.
+    bool atContainerStart() const { return _atStart; }
+
+    void next() { _load(); }
+
+    void skipContainer() {
+        ++_c;
+        _pos = 0;
+        _load();
+    }
+
+private:
+    Container const * _c;
+    Container const * _end;
+    size_t _pos = 0;
+    uint64_t _first = 0;
+    uint64_t _last = 0;
+    bool _valid = true;
+    bool _atStart = false;
+
+    void _load();
+};
+
+void HybridRangeSet::Cursor::_load() {
+    for (; _c != _end; ++_c, _pos = 0) {
+        Container const & c = *_c;
+        uint64_t const base = c.key << BLOCK_BITS;
+        _atStart = (_pos == 0);
+        switch (c.kind) {
+            case Kind::FULL:
+                if (_pos == 0) {
+                    _first = base;
+                    // Note that this wraps to 2^64 - 1 for the last block.
+                    _last = ((c.key + c.numBlocks) << BLOCK_BITS) - 1;
+                    _pos = 1;
+                    return;
+                }
+                break;
+            case Kind::RUN:
+                if (_pos < c.values.size()) {
+                    _first = base + c.values[_pos];
+                    _last = base + c.values[_pos + 1];
+                    _pos += 2;
+                    return;
+                }
+                break;
+            case Kind::ARRAY:
+                if (_pos < c.values.size()) {
+                    size_t j = _pos + 1;
+                    while (j < c.values.size() &&
+                           c.values[j] == c.values[j - 1] + 1) {
+                        ++j;
+                    }
+                    _first = base + c.values[_pos];
+                    _last = base + c.values[j - 1];
+                    _pos = j;
+                    return;
+                }
+                break;
+            case Kind::BITMAP:
+                if (_pos < BLOCK_SIZE) {
+                    // Find the next 1 bit.
+                    size_t w = _pos >> 6;
+                    uint64_t bits = c.words[w] & (MAX_VALUE << (_pos & 63));
+                    while (bits == 0 && ++w < NUM_WORDS) {
+                        bits = c.words[w];
+                    }
+                    if (w == NUM_WORDS) {
+                        break;
+                    }
+                    size_t b = (w << 6) + countTrailingZeros(bits);
+                    // Find the next 0 bit.
+                    bits = ~c.words[w] & (MAX_VALUE << (b & 63));
+                    while (bits == 0 && ++w < NUM_WORDS) {
+                        bits = ~c.words[w];
+                    }
+                    size_t e = (w == NUM_WORDS) ? BLOCK_SIZE :
+                               (w << 6) + countTrailingZeros(bits);
+                    _first = base + b;
+                    _last = base + (e - 1);
+                    _pos = e;
+                    return;
+                }
+                break;
+        }
+    }
+    _valid = false;
+}
+
+
+// `Builder` appends ascending ranges of integers to a container vector,
+// merging adjacent ranges and choosing the smallest encoding for each block.
+class HybridRangeSet::Builder {
+public:
+    explicit Builder(std::vector<Container> & out) : _out(out) {}
+
+    // `resume` re-opens the last container of the output vector,
+    // so that subsequently appended integers can be added to its block.
+    void resume();
+
+    // `append` adds the inclusive range [first, last] to the output. The
+    // range must follow all previously appended integers.
+    void append(uint64_t first, uint64_t last) {
+        if (_havePending && _pendingLast != MAX_VALUE &&
+            first <= _pendingLast + 1) {
+            _pendingLast = std::max(_pendingLast, last);
+            return;
+        }
+        _flushPending();
+        _havePending = true;
+        _pendingFirst = first;
+        _pendingLast = last;
+    }
+
+    // `appendBlock` adds the block with the given key and bits to the
+    // output. The block must follow all previously appended integers.
+    void appendBlock(uint64_t key, uint64_t const * words);
+
+    void finish() {
+        _flushPending();
+        _flushBlock();
+    }
+
+private:
+    std::vector<Container> & _out;
+    bool _havePending = false;
+    uint64_t _pendingFirst = 0;
+    uint64_t _pendingLast = 0;
+    bool _haveBlock = false;
+    uint64_t _blockKey = 0;
+    // Inclusive (first, last) offset pairs for the current block.
+    std::vector<uint16_t> _runs;
+
+    void _flushPending() {
+        if (_havePending) {
+            _emit(_pendingFirst, _pendingLast);
+            _havePending = false;
+        }
+    }
+
+    void _emit(uint64_t first, uint64_t last);
+    void _addToBlock(uint64_t key, uint16_t lo, uint16_t hi);
+    void _addFull(uint64_t firstKey, uint64_t lastKey);
+    void _flushBlock();
+};
+
+void HybridRangeSet::Builder::resume() {
+    if (_out.empty() || _out.back().kind == Kind::FULL) {
+        return;
+    }
+    Container const & c = _out.back();
+    uint64_t const base = c.key << BLOCK_BITS;
+    _blockKey = c.key;
+    _haveBlock = true;
+    _runs.clear();
+    Cursor cursor(&c, &c + 1);
+    for (; cursor.valid(); cursor.next()) {
+        _runs.push_back(static_cast<uint16_t>(cursor.first() - base));
+        _runs.push_back(static_cast<uint16_t>(cursor.last() - base));
+    }
+    _out.pop_back();
+    // Make the last run pending, so that it can be merged with an
+    // adjacent range.
+    _havePending = true;
+    _pendingFirst = base + _runs[_runs.size() - 2];
+    _pendingLast = base + _runs.back();
+    _runs.resize(_runs.size() - 2);
+    if (_runs.empty()) {
+        _haveBlock = false;
+    }
+}
+
+void HybridRangeSet::Builder::appendBlock(uint64_t key,
+                                          uint64_t const * words)
+{
+    _flushPending();
+    _flushBlock();
+    uint32_t cardinality = 0;
+    for (size_t i = 0; i < NUM_WORDS; ++i) {
+        cardinality += popCount(words[i]);
+    }
+    if (cardinality == 0) {
+        return;
+    }
+    if (cardinality == BLOCK_SIZE) {
+        _addFull(key, key);
+        return;
+    }
+    size_t numRuns = countRuns(words);
+    if (4 * numRuns <= BITMAP_BYTES || 2 * cardinality <= BITMAP_BYTES) {
+        // The block is smaller as a run or array container. Convert it to
+        // runs and let _flushBlock pick the encoding.
+        Container tmp;
+        tmp.key = key;
+        tmp.kind = Kind::BITMAP;
+        tmp.words.assign(words, words + NUM_WORDS);
+        uint64_t const base = key << BLOCK_BITS;
+        _blockKey = key;
+        _haveBlock = true;
+        for (Cursor c(&tmp, &tmp + 1); c.valid(); c.next()) {
+            _runs.push_back(static_cast<uint16_t>(c.first() - base));
+            _runs.push_back(static_cast<uint16_t>(c.last() - base));
+        }
+        _flushBlock();
+        return;
+    }
+    _out.emplace_back();
+    Container & c = _out.back();
+    c.key = key;
+    c.cardinality = cardinality;
+    c.kind = Kind::BITMAP;
+    c.words.assign(words, words + NUM_WORDS);
+}
+
+void HybridRangeSet::Builder::_emit(uint64_t first, uint64_t last) {
+    uint64_t kf = first >> BLOCK_BITS;
+    uint64_t kl = last >> BLOCK_BITS;
+    uint16_t lo = static_cast<uint16_t>(first & OFFSET_MASK);
+    uint16_t hi = static_cast<uint16_t>(last & OFFSET_MASK);
+    if (kf == kl) {
+        _addToBlock(kf, lo, hi);
+        return;
+    }
+    if (lo != 0) {
+        _addToBlock(kf, lo, static_cast<uint16_t>(OFFSET_MASK));
+        ++kf;
+    }
+    if (hi != OFFSET_MASK) {
+        if (kf < kl) {
+            _addFull(kf, kl - 1);
+        }
+        _addToBlock(kl, 0, hi);
+    } else {
+        _addFull(kf, kl);
+    }
+}
+
+void HybridRangeSet::Builder::_addToBlock(uint64_t key,
+                                          uint16_t lo,
+                                          uint16_t hi)
+{
+    if (lo == 0 && hi == OFFSET_MASK) {
+        _addFull(key, key);
+        return;
+    }
+    if (_haveBlock && key != _blockKey) {
+        _flushBlock();
+    }
+    _haveBlock = true;
+    _blockKey = key;
+    _runs.push_back(lo);
+    _runs.push_back(hi);
+}
+
+void HybridRangeSet::Builder::_addFull(uint64_t firstKey, uint64_t lastKey) {
+    _flushBlock();
+    if (!_out.empty()) {
+        Container & c = _out.back();
+        if (c.kind == Kind::FULL && c.key + c.numBlocks == firstKey) {
+            c.numBlocks += lastKey - firstKey + 1;
+            return;
+        }
+    }
+    _out.emplace_back();
+    Container & c = _out.back();
+    c.key = firstKey;
+    c.numBlocks = lastKey - firstKey + 1;
+    c.kind = Kind::FULL;
+}
+
+void HybridRangeSet::Builder::_flushBlock() {
+    if (!_haveBlock) {
+        return;
+    }
+    _haveBlock = false;
+    size_t const numRuns = _runs.size() / 2;
+    uint32_t cardinality = 0;
+    for (size_t i = 0; i < _runs.size(); i += 2) {
+        cardinality += static_cast<uint32_t>(_runs[i + 1] - _runs[i]) + 1;
+    }
+    _out.emplace_back();
+    Container & c = _out.back();
+    c.key = _blockKey;
+    c.cardinality = cardinality;
+    if (4 * numRuns <= 2 * cardinality && 4 * numRuns <= BITMAP_BYTES) {
+        c.kind = Kind::RUN;
+        c.values.assign(_runs.begin(), _runs.end());
+    } else if (2 * cardinality <= BITMAP_BYTES) {
+        c.kind = Kind::ARRAY;
+        c.values.reserve(cardinality);
+        for (size_t i = 0; i < _runs.size(); i += 2) {
+            for (uint32_t v = _runs[i]; v <= _runs[i + 1]; ++v) {
+                c.values.push_back(static_cast<uint16_t>(v));
+            }
+        }
+    } else {
+        c.kind = Kind::BITMAP;
+        c.words.assign(NUM_WORDS, 0);
+        for (size_t i = 0; i < _runs.size(); i += 2) {
+            for (uint32_t v = _runs[i]; v <= _runs[i + 1]; ++v) {
+                c.words[v >> 6] |= static_cast<uint64_t>(1) << (v & 63);
+            }
+        }
+    }
+    _runs.clear();
+}
+
+
+bool HybridRangeSet::Container::contains(uint16_t offset) const {
+    switch (kind) {
+        case Kind::FULL:
+            return true;
+        case Kind::RUN: {
+            // Find the last run with a first element <= offset.
+            size_t lo = 0;
+            size_t hi = values.size() / 2;
+            while (lo < hi) {
+                size_t mid = (lo + hi) / 2;
+                if (values[2 * mid] <= offset) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            return lo > 0 && offset <= values[2 * lo - 1];
+        }
+        case Kind::ARRAY:
+            return std::binary_search(values.begin(), values.end(), offset);
+        case Kind::BITMAP:
+            return ((words[offset >> 6] >> (offset & 63)) & 1) != 0;
+    }
+    return false;
+}
+
+
+template <typename Op>
+void HybridRangeSet::_combine(std::vector<Container> & out,
+                              HybridRangeSet const & a,
+                              HybridRangeSet const & b,
+                              Op op)
+{
+    Builder builder(out);
+    Cursor ca(a._containers.data(), a._containers.data() + a._containers.size());
+    Cursor cb(b._containers.data(), b._containers.data() + b._containers.size());
+    uint64_t words[NUM_WORDS];
+    // Sweep through the beginning and end points of the ranges from A and B
+    // in ascending order. The sweep position pos is the first integer that
+    // has not been classified yet.
+    uint64_t pos = 0;
+    while (ca.valid() || cb.valid()) {
+        if (ca.valid() && cb.valid() &&
+            ca.atContainerStart() && cb.atContainerStart() &&
+            ca.container()->kind == Kind::BITMAP &&
+            cb.container()->kind == Kind::BITMAP &&
+            ca.container()->key == cb.container()->key) {
+            // Both sets have a bitmap for the same block, and the sweep
+            // has not entered it yet. Process it word by word.
+            Container const * x = ca.container();
+            Container const * y = cb.container();
+            for (size_t i = 0; i < NUM_WORDS; ++i) {
+                words[i] = op(x->words[i], y->words[i]);
+            }
+            builder.appendBlock(x->key, words);
+            uint64_t blockLast = (x->key << BLOCK_BITS) + OFFSET_MASK;
+            ca.skipContainer();
+            cb.skipContainer();
+            if (blockLast == MAX_VALUE) {
+                break;
+            }
+            pos = blockLast + 1;
+            continue;
+        }
+        bool inA = ca.valid() && ca.first() <= pos;
+        bool inB = cb.valid() && cb.first() <= pos;
+        // Find the end of the segment starting at pos on which membership
+        // in A and B is constant.
+        uint64_t segLast = MAX_VALUE;
+        if (ca.valid()) {
+            segLast = std::min(segLast, inA ? ca.last() : ca.first() - 1);
+        }
+        if (cb.valid()) {
+            segLast = std::min(segLast, inB ? cb.last() : cb.first() - 1);
+        }
+        if (op(inA, inB)) {
+            builder.append(pos, segLast);
+        }
+        if (segLast == MAX_VALUE) {
+            break;
+        }
+        pos = segLast + 1;
+        if (ca.valid() && ca.last() < pos) {
+            ca.next();
+        }
+        if (cb.valid() && cb.last() < pos) {
+            cb.next();
+        }
+    }
+    builder.finish();
+}
+
+template <typename Op>
+bool HybridRangeSet::_any(Container const * aBegin, Container const * aEnd,
+                          Container const * bBegin, Container const * bEnd,
+                          Op op)
+{
+    // This is the same sweep as in _combine, except that it stops as soon
+    // as an integer satisfying op is found.
+    Cursor ca(aBegin, aEnd);
+    Cursor cb(bBegin, bEnd);
+    uint64_t pos = 0;
+    while (ca.valid() || cb.valid()) {
+        if (ca.valid() && cb.valid() &&
+            ca.atContainerStart() && cb.atContainerStart() &&
+            ca.container()->kind == Kind::BITMAP &&
+            cb.container()->kind == Kind::BITMAP &&
+            ca.container()->key == cb.container()->key) {
+            Container const * x = ca.container();
+            Container const * y = cb.container();
+            for (size_t i = 0; i < NUM_WORDS; ++i) {
+                if (op(x->words[i], y->words[i]) != 0) {
+                    return true;
+                }
+            }
+            uint64_t blockLast = (x->key << BLOCK_BITS) + OFFSET_MASK;
+            ca.skipContainer();
+            cb.skipContainer();
+            if (blockLast == MAX_VALUE) {
+                break;
+            }
+            pos = blockLast + 1;
+            continue;
+        }
+        bool inA = ca.valid() && ca.first() <= pos;
+        bool inB = cb.valid() && cb.first() <= pos;
+        if (op(inA, inB)) {
+            return true;
+        }
+        uint64_t segLast = MAX_VALUE;
+        if (ca.valid()) {
+            segLast = std::min(segLast, inA ? ca.last() : ca.first() - 1);
+        }
+        if (cb.valid()) {
+            segLast = std::min(segLast, inB ? cb.last() : cb.first() - 1);
+        }
+        if (segLast == MAX_VALUE) {
+            break;
+        }
+        pos = segLast + 1;
+        if (ca.valid() && ca.last() < pos) {
+            ca.next();
+        }
+        if (cb.valid() && cb.last() < pos) {
+            cb.next();
+        }
+    }
+    return false;
+}
+
+
+HybridRangeSet::HybridRangeSet(RangeSet const & s) {
+    Builder builder(_containers);
+    for (auto const & t: s) {
+        builder.append(std::get<0>(t), std::get<1>(t) - 1);
+    }
+    builder.finish();
+}
+
+RangeSet HybridRangeSet::toRangeSet() const {
+    RangeSet s;
+    Cursor c(_containers.data(), _containers.data() + _containers.size());
+    for (; c.valid(); c.next()) {
+        // Note that RangeSet represents an end point of 2^64 as 0.
+        s.insert(c.first(), c.last() + 1);
+    }
+    return s;
+}
+
+void HybridRangeSet::insert(uint64_t first, uint64_t last) {
+    if (first == last) {
+        fill();
+        return;
+    }
+    if (first > last - 1) {
+        // [first, last) wraps around.
+        HybridRangeSet s(first, 0);
+        s.insert(0, last);
+        *this = join(s);
+        return;
+    }
+    last -= 1;
+    if (!_containers.empty()) {
+        // Check whether [first, last] follows every integer in this set.
+        Container const & c = _containers.back();
+        uint64_t const base = c.key << BLOCK_BITS;
+        uint64_t max = 0;
+        switch (c.kind) {
+            case Kind::FULL:
+                max = ((c.key + c.numBlocks) << BLOCK_BITS) - 1;
+                break;
+            case Kind::RUN:
+            case Kind::ARRAY:
+                max = base + c.values.back();
+                break;
+            case Kind::BITMAP: {
+                size_t w = NUM_WORDS - 1;
+                while (c.words[w] == 0) {
+                    --w;
+                }
+                max = base + (w << 6) + (63 - __builtin_clzll(c.words[w]));
+                break;
+            }
+        }
+        if (first <= max) {
+            HybridRangeSet s;
+            Builder builder(s._containers);
+            builder.append(first, last);
+            builder.finish();
+            *this = join(s);
+            return;
+        }
+    }
+    Builder builder(_containers);
+    builder.resume();
+    builder.append(first, last);
+    builder.finish();
+}
+
+HybridRangeSet & HybridRangeSet::complement() {
+    HybridRangeSet s;
+    s.fill();
+    *this = s.difference(*this);
+    return *this;
+}
+
+HybridRangeSet HybridRangeSet::intersection(HybridRangeSet const & s) const {
+    HybridRangeSet result;
+    if (this == &s) {
+        result = s;
+    } else {
+        _combine(result._containers, *this, s, IntersectionOp());
+    }
+    return result;
+}
+
+HybridRangeSet HybridRangeSet::join(HybridRangeSet const & s) const {
+    HybridRangeSet result;
+    if (this == &s) {
+        result = s;
+    } else {
+        _combine(result._containers, *this, s, UnionOp());
+    }
+    return result;
+}
+
+HybridRangeSet HybridRangeSet::difference(HybridRangeSet const & s) const {
+    HybridRangeSet result;
+    if (this != &s) {
+        _combine(result._containers, *this, s, DifferenceOp());
+    }
+    return result;
+}
+
+HybridRangeSet HybridRangeSet::symmetricDifference(
+    HybridRangeSet const & s) const
+{
+    HybridRangeSet result;
+    if (this != &s) {
+        _combine(result._containers, *this, s, SymmetricDifferenceOp());
+    }
+    return result;
+}
+
+void HybridRangeSet::_slice(uint64_t first, uint64_t last,
+                            Container const ** begin,
+                            Container const ** end) const
+{
+    uint64_t const firstKey = first >> BLOCK_BITS;
+    uint64_t const lastKey = last >> BLOCK_BITS;
+    Container const * b = _containers.data();
+    Container const * e = b + _containers.size();
+    // Skip containers with a last block < firstKey, and containers with
+    // a first block > lastKey.
+    b = std::lower_bound(b, e, firstKey,
+        [](Container const & c, uint64_t k) {
+            return c.key + (c.numBlocks - 1) < k;
+        });
+    e = std::upper_bound(b, e, lastKey,
+        [](uint64_t k, Container const & c) { return k < c.key; });
+    *begin = b;
+    *end = e;
+}
+
+bool HybridRangeSet::intersects(uint64_t first, uint64_t last) const {
+    HybridRangeSet s(first, last);
+    Container const * sb = s._containers.data();
+    Container const * se = sb + s._containers.size();
+    if (sb == se) {
+        return false;
+    }
+    Container const * b;
+    Container const * e;
+    if (first == last || first > last - 1) {
+        // Full or wrapping ranges are not worth slicing.
+        b = _containers.data();
+        e = b + _containers.size();
+    } else {
+        _slice(first, last - 1, &b, &e);
+    }
+    return _any(b, e, sb, se, IntersectionOp());
+}
+
+bool HybridRangeSet::intersects(HybridRangeSet const & s) const {
+    Container const * b = _containers.data();
+    Container const * sb = s._containers.data();
+    return _any(b, b + _containers.size(),
+                sb, sb + s._containers.size(),
+                IntersectionOp());
+}
+
+bool HybridRangeSet::contains(uint64_t u) const {
+    uint64_t const key = u >> BLOCK_BITS;
+    // Find the first container with a last block >= key.
+    auto c = std::lower_bound(
+        _containers.begin(), _containers.end(), key,
+        [](Container const & c, uint64_t k) {
+            return c.key + (c.numBlocks - 1) < k;
+        });
+    if (c == _containers.end() || c->key > key) {
+        return false;
+    }
+    return c->contains(static_cast<uint16_t>(u & OFFSET_MASK));
+}
+
+bool HybridRangeSet::contains(uint64_t first, uint64_t last) const {
+    HybridRangeSet s(first, last);
+    Container const * sb = s._containers.data();
+    Container const * se = sb + s._containers.size();
+    Container const * b;
+    Container const * e;
+    if (first == last || first > last - 1) {
+        b = _containers.data();
+        e = b + _containers.size();
+    } else {
+        _slice(first, last - 1, &b, &e);
+    }
+    return !_any(sb, se, b, e, DifferenceOp());
+}
+
+bool HybridRangeSet::contains(HybridRangeSet const & s) const {
+    Container const * b = _containers.data();
+    Container const * sb = s._containers.data();
+    return !_any(sb, sb + s._containers.size(),
+                 b, b + _containers.size(),
+                 DifferenceOp());
+}
+
+void HybridRangeSet::fill() {
+    _containers.clear();
+    _containers.emplace_back();
+    _containers.back().numBlocks = NUM_BLOCKS;
+}
+
+bool HybridRangeSet::full() const {
+    return _containers.size() == 1 &&
+           _containers[0].kind == Kind::FULL &&
+           _containers[0].numBlocks == NUM_BLOCKS;
+}
+
+uint64_t HybridRangeSet::cardinality() const {
+    uint64_t n = 0;
+    for (Container const & c: _containers) {
+        if (c.kind == Kind::FULL) {
+            n += c.numBlocks << BLOCK_BITS;
+        } else {
+            n += c.cardinality;
+        }
+    }
+    return n;
+}
+
+size_t HybridRangeSet::getNumRanges() const {
+    size_t n = 0;
+    uint64_t prevLast = 0;
+    Cursor c(_containers.data(), _containers.data() + _containers.size());
+    for (; c.valid(); c.next()) {
+        if (n == 0 || c.first() != prevLast + 1) {
+            ++n;
+        }
+        prevLast = c.last();
+    }
+    return n;
+}
+
+size_t HybridRangeSet::getMemoryUsage() const {
+    size_t n = _containers.capacity() * sizeof(Container);
+    for (Container const & c: _containers) {
+        n += c.values.capacity() * sizeof(uint16_t) +
+             c.words.capacity() * sizeof(uint64_t);
+    }
+    return n;
+}
+
+bool HybridRangeSet::isValid() const {
+    Container const * prev = nullptr;
+    for (Container const & c: _containers) {
+        if (prev != nullptr) {
+            // Containers must be sorted and disjoint, and adjacent full
+            // blocks must be merged.
+            uint64_t prevEnd = prev->key + prev->numBlocks;
+            if (c.key < prevEnd ||
+                (c.key == prevEnd && c.kind == Kind::FULL &&
+                 prev->kind == Kind::FULL)) {
+                return false;
+            }
+        }
+        prev = &c;
+        if (c.kind == Kind::FULL) {
+            if (c.numBlocks == 0 || c.key + c.numBlocks > NUM_BLOCKS ||
+                !c.values.empty() || !c.words.empty()) {
+                return false;
+            }
+            continue;
+        }
+        if (c.numBlocks != 1 || c.key >= NUM_BLOCKS) {
+            return false;
+        }
+        // Recompute the number of runs and the cardinality.
+        size_t numRuns = 0;
+        uint32_t cardinality = 0;
+        if (c.kind == Kind::RUN) {
+            if (c.values.empty() || (c.values.size() & 1) != 0 ||
+                !c.words.empty()) {
+                return false;
+            }
+            for (size_t i = 0; i < c.values.size(); i += 2) {
+                if (c.values[i] > c.values[i + 1] ||
+                    (i > 0 && c.values[i] <= c.values[i - 1] + 1)) {
+                    return false;
+                }
+                cardinality += c.values[i + 1] - c.values[i] + 1;
+            }
+            numRuns = c.values.size() / 2;
+        } else if (c.kind == Kind::ARRAY) {
+            if (c.values.empty() || !c.words.empty()) {
+                return false;
+            }
+            for (size_t i = 0; i < c.values.size(); ++i) {
+                if (i > 0 && c.values[i] <= c.values[i - 1]) {
+                    return false;
+                }
+                if (i == 0 || c.values[i] != c.values[i - 1] + 1) {
+                    ++numRuns;
+                }
+            }
+            cardinality = static_cast<uint32_t>(c.values.size());
+        } else {
+            if (c.words.size() != NUM_WORDS || !c.values.empty()) {
+                return false;
+            }
+            for (uint64_t w: c.words) {
+                cardinality += popCount(w);
+            }
+            numRuns = countRuns(c.words.data());
+        }
+        if (cardinality != c.cardinality || cardinality == 0 ||
+            cardinality == BLOCK_SIZE) {
+            return false;
+        }
+        // The encoding must be the smallest one.
+        Kind kind = Kind::BITMAP;
+        if (4 * numRuns <= 2 * cardinality && 4 * numRuns <= BITMAP_BYTES) {
+            kind = Kind::RUN;
+        } else if (2 * cardinality <= BITMAP_BYTES) {
+            kind = Kind::ARRAY;
+        }
+        if (kind != c.kind) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::ostream & operator<<(std::ostream & os, HybridRangeSet const & s) {
+    os << "{\"HybridRangeSet\": [";
+    bool first = true;
+    for (auto const & t: s.toRangeSet()) {
+        if (!first) {
+            os << ", ";
+        }
+        first = false;
+        os << '[' << std::get<0>(t) << ", " << std::get<1>(t) << ']';
+    }
+    os << "]}";
+    return os;
+}
+
+}} // namespace lsst::sphgeom
@@ -0,0 +1,73 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains instruction set detection and selection.
+
+#include "lsst/sphgeom/InstructionSet.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "Simd.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+namespace {
+
+InstructionSet detect() {
+#if LSST_SPHGEOM_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return InstructionSet::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return InstructionSet::AVX2;
+    }
+#endif
+    return InstructionSet::SCALAR;
+}
+
+InstructionSet const SUPPORTED = detect();
+
+std::atomic<int> current{static_cast<int>(SUPPORTED)};
+
+} // unnamed namespace
+
+
+InstructionSet getSupportedInstructionSet() {
+    return SUPPORTED;
+}
+
+InstructionSet getInstructionSet() {
+    return static_cast<InstructionSet>(current.load(std::memory_order_relaxed));
+}
+
+InstructionSet setInstructionSet(InstructionSet s) {
+    s = std::min(s, SUPPORTED);
+    current.store(static_cast<int>(s), std::memory_order_relaxed);
+    return s;
+}
+
+}} // namespace lsst::sphgeom
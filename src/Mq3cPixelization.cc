@@ -204,11 +204,11 @@ private:
     using Base::visit;
 
 public:
-    Mq3cPixelFinder(RangeSet & ranges,
-                    RegionType const & region,
-                    int level,
-                    size_t maxRanges):
-        Base(ranges, region, level, maxRanges)
+    Mq3cPixelFinder(RegionType const & region,
+                    detail::PixelSink<false> & envelope,
+                    detail::PixelSink<true> & interior,
+                    TraversalStats * stats):
+        Base(region, envelope, interior, stats)
     {}
 
     void operator()() {
@@ -248,13 +248,17 @@ int Mq3cPixelization::level(uint64_t i) {
 }
 
 ConvexPolygon Mq3cPixelization::quad(uint64_t i) {
+    return fixedQuad(i).toConvexPolygon();
+}
+
+FixedConvexPolygon<4> Mq3cPixelization::fixedQuad(uint64_t i) {
     int l = level(i);
     if (l < 0 || l > MAX_LEVEL) {
         throw std::invalid_argument("Invalid modified-Q3C index");
     }
     UnitVector3d verts[4];
     makeQuad(i, l, verts);
-    return ConvexPolygon(verts[0], verts[1], verts[2], verts[3]);
+    return FixedConvexPolygon<4>(verts[0], verts[1], verts[2], verts[3]);
 }
 
 std::vector<uint64_t> Mq3cPixelization::neighborhood(uint64_t i) {
@@ -335,12 +339,112 @@ std::unique_ptr<Region> Mq3cPixelization::pixel(uint64_t i) const {
     }
 #endif
 
-RangeSet Mq3cPixelization::_envelope(Region const & r, size_t maxRanges) const {
-    return detail::findPixels<Mq3cPixelFinder, false>(r, maxRanges, _level);
+RangeSet Mq3cPixelization::envelope(Box const & r,
+                                    size_t maxRanges,
+                                    Coarsening coarsening,
+                                    TraversalStats * stats) const
+{
+    return detail::findPixels<Mq3cPixelFinder, false>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet Mq3cPixelization::envelope(Circle const & r,
+                                    size_t maxRanges,
+                                    Coarsening coarsening,
+                                    TraversalStats * stats) const
+{
+    return detail::findPixels<Mq3cPixelFinder, false>(
+        r, maxRanges, _level, coarsening, stats);
 }
 
-RangeSet Mq3cPixelization::_interior(Region const & r, size_t maxRanges) const {
-    return detail::findPixels<Mq3cPixelFinder, true>(r, maxRanges, _level);
+RangeSet Mq3cPixelization::envelope(ConvexPolygon const & r,
+                                    size_t maxRanges,
+                                    Coarsening coarsening,
+                                    TraversalStats * stats) const
+{
+    return detail::findPixels<Mq3cPixelFinder, false>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet Mq3cPixelization::interior(Box const & r,
+                                    size_t maxRanges,
+                                    Coarsening coarsening,
+                                    TraversalStats * stats) const
+{
+    return detail::findPixels<Mq3cPixelFinder, true>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet Mq3cPixelization::interior(Circle const & r,
+                                    size_t maxRanges,
+                                    Coarsening coarsening,
+                                    TraversalStats * stats) const
+{
+    return detail::findPixels<Mq3cPixelFinder, true>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet Mq3cPixelization::interior(ConvexPolygon const & r,
+                                    size_t maxRanges,
+                                    Coarsening coarsening,
+                                    TraversalStats * stats) const
+{
+    return detail::findPixels<Mq3cPixelFinder, true>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet Mq3cPixelization::_envelope(Region const & r,
+                                     size_t maxRanges,
+                                     Coarsening coarsening,
+                                     TraversalStats * stats) const
+{
+    return detail::findPixels<Mq3cPixelFinder, false>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet Mq3cPixelization::_interior(Region const & r,
+                                     size_t maxRanges,
+                                     Coarsening coarsening,
+                                     TraversalStats * stats) const
+{
+    return detail::findPixels<Mq3cPixelFinder, true>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+std::pair<RangeSet, RangeSet> Mq3cPixelization::_envelopeAndInterior(
+    Region const & r,
+    size_t maxRanges,
+    Coarsening coarsening,
+    TraversalStats * stats) const
+{
+    return detail::findEnvelopeAndInterior<Mq3cPixelFinder>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+MultiOrderCoverage Mq3cPixelization::envelopeCoverage(
+    Region const & r,
+    TraversalStats * stats) const
+{
+    return detail::findCoverage<Mq3cPixelFinder, false>(r, _level, stats);
+}
+
+MultiOrderCoverage Mq3cPixelization::interiorCoverage(
+    Region const & r,
+    TraversalStats * stats) const
+{
+    return detail::findCoverage<Mq3cPixelFinder, true>(r, _level, stats);
+}
+
+void Mq3cPixelization::_streamEnvelope(Region const & r,
+                                       RangeCallback const & callback) const
+{
+    detail::streamPixels<Mq3cPixelFinder, false>(r, _level, callback);
+}
+
+void Mq3cPixelization::_streamInterior(Region const & r,
+                                       RangeCallback const & callback) const
+{
+    detail::streamPixels<Mq3cPixelFinder, true>(r, _level, callback);
 }
 
 }} // namespace lsst::sphgeom
@@ -0,0 +1,311 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains the MultiOrderCoverage class implementation.
+
+#include "lsst/sphgeom/MultiOrderCoverage.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+
+namespace lsst {
+namespace sphgeom {
+
+namespace {
+
+char const * const NOT_ENCODED =
+    "Byte-string is not an encoded MultiOrderCoverage";
+
+constexpr uint8_t TYPE_CODE = 'M';
+constexpr int MAX_LEVEL = MultiOrderCoverage::MAX_LEVEL;
+
+bool isValidLevel(int level) {
+    return level >= 0 && level <= MAX_LEVEL;
+}
+
+// `isValidCell` returns true if index < 16·4^level.
+bool isValidCell(int level, uint64_t index) {
+    return isValidLevel(level) &&
+           (2 * level + 4 >= 64 || (index >> (2 * level + 4)) == 0);
+}
+
+void checkLevel(int level) {
+    if (!isValidLevel(level)) {
+        throw std::invalid_argument("Invalid MultiOrderCoverage level");
+    }
+}
+
+void checkCell(int level, uint64_t index) {
+    checkLevel(level);
+    if (!isValidCell(level, index)) {
+        throw std::invalid_argument("Invalid MultiOrderCoverage cell index");
+    }
+}
+
+// `cellRange` returns the range of level MAX_LEVEL descendants of a cell.
+// The end of the range is 0 for the last cell of level 0.
+std::tuple<uint64_t, uint64_t> cellRange(int level, uint64_t index) {
+    int shift = 2 * (MAX_LEVEL - level);
+    return std::make_tuple(index << shift, (index + 1) << shift);
+}
+
+// `alignment` returns the number of trailing zero bit pairs of u, up to
+// MAX_LEVEL.
+int alignment(uint64_t u) {
+    int k = 0;
+    for (; k < MAX_LEVEL && (u & 3) == 0; ++k) {
+        u >>= 2;
+    }
+    return k;
+}
+
+// `forEachCell` calls f(level, index) for each normalized cell of the
+// level MAX_LEVEL range [first, last), in order. Each cell is the largest
+// aligned block of 4^k indexes starting at first that fits in the range.
+template <typename F>
+void forEachCell(uint64_t first, uint64_t last, F f) {
+    uint64_t n = last - first;
+    if (n == 0) {
+        // The range is full, and consists of 2^64 integers.
+        for (uint64_t i = 0; i < 16; ++i) {
+            f(0, i);
+        }
+        return;
+    }
+    while (n != 0) {
+        int k = 0;
+        while (k < MAX_LEVEL) {
+            uint64_t size = uint64_t(1) << (2 * k + 2);
+            if ((first & (size - 1)) != 0 || n < size) {
+                break;
+            }
+            ++k;
+        }
+        f(MAX_LEVEL - k, first >> (2 * k));
+        first += uint64_t(1) << (2 * k);
+        n -= uint64_t(1) << (2 * k);
+    }
+}
+
+void encodeVarint(uint64_t u, std::vector<uint8_t> & buffer) {
+    for (; u >= 0x80; u >>= 7) {
+        buffer.push_back(static_cast<uint8_t>(u | 0x80));
+    }
+    buffer.push_back(static_cast<uint8_t>(u));
+}
+
+uint64_t decodeVarint(uint8_t const * & buffer, uint8_t const * end) {
+    uint64_t u = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (buffer == end) {
+            break;
+        }
+        uint8_t b = *buffer++;
+        if (shift == 63 && b > 1) {
+            break;
+        }
+        u |= static_cast<uint64_t>(b & 0x7f) << shift;
+        if ((b & 0x80) == 0) {
+            return u;
+        }
+    }
+    throw std::runtime_error(NOT_ENCODED);
+}
+
+} // unnamed namespace
+
+
+MultiOrderCoverage MultiOrderCoverage::fromRangeSet(RangeSet const & s,
+                                                    int level)
+{
+    checkLevel(level);
+    if (2 * level + 4 < 64 &&
+        !s.isWithin(0, uint64_t(16) << (2 * level))) {
+        throw std::invalid_argument("Invalid MultiOrderCoverage cell index");
+    }
+    int shift = 2 * (MAX_LEVEL - level);
+    RangeSet ranges;
+    for (auto const & range: s) {
+        // The last range end is 2^64, or 0, if it is 16·4^level.
+        ranges.insert(std::get<0>(range) << shift,
+                      std::get<1>(range) << shift);
+    }
+    return MultiOrderCoverage(std::move(ranges));
+}
+
+void MultiOrderCoverage::insert(int level, uint64_t index) {
+    checkCell(level, index);
+    _ranges.insert(cellRange(level, index));
+}
+
+int MultiOrderCoverage::getMaxLevel() const {
+    if (_ranges.empty()) {
+        return -1;
+    }
+    // The finest cells of a range are those adjacent to its least aligned
+    // end point.
+    int level = 0;
+    for (auto const & range: _ranges) {
+        for (uint64_t u: {std::get<0>(range), std::get<1>(range)}) {
+            level = std::max(level, MAX_LEVEL - alignment(u));
+        }
+    }
+    return level;
+}
+
+std::vector<MultiOrderCoverage::Cell> MultiOrderCoverage::getCells() const {
+    std::vector<Cell> cells;
+    for (auto const & range: _ranges) {
+        forEachCell(std::get<0>(range), std::get<1>(range),
+                    [&cells](int level, uint64_t index) {
+                        cells.emplace_back(level, index);
+                    });
+    }
+    return cells;
+}
+
+size_t MultiOrderCoverage::getNumCells() const {
+    size_t n = 0;
+    for (auto const & range: _ranges) {
+        forEachCell(std::get<0>(range), std::get<1>(range),
+                    [&n](int, uint64_t) { ++n; });
+    }
+    return n;
+}
+
+bool MultiOrderCoverage::contains(int level, uint64_t index) const {
+    checkCell(level, index);
+    uint64_t first, last;
+    std::tie(first, last) = cellRange(level, index);
+    return _ranges.contains(first, last);
+}
+
+bool MultiOrderCoverage::intersects(int level, uint64_t index) const {
+    checkCell(level, index);
+    uint64_t first, last;
+    std::tie(first, last) = cellRange(level, index);
+    return _ranges.intersects(first, last);
+}
+
+RangeSet MultiOrderCoverage::toRangeSet(int level) const {
+    checkLevel(level);
+    int shift = 2 * (MAX_LEVEL - level);
+    if (shift == 0) {
+        return _ranges;
+    }
+    RangeSet s;
+    for (auto const & range: _ranges) {
+        uint64_t first = std::get<0>(range) >> shift;
+        uint64_t last = std::get<1>(range);
+        last = (last == 0) ? uint64_t(1) << (64 - shift)
+                           : ((last - 1) >> shift) + 1;
+        s.insert(first, last);
+    }
+    return s;
+}
+
+RangeSet MultiOrderCoverage::toInteriorRangeSet(int level) const {
+    checkLevel(level);
+    int shift = 2 * (MAX_LEVEL - level);
+    if (shift == 0) {
+        return _ranges;
+    }
+    uint64_t const mask = (uint64_t(1) << shift) - 1;
+    RangeSet s;
+    for (auto const & range: _ranges) {
+        uint64_t first = std::get<0>(range);
+        first = (first >> shift) + ((first & mask) != 0 ? 1 : 0);
+        uint64_t last = std::get<1>(range);
+        last = (last == 0) ? uint64_t(1) << (64 - shift) : last >> shift;
+        if (first < last) {
+            s.insert(first, last);
+        }
+    }
+    return s;
+}
+
+std::vector<uint8_t> MultiOrderCoverage::encode() const {
+    std::vector<std::vector<uint64_t>> levels(MAX_LEVEL + 1);
+    for (Cell const & c: getCells()) {
+        levels[c.first].push_back(c.second);
+    }
+    std::vector<uint8_t> buffer;
+    buffer.push_back(TYPE_CODE);
+    for (int level = 0; level <= MAX_LEVEL; ++level) {
+        std::vector<uint64_t> const & indexes = levels[level];
+        if (indexes.empty()) {
+            continue;
+        }
+        buffer.push_back(static_cast<uint8_t>(level));
+        encodeVarint(indexes.size(), buffer);
+        encodeVarint(indexes[0], buffer);
+        for (size_t i = 1; i < indexes.size(); ++i) {
+            encodeVarint(indexes[i] - indexes[i - 1], buffer);
+        }
+    }
+    return buffer;
+}
+
+MultiOrderCoverage MultiOrderCoverage::decode(uint8_t const * buffer,
+                                              size_t n)
+{
+    if (buffer == nullptr || n == 0 || buffer[0] != TYPE_CODE) {
+        throw std::runtime_error(NOT_ENCODED);
+    }
+    uint8_t const * end = buffer + n;
+    ++buffer;
+    RangeSet ranges;
+    int previousLevel = -1;
+    while (buffer != end) {
+        int level = *buffer++;
+        if (level > MAX_LEVEL || level <= previousLevel) {
+            throw std::runtime_error(NOT_ENCODED);
+        }
+        previousLevel = level;
+        uint64_t count = decodeVarint(buffer, end);
+        if (count == 0 || count > static_cast<uint64_t>(end - buffer)) {
+            throw std::runtime_error(NOT_ENCODED);
+        }
+        // Cells of a single level are increasing, so they can be inserted
+        // efficiently into a range set of their own.
+        RangeSet cells;
+        uint64_t index = 0;
+        for (uint64_t i = 0; i < count; ++i) {
+            uint64_t delta = decodeVarint(buffer, end);
+            if (i != 0 && (delta == 0 || index + delta < index)) {
+                throw std::runtime_error(NOT_ENCODED);
+            }
+            index += delta;
+            if (!isValidCell(level, index)) {
+                throw std::runtime_error(NOT_ENCODED);
+            }
+            cells.insert(cellRange(level, index));
+        }
+        ranges |= cells;
+    }
+    return MultiOrderCoverage(std::move(ranges));
+}
+
+}} // namespace lsst::sphgeom
@@ -0,0 +1,287 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains the PixelAggregates class implementation.
+
+#include "lsst/sphgeom/PixelAggregates.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+#include "ForEachSlice.h"
+#include "PixelizationType.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+using detail::forEachSlice;
+
+struct PixelAggregates::Cell {
+    uint64_t count = 0;
+    double sum = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void add(double w) {
+        ++count;
+        sum += w;
+        min = std::min(min, w);
+        max = std::max(max, w);
+    }
+
+    void add(Cell const & c) {
+        count += c.count;
+        sum += c.sum;
+        min = std::min(min, c.min);
+        max = std::max(max, c.max);
+    }
+};
+
+namespace {
+
+// Below this many pixels, each thread accumulates into a dense array
+// rather than a hash map.
+constexpr uint64_t MAX_DENSE_PIXELS = 1 << 16;
+
+std::pair<uint64_t, uint64_t> bounds(Pixelization const & p) {
+    auto const & r = *p.universe().begin();
+    return std::make_pair(std::get<0>(r), std::get<1>(r));
+}
+
+// `weightsFor` returns a pointer to the weights of the given points, or
+// null if there are none.
+double const * weightsFor(std::vector<UnitVector3d> const & points,
+                          std::vector<double> const & weights) {
+    if (weights.empty()) {
+        return nullptr;
+    }
+    if (weights.size() != points.size()) {
+        throw std::invalid_argument(
+            "The number of weights must equal the number of points");
+    }
+    return weights.data();
+}
+
+} // unnamed namespace
+
+
+PixelAggregates::PixelAggregates(Pixelization const & pixelization) {
+    _type = detail::getPixelizationType(pixelization, _level,
+                                        "PixelAggregates");
+    _pixelization = detail::makePixelization(_type, _level);
+}
+
+PixelAggregates::PixelAggregates(Pixelization const & pixelization,
+                                 UnitVector3d const * points,
+                                 double const * weights,
+                                 size_t n,
+                                 unsigned numThreads) :
+    PixelAggregates(pixelization)
+{
+    if (n == 0) {
+        return;
+    }
+    numThreads = static_cast<unsigned>(
+        std::max<size_t>(1, std::min<size_t>(numThreads, n)));
+    uint64_t first, last;
+    std::tie(first, last) = bounds(*_pixelization);
+    Pixelization const & p = *_pixelization;
+    std::vector<std::pair<uint64_t, Cell>> cells;
+    if (last - first <= MAX_DENSE_PIXELS) {
+        std::vector<std::vector<Cell>> partials(
+            numThreads, std::vector<Cell>(last - first));
+        forEachSlice(n, numThreads, [&](unsigned t, size_t b, size_t e) {
+            std::vector<Cell> & partial = partials[t];
+            for (size_t i = b; i < e; ++i) {
+                partial[p.index(points[i]) - first].add(
+                    weights ? weights[i] : 1.0);
+            }
+        });
+        for (uint64_t i = 0; i < last - first; ++i) {
+            Cell c = partials[0][i];
+            for (unsigned t = 1; t < numThreads; ++t) {
+                c.add(partials[t][i]);
+            }
+            if (c.count != 0) {
+                cells.emplace_back(first + i, c);
+            }
+        }
+    } else {
+        std::vector<std::unordered_map<uint64_t, Cell>> partials(numThreads);
+        forEachSlice(n, numThreads, [&](unsigned t, size_t b, size_t e) {
+            std::unordered_map<uint64_t, Cell> & partial = partials[t];
+            for (size_t i = b; i < e; ++i) {
+                partial[p.index(points[i])].add(weights ? weights[i] : 1.0);
+            }
+        });
+        for (unsigned t = 1; t < numThreads; ++t) {
+            for (auto const & kv: partials[t]) {
+                partials[0][kv.first].add(kv.second);
+            }
+            partials[t].clear();
+        }
+        cells.assign(partials[0].begin(), partials[0].end());
+        std::sort(cells.begin(), cells.end(),
+                  [](std::pair<uint64_t, Cell> const & a,
+                     std::pair<uint64_t, Cell> const & b) {
+                      return a.first < b.first;
+                  });
+    }
+    _assign(cells);
+}
+
+PixelAggregates::PixelAggregates(Pixelization const & pixelization,
+                                 std::vector<UnitVector3d> const & points,
+                                 std::vector<double> const & weights,
+                                 unsigned numThreads) :
+    PixelAggregates(pixelization, points.data(),
+                    weightsFor(points, weights), points.size(), numThreads)
+{}
+
+uint64_t PixelAggregates::getTotalCount() const {
+    uint64_t total = 0;
+    for (uint64_t c: _counts) {
+        total += c;
+    }
+    return total;
+}
+
+std::vector<uint64_t> PixelAggregates::getDenseCounts() const {
+    return _dense(_counts, uint64_t(0));
+}
+
+std::vector<double> PixelAggregates::getDenseSums() const {
+    return _dense(_sums, 0.0);
+}
+
+std::vector<double> PixelAggregates::getDenseMins() const {
+    return _dense(_mins, std::numeric_limits<double>::quiet_NaN());
+}
+
+std::vector<double> PixelAggregates::getDenseMaxs() const {
+    return _dense(_maxs, std::numeric_limits<double>::quiet_NaN());
+}
+
+PixelAggregates PixelAggregates::coarsened(int level) const {
+    if (level > _level) {
+        throw std::invalid_argument(
+            "Aggregates cannot be coarsened to a finer level");
+    }
+    PixelAggregates a;
+    a._type = _type;
+    a._level = level;
+    a._pixelization = detail::makePixelization(_type, level);
+    // Since pixel indexes at a coarser level are obtained by dropping
+    // trailing bits, sorted indexes remain sorted, and the children of a
+    // pixel are consecutive.
+    int shift = 2 * (_level - level);
+    std::vector<std::pair<uint64_t, Cell>> cells;
+    for (size_t i = 0; i < _indexes.size(); ++i) {
+        uint64_t index = _indexes[i] >> shift;
+        if (cells.empty() || cells.back().first != index) {
+            cells.emplace_back(index, Cell());
+        }
+        cells.back().second.add(_cell(i));
+    }
+    a._assign(cells);
+    return a;
+}
+
+PixelAggregates PixelAggregates::merged(PixelAggregates const & a) const {
+    if (_type != a._type || _level != a._level) {
+        throw std::invalid_argument(
+            "Only aggregates with the same pixelization can be merged");
+    }
+    std::vector<std::pair<uint64_t, Cell>> cells;
+    cells.reserve(size() + a.size());
+    size_t i = 0, j = 0;
+    while (i < size() || j < a.size()) {
+        if (j == a.size() || (i < size() && _indexes[i] < a._indexes[j])) {
+            cells.emplace_back(_indexes[i], _cell(i));
+            ++i;
+        } else if (i == size() || a._indexes[j] < _indexes[i]) {
+            cells.emplace_back(a._indexes[j], a._cell(j));
+            ++j;
+        } else {
+            cells.emplace_back(_indexes[i], _cell(i));
+            cells.back().second.add(a._cell(j));
+            ++i;
+            ++j;
+        }
+    }
+    PixelAggregates result;
+    result._type = _type;
+    result._level = _level;
+    result._pixelization = _pixelization;
+    result._assign(cells);
+    return result;
+}
+
+PixelAggregates::Cell PixelAggregates::_cell(size_t i) const {
+    Cell c;
+    c.count = _counts[i];
+    c.sum = _sums[i];
+    c.min = _mins[i];
+    c.max = _maxs[i];
+    return c;
+}
+
+void PixelAggregates::_assign(std::vector<std::pair<uint64_t, Cell>> & cells) {
+    _indexes.clear();
+    _counts.clear();
+    _sums.clear();
+    _mins.clear();
+    _maxs.clear();
+    _indexes.reserve(cells.size());
+    _counts.reserve(cells.size());
+    _sums.reserve(cells.size());
+    _mins.reserve(cells.size());
+    _maxs.reserve(cells.size());
+    for (auto const & kv: cells) {
+        _indexes.push_back(kv.first);
+        _counts.push_back(kv.second.count);
+        _sums.push_back(kv.second.sum);
+        _mins.push_back(kv.second.min);
+        _maxs.push_back(kv.second.max);
+    }
+}
+
+template <typename T>
+std::vector<T> PixelAggregates::_dense(std::vector<T> const & values,
+                                       T fill) const
+{
+    uint64_t first, last;
+    std::tie(first, last) = bounds(*_pixelization);
+    std::vector<T> result(last - first, fill);
+    for (size_t i = 0; i < _indexes.size(); ++i) {
+        result[_indexes[i] - first] = values[i];
+    }
+    return result;
+}
+
+}} // namespace lsst::sphgeom
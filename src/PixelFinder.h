@@ -26,15 +26,270 @@
 /// \file
 /// \brief This file provides a base class for pixel finders.
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lsst/sphgeom/CompoundRegion.h"
+#include "lsst/sphgeom/MultiOrderCoverage.h"
+#include "lsst/sphgeom/Pixelization.h"
+#include "lsst/sphgeom/Polygon.h"
 #include "lsst/sphgeom/RangeSet.h"
 
 #include "ConvexPolygonImpl.h"
+#include "TraversalStatsImpl.h"
 
 
 namespace lsst {
 namespace sphgeom {
 namespace detail {
 
+// This overload of `relate` lets PixelFinder relate convex pixels to
+// non-convex polygons.
+inline Relationship relate(UnitVector3d const * begin,
+                           UnitVector3d const * end,
+                           Polygon const & p)
+{
+    return polygonRelate(begin, static_cast<size_t>(end - begin), p);
+}
+
+// This overload of `relate` lets convex polygons be related to compound
+// regions. Operands are related only until the result is decided.
+inline Relationship relate(UnitVector3d const * begin,
+                           UnitVector3d const * end,
+                           CompoundRegion const & c)
+{
+    return compoundRelate(begin, static_cast<size_t>(end - begin), c);
+}
+
+// `RangeCoarsener` accumulates a stream of ascending, disjoint ranges, and
+// produces the closest set with at most `maxRanges` ranges.
+//
+// For envelopes (`InteriorOnly` false), ranges are merged across the
+// smallest gaps, so that the fewest possible integers are added. For
+// interiors, the smallest ranges are removed, so that the fewest possible
+// integers are removed. Either way, the set of retained gaps (or ranges)
+// is the top-k of a stream, which is maintained with a bounded min-heap.
+// Memory usage is O(maxRanges), and run time is O(n log maxRanges) for
+// n input ranges.
+template <bool InteriorOnly>
+class RangeCoarsener {
+public:
+    explicit RangeCoarsener(size_t maxRanges) :
+        _capacity{InteriorOnly ? maxRanges : maxRanges - 1}
+    {}
+
+    // `append` adds [first, last) to the stream, where a last value of 0
+    // corresponds to 2^64. The range must not precede any previously
+    // appended range.
+    void append(uint64_t first, uint64_t last) {
+        if (_empty) {
+            _empty = false;
+            _first = first;
+            _last = last;
+            return;
+        }
+        if (first == _last) {
+            // [first, last) extends the current range.
+            _last = last;
+            return;
+        }
+        if (InteriorOnly) {
+            // The current range is complete.
+            _push(_first, _last);
+            _first = first;
+        } else {
+            // [_last, first) is a gap between ranges.
+            _push(_last, first);
+        }
+        _last = last;
+    }
+
+    // `finish` inserts the coarsened ranges into s.
+    void finish(RangeSet & s) {
+        if (_empty) {
+            return;
+        }
+        if (InteriorOnly) {
+            _push(_first, _last);
+        }
+        std::vector<Entry> entries;
+        entries.reserve(_heap.size());
+        for (; !_heap.empty(); _heap.pop()) {
+            entries.push_back(_heap.top());
+        }
+        std::sort(entries.begin(), entries.end(),
+                  [](Entry const & a, Entry const & b) {
+                      return std::get<1>(a) < std::get<1>(b);
+                  });
+        if (InteriorOnly) {
+            for (Entry const & e: entries) {
+                s.insert(std::get<1>(e), std::get<2>(e));
+            }
+        } else {
+            // Output the ranges between retained gaps.
+            uint64_t first = _first;
+            for (Entry const & e: entries) {
+                s.insert(first, std::get<1>(e));
+                first = std::get<2>(e);
+            }
+            s.insert(first, _last);
+        }
+        _empty = true;
+    }
+
+private:
+    // A gap or range [first, last), keyed by its size minus one (so that
+    // a range of 2^64 integers does not wrap to 0), then by position.
+    using Entry = std::tuple<uint64_t, uint64_t, uint64_t>;
+
+    size_t const _capacity;
+    bool _empty = true;
+    uint64_t _first = 0;
+    uint64_t _last = 0;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> _heap;
+
+    void _push(uint64_t first, uint64_t last) {
+        _heap.emplace(last - first - 1, first, last);
+        if (_heap.size() > _capacity) {
+            _heap.pop();
+        }
+    }
+};
+
+
+// `PixelSink` accumulates the indexes of pixels found by a PixelFinder for
+// either an envelope (`InteriorOnly` false) or an interior. It either stores
+// them in a RangeSet, enforcing the limit on the number of ranges, merges
+// adjacent ranges and passes them to a callback as soon as they are complete,
+// or adds them to a MultiOrderCoverage at the level they were found at.
+// A default constructed sink discards everything.
+template <bool InteriorOnly>
+class PixelSink {
+public:
+    PixelSink() : PixelSink(nullptr, 0, 0, Coarsening::LEVEL) {}
+
+    PixelSink(RangeSet * ranges,
+              int level,
+              size_t maxRanges,
+              Coarsening coarsening):
+        _ranges{ranges},
+        _callback{nullptr},
+        _level{level},
+        _desiredLevel{level},
+        _maxRanges{maxRanges == 0 ? maxRanges - 1 : maxRanges},
+        _optimal{coarsening == Coarsening::OPTIMAL && maxRanges != 0},
+        _coarsener{maxRanges}
+    {}
+
+    PixelSink(Pixelization::RangeCallback const & callback, int level):
+        PixelSink(nullptr, level, 0, Coarsening::LEVEL)
+    {
+        _callback = &callback;
+    }
+
+    PixelSink(MultiOrderCoverage * coverage, int level):
+        PixelSink(nullptr, level, 0, Coarsening::LEVEL)
+    {
+        _coverage = coverage;
+    }
+
+    // `accepts` returns true if pixels at the given level can still affect
+    // the output. It is false for all levels if there is no output.
+    bool accepts(int level) const {
+        return (_ranges != nullptr || _callback != nullptr ||
+                _coverage != nullptr) && level <= _level;
+    }
+
+    // `level` returns the current (possibly reduced) subdivision level.
+    int level() const { return _level; }
+
+    // `setStats` sets the statistics updated when the level is reduced.
+    void setStats(TraversalStats * stats) { _stats = stats; }
+
+    void insert(uint64_t index, int level) {
+        if (_coverage != nullptr) {
+            // Pixels are found in ascending order of their descendants,
+            // which keeps coverage inserts efficient.
+            _coverage->insert(level, index);
+            return;
+        }
+        int shift = 2 * (_desiredLevel - level);
+        uint64_t first = index << shift;
+        uint64_t last = (index + 1) << shift;
+        if (_callback != nullptr) {
+            // Pixels are found in ascending index order, so a range is
+            // complete once a non-adjacent pixel has been found.
+            if (_pending && first == _last) {
+                _last = last;
+            } else {
+                if (_pending) {
+                    (*_callback)(_first, _last);
+                }
+                _pending = true;
+                _first = first;
+                _last = last;
+            }
+            return;
+        }
+        if (_optimal) {
+            _coarsener.append(first, last);
+            return;
+        }
+        _ranges->insert(first, last);
+        while (_ranges->size() > _maxRanges) {
+            // Reduce the subdivision level.
+            --_level;
+            shift += 2;
+            count(_stats, &TraversalStats::levelReductions);
+            // When looking for intersecting pixels, ranges are simplified
+            // by expanding them outwards, causing nearly adjacent small ranges
+            // to merge.
+            //
+            // When looking for interior pixels, ranges are simplified by
+            // shrinking them inwards, causing small ranges to disappear.
+            if (InteriorOnly) {
+                _ranges->complement();
+            }
+            _ranges->simplify(shift);
+            count(_stats, &TraversalStats::simplifications);
+            if (InteriorOnly) {
+                _ranges->complement();
+            }
+        }
+    }
+
+    void finish() {
+        if (_callback != nullptr && _pending) {
+            _pending = false;
+            (*_callback)(_first, _last);
+        } else if (_ranges != nullptr && _optimal) {
+            _coarsener.finish(*_ranges);
+        }
+    }
+
+private:
+    RangeSet * _ranges;
+    Pixelization::RangeCallback const * _callback;
+    MultiOrderCoverage * _coverage = nullptr;
+    TraversalStats * _stats = nullptr;
+    bool _pending = false;
+    uint64_t _first = 0;
+    uint64_t _last = 0;
+    int _level;
+    int const _desiredLevel;
+    size_t const _maxRanges;
+    bool const _optimal;
+    RangeCoarsener<InteriorOnly> _coarsener;
+};
+
+
 // `PixelFinder` is a CRTP base class that locates pixels intersecting a
 // region. It assumes a hierarchical pixelization, and that pixels are
 // convex spherical polygons with a fixed number of vertices.
@@ -59,6 +314,37 @@ namespace detail {
 // to locate all pixels that intersect the input region, or only those that
 // are entirely inside it. Finally, the `NumVertices` template parameter is
 // the number of vertices in the polygonal representation of a pixel.
+//
+// Intersecting pixels are passed to the `envelope` sink, and pixels inside
+// the region to the `interior` sink. When `InteriorOnly` is false, both can
+// be active, in which case both sets are computed with a single traversal,
+// and are identical to the ones computed by separate searches. The sinks
+// must be finished by the caller after the traversal.
+//
+// Before computing the exact relationship between a pixel and a box or
+// polygon, which for polygons costs O(NumVertices·n) orientation tests,
+// `visit` applies cheap conservative tests. The pixel is bounded by the
+// circle centered on its normalized vertex sum that contains its vertices.
+// If that circle is disjoint from the bounding circle of the region, or if
+// the box containing the pixel vertices, scaled up to account for edge and
+// interior points further from the origin, is disjoint from the
+// 3-dimensional bounding box of the region, then so is the pixel. For
+// polygons, the pixel bounding circle is also compared to each edge plane,
+// which decides most pixels near the region boundary: a circle outside of
+// one edge plane is disjoint from the polygon, and a circle inside of all of
+// them is within it. The exact test for circular regions is no more costly
+// than these, so they are skipped. Descendants of a pixel inside both the
+// bounding circle and the bounding box of the region cannot fail those two
+// tests, so they are not repeated for them. For compound regions, the exact
+// test skips the operands that are disjoint from or contain an ancestor of
+// the pixel, see `CompoundRelater`.
+//
+// The bounds are obtained without trigonometry: every point of a pixel is
+// the normalized sum of a non-negative combination of its vertices, so if c
+// is the bounding circle center, its dot product with c is at least the
+// cosine of the bounding circle opening angle, which also bounds the norms
+// of such sums from below. The number of pixels decided by each stage is
+// recorded in `stats`, if it is not null.
 template <
     typename Derived,
     typename RegionType,
@@ -67,29 +353,50 @@ template <
 >
 class PixelFinder {
 public:
-    PixelFinder(RangeSet & ranges,
-                RegionType const & region,
-                int level,
-                size_t maxRanges):
-        _ranges{&ranges},
+    PixelFinder(RegionType const & region,
+                PixelSink<false> & envelope,
+                PixelSink<true> & interior,
+                TraversalStats * stats):
         _region{&region},
-        _level{level},
-        _desiredLevel{level},
-        _maxRanges{maxRanges == 0 ? maxRanges - 1 : maxRanges}
-    {}
+        _envelope{&envelope},
+        _interior{&interior},
+        _stats{stats}
+    {
+        _addOperands(region);
+        Circle c = region.getBoundingCircle();
+        _prefilter = !std::is_same<RegionType, Circle>::value &&
+                     !c.isEmpty() && !c.isFull();
+        if (!_prefilter) {
+            return;
+        }
+        double cl2 = c.getSquaredChordLength();
+        _center = c.getCenter();
+        _cosRadius = 1.0 - 0.5 * cl2;
+        _sinRadius = std::sqrt(std::max(0.0, cl2 * (1.0 - 0.25 * cl2)));
+        Box3d b = region.getBoundingBox3d();
+        for (int i = 0; i < 3; ++i) {
+            _boxMin[i] = b(i).getA() - PREFILTER_ERROR;
+            _boxMax[i] = b(i).getB() + PREFILTER_ERROR;
+        }
+        _addEdgeNormals(region);
+    }
 
     void visit(UnitVector3d const * pixel,
                uint64_t index,
                int level)
     {
-        if (level > _level) {
+        bool envelope = !InteriorOnly && _envelope->accepts(level);
+        bool interior = _interior->accepts(level);
+        if (!envelope && !interior) {
             // Nothing to do - the subdivision level has been reduced
             // or a pixel that completely contains the search region
             // has been found.
             return;
         }
         // Determine the relationship between the pixel and the search region.
-        Relationship r = detail::relate(pixel, pixel + NumVertices, *_region);
+        bool inBounds = false;
+        Relationship r = _relate(pixel, inBounds);
+        countVisit(_stats, level, r);
         if ((r & DISJOINT) != 0) {
             // The pixel is disjoint from the search region.
             return;
@@ -97,79 +404,346 @@ public:
         if ((r & WITHIN) != 0) {
             // The tree traversal has reached a pixel that is entirely within
             // the search region.
-            _insert(index, level);
-            return;
-        } else if (level == _level) {
-            // The tree traversal has reached a leaf.
-            if (!InteriorOnly) {
-                _insert(index, level);
+            if (envelope) {
+                _envelope->insert(index, level);
+            }
+            if (interior) {
+                _interior->insert(index, level);
             }
             return;
         }
-        static_cast<Derived *>(this)->subdivide(pixel, index, level);
+        if (envelope && level == _envelope->level()) {
+            // The tree traversal has reached an envelope leaf.
+            _envelope->insert(index, level);
+            envelope = false;
+        }
+        if (interior && level == _interior->level()) {
+            // The tree traversal has reached an interior leaf.
+            interior = false;
+        }
+        if (envelope || interior) {
+            bool ancestorInBounds = _inBounds;
+            _inBounds = ancestorInBounds || inBounds;
+            ++_depth;
+            static_cast<Derived *>(this)->subdivide(pixel, index, level);
+            --_depth;
+            _inBounds = ancestorInBounds;
+        }
     }
 
 private:
-    RangeSet * _ranges;
+    // `PREFILTER_ERROR` bounds the absolute error of the dot products and
+    // coordinates computed by the conservative tests.
+    static constexpr double PREFILTER_ERROR = 1.0e-14;
+
     RegionType const * _region;
-    int _level;
-    int const _desiredLevel;
-    size_t const _maxRanges;
+    PixelSink<false> * _envelope;
+    PixelSink<true> * _interior;
+    TraversalStats * _stats;
+    bool _prefilter;
+    UnitVector3d _center;
+    double _cosRadius = 1.0;
+    double _sinRadius = 0.0;
+    double _boxMin[3];
+    double _boxMax[3];
+    // The inward unit normals of the edge planes of a polygonal region.
+    std::vector<Vector3d> _edgeNormals;
+    // The number of ancestors of the pixel being visited.
+    size_t _depth = 0;
+    // Whether an ancestor of the pixel being visited lies inside the
+    // bounding circle and 3-dimensional bounding box of the region.
+    bool _inBounds = false;
+    // Relates pixels to the operands of a compound region that are still
+    // undecided for their ancestors.
+    CompoundRelater _relater;
 
-    void _insert(uint64_t index, int level) {
-        int shift = 2 * (_desiredLevel - level);
-        _ranges->insert(index << shift, (index + 1) << shift);
-        while (_ranges->size() > _maxRanges) {
-            // Reduce the subdivision level.
-            --_level;
-            shift += 2;
-            // When looking for intersecting pixels, ranges are simplified
-            // by expanding them outwards, causing nearly adjacent small ranges
-            // to merge.
-            //
-            // When looking for interior pixels, ranges are simplified by
-            // shrinking them inwards, causing small ranges to disappear.
-            if (InteriorOnly) {
-                _ranges->complement();
+    template <typename R>
+    void _addEdgeNormals(R const &) {}
+
+    template <typename R>
+    void _addOperands(R const &) {}
+
+    void _addOperands(CompoundRegion const & c) {
+        _relater = CompoundRelater(c);
+    }
+
+    void _addEdgeNormals(ConvexPolygon const & p) {
+        std::vector<UnitVector3d> const & v = p.getVertices();
+        _edgeNormals.reserve(v.size());
+        for (auto a = std::prev(v.end()), b = v.begin(); b != v.end();
+             a = b, ++b) {
+            _edgeNormals.push_back(UnitVector3d(a->robustCross(*b)));
+        }
+    }
+
+    Relationship _relate(UnitVector3d const * pixel, bool & inBounds) {
+        if (_prefilter && !(_inBounds && _edgeNormals.empty())) {
+            Vector3d s = pixel[0];
+            for (size_t i = 1; i < NumVertices; ++i) {
+                s += pixel[i];
             }
-            _ranges->simplify(shift);
-            if (InteriorOnly) {
-                _ranges->complement();
+            // The vertex sum of a pixel smaller than a hemisphere is never
+            // close to zero, so it can be normalized without care.
+            Vector3d c = s * (1.0 / s.getNorm());
+            double cosRadius = pixel[0].dot(c);
+            for (size_t i = 1; i < NumVertices; ++i) {
+                cosRadius = std::min(cosRadius, pixel[i].dot(c));
+            }
+            cosRadius -= PREFILTER_ERROR;
+            // The bounds are only valid for pixels smaller than a hemisphere.
+            if (cosRadius > 0.0) {
+                double sinRadius = std::sqrt(1.0 - cosRadius * cosRadius);
+                Relationship r = _prefilterRelate(pixel, c, cosRadius,
+                                                  sinRadius, inBounds);
+                if (r != INTERSECTS) {
+                    return r;
+                }
+                _setBound(c, cosRadius, sinRadius, *_region);
             }
         }
+        count(_stats, &TraversalStats::exactRelated);
+        return _exactRelate(pixel, *_region);
+    }
+
+    // `_setBound` hands the pixel bounding circle computed for the
+    // prefilter to the exact test of compound regions, which also needs it.
+    template <typename R>
+    void _setBound(Vector3d const &, double, double, R const &) {}
+
+    void _setBound(Vector3d const & c, double cosRadius, double sinRadius,
+                   CompoundRegion const &)
+    {
+        _relater.setBound(UnitVector3d::fromNormalized(c), cosRadius,
+                          sinRadius);
+    }
+
+    template <typename R>
+    Relationship _exactRelate(UnitVector3d const * pixel, R const & r) {
+        return detail::relate(pixel, pixel + NumVertices, r);
+    }
+
+    Relationship _exactRelate(UnitVector3d const * pixel,
+                              CompoundRegion const &)
+    {
+        return _relater.relate(pixel, NumVertices, _depth);
+    }
+
+    // `_prefilterRelate` compares the pixel bounding circle with center c
+    // and opening angle cosine `cosRadius` to the region. It returns
+    // INTERSECTS if it cannot decide, and sets `inBounds` if the pixel lies
+    // inside the bounding circle and box of the region.
+    Relationship _prefilterRelate(UnitVector3d const * pixel,
+                                  Vector3d const & c,
+                                  double cosRadius,
+                                  double sinRadius,
+                                  bool & inBounds)
+    {
+        if (!_inBounds) {
+            double d = c.dot(_center);
+            // The bounding circles are disjoint if the angle between their
+            // centers exceeds the sum of their opening angles, which must be
+            // less than π.
+            if (_cosRadius + cosRadius > 0.0 &&
+                d < _cosRadius * cosRadius - _sinRadius * sinRadius -
+                    PREFILTER_ERROR) {
+                count(_stats, &TraversalStats::capRejected);
+                return DISJOINT;
+            }
+            // The pixel bounding circle is inside the region bounding circle
+            // if the angle between their centers plus its opening angle is
+            // less than the opening angle of the region bounding circle.
+            inBounds = cosRadius > _cosRadius &&
+                       d > _cosRadius * cosRadius + _sinRadius * sinRadius +
+                           PREFILTER_ERROR;
+            double invCosRadius = 1.0 / cosRadius;
+            for (int i = 0; i < 3; ++i) {
+                double lo = pixel[0](i);
+                double hi = lo;
+                for (size_t j = 1; j < NumVertices; ++j) {
+                    lo = std::min(lo, pixel[j](i));
+                    hi = std::max(hi, pixel[j](i));
+                }
+                lo = lo < 0.0 ? lo * invCosRadius : lo;
+                hi = hi > 0.0 ? hi * invCosRadius : hi;
+                if (lo > _boxMax[i] || hi < _boxMin[i]) {
+                    count(_stats, &TraversalStats::boxRejected);
+                    return DISJOINT;
+                }
+                inBounds = inBounds && lo >= _boxMin[i] && hi <= _boxMax[i];
+            }
+        }
+        if (_edgeNormals.empty()) {
+            return INTERSECTS;
+        }
+        // The sine of the angle between c and an edge plane is the dot
+        // product of c with the plane normal.
+        bool inside = true;
+        for (Vector3d const & n: _edgeNormals) {
+            double t = n.dot(c);
+            if (t < -sinRadius - PREFILTER_ERROR) {
+                count(_stats, &TraversalStats::edgeRejected);
+                return DISJOINT;
+            }
+            inside = inside && t > sinRadius + PREFILTER_ERROR;
+        }
+        if (inside) {
+            count(_stats, &TraversalStats::capAccepted);
+            return WITHIN;
+        }
+        return INTERSECTS;
     }
 };
 
+template <typename Derived, typename RegionType, bool InteriorOnly,
+          size_t NumVertices>
+constexpr double PixelFinder<
+    Derived, RegionType, InteriorOnly, NumVertices>::PREFILTER_ERROR;
+
 
-// `findPixels` implements pixel-finding for an arbitrary Region, given a
-// PixelFinder subclass for a specific pixelization.
+// `runFinder` runs a PixelFinder subclass for a specific pixelization on a
+// region of type `RegionType`.
+template <
+    template <typename, bool> class Finder,
+    bool InteriorOnly,
+    typename RegionType
+>
+void runFinder(RegionType const & r,
+               PixelSink<false> & envelope,
+               PixelSink<true> & interior,
+               TraversalStats * stats)
+{
+    Finder<RegionType, InteriorOnly> find(r, envelope, interior, stats);
+    find();
+}
+
+// This overload of `runFinder` determines the type of an arbitrary Region
+// at run-time.
 template <
     template <typename, bool> class Finder,
     bool InteriorOnly
 >
-RangeSet findPixels(Region const & r, size_t maxRanges, int level) {
-    RangeSet s;
+void runFinder(Region const & r,
+               PixelSink<false> & envelope,
+               PixelSink<true> & interior,
+               TraversalStats * stats)
+{
     Circle const * c = nullptr;
     Ellipse const * e = nullptr;
     Box const * b = nullptr;
+    Polygon const * p = nullptr;
+    CompoundRegion const * cr = nullptr;
     if ((c = dynamic_cast<Circle const *>(&r))) {
-        Finder<Circle, InteriorOnly> find(s, *c, level, maxRanges);
-        find();
+        runFinder<Finder, InteriorOnly>(*c, envelope, interior, stats);
     } else if ((e = dynamic_cast<Ellipse const *>(&r))) {
-        Finder<Circle, InteriorOnly> find(
-            s, e->getBoundingCircle(), level, maxRanges);
-        find();
+        Circle bc = e->getBoundingCircle();
+        runFinder<Finder, InteriorOnly>(bc, envelope, interior, stats);
     } else if ((b = dynamic_cast<Box const *>(&r))) {
-        Finder<Box, InteriorOnly> find(s, *b, level, maxRanges);
-        find();
+        runFinder<Finder, InteriorOnly>(*b, envelope, interior, stats);
+    } else if ((p = dynamic_cast<Polygon const *>(&r))) {
+        runFinder<Finder, InteriorOnly>(*p, envelope, interior, stats);
+    } else if ((cr = dynamic_cast<CompoundRegion const *>(&r))) {
+        runFinder<Finder, InteriorOnly>(*cr, envelope, interior, stats);
     } else {
-        Finder<ConvexPolygon, InteriorOnly> find(
-            s, dynamic_cast<ConvexPolygon const &>(r), level, maxRanges);
-        find();
+        runFinder<Finder, InteriorOnly>(
+            dynamic_cast<ConvexPolygon const &>(r), envelope, interior, stats);
     }
+}
+
+// `findPixels` implements pixel-finding for a region, given a PixelFinder
+// subclass for a specific pixelization, and finishes the sinks. If
+// `RegionType` is Region, the actual region type is determined at run-time.
+template <
+    template <typename, bool> class Finder,
+    bool InteriorOnly,
+    typename RegionType
+>
+void findPixels(RegionType const & r,
+                PixelSink<false> & envelope,
+                PixelSink<true> & interior,
+                TraversalStats * stats)
+{
+    ThreadCountersScope scope(stats);
+    envelope.setStats(stats);
+    interior.setStats(stats);
+    runFinder<Finder, InteriorOnly>(r, envelope, interior, stats);
+    envelope.finish();
+    interior.finish();
+}
+
+template <
+    template <typename, bool> class Finder,
+    bool InteriorOnly,
+    typename RegionType
+>
+RangeSet findPixels(RegionType const & r,
+                    size_t maxRanges,
+                    int level,
+                    Coarsening coarsening,
+                    TraversalStats * stats)
+{
+    RangeSet s;
+    PixelSink<false> envelope(InteriorOnly ? nullptr : &s,
+                              level, maxRanges, coarsening);
+    PixelSink<true> interior(InteriorOnly ? &s : nullptr,
+                             level, maxRanges, coarsening);
+    findPixels<Finder, InteriorOnly>(r, envelope, interior, stats);
     return s;
 }
 
+// `findEnvelopeAndInterior` computes the pixels intersecting and inside
+// an arbitrary Region with a single traversal.
+template <template <typename, bool> class Finder>
+std::pair<RangeSet, RangeSet> findEnvelopeAndInterior(Region const & r,
+                                                      size_t maxRanges,
+                                                      int level,
+                                                      Coarsening coarsening,
+                                                      TraversalStats * stats)
+{
+    std::pair<RangeSet, RangeSet> result;
+    PixelSink<false> envelope(&result.first, level, maxRanges, coarsening);
+    PixelSink<true> interior(&result.second, level, maxRanges, coarsening);
+    findPixels<Finder, false>(r, envelope, interior, stats);
+    return result;
+}
+
+// `streamPixels` passes the ranges of pixels intersecting (or, if
+// `InteriorOnly` is true, inside) an arbitrary Region to a callback, in
+// ascending order.
+template <
+    template <typename, bool> class Finder,
+    bool InteriorOnly
+>
+void streamPixels(Region const & r,
+                  int level,
+                  Pixelization::RangeCallback const & callback)
+{
+    PixelSink<false> envelope = InteriorOnly ? PixelSink<false>() :
+                                PixelSink<false>(callback, level);
+    PixelSink<true> interior = InteriorOnly ? PixelSink<true>(callback, level) :
+                               PixelSink<true>();
+    findPixels<Finder, InteriorOnly>(r, envelope, interior, nullptr);
+}
+
+// `findCoverage` returns the pixels intersecting (or, if `InteriorOnly` is
+// true, inside) an arbitrary Region as a multi-order coverage, in which
+// pixels found inside the region above the target level are kept as is.
+template <
+    template <typename, bool> class Finder,
+    bool InteriorOnly
+>
+MultiOrderCoverage findCoverage(Region const & r,
+                                int level,
+                                TraversalStats * stats)
+{
+    MultiOrderCoverage coverage;
+    PixelSink<false> envelope = InteriorOnly ? PixelSink<false>() :
+                                PixelSink<false>(&coverage, level);
+    PixelSink<true> interior = InteriorOnly ? PixelSink<true>(&coverage, level) :
+                               PixelSink<true>();
+    findPixels<Finder, InteriorOnly>(r, envelope, interior, stats);
+    return coverage;
+}
+
 }}} // namespace lsst::sphgeom::detail
 
 #endif // LSST_SPHGEOM_PIXELFINDER_H_
@@ -0,0 +1,244 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains the PixelTranslator class implementation.
+
+#include "lsst/sphgeom/PixelTranslator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "lsst/sphgeom/Chunker.h"
+#include "lsst/sphgeom/Region.h"
+
+#include "ForEachSlice.h"
+#include "PixelizationType.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+using detail::forEachSlice;
+
+namespace {
+
+using Cell = std::pair<int, uint64_t>;
+
+// `decompose` appends the (level, index) pairs of the fewest pixels with
+// levels between `minLevel` and `level` that cover exactly the given level
+// `level` pixels. The children of pixel i at level l are the pixels 4i
+// through 4i + 3 at level l + 1 in all supported pixelizations.
+void decompose(RangeSet const & pixels,
+               int level,
+               int minLevel,
+               std::vector<Cell> & cells)
+{
+    for (auto const & range: pixels) {
+        uint64_t first = std::get<0>(range);
+        uint64_t last = std::get<1>(range);
+        while (first < last) {
+            int k = 0;
+            while (k < level - minLevel) {
+                uint64_t n = uint64_t(1) << (2 * k + 2);
+                if ((first & (n - 1)) != 0 || last - first < n) {
+                    break;
+                }
+                ++k;
+            }
+            cells.emplace_back(level - k, first >> (2 * k));
+            first += uint64_t(1) << (2 * k);
+        }
+    }
+}
+
+// `unite` returns the union of the given sets, merging them pairwise so
+// that the cost is logarithmic rather than linear in their number.
+RangeSet unite(std::vector<RangeSet> & sets) {
+    if (sets.empty()) {
+        return RangeSet();
+    }
+    for (size_t stride = 1; stride < sets.size(); stride *= 2) {
+        for (size_t i = 0; i + stride < sets.size(); i += 2 * stride) {
+            sets[i] |= sets[i + stride];
+            sets[i + stride] = RangeSet();
+        }
+    }
+    return std::move(sets[0]);
+}
+
+} // unnamed namespace
+
+
+PixelTranslator::PixelTranslator(Pixelization const & source,
+                                 int maxCacheLevel) :
+    _maxCacheLevel(maxCacheLevel)
+{
+    int level;
+    uint8_t type = detail::getPixelizationType(source, level,
+                                               "PixelTranslator");
+    if (maxCacheLevel > MAX_CACHE_LEVEL) {
+        throw std::invalid_argument("Maximum cache level is too large");
+    }
+    for (int l = 0; l <= level; ++l) {
+        _levels.push_back(detail::makePixelization(type, l));
+    }
+    _sourceUniverse = _levels.back()->universe();
+}
+
+PixelTranslator::PixelTranslator(Pixelization const & source,
+                                 Pixelization const & target,
+                                 int maxCacheLevel) :
+    PixelTranslator(source, maxCacheLevel)
+{
+    int level;
+    uint8_t type = detail::getPixelizationType(target, level,
+                                               "PixelTranslator");
+    _target = detail::makePixelization(type, level);
+}
+
+PixelTranslator::PixelTranslator(Pixelization const & source,
+                                 Chunker const & target,
+                                 bool subChunks,
+                                 int maxCacheLevel) :
+    PixelTranslator(source, maxCacheLevel)
+{
+    _chunker = std::make_shared<Chunker>(target);
+    _subChunks = subChunks;
+    // Chunker relates regions to chunk bounding boxes, and regions to
+    // boxes via their own bounding boxes, so source pixels much larger
+    // than chunks give very loose results. The root pixels of all supported
+    // pixelizations span about 90 degrees.
+    double height = 180.0 / target.getNumStripes();
+    if (subChunks) {
+        height /= target.getNumSubStripesPerStripe();
+    }
+    int level = static_cast<int>(_levels.size()) - 1;
+    for (_minLevel = 0;
+         _minLevel < level && std::ldexp(90.0, -_minLevel) > height;
+         ++_minLevel) {}
+}
+
+RangeSet PixelTranslator::envelope(RangeSet const & pixels,
+                                   unsigned numThreads) const
+{
+    if (!pixels.isWithin(_sourceUniverse)) {
+        throw std::invalid_argument("Invalid source pixel index");
+    }
+    std::vector<Cell> cells;
+    decompose(pixels, static_cast<int>(_levels.size()) - 1, _minLevel, cells);
+    std::vector<RangeSet> envelopes = _envelopes(cells, numThreads);
+    return unite(envelopes);
+}
+
+RangeSet PixelTranslator::interior(RangeSet const & pixels,
+                                   unsigned numThreads) const
+{
+    RangeSet candidates = envelope(pixels, numThreads);
+    // Remove the envelope of the complement of the source pixels from the
+    // candidates. Complement pixels with envelopes disjoint from the
+    // candidates are ignored, and those coarser than the minimum level are
+    // split, so that only the vicinity of the source pixels is refined.
+    int const level = static_cast<int>(_levels.size()) - 1;
+    std::vector<Cell> cells;
+    decompose(_sourceUniverse - pixels, level, 0, cells);
+    std::vector<RangeSet> excluded;
+    while (!cells.empty()) {
+        std::vector<RangeSet> envelopes = _envelopes(cells, numThreads);
+        std::vector<Cell> children;
+        for (size_t i = 0; i < cells.size(); ++i) {
+            if (envelopes[i].isDisjointFrom(candidates)) {
+                continue;
+            }
+            if (cells[i].first < _minLevel) {
+                for (uint64_t c = 0; c < 4; ++c) {
+                    children.emplace_back(cells[i].first + 1,
+                                          4 * cells[i].second + c);
+                }
+            } else {
+                excluded.push_back(std::move(envelopes[i]));
+            }
+        }
+        cells.swap(children);
+    }
+    return candidates - unite(excluded);
+}
+
+size_t PixelTranslator::getCacheSize() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _cache.size();
+}
+
+void PixelTranslator::clearCache() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _cache.clear();
+}
+
+RangeSet PixelTranslator::_envelope(int level, uint64_t index) const {
+    // Pixel indexes at the cached levels are below 2^52, leaving the top
+    // bits of the cache key for the level.
+    bool const cached = level <= _maxCacheLevel;
+    uint64_t const key = (static_cast<uint64_t>(level) << 56) | index;
+    if (cached) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto i = _cache.find(key);
+        if (i != _cache.end()) {
+            return i->second;
+        }
+    }
+    // Another thread may map the same pixel concurrently, which wastes
+    // some work but gives the same result.
+    std::unique_ptr<Region> region = _levels[level]->pixel(index);
+    RangeSet result;
+    if (_target) {
+        result = _target->envelope(*region);
+    } else {
+        Region const * r = region.get();
+        result = _subChunks ? _chunker->getSubChunksIntersecting(&r, 1)[0]
+                            : _chunker->getChunksIntersecting(&r, 1)[0];
+    }
+    if (cached) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cache.emplace(key, result);
+    }
+    return result;
+}
+
+std::vector<RangeSet> PixelTranslator::_envelopes(
+    std::vector<std::pair<int, uint64_t>> const & cells,
+    unsigned numThreads) const
+{
+    std::vector<RangeSet> envelopes(cells.size());
+    numThreads = static_cast<unsigned>(
+        std::max<size_t>(1, std::min<size_t>(numThreads, cells.size())));
+    forEachSlice(cells.size(), numThreads, [&](unsigned, size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            envelopes[i] = _envelope(cells[i].first, cells[i].second);
+        }
+    });
+    return envelopes;
+}
+
+}} // namespace lsst::sphgeom
@@ -0,0 +1,81 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_PIXELIZATIONTYPE_H_
+#define LSST_SPHGEOM_PIXELIZATIONTYPE_H_
+
+/// \file
+/// \brief This file contains helpers for identifying, serializing and
+///        recreating hierarchical pixelizations.
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "lsst/sphgeom/HtmPixelization.h"
+#include "lsst/sphgeom/Mq3cPixelization.h"
+#include "lsst/sphgeom/Q3cPixelization.h"
+
+
+namespace lsst {
+namespace sphgeom {
+namespace detail {
+
+// `getPixelizationType` returns 'h', 'q' or 'm' if p is an HtmPixelization,
+// Q3cPixelization or Mq3cPixelization, and stores its level in `level`.
+// For other pixelizations, it throws a std::invalid_argument saying that
+// `user` does not support them.
+inline uint8_t getPixelizationType(Pixelization const & p,
+                                   int & level,
+                                   char const * user)
+{
+    if (auto h = dynamic_cast<HtmPixelization const *>(&p)) {
+        level = h->getLevel();
+        return 'h';
+    } else if (auto q = dynamic_cast<Q3cPixelization const *>(&p)) {
+        level = q->getLevel();
+        return 'q';
+    } else if (auto m = dynamic_cast<Mq3cPixelization const *>(&p)) {
+        level = m->getLevel();
+        return 'm';
+    }
+    throw std::invalid_argument(
+        std::string(user) + " does not support this pixelization type");
+}
+
+// `makePixelization` returns the pixelization with the given type and
+// level. It throws a std::invalid_argument if either is invalid.
+inline std::shared_ptr<Pixelization const> makePixelization(uint8_t type,
+                                                            int level)
+{
+    switch (type) {
+        case 'h': return std::make_shared<HtmPixelization>(level);
+        case 'q': return std::make_shared<Q3cPixelization>(level);
+        case 'm': return std::make_shared<Mq3cPixelization>(level);
+    }
+    throw std::invalid_argument("Invalid pixelization type");
+}
+
+}}} // namespace lsst::sphgeom::detail
+
+#endif // LSST_SPHGEOM_PIXELIZATIONTYPE_H_
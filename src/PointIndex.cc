@@ -0,0 +1,315 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains the PointIndex class implementation.
+
+#include "lsst/sphgeom/PointIndex.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <tuple>
+
+#include "lsst/sphgeom/Region.h"
+
+#include "ForEachSlice.h"
+#include "PixelizationType.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+using detail::forEachSlice;
+
+namespace {
+
+// An index file starts with a header consisting of `MAGIC`, the
+// pixelization type and level, 6 bytes of padding, `BYTE_ORDER_MARK`, the
+// number of points and the number of non-empty pixels. It is followed by
+// the points, their IDs, the pixel indexes and the pixel offsets. All
+// values are stored in the native byte order, and all arrays are 8 byte
+// aligned.
+char const MAGIC[8] = {'S', 'P', 'H', 'P', 'T', 'I', '0', '1'};
+constexpr uint64_t BYTE_ORDER_MARK = 0x0102030405060708;
+constexpr size_t HEADER_SIZE = 40;
+
+static_assert(sizeof(UnitVector3d) == 3 * sizeof(double),
+              "UnitVector3d must consist of exactly 3 doubles");
+
+char const * const NOT_AN_INDEX = "File is not a valid point index: ";
+
+} // unnamed namespace
+
+
+// `Storage` owns the arrays of an index built in memory.
+struct PointIndex::Storage {
+    std::vector<UnitVector3d> points;
+    std::vector<uint64_t> ids;
+    std::vector<uint64_t> pixels;
+    std::vector<uint64_t> offsets;
+};
+
+// `Mapping` owns a read-only memory mapping of an index file.
+class PointIndex::Mapping {
+public:
+    explicit Mapping(std::string const & path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open point index file: " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size < 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat point index file: " + path);
+        }
+        _size = static_cast<size_t>(st.st_size);
+        if (_size < HEADER_SIZE) {
+            ::close(fd);
+            throw std::runtime_error(NOT_AN_INDEX + path);
+        }
+        _data = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (_data == MAP_FAILED) {
+            throw std::runtime_error("Cannot map point index file: " + path);
+        }
+    }
+
+    Mapping(Mapping const &) = delete;
+    Mapping & operator=(Mapping const &) = delete;
+
+    ~Mapping() { ::munmap(_data, _size); }
+
+    uint8_t const * data() const { return static_cast<uint8_t const *>(_data); }
+    size_t size() const { return _size; }
+
+private:
+    void * _data;
+    size_t _size;
+};
+
+
+PointIndex::PointIndex(Pixelization const & pixelization) {
+    _type = detail::getPixelizationType(pixelization, _level, "PointIndex");
+    _pixelization = detail::makePixelization(_type, _level);
+    auto storage = std::make_shared<Storage>();
+    storage->offsets.push_back(0);
+    _attach(storage);
+}
+
+PointIndex::PointIndex(Pixelization const & pixelization,
+                       UnitVector3d const * points,
+                       size_t n,
+                       unsigned numThreads) :
+    PointIndex(pixelization)
+{
+    if (n == 0) {
+        return;
+    }
+    numThreads = static_cast<unsigned>(
+        std::max<size_t>(1, std::min<size_t>(numThreads, n)));
+    // Sort (pixel index, ID) pairs. Each slice is sorted by its own thread,
+    // and the sorted slices are then merged, which gives the same result
+    // as sorting all pairs at once.
+    std::vector<std::pair<uint64_t, uint64_t>> entries(n);
+    Pixelization const & p = *_pixelization;
+    forEachSlice(n, numThreads, [&](unsigned, size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            entries[i] = std::make_pair(p.index(points[i]),
+                                        static_cast<uint64_t>(i));
+        }
+        std::sort(entries.begin() + b, entries.begin() + e);
+    });
+    for (unsigned t = 1; t < numThreads; ++t) {
+        std::inplace_merge(entries.begin(),
+                           entries.begin() + t * n / numThreads,
+                           entries.begin() + (t + 1) * n / numThreads);
+    }
+    auto storage = std::make_shared<Storage>();
+    storage->points.reserve(n);
+    storage->ids.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t pixel = entries[i].first;
+        if (storage->pixels.empty() || storage->pixels.back() != pixel) {
+            storage->pixels.push_back(pixel);
+            storage->offsets.push_back(i);
+        }
+        storage->points.push_back(points[entries[i].second]);
+        storage->ids.push_back(entries[i].second);
+    }
+    storage->offsets.push_back(n);
+    _attach(storage);
+}
+
+std::vector<PointIndex::Span> PointIndex::getSpans(
+    RangeSet const & pixels) const
+{
+    std::vector<Span> spans;
+    for (auto const & range: pixels) {
+        Span s = _span(std::get<0>(range), std::get<1>(range));
+        if (s.first == s.second) {
+            continue;
+        }
+        if (!spans.empty() && spans.back().second == s.first) {
+            spans.back().second = s.second;
+        } else {
+            spans.push_back(s);
+        }
+    }
+    return spans;
+}
+
+std::vector<uint64_t> PointIndex::find(RangeSet const & pixels) const {
+    std::vector<uint64_t> ids;
+    for (Span const & s: getSpans(pixels)) {
+        ids.insert(ids.end(), _ids + s.first, _ids + s.second);
+    }
+    return ids;
+}
+
+std::vector<uint64_t> PointIndex::find(Region const & r) const {
+    RangeSet envelope, interior;
+    std::tie(envelope, interior) = _pixelization->envelopeAndInterior(r);
+    std::vector<Span> inside = getSpans(interior);
+    std::vector<Span> boundary = getSpans(envelope - interior);
+    // Visit both span lists in position order, so that IDs are returned
+    // in sorted order.
+    std::vector<uint64_t> ids;
+    auto i = inside.begin();
+    auto b = boundary.begin();
+    while (i != inside.end() || b != boundary.end()) {
+        if (b == boundary.end() || (i != inside.end() && i->first < b->first)) {
+            ids.insert(ids.end(), _ids + i->first, _ids + i->second);
+            ++i;
+        } else {
+            for (size_t p = b->first; p < b->second; ++p) {
+                if (r.contains(_points[p])) {
+                    ids.push_back(_ids[p]);
+                }
+            }
+            ++b;
+        }
+    }
+    return ids;
+}
+
+void PointIndex::save(std::string const & path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Cannot open point index file: " + path);
+    }
+    uint8_t header[HEADER_SIZE] = {};
+    uint64_t const values[3] = {BYTE_ORDER_MARK, _size, _numPixels};
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    header[8] = _type;
+    header[9] = static_cast<uint8_t>(_level);
+    std::memcpy(header + 16, values, sizeof(values));
+    file.write(reinterpret_cast<char const *>(header), HEADER_SIZE);
+    file.write(reinterpret_cast<char const *>(_points),
+               _size * sizeof(UnitVector3d));
+    file.write(reinterpret_cast<char const *>(_ids), _size * 8);
+    file.write(reinterpret_cast<char const *>(_pixels), _numPixels * 8);
+    file.write(reinterpret_cast<char const *>(_offsets),
+               (_numPixels + 1) * 8);
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Cannot write point index file: " + path);
+    }
+}
+
+PointIndex PointIndex::open(std::string const & path) {
+    auto mapping = std::make_shared<Mapping>(path);
+    uint8_t const * data = mapping->data();
+    uint64_t values[3];
+    std::memcpy(values, data + 16, sizeof(values));
+    if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 ||
+        values[0] != BYTE_ORDER_MARK) {
+        throw std::runtime_error(NOT_AN_INDEX + path);
+    }
+    PointIndex index;
+    index._type = data[8];
+    index._level = data[9];
+    try {
+        index._pixelization = detail::makePixelization(index._type,
+                                                       index._level);
+    } catch (std::invalid_argument const &) {
+        throw std::runtime_error(NOT_AN_INDEX + path);
+    }
+    // Check that the array sizes are consistent with the file size, taking
+    // care to avoid overflow.
+    size_t const available = mapping->size() - HEADER_SIZE;
+    uint64_t const n = values[1];
+    uint64_t const m = values[2];
+    if (n > available / 32 || m >= available / 8 ||
+        n * 32 + (2 * m + 1) * 8 != available) {
+        throw std::runtime_error(NOT_AN_INDEX + path);
+    }
+    index._size = static_cast<size_t>(n);
+    index._numPixels = static_cast<size_t>(m);
+    index._points = reinterpret_cast<UnitVector3d const *>(data + HEADER_SIZE);
+    index._ids = reinterpret_cast<uint64_t const *>(
+        data + HEADER_SIZE + n * sizeof(UnitVector3d));
+    index._pixels = index._ids + n;
+    index._offsets = index._pixels + m;
+    // Validate the pixel directory, but not the points and IDs, which
+    // would require reading the whole file.
+    auto const & universe = *index._pixelization->universe().begin();
+    for (size_t i = 0; i < m; ++i) {
+        if (index._pixels[i] < std::get<0>(universe) ||
+            index._pixels[i] >= std::get<1>(universe) ||
+            (i > 0 && index._pixels[i] <= index._pixels[i - 1]) ||
+            index._offsets[i + 1] <= index._offsets[i]) {
+            throw std::runtime_error(NOT_AN_INDEX + path);
+        }
+    }
+    if (index._offsets[0] != 0 || index._offsets[m] != n) {
+        throw std::runtime_error(NOT_AN_INDEX + path);
+    }
+    index._owner = mapping;
+    return index;
+}
+
+void PointIndex::_attach(std::shared_ptr<Storage const> storage) {
+    _points = storage->points.data();
+    _ids = storage->ids.data();
+    _pixels = storage->pixels.data();
+    _offsets = storage->offsets.data();
+    _size = storage->points.size();
+    _numPixels = storage->pixels.size();
+    _owner = std::move(storage);
+}
+
+PointIndex::Span PointIndex::_span(uint64_t first, uint64_t last) const {
+    // As for RangeSet, a range end point of 0 corresponds to 2^64.
+    uint64_t const * end = _pixels + _numPixels;
+    uint64_t const * b = std::lower_bound(_pixels, end, first);
+    uint64_t const * e = (last == 0) ? end : std::lower_bound(b, end, last);
+    return Span(_offsets[b - _pixels], _offsets[e - _pixels]);
+}
+
+}} // namespace lsst::sphgeom
@@ -0,0 +1,653 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains the Polygon class implementation.
+
+#include "lsst/sphgeom/Polygon.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+
+#include "lsst/sphgeom/Box3d.h"
+#include "lsst/sphgeom/CompoundRegion.h"
+#include "lsst/sphgeom/Ellipse.h"
+#include "lsst/sphgeom/LonLat.h"
+#include "lsst/sphgeom/codec.h"
+#include "lsst/sphgeom/orientation.h"
+
+#include "ConvexPolygonImpl.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+namespace {
+
+char const * const NOT_SIMPLE =
+    "Polygon boundary is not a simple closed curve";
+
+typedef std::array<size_t, 3> Triangle;
+
+// `normalizeCurve` removes repeated consecutive vertices from a closed
+// curve, and puts it in counter-clockwise order if `ccw` is true, or in
+// clockwise order otherwise. If `hull` is not null, the convex hull of the
+// curve is stored in it.
+std::vector<UnitVector3d> normalizeCurve(std::vector<UnitVector3d> const & c,
+                                         bool ccw,
+                                         ConvexPolygon * hull)
+{
+    std::vector<UnitVector3d> v;
+    v.reserve(c.size());
+    for (UnitVector3d const & p: c) {
+        if (v.empty() || p != v.back()) {
+            v.push_back(p);
+        }
+    }
+    while (v.size() > 1 && v.front() == v.back()) {
+        v.pop_back();
+    }
+    // This throws if the vertices are degenerate or do not lie in an open
+    // hemisphere.
+    ConvexPolygon h = ConvexPolygon::fastConvexHull(v);
+    // The curve turns in the direction of its orientation at a vertex of
+    // its convex hull.
+    size_t const n = v.size();
+    size_t i = std::find(v.begin(), v.end(), h.getVertices()[0]) - v.begin();
+    int o = orientation(v[(i + n - 1) % n], v[i], v[(i + 1) % n]);
+    if (o == 0) {
+        throw std::invalid_argument(NOT_SIMPLE);
+    }
+    if ((o > 0) != ccw) {
+        std::reverse(v.begin(), v.end());
+    }
+    if (hull != nullptr) {
+        *hull = std::move(h);
+    }
+    return v;
+}
+
+// `triangulate` splits the simple polygon with counter-clockwise vertices v
+// into triangles by ear clipping, and appends their vertex indexes to
+// `triangles`. Vertices at which the boundary does not turn are dropped.
+//
+// Only reflex vertices can lie inside a candidate ear, so the run time is
+// O(nr) for n vertices, r of which are reflex.
+void triangulate(std::vector<UnitVector3d> const & v,
+                 std::vector<Triangle> & triangles)
+{
+    size_t const n = v.size();
+    std::vector<size_t> prev(n);
+    std::vector<size_t> next(n);
+    for (size_t i = 0; i < n; ++i) {
+        prev[i] = (i + n - 1) % n;
+        next[i] = (i + 1) % n;
+    }
+    auto turn = [&](size_t i) {
+        return orientation(v[prev[i]], v[i], v[next[i]]);
+    };
+    std::vector<char> reflex(n, 0);
+    std::vector<size_t> reflexes;
+    for (size_t i = 0; i < n; ++i) {
+        if (turn(i) <= 0) {
+            reflex[i] = 1;
+            reflexes.push_back(i);
+        }
+    }
+    auto isEar = [&](size_t i) {
+        UnitVector3d const & a = v[prev[i]];
+        UnitVector3d const & b = v[i];
+        UnitVector3d const & c = v[next[i]];
+        for (size_t r: reflexes) {
+            if (!reflex[r] || v[r] == a || v[r] == b || v[r] == c) {
+                continue;
+            }
+            if (orientation(a, b, v[r]) >= 0 &&
+                orientation(b, c, v[r]) >= 0 &&
+                orientation(c, a, v[r]) >= 0) {
+                return false;
+            }
+        }
+        return true;
+    };
+    size_t remaining = n;
+    size_t misses = 0;
+    size_t i = 0;
+    while (remaining > 3) {
+        int o = turn(i);
+        if (o < 0 || (o > 0 && !isEar(i))) {
+            i = next[i];
+            if (++misses > remaining) {
+                throw std::invalid_argument(NOT_SIMPLE);
+            }
+            continue;
+        }
+        // Clip the ear at i, or drop i if the boundary does not turn there.
+        size_t p = prev[i];
+        size_t q = next[i];
+        if (o > 0) {
+            triangles.push_back(Triangle{{p, i, q}});
+        }
+        reflex[i] = 0;
+        next[p] = q;
+        prev[q] = p;
+        --remaining;
+        misses = 0;
+        for (size_t j: {p, q}) {
+            if (reflex[j] && turn(j) > 0) {
+                reflex[j] = 0;
+            }
+        }
+        i = p;
+    }
+    int o = turn(i);
+    if (o > 0) {
+        triangles.push_back(Triangle{{prev[i], i, next[i]}});
+    } else if (o < 0) {
+        throw std::invalid_argument(NOT_SIMPLE);
+    }
+}
+
+// `mergeTriangles` merges adjacent triangles across shared edges for as
+// long as the results remain strictly convex (the Hertel-Mehlhorn
+// algorithm), and returns the vertex indexes of the resulting pieces.
+std::vector<std::vector<size_t>> mergeTriangles(
+    std::vector<UnitVector3d> const & v,
+    std::vector<Triangle> const & triangles)
+{
+    std::vector<std::vector<size_t>> pieces;
+    std::map<std::pair<size_t, size_t>, size_t> owners;
+    for (Triangle const & t: triangles) {
+        for (int i = 0; i < 3; ++i) {
+            owners[std::make_pair(t[i], t[(i + 1) % 3])] = pieces.size();
+        }
+        pieces.emplace_back(t.begin(), t.end());
+    }
+    std::vector<size_t> parent(pieces.size());
+    std::iota(parent.begin(), parent.end(), size_t(0));
+    auto find = [&parent](size_t k) {
+        while (parent[k] != k) {
+            k = parent[k] = parent[parent[k]];
+        }
+        return k;
+    };
+    for (auto const & owner: owners) {
+        size_t a = owner.first.first;
+        size_t b = owner.first.second;
+        auto twin = owners.find(std::make_pair(b, a));
+        if (a > b || twin == owners.end()) {
+            continue;
+        }
+        size_t i = find(owner.second);
+        size_t j = find(twin->second);
+        std::vector<size_t> & p = pieces[i];
+        std::vector<size_t> & q = pieces[j];
+        // Rotate p so that it runs from b to a, and q so that it runs
+        // from a to b. The merged piece is then p followed by the interior
+        // of q, and is convex if it turns left at a and at b.
+        std::rotate(p.begin(), std::find(p.begin(), p.end(), b), p.end());
+        std::rotate(q.begin(), std::find(q.begin(), q.end(), a), q.end());
+        if (orientation(v[p[p.size() - 2]], v[a], v[q[1]]) <= 0 ||
+            orientation(v[q[q.size() - 2]], v[b], v[p[1]]) <= 0) {
+            continue;
+        }
+        p.insert(p.end(), q.begin() + 1, q.end() - 1);
+        q.clear();
+        parent[j] = i;
+    }
+    pieces.erase(std::remove_if(pieces.begin(), pieces.end(),
+                                [](std::vector<size_t> const & p) {
+                                    return p.empty();
+                                }),
+                 pieces.end());
+    return pieces;
+}
+
+} // unnamed namespace
+
+
+Polygon::Polygon(std::vector<UnitVector3d> const & boundary) :
+    Polygon(boundary, std::vector<std::vector<UnitVector3d>>())
+{}
+
+Polygon::Polygon(std::vector<UnitVector3d> const & boundary,
+                 std::vector<std::vector<UnitVector3d>> const & holes)
+{
+    _boundary = normalizeCurve(boundary, true, &_hull);
+    _holes.reserve(holes.size());
+    for (std::vector<UnitVector3d> const & h: holes) {
+        _holes.push_back(normalizeCurve(h, false, nullptr));
+    }
+    _build();
+}
+
+void Polygon::_build() {
+    // `addParts` splits the simple polygon with counter-clockwise
+    // vertices v into convex parts.
+    auto addParts = [](std::vector<UnitVector3d> const & v,
+                       std::vector<Part> & parts) {
+        std::vector<Triangle> triangles;
+        triangulate(v, triangles);
+        for (std::vector<size_t> const & piece: mergeTriangles(v, triangles)) {
+            ConvexPolygon p;
+            p._vertices.reserve(piece.size());
+            for (size_t i: piece) {
+                p._vertices.push_back(v[i]);
+            }
+            Circle c = p.getBoundingCircle();
+            parts.push_back(Part{std::move(p), c});
+        }
+    };
+    addParts(_boundary, _pieces);
+    for (std::vector<UnitVector3d> const & h: _holes) {
+        addParts(std::vector<UnitVector3d>(h.rbegin(), h.rend()), _holeParts);
+    }
+    // Walk along the boundary, starting at the first hull vertex. Every
+    // stretch of boundary between consecutive hull vertices that does not
+    // lie on the hull edge bounds one or more pockets. In reverse, it has
+    // counter-clockwise orientation.
+    std::vector<UnitVector3d> const & hull = _hull.getVertices();
+    size_t const n = _boundary.size();
+    size_t const start =
+        std::find(_boundary.begin(), _boundary.end(), hull[0]) -
+        _boundary.begin();
+    size_t k = 0;
+    std::vector<UnitVector3d> pocket(1, hull[0]);
+    for (size_t step = 1; step <= n; ++step) {
+        UnitVector3d const & v = _boundary[(start + step) % n];
+        UnitVector3d const & a = hull[k];
+        UnitVector3d const & b = hull[(k + 1) % hull.size()];
+        pocket.push_back(v);
+        // A boundary vertex on the hull edge splits the pocket in two.
+        if (v == b || orientation(a, b, v) == 0) {
+            if (pocket.size() > 2) {
+                addParts(std::vector<UnitVector3d>(pocket.rbegin(),
+                                                   pocket.rend()),
+                         _pockets);
+            }
+            pocket.assign(1, v);
+            if (v == b) {
+                ++k;
+            }
+        }
+    }
+    if (k != hull.size()) {
+        throw std::invalid_argument(NOT_SIMPLE);
+    }
+    _box = _hull.getBoundingBox();
+    _buildIndex();
+}
+
+void Polygon::_buildIndex() {
+    size_t const n = _pieces.size() + _holeParts.size();
+    if (n <= 16) {
+        return;
+    }
+    // Use about 2 cells per piece.
+    _numLat = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(n))));
+    _numLon = 2 * _numLat;
+    _cells.assign(static_cast<size_t>(_numLon) * _numLat,
+                  std::vector<uint32_t>());
+    for (size_t i = 0; i < n; ++i) {
+        Part const & p = i < _pieces.size() ? _pieces[i] :
+                         _holeParts[i - _pieces.size()];
+        Box b = p.polygon.getBoundingBox();
+        int lat0 = _latCell(b.getLat().getA());
+        int lat1 = _latCell(b.getLat().getB());
+        int lon0 = 0;
+        int lon1 = _numLon - 1;
+        if (!b.getLon().isFull()) {
+            lon0 = _lonCell(b.getLon().getA());
+            lon1 = _lonCell(b.getLon().getB());
+        }
+        for (int y = lat0; y <= lat1; ++y) {
+            for (int x = lon0; ; x = (x + 1) % _numLon) {
+                _cells[static_cast<size_t>(y) * _numLon + x].push_back(
+                    static_cast<uint32_t>(i));
+                if (x == lon1) {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+int Polygon::_lonCell(NormalizedAngle lon) const {
+    double width = _box.getLon().getSize().asRadians();
+    double d = _box.getLon().getA().getAngleTo(lon).asRadians();
+    if (d > width) {
+        // Angles slightly outside of the bounding box belong to the nearest
+        // end of it.
+        d = (d - width < 2.0 * PI - d) ? width : 0.0;
+    }
+    int x = static_cast<int>(d / width * _numLon);
+    return std::min(std::max(x, 0), _numLon - 1);
+}
+
+int Polygon::_latCell(Angle lat) const {
+    double a = _box.getLat().getA().asRadians();
+    double height = _box.getLat().getB().asRadians() - a;
+    int y = static_cast<int>((lat.asRadians() - a) / height * _numLat);
+    return std::min(std::max(y, 0), _numLat - 1);
+}
+
+bool Polygon::operator==(Polygon const & p) const {
+    return _boundary == p._boundary && _holes == p._holes;
+}
+
+Box Polygon::getBoundingBox() const {
+    return _box;
+}
+
+Box3d Polygon::getBoundingBox3d() const {
+    return _hull.getBoundingBox3d();
+}
+
+Circle Polygon::getBoundingCircle() const {
+    return _hull.getBoundingCircle();
+}
+
+bool Polygon::contains(UnitVector3d const & v) const {
+    if (_cells.empty()) {
+        bool inside = false;
+        for (Part const & p: _pieces) {
+            if (p.boundingCircle.contains(v) && p.polygon.contains(v)) {
+                inside = true;
+                break;
+            }
+        }
+        if (!inside) {
+            return false;
+        }
+        for (Part const & p: _holeParts) {
+            if (p.boundingCircle.contains(v) && p.polygon.contains(v)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    LonLat ll(v);
+    if (!_box.contains(ll)) {
+        return false;
+    }
+    std::vector<uint32_t> const & cell = _cells[
+        static_cast<size_t>(_latCell(ll.getLat())) * _numLon +
+        _lonCell(ll.getLon())];
+    bool inside = false;
+    for (uint32_t i: cell) {
+        if (i < _pieces.size()) {
+            inside = inside || _pieces[i].polygon.contains(v);
+        } else if (_holeParts[i - _pieces.size()].polygon.contains(v)) {
+            return false;
+        }
+    }
+    return inside;
+}
+
+template <typename RegionType>
+Relationship Polygon::_relate(RegionType const & r) const {
+    Relationship h = _hull.relate(r);
+    if ((h & DISJOINT) != 0) {
+        return DISJOINT;
+    }
+    Circle c = r.getBoundingCircle();
+    // This polygon is within r if its convex hull or all of its pieces are,
+    // and disjoint from r if all of its pieces are.
+    bool checkWithin = (h & WITHIN) == 0;
+    bool within = true;
+    bool disjoint = true;
+    for (Part const & p: _pieces) {
+        if (!disjoint && !(checkWithin && within)) {
+            break;
+        }
+        Relationship s = p.boundingCircle.isDisjointFrom(c) ?
+                         DISJOINT : p.polygon.relate(r);
+        disjoint = disjoint && (s & DISJOINT) != 0;
+        within = within && (s & WITHIN) != 0;
+    }
+    if (disjoint) {
+        return DISJOINT;
+    }
+    // This polygon contains r if its convex hull does, and r is disjoint
+    // from all pockets and holes. It is disjoint from r if r is within a
+    // piece of a hole.
+    bool contains = (h & CONTAINS) != 0;
+    for (Part const & p: _holeParts) {
+        if (p.boundingCircle.isDisjointFrom(c)) {
+            continue;
+        }
+        Relationship s = p.polygon.relate(r);
+        if ((s & CONTAINS) != 0) {
+            return DISJOINT;
+        }
+        contains = contains && (s & DISJOINT) != 0;
+    }
+    for (Part const & p: _pockets) {
+        if (!contains) {
+            break;
+        }
+        contains = p.boundingCircle.isDisjointFrom(c) ||
+                   (p.polygon.relate(r) & DISJOINT) != 0;
+    }
+    return (checkWithin && !within ? INTERSECTS : WITHIN) |
+           (contains ? CONTAINS : INTERSECTS);
+}
+
+Relationship Polygon::relate(Region const & r) const {
+    // Dispatch on the type of r.
+    return invert(r.relate(*this));
+}
+
+Relationship Polygon::relate(Box const & b) const {
+    return _relate(b);
+}
+
+Relationship Polygon::relate(Circle const & c) const {
+    return _relate(c);
+}
+
+Relationship Polygon::relate(ConvexPolygon const & p) const {
+    return _relate(p);
+}
+
+Relationship Polygon::relate(Ellipse const & e) const {
+    // Polygon-ellipse relations are computed with the bounding circle of
+    // the ellipse, as for convex polygons.
+    return _relate(e.getBoundingCircle()) & (CONTAINS | DISJOINT);
+}
+
+Relationship Polygon::relate(Polygon const & p) const {
+    // Shared boundaries defeat the tests below, so handle equal polygons
+    // up front.
+    if (*this == p) {
+        return CONTAINS | WITHIN;
+    }
+    if ((_hull.relate(p._hull) & DISJOINT) != 0) {
+        return DISJOINT;
+    }
+    // The pieces of either polygon cover it, so the polygons are disjoint
+    // if all pieces of one are disjoint from the other. Since pieces of a
+    // polygon with holes also cover the holes, the containment tests are
+    // conservative.
+    bool disjoint = true;
+    bool within = true;
+    for (Part const & q: _pieces) {
+        if (!disjoint && !within) {
+            break;
+        }
+        Relationship s = p._relate(q.polygon);
+        disjoint = disjoint && (s & DISJOINT) != 0;
+        within = within && (s & CONTAINS) != 0;
+    }
+    if (disjoint) {
+        return DISJOINT;
+    }
+    disjoint = true;
+    bool contains = true;
+    for (Part const & q: p._pieces) {
+        if (!disjoint && !contains) {
+            break;
+        }
+        Relationship s = _relate(q.polygon);
+        disjoint = disjoint && (s & DISJOINT) != 0;
+        contains = contains && (s & CONTAINS) != 0;
+    }
+    if (disjoint) {
+        return DISJOINT;
+    }
+    return (within ? WITHIN : INTERSECTS) | (contains ? CONTAINS : INTERSECTS);
+}
+
+Relationship Polygon::relate(CompoundRegion const & c) const {
+    // CompoundRegion-Polygon relations are implemented by CompoundRegion.
+    return invert(c.relate(*this));
+}
+
+std::vector<uint8_t> Polygon::encode() const {
+    std::vector<uint8_t> buffer;
+    uint8_t tc = TYPE_CODE;
+    buffer.push_back(tc);
+    encodeU64(1 + _holes.size(), buffer);
+    for (size_t i = 0; i <= _holes.size(); ++i) {
+        std::vector<UnitVector3d> const & c = i == 0 ? _boundary : _holes[i - 1];
+        encodeU64(c.size(), buffer);
+        for (UnitVector3d const & v: c) {
+            encodeDouble(v.x(), buffer);
+            encodeDouble(v.y(), buffer);
+            encodeDouble(v.z(), buffer);
+        }
+    }
+    return buffer;
+}
+
+std::unique_ptr<Polygon> Polygon::decode(uint8_t const * buffer, size_t n) {
+    char const * const NOT_ENCODED = "Byte-string is not an encoded Polygon";
+    if (buffer == nullptr || n < 9 || *buffer != TYPE_CODE) {
+        throw std::runtime_error(NOT_ENCODED);
+    }
+    uint8_t const * end = buffer + n;
+    uint64_t numCurves = decodeU64(buffer + 1);
+    buffer += 9;
+    if (numCurves == 0 || numCurves > static_cast<uint64_t>(end - buffer) / 8) {
+        throw std::runtime_error(NOT_ENCODED);
+    }
+    std::vector<std::vector<UnitVector3d>> curves(numCurves);
+    for (std::vector<UnitVector3d> & c: curves) {
+        if (end - buffer < 8) {
+            throw std::runtime_error(NOT_ENCODED);
+        }
+        uint64_t nv = decodeU64(buffer);
+        buffer += 8;
+        if (nv > static_cast<uint64_t>(end - buffer) / 24) {
+            throw std::runtime_error(NOT_ENCODED);
+        }
+        c.reserve(nv);
+        for (uint64_t i = 0; i < nv; ++i, buffer += 24) {
+            c.push_back(UnitVector3d::fromNormalized(
+                decodeDouble(buffer),
+                decodeDouble(buffer + 8),
+                decodeDouble(buffer + 16)
+            ));
+        }
+    }
+    if (buffer != end) {
+        throw std::runtime_error(NOT_ENCODED);
+    }
+    std::vector<std::vector<UnitVector3d>> holes(
+        std::make_move_iterator(curves.begin() + 1),
+        std::make_move_iterator(curves.end()));
+    return std::unique_ptr<Polygon>(new Polygon(curves[0], holes));
+}
+
+std::ostream & operator<<(std::ostream & os, Polygon const & p) {
+    auto print = [&os](std::vector<UnitVector3d> const & c) {
+        os << "[" << c[0];
+        for (size_t i = 1; i < c.size(); ++i) {
+            os << ", " << c[i];
+        }
+        os << "]";
+    };
+    os << "{\"Polygon\": [";
+    print(p.getBoundary());
+    for (std::vector<UnitVector3d> const & h: p.getHoles()) {
+        os << ", ";
+        print(h);
+    }
+    os << "]}";
+    return os;
+}
+
+
+namespace detail {
+
+Relationship polygonRelate(UnitVector3d const * v, size_t n,
+                           Polygon const & p)
+{
+    Relationship h = relate(v, v + n, p._hull);
+    if ((h & DISJOINT) != 0) {
+        return DISJOINT;
+    }
+    Circle c = boundingCircle(v, v + n);
+    bool disjoint = true;
+    for (Polygon::Part const & q: p._pieces) {
+        if (!q.boundingCircle.isDisjointFrom(c) &&
+            (relate(v, v + n, q.polygon) & DISJOINT) == 0) {
+            disjoint = false;
+            break;
+        }
+    }
+    if (disjoint) {
+        return DISJOINT;
+    }
+    // The convex polygon contains p if and only if it contains the convex
+    // hull of p. It is within p if it is within the hull and disjoint from
+    // all pockets and holes, and disjoint from p if it is within a hole.
+    bool within = (h & WITHIN) != 0;
+    for (Polygon::Part const & q: p._holeParts) {
+        if (q.boundingCircle.isDisjointFrom(c)) {
+            continue;
+        }
+        Relationship s = relate(v, v + n, q.polygon);
+        if ((s & WITHIN) != 0) {
+            return DISJOINT;
+        }
+        within = within && (s & DISJOINT) != 0;
+    }
+    for (Polygon::Part const & q: p._pockets) {
+        if (!within) {
+            break;
+        }
+        within = q.boundingCircle.isDisjointFrom(c) ||
+                 (relate(v, v + n, q.polygon) & DISJOINT) != 0;
+    }
+    return (h & CONTAINS) | (within ? WITHIN : INTERSECTS);
+}
+
+} // namespace detail
+
+}} // namespace lsst::sphgeom
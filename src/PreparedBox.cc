@@ -0,0 +1,194 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains the PreparedBox class implementation.
+
+#include "lsst/sphgeom/PreparedBox.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "lsst/sphgeom/LonLat.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+namespace {
+
+// Points are tested in blocks, so that the flags marking points that
+// require an exact test fit on the stack.
+constexpr size_t BLOCK_SIZE = 256;
+
+// `UnitVectors` and `Components` provide uniform access to the coordinates
+// of arrays of unit vectors and of separate coordinate arrays.
+struct UnitVectors {
+    UnitVector3d const * v;
+    double x(size_t i) const { return v[i].x(); }
+    double y(size_t i) const { return v[i].y(); }
+    double z(size_t i) const { return v[i].z(); }
+};
+
+struct Components {
+    double const * px;
+    double const * py;
+    double const * pz;
+    double x(size_t i) const { return px[i]; }
+    double y(size_t i) const { return py[i]; }
+    double z(size_t i) const { return pz[i]; }
+};
+
+} // unnamed namespace
+
+
+constexpr double PreparedBox::EPSILON;
+
+PreparedBox::PreparedBox(Box const & box) :
+    _box{box},
+    _empty{box.isEmpty()},
+    _lonTest{LonTest::FULL},
+    _zMin{-2.0},
+    _zMax{2.0},
+    _ax{0.0},
+    _ay{0.0},
+    _bx{0.0},
+    _by{0.0}
+{
+    if (_empty) {
+        return;
+    }
+    // Latitude bounds at the poles do not need to be tested, and are
+    // replaced by thresholds that no unit vector can be close to.
+    double latA = box.getLat().getA().asRadians();
+    double latB = box.getLat().getB().asRadians();
+    if (latA > -0.5 * PI) {
+        _zMin = std::sin(latA);
+    }
+    if (latB < 0.5 * PI) {
+        _zMax = std::sin(latB);
+    }
+    NormalizedAngleInterval const & lon = box.getLon();
+    if (lon.isFull()) {
+        return;
+    }
+    double a = lon.getA().asRadians();
+    double b = lon.getB().asRadians();
+    // The dot product of v with (-sin a, cos a, 0) is r sin(λ - a), where
+    // r and λ are the cylindrical radius and longitude of v. It is
+    // non-negative iff λ ∈ [a, a + π]. Similarly, the dot product of v with
+    // (sin b, -cos b, 0) is non-negative iff λ ∈ [b - π, b].
+    _ax = -std::sin(a);
+    _ay = std::cos(a);
+    _bx = std::sin(b);
+    _by = -std::cos(b);
+    // For a longitude interval no wider than π, [a, b] is the intersection
+    // of the two half-spaces. Otherwise, it is their union.
+    _lonTest = (lon.getSize().asRadians() <= PI) ? LonTest::NARROW :
+                                                   LonTest::WIDE;
+}
+
+void PreparedBox::contains(UnitVector3d const * v,
+                           size_t n,
+                           bool * results) const
+{
+    _contains(UnitVectors{v}, n, results);
+}
+
+void PreparedBox::contains(double const * x,
+                           double const * y,
+                           double const * z,
+                           size_t n,
+                           bool * results) const
+{
+    _contains(Components{x, y, z}, n, results);
+}
+
+template <typename Vectors>
+void PreparedBox::_contains(Vectors const & v,
+                            size_t n,
+                            bool * results) const
+{
+    if (_empty) {
+        for (size_t i = 0; i < n; ++i) {
+            results[i] = false;
+        }
+        return;
+    }
+    bool uncertain[BLOCK_SIZE];
+    for (size_t begin = 0; begin < n; begin += BLOCK_SIZE) {
+        size_t end = std::min(n, begin + BLOCK_SIZE);
+        switch (_lonTest) {
+            case LonTest::NARROW:
+                _containsBlock<LonTest::NARROW>(
+                    v, begin, end, results, uncertain);
+                break;
+            case LonTest::WIDE:
+                _containsBlock<LonTest::WIDE>(
+                    v, begin, end, results, uncertain);
+                break;
+            case LonTest::FULL:
+                _containsBlock<LonTest::FULL>(
+                    v, begin, end, results, uncertain);
+                break;
+        }
+        // Use the exact test for points that are too close to a boundary.
+        for (size_t i = begin; i < end; ++i) {
+            if (uncertain[i - begin]) {
+                results[i] = _box.contains(LonLat(Vector3d(
+                    v.x(i), v.y(i), v.z(i))));
+            }
+        }
+    }
+}
+
+template <PreparedBox::LonTest Test, typename Vectors>
+void PreparedBox::_containsBlock(Vectors const & v,
+                                 size_t begin,
+                                 size_t end,
+                                 bool * results,
+                                 bool * uncertain) const
+{
+    // This loop is branch-free, so that it can be vectorized.
+    for (size_t i = begin; i < end; ++i) {
+        double x = v.x(i);
+        double y = v.y(i);
+        double z = v.z(i);
+        bool in = (z >= _zMin) & (z <= _zMax);
+        bool close = (std::fabs(z - _zMin) <= EPSILON) |
+                     (std::fabs(z - _zMax) <= EPSILON);
+        if (Test != LonTest::FULL) {
+            double da = x * _ax + y * _ay;
+            double db = x * _bx + y * _by;
+            if (Test == LonTest::NARROW) {
+                in &= (da >= 0.0) & (db >= 0.0);
+            } else {
+                in &= (da >= 0.0) | (db >= 0.0);
+            }
+            close |= (std::fabs(da) <= EPSILON) | (std::fabs(db) <= EPSILON);
+        }
+        results[i] = in;
+        uncertain[i - begin] = close;
+    }
+}
+
+}} // namespace lsst::sphgeom
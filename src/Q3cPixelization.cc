@@ -224,11 +224,11 @@ private:
     using Base::visit;
 
 public:
-    Q3cPixelFinder(RangeSet & ranges,
-                   RegionType const & region,
-                   int level,
-                   size_t maxRanges):
-        Base(ranges, region, level, maxRanges)
+    Q3cPixelFinder(RegionType const & region,
+                   detail::PixelSink<false> & envelope,
+                   detail::PixelSink<true> & interior,
+                   TraversalStats * stats):
+        Base(region, envelope, interior, stats)
     {}
 
     void operator()() {
@@ -260,12 +260,16 @@ Q3cPixelization::Q3cPixelization(int level) : _level{level} {
 }
 
 ConvexPolygon Q3cPixelization::quad(uint64_t i) const {
+    return fixedQuad(i).toConvexPolygon();
+}
+
+FixedConvexPolygon<4> Q3cPixelization::fixedQuad(uint64_t i) const {
     if (i >= static_cast<uint64_t>(6) << (2 * _level)) {
         throw std::invalid_argument("Invalid Q3C index");
     }
     UnitVector3d verts[4];
     makeQuad(i, _level, verts);
-    return ConvexPolygon(verts[0], verts[1], verts[2], verts[3]);
+    return FixedConvexPolygon<4>(verts[0], verts[1], verts[2], verts[3]);
 }
 
 std::vector<uint64_t> Q3cPixelization::neighborhood(uint64_t i) const {
@@ -333,12 +337,112 @@ std::unique_ptr<Region> Q3cPixelization::pixel(uint64_t i) const {
     }
 #endif
 
-RangeSet Q3cPixelization::_envelope(Region const & r, size_t maxRanges) const {
-    return detail::findPixels<Q3cPixelFinder, false>(r, maxRanges, _level);
+RangeSet Q3cPixelization::envelope(Box const & r,
+                                   size_t maxRanges,
+                                   Coarsening coarsening,
+                                   TraversalStats * stats) const
+{
+    return detail::findPixels<Q3cPixelFinder, false>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet Q3cPixelization::envelope(Circle const & r,
+                                   size_t maxRanges,
+                                   Coarsening coarsening,
+                                   TraversalStats * stats) const
+{
+    return detail::findPixels<Q3cPixelFinder, false>(
+        r, maxRanges, _level, coarsening, stats);
 }
 
-RangeSet Q3cPixelization::_interior(Region const & r, size_t maxRanges) const {
-    return detail::findPixels<Q3cPixelFinder, true>(r, maxRanges, _level);
+RangeSet Q3cPixelization::envelope(ConvexPolygon const & r,
+                                   size_t maxRanges,
+                                   Coarsening coarsening,
+                                   TraversalStats * stats) const
+{
+    return detail::findPixels<Q3cPixelFinder, false>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet Q3cPixelization::interior(Box const & r,
+                                   size_t maxRanges,
+                                   Coarsening coarsening,
+                                   TraversalStats * stats) const
+{
+    return detail::findPixels<Q3cPixelFinder, true>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet Q3cPixelization::interior(Circle const & r,
+                                   size_t maxRanges,
+                                   Coarsening coarsening,
+                                   TraversalStats * stats) const
+{
+    return detail::findPixels<Q3cPixelFinder, true>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet Q3cPixelization::interior(ConvexPolygon const & r,
+                                   size_t maxRanges,
+                                   Coarsening coarsening,
+                                   TraversalStats * stats) const
+{
+    return detail::findPixels<Q3cPixelFinder, true>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet Q3cPixelization::_envelope(Region const & r,
+                                    size_t maxRanges,
+                                    Coarsening coarsening,
+                                    TraversalStats * stats) const
+{
+    return detail::findPixels<Q3cPixelFinder, false>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+RangeSet Q3cPixelization::_interior(Region const & r,
+                                    size_t maxRanges,
+                                    Coarsening coarsening,
+                                    TraversalStats * stats) const
+{
+    return detail::findPixels<Q3cPixelFinder, true>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+std::pair<RangeSet, RangeSet> Q3cPixelization::_envelopeAndInterior(
+    Region const & r,
+    size_t maxRanges,
+    Coarsening coarsening,
+    TraversalStats * stats) const
+{
+    return detail::findEnvelopeAndInterior<Q3cPixelFinder>(
+        r, maxRanges, _level, coarsening, stats);
+}
+
+MultiOrderCoverage Q3cPixelization::envelopeCoverage(
+    Region const & r,
+    TraversalStats * stats) const
+{
+    return detail::findCoverage<Q3cPixelFinder, false>(r, _level, stats);
+}
+
+MultiOrderCoverage Q3cPixelization::interiorCoverage(
+    Region const & r,
+    TraversalStats * stats) const
+{
+    return detail::findCoverage<Q3cPixelFinder, true>(r, _level, stats);
+}
+
+void Q3cPixelization::_streamEnvelope(Region const & r,
+                                      RangeCallback const & callback) const
+{
+    detail::streamPixels<Q3cPixelFinder, false>(r, _level, callback);
+}
+
+void Q3cPixelization::_streamInterior(Region const & r,
+                                      RangeCallback const & callback) const
+{
+    detail::streamPixels<Q3cPixelFinder, true>(r, _level, callback);
 }
 
 }} // namespace lsst::sphgeom
@@ -26,7 +26,14 @@
 #include "lsst/sphgeom/RangeSet.h"
 
 #include <algorithm>
+#include <exception>
+#include <functional>
 #include <ostream>
+#include <queue>
+#include <thread>
+#include <utility>
+
+#include "TraversalStatsImpl.h"
 
 
 namespace lsst {
@@ -63,7 +70,7 @@ struct RangeIter {
     RangeIter operator--(int) { RangeIter i(*this); ptr -= 2; return i; }
 
     RangeIter operator+(ptrdiff_t n) const { return RangeIter(ptr + 2 * n); }
-    RangeIter operator-(ptrdiff_t n) const { return RangeIter(ptr + 2 * n); }
+    RangeIter operator-(ptrdiff_t n) const { return RangeIter(ptr - 2 * n); }
 
     RangeIter & operator+=(ptrdiff_t n) { ptr += 2 * n; return *this; }
     RangeIter & operator-=(ptrdiff_t n) { ptr -= 2 * n; return *this; }
@@ -107,8 +114,13 @@ void RangeSet::insert(uint64_t first, uint64_t last) {
     } else {
         // Ensure that there is enough space for 2 new values in _ranges.
         // Afterwards, none of the possible modifications of _ranges will throw,
-        // so the strong exception safety guarantee is provided.
-        _ranges.reserve(_ranges.size() + 2);
+        // so the strong exception safety guarantee is provided. Capacity is
+        // grown geometrically, since reserving exactly the space needed would
+        // make every insert reallocate, and a series of appends quadratic.
+        if (_ranges.capacity() - _ranges.size() < 2) {
+            _ranges.reserve(2 * _ranges.size() + 2);
+            detail::countEvent(&detail::ThreadCounters::rangeSetReallocations);
+        }
         if (first <= last - 1) {
             _insert(first, last);
         } else {
@@ -613,6 +625,168 @@ bool RangeSet::_intersects(uint64_t const * a,
            _intersects(amid, aend, bmid, bend);
 }
 
+RangeSet RangeSet::coveredBy(RangeSet const * sets, size_t n, size_t k,
+                             unsigned numThreads)
+{
+    RangeSet result;
+    if (k == 0) {
+        result.fill();
+        return result;
+    }
+    if (k > n) {
+        return result;
+    }
+    size_t numPoints = 0;
+    for (size_t i = 0; i < n; ++i) {
+        numPoints += sets[i]._end() - sets[i]._begin();
+    }
+    // Choose slice boundaries by sampling the range end points, so that
+    // each slice contains roughly the same number of them. Slicing small
+    // inputs is not worth the thread start-up cost.
+    std::vector<uint64_t> splits;
+    if (numThreads > 1 && numPoints >= 4096u * numThreads) {
+        size_t stride = std::max<size_t>(1, numPoints / (64u * numThreads));
+        size_t j = 0;
+        std::vector<uint64_t> samples;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t const * b = sets[i]._begin();
+            size_t size = sets[i]._end() - b;
+            for (; j < size; j += stride) {
+                samples.push_back(b[j]);
+            }
+            j -= size;
+        }
+        std::sort(samples.begin(), samples.end());
+        for (unsigned t = 1; t < numThreads; ++t) {
+            uint64_t u = samples[t * samples.size() / numThreads];
+            if (u != 0 && (splits.empty() || u > splits.back())) {
+                splits.push_back(u);
+            }
+        }
+    }
+    std::vector<std::vector<uint64_t>> slices(splits.size() + 1);
+    if (splits.empty()) {
+        _coveredBy(slices[0], sets, n, k, 0, 0);
+    } else {
+        std::vector<std::thread> threads;
+        std::vector<std::exception_ptr> errors(slices.size());
+        for (size_t t = 0; t < slices.size(); ++t) {
+            uint64_t first = (t == 0) ? 0 : splits[t - 1];
+            uint64_t last = (t == splits.size()) ? 0 : splits[t];
+            threads.emplace_back([&, t, first, last]() {
+                try {
+                    _coveredBy(slices[t], sets, n, k, first, last);
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        for (std::thread & thread: threads) {
+            thread.join();
+        }
+        for (std::exception_ptr const & e: errors) {
+            if (e) {
+                std::rethrow_exception(e);
+            }
+        }
+    }
+    // Concatenate the slice results, merging ranges that abut at slice
+    // boundaries, and add bookends as necessary.
+    std::vector<uint64_t> & r = result._ranges;
+    r.clear();
+    r.push_back(0);
+    for (std::vector<uint64_t> const & slice: slices) {
+        for (size_t i = 0; i < slice.size(); i += 2) {
+            if (r.size() > 1 && r.back() == slice[i]) {
+                r.back() = slice[i + 1];
+            } else {
+                r.push_back(slice[i]);
+                r.push_back(slice[i + 1]);
+            }
+        }
+    }
+    if (r.size() == 1) {
+        r.push_back(0);
+        return result;
+    }
+    result._offset = (r[1] != 0);
+    if (!result._offset) {
+        r.erase(r.begin());
+    }
+    if (r.back() != 0) {
+        r.push_back(0);
+    }
+    return result;
+}
+
+void RangeSet::_coveredBy(std::vector<uint64_t> & out,
+                          RangeSet const * sets, size_t n, size_t k,
+                          uint64_t first, uint64_t last)
+{
+    // Perform a k-way merge of the range end points in [first, last),
+    // where a last value of 0 corresponds to 2^64, while tracking the
+    // number of sets containing the current sweep position.
+    using Point = std::pair<uint64_t, size_t>;
+    std::priority_queue<Point, std::vector<Point>, std::greater<Point>> heap;
+    std::vector<uint64_t const *> begins(n);
+    std::vector<uint64_t const *> ptrs(n);
+    std::vector<uint64_t const *> ends(n);
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t const * b = sets[i]._begin();
+        uint64_t const * e = sets[i]._end();
+        // Drop trailing zero bookends. Since the number of remaining end
+        // points is then odd, the last range extends to 2^64 as required.
+        if (e != b && e[-1] == 0) {
+            --e;
+        }
+        // The number of end points <= first determines whether or not
+        // first belongs to the set.
+        uint64_t const * p = std::upper_bound(b, e, first);
+        count += (p - b) & 1;
+        begins[i] = b;
+        ptrs[i] = p;
+        ends[i] = e;
+        if (p != e && (last == 0 || *p < last)) {
+            heap.emplace(*p, i);
+        }
+    }
+    bool inside = count >= k;
+    uint64_t start = first;
+    while (!heap.empty()) {
+        uint64_t u = heap.top().first;
+        // Process all the end points with value u.
+        do {
+            size_t i = heap.top().second;
+            heap.pop();
+            uint64_t const * p = ptrs[i];
+            if (((p - begins[i]) & 1) == 0) {
+                ++count;
+            } else {
+                --count;
+            }
+            ptrs[i] = ++p;
+            if (p != ends[i] && (last == 0 || *p < last)) {
+                heap.emplace(*p, i);
+            }
+        } while (!heap.empty() && heap.top().first == u);
+        bool in = count >= k;
+        if (in != inside) {
+            if (in) {
+                start = u;
+            } else {
+                out.push_back(start);
+                out.push_back(u);
+            }
+            inside = in;
+        }
+    }
+    if (inside) {
+        out.push_back(start);
+        out.push_back(last);
+    }
+}
+
 std::ostream & operator<<(std::ostream & os, RangeSet const & s) {
     os << "{\"RangeSet\": [";
     bool first = true;
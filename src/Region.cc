@@ -29,8 +29,10 @@
 
 #include "lsst/sphgeom/Box.h"
 #include "lsst/sphgeom/Circle.h"
+#include "lsst/sphgeom/CompoundRegion.h"
 #include "lsst/sphgeom/ConvexPolygon.h"
 #include "lsst/sphgeom/Ellipse.h"
+#include "lsst/sphgeom/Polygon.h"
 
 
 namespace lsst {
@@ -49,6 +51,12 @@ std::unique_ptr<Region> Region::decode(uint8_t const * buffer, size_t n) {
         return ConvexPolygon::decode(buffer, n);
     } else if (type == Ellipse::TYPE_CODE) {
         return Ellipse::decode(buffer, n);
+    } else if (type == Polygon::TYPE_CODE) {
+        return Polygon::decode(buffer, n);
+    } else if (type == UnionRegion::TYPE_CODE ||
+               type == IntersectionRegion::TYPE_CODE ||
+               type == DifferenceRegion::TYPE_CODE) {
+        return CompoundRegion::decode(buffer, n);
     }
     throw std::runtime_error("Byte-string is not an encoded Region");
 }
@@ -0,0 +1,98 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains the RegionValue class implementation.
+
+#include "lsst/sphgeom/RegionValue.h"
+
+#include <stdexcept>
+#include <utility>
+
+
+namespace lsst {
+namespace sphgeom {
+
+RegionValue::RegionValue(Region const & r) {
+    if (Box const * b = dynamic_cast<Box const *>(&r)) {
+        _type = Type::BOX;
+        new (&_box) Box(*b);
+    } else if (Circle const * c = dynamic_cast<Circle const *>(&r)) {
+        _type = Type::CIRCLE;
+        new (&_circle) Circle(*c);
+    } else if (ConvexPolygon const * p =
+               dynamic_cast<ConvexPolygon const *>(&r)) {
+        _type = Type::CONVEX_POLYGON;
+        new (&_polygon) ConvexPolygon(*p);
+    } else if (Ellipse const * e = dynamic_cast<Ellipse const *>(&r)) {
+        _type = Type::ELLIPSE;
+        new (&_ellipse) Ellipse(*e);
+    } else {
+        throw std::invalid_argument("Region type has no RegionValue form");
+    }
+}
+
+void RegionValue::decodeInPlace(uint8_t const * buffer, size_t n) {
+    if (buffer == nullptr || n == 0) {
+        throw std::runtime_error("Byte-string is not an encoded Region");
+    }
+    uint8_t type = *buffer;
+    if (type == Box::TYPE_CODE) {
+        _emplace(Type::BOX);
+        _box._decode(buffer, n);
+    } else if (type == Circle::TYPE_CODE) {
+        _emplace(Type::CIRCLE);
+        _circle._decode(buffer, n);
+    } else if (type == ConvexPolygon::TYPE_CODE) {
+        if (_type == Type::CONVEX_POLYGON) {
+            _polygon._decode(buffer, n);
+        } else {
+            // A default constructed polygon has no vertices, and is not a
+            // valid region, so decode into a temporary that replaces the
+            // current region only if the byte string is valid.
+            ConvexPolygon p;
+            p._decode(buffer, n);
+            *this = RegionValue(std::move(p));
+        }
+    } else if (type == Ellipse::TYPE_CODE) {
+        _emplace(Type::ELLIPSE);
+        _ellipse._decode(buffer, n);
+    } else {
+        throw std::runtime_error("Byte-string is not an encoded Region");
+    }
+}
+
+void RegionValue::_emplace(Type type) {
+    if (_type == type) {
+        return;
+    }
+    _destroy();
+    _type = type;
+    switch (type) {
+        case Type::BOX: new (&_box) Box(); break;
+        case Type::CIRCLE: new (&_circle) Circle(); break;
+        case Type::CONVEX_POLYGON: new (&_polygon) ConvexPolygon(); break;
+        default: new (&_ellipse) Ellipse(); break;
+    }
+}
+
+}} // namespace lsst::sphgeom
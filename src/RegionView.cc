@@ -0,0 +1,290 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains the RegionView class implementation.
+
+#include "lsst/sphgeom/RegionView.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include "lsst/sphgeom/codec.h"
+
+#include "ConvexPolygonImpl.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+namespace {
+
+// `EncodedVertexIterator` iterates over the vertices of an encoded
+// ConvexPolygon, decoding each one as it is dereferenced. This allows the
+// ConvexPolygon implementation templates to run directly on encoded bytes.
+class EncodedVertexIterator {
+public:
+    struct Arrow {
+        UnitVector3d v;
+        UnitVector3d const * operator->() const { return &v; }
+    };
+
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = UnitVector3d;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Arrow;
+    using reference = UnitVector3d;
+
+    explicit EncodedVertexIterator(uint8_t const * p) : _p(p) {}
+
+    UnitVector3d operator*() const {
+        return UnitVector3d::fromNormalized(decodeDouble(_p),
+                                            decodeDouble(_p + 8),
+                                            decodeDouble(_p + 16));
+    }
+
+    Arrow operator->() const { return Arrow{**this}; }
+
+    EncodedVertexIterator & operator++() { _p += 24; return *this; }
+    EncodedVertexIterator & operator--() { _p -= 24; return *this; }
+
+    EncodedVertexIterator operator++(int) {
+        EncodedVertexIterator i = *this;
+        _p += 24;
+        return i;
+    }
+
+    EncodedVertexIterator operator--(int) {
+        EncodedVertexIterator i = *this;
+        _p -= 24;
+        return i;
+    }
+
+    bool operator==(EncodedVertexIterator const & i) const {
+        return _p == i._p;
+    }
+
+    bool operator!=(EncodedVertexIterator const & i) const {
+        return _p != i._p;
+    }
+
+private:
+    uint8_t const * _p;
+};
+
+bool isPolygon(RegionView const & r) {
+    return r.getTypeCode() == ConvexPolygon::TYPE_CODE;
+}
+
+EncodedVertexIterator beginVertices(RegionView const & r) {
+    return EncodedVertexIterator(r.data() + 1);
+}
+
+EncodedVertexIterator endVertices(RegionView const & r) {
+    return EncodedVertexIterator(r.data() + r.size());
+}
+
+// `withVertices` calls f with a pair of vertex iterators for the encoded
+// polygon r. Vertices of small polygons are decoded into a stack array
+// first, since the polygon algorithms dereference each vertex several times.
+template <typename F>
+auto withVertices(RegionView const & r, F f) {
+    static constexpr size_t MAX_STACK_VERTICES = 16;
+    size_t const n = r.getNumVertices();
+    if (n <= MAX_STACK_VERTICES) {
+        UnitVector3d vertices[MAX_STACK_VERTICES];
+        std::copy(beginVertices(r), endVertices(r), vertices);
+        return f(vertices, vertices + n);
+    }
+    return f(beginVertices(r), endVertices(r));
+}
+
+// `relateTo` computes the relationship between the encoded region v and r.
+template <typename RegionType>
+Relationship relateTo(RegionView const & v, RegionType const & r) {
+    if (!isPolygon(v)) {
+        return v.decode().relate(r);
+    }
+    return withVertices(v, [&r](auto begin, auto end) {
+        return detail::relate(begin, end, r);
+    });
+}
+
+template <typename Offset>
+std::vector<RegionView> viewColumn(uint8_t const * data,
+                                   Offset const * offsets,
+                                   size_t n)
+{
+    std::vector<RegionView> views;
+    views.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        if (offsets[i + 1] < offsets[i]) {
+            throw std::runtime_error("Binary column offsets must not decrease");
+        }
+        size_t size = static_cast<size_t>(offsets[i + 1] - offsets[i]);
+        if (size == 0) {
+            views.emplace_back();
+        } else {
+            views.emplace_back(data + offsets[i], size);
+        }
+    }
+    return views;
+}
+
+} // unnamed namespace
+
+
+std::vector<RegionView> RegionView::fromColumn(uint8_t const * data,
+                                               int32_t const * offsets,
+                                               size_t n)
+{
+    return viewColumn(data, offsets, n);
+}
+
+std::vector<RegionView> RegionView::fromColumn(uint8_t const * data,
+                                               int64_t const * offsets,
+                                               size_t n)
+{
+    return viewColumn(data, offsets, n);
+}
+
+RegionView::RegionView(uint8_t const * buffer, size_t n) :
+    _data(buffer),
+    _size(n)
+{
+    bool valid = false;
+    if (buffer != nullptr && n != 0) {
+        switch (buffer[0]) {
+            case Box::TYPE_CODE:
+                valid = (n == Box::ENCODED_SIZE);
+                break;
+            case Circle::TYPE_CODE:
+                valid = (n == Circle::ENCODED_SIZE);
+                break;
+            case ConvexPolygon::TYPE_CODE:
+                valid = (n >= 1 + 24*3 && (n - 1) % 24 == 0);
+                break;
+            case Ellipse::TYPE_CODE:
+                valid = (n == Ellipse::ENCODED_SIZE);
+                break;
+        }
+    }
+    if (!valid) {
+        throw std::runtime_error("Byte-string is not an encoded Region");
+    }
+}
+
+UnitVector3d RegionView::getVertex(size_t i) const {
+    if (i >= getNumVertices()) {
+        throw std::out_of_range("Vertex index out of range");
+    }
+    return *EncodedVertexIterator(_data + 1 + 24 * i);
+}
+
+Box RegionView::getBoundingBox() const {
+    if (isPolygon(*this)) {
+        return withVertices(*this, [](auto begin, auto end) {
+            return detail::boundingBox(begin, end);
+        });
+    }
+    return decode().getBoundingBox();
+}
+
+Box3d RegionView::getBoundingBox3d() const {
+    if (isPolygon(*this)) {
+        return withVertices(*this, [](auto begin, auto end) {
+            return detail::boundingBox3d(begin, end);
+        });
+    }
+    return decode().getBoundingBox3d();
+}
+
+Circle RegionView::getBoundingCircle() const {
+    if (isPolygon(*this)) {
+        return withVertices(*this, [](auto begin, auto end) {
+            return detail::boundingCircle(begin, end);
+        });
+    }
+    return decode().getBoundingCircle();
+}
+
+bool RegionView::contains(UnitVector3d const & v) const {
+    if (isPolygon(*this)) {
+        return withVertices(*this, [&v](auto begin, auto end) {
+            return detail::contains(begin, end, v);
+        });
+    }
+    return decode().contains(v);
+}
+
+Relationship RegionView::relate(Region const & r) const {
+    if (Box const * b = dynamic_cast<Box const *>(&r)) {
+        return relate(*b);
+    } else if (Circle const * c = dynamic_cast<Circle const *>(&r)) {
+        return relate(*c);
+    } else if (ConvexPolygon const * p =
+               dynamic_cast<ConvexPolygon const *>(&r)) {
+        return relate(*p);
+    } else if (Ellipse const * e = dynamic_cast<Ellipse const *>(&r)) {
+        return relate(*e);
+    }
+    return decode().relate(r);
+}
+
+Relationship RegionView::relate(Box const & b) const {
+    return relateTo(*this, b);
+}
+
+Relationship RegionView::relate(Circle const & c) const {
+    return relateTo(*this, c);
+}
+
+Relationship RegionView::relate(ConvexPolygon const & p) const {
+    return relateTo(*this, p);
+}
+
+Relationship RegionView::relate(Ellipse const & e) const {
+    return relateTo(*this, e);
+}
+
+Relationship RegionView::relate(RegionValue const & r) const {
+    return r.visit([this](auto const & s) { return this->relate(s); });
+}
+
+Relationship RegionView::relate(RegionView const & r) const {
+    if (!isPolygon(r)) {
+        return relate(r.decode());
+    }
+    if (!isPolygon(*this)) {
+        // Relations between non-polygonal regions and polygons are
+        // implemented by the polygons.
+        return invert(r.relate(decode()));
+    }
+    return withVertices(*this, [&r](auto begin1, auto end1) {
+        return withVertices(r, [&](auto begin2, auto end2) {
+            return detail::relate(begin1, end1, begin2, end2);
+        });
+    });
+}
+
+}} // namespace lsst::sphgeom
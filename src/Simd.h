@@ -0,0 +1,335 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_SIMD_H_
+#define LSST_SPHGEOM_SIMD_H_
+
+/// \file
+/// \brief This file contains helpers for writing batch kernels that are
+///        compiled for several vector instruction sets.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "lsst/sphgeom/InstructionSet.h"
+
+
+// Vector kernels rely on the GCC vector extensions and on the target
+// function attribute, which GCC and Clang support. As elsewhere, defining
+// NO_SIMD disables them.
+#if !defined(NO_SIMD) && defined(__x86_64__) && \
+    (defined(__GNUC__) || defined(__clang__))
+#   define LSST_SPHGEOM_X86_DISPATCH 1
+#else
+#   define LSST_SPHGEOM_X86_DISPATCH 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#   define LSST_SPHGEOM_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#   define LSST_SPHGEOM_ALWAYS_INLINE inline
+#endif
+
+// Kernels must give the same results for all instruction sets, so no
+// version may contract multiplies and adds into fused multiply-adds. The
+// scalar version would otherwise use them whenever the compiler targets a
+// CPU that supports them, e.g. with -march=native, and the vector versions
+// always could.
+//
+// GCC decides whether to contract per function, so the functions that run
+// kernels are marked with LSST_SPHGEOM_NO_CONTRACT. Clang decides per
+// expression, so the code making up kernels, here and in the files that
+// define them, is enclosed in LSST_SPHGEOM_BEGIN_KERNELS and
+// LSST_SPHGEOM_END_KERNELS.
+#if defined(__clang__)
+#   define LSST_SPHGEOM_NO_CONTRACT
+#   define LSST_SPHGEOM_BEGIN_KERNELS \
+        _Pragma("float_control(push)") \
+        _Pragma("clang fp contract(off)")
+#   define LSST_SPHGEOM_END_KERNELS _Pragma("float_control(pop)")
+#elif defined(__GNUC__)
+#   define LSST_SPHGEOM_NO_CONTRACT \
+        __attribute__((optimize("fp-contract=off")))
+#   define LSST_SPHGEOM_BEGIN_KERNELS
+#   define LSST_SPHGEOM_END_KERNELS
+#else
+#   define LSST_SPHGEOM_NO_CONTRACT
+#   define LSST_SPHGEOM_BEGIN_KERNELS
+#   define LSST_SPHGEOM_END_KERNELS
+#endif
+
+#if LSST_SPHGEOM_X86_DISPATCH
+#   include <x86intrin.h>
+#   define LSST_SPHGEOM_TARGET(isa) \
+        __attribute__((target(isa))) LSST_SPHGEOM_NO_CONTRACT
+#endif
+
+
+namespace lsst {
+namespace sphgeom {
+namespace detail {
+
+LSST_SPHGEOM_BEGIN_KERNELS
+
+#if LSST_SPHGEOM_X86_DISPATCH
+typedef double Double4 __attribute__((vector_size(32)));
+typedef double Double8 __attribute__((vector_size(64)));
+typedef uint64_t Bits4 __attribute__((vector_size(32)));
+typedef uint64_t Bits8 __attribute__((vector_size(64)));
+#endif
+
+// `Bits<V>` is the type with as many unsigned 64 bit integer lanes as V has
+// doubles.
+template <typename V> struct BitsOf;
+template <> struct BitsOf<double> { using Type = uint64_t; };
+#if LSST_SPHGEOM_X86_DISPATCH
+template <> struct BitsOf<Double4> { using Type = Bits4; };
+template <> struct BitsOf<Double8> { using Type = Bits8; };
+#endif
+
+template <typename V>
+using Bits = typename BitsOf<V>::Type;
+
+// A kernel is written once, as a class derived from VectorKernel, in terms
+// of the helpers below and of the arithmetic operators, where V is either
+// double or one of the vector types above. Helpers take vectors by
+// reference, since vectors passed by value to functions compiled without
+// the corresponding instruction set trigger ABI warnings.
+
+// `lanes<V>` returns the number of doubles in V.
+template <typename V>
+constexpr size_t lanes() { return sizeof(V) / sizeof(double); }
+
+template <typename V>
+LSST_SPHGEOM_ALWAYS_INLINE void load(V & v, double const * p) {
+    std::memcpy(&v, p, sizeof(V));
+}
+
+template <typename V>
+LSST_SPHGEOM_ALWAYS_INLINE void store(double * p, V const & v) {
+    std::memcpy(p, &v, sizeof(V));
+}
+
+template <typename V, size_t... K>
+LSST_SPHGEOM_ALWAYS_INLINE void splat(V & v,
+                                      double d,
+                                      std::index_sequence<K...>)
+{
+    v = V{(static_cast<void>(K), d)...};
+}
+
+template <typename V>
+LSST_SPHGEOM_ALWAYS_INLINE void splat(V & v, double d) {
+    splat(v, d, std::make_index_sequence<lanes<V>()>());
+}
+
+template <>
+LSST_SPHGEOM_ALWAYS_INLINE void splat<double>(double & v, double d) {
+    v = d;
+}
+
+// `broadcast<V>(d)` returns a V with all lanes equal to d.
+template <typename V>
+LSST_SPHGEOM_ALWAYS_INLINE V broadcast(double d) {
+    V v;
+    splat(v, d);
+    return v;
+}
+
+// `toBits` and `fromBits` reinterpret the lanes of V as integers and back.
+template <typename V>
+LSST_SPHGEOM_ALWAYS_INLINE Bits<V> toBits(V const & v) {
+    Bits<V> b;
+    std::memcpy(&b, &v, sizeof(V));
+    return b;
+}
+
+template <typename V>
+LSST_SPHGEOM_ALWAYS_INLINE V fromBits(Bits<V> const & b) {
+    V v;
+    std::memcpy(&v, &b, sizeof(V));
+    return v;
+}
+
+// A mask is a Bits<V> value with lanes equal to either 0 or ~0.
+// `mask<V>(c)` converts the result c of a comparison involving V values to
+// a mask. Vector comparisons produce masks of signed integers, and scalar
+// comparisons produce bools.
+template <typename V, typename C>
+LSST_SPHGEOM_ALWAYS_INLINE Bits<V> mask(C const & c) {
+    return (Bits<V>) c;
+}
+
+template <typename V>
+LSST_SPHGEOM_ALWAYS_INLINE Bits<V> mask(bool c) {
+    return -static_cast<uint64_t>(c);
+}
+
+// `select(m, a, b)` returns a where m is set, and b elsewhere.
+template <typename V>
+LSST_SPHGEOM_ALWAYS_INLINE V select(Bits<V> const & m,
+                                    V const & a,
+                                    V const & b)
+{
+    return fromBits<V>((toBits(a) & m) | (toBits(b) & ~m));
+}
+
+// `squareRoot` returns the correctly rounded square roots of the lanes of v.
+LSST_SPHGEOM_ALWAYS_INLINE double squareRoot(double const & v) {
+    return std::sqrt(v);
+}
+
+// `storeLessEqual` sets p[k] to a[k] <= b[k].
+LSST_SPHGEOM_ALWAYS_INLINE void storeLessEqual(bool * p,
+                                               double const & a,
+                                               double const & b)
+{
+    *p = a <= b;
+}
+
+#if LSST_SPHGEOM_X86_DISPATCH
+// `spreadBits` returns the 4 byte integer with bit 0 of byte k equal to bit
+// k of m, i.e. the bool array {m & 1, m & 2, m & 4, m & 8}.
+LSST_SPHGEOM_ALWAYS_INLINE uint32_t spreadBits(unsigned m) {
+    return (m & 1) | ((m & 2) << 7) | ((m & 4) << 14) | ((m & 8) << 21);
+}
+
+// The vector versions of the helpers using intrinsics cannot be forcibly
+// inlined into kernels, which are compiled for a specific instruction set
+// only once inlined themselves.
+inline LSST_SPHGEOM_TARGET("avx2")
+Double4 squareRoot(Double4 const & v) {
+    return _mm256_sqrt_pd(v);
+}
+
+inline LSST_SPHGEOM_TARGET("avx512f")
+Double8 squareRoot(Double8 const & v) {
+    // The masked form avoids a spurious GCC warning about the undefined
+    // source operand of _mm512_sqrt_pd.
+    return _mm512_mask_sqrt_pd(v, 0xff, v);
+}
+
+inline LSST_SPHGEOM_TARGET("avx2")
+void storeLessEqual(bool * p, Double4 const & a, Double4 const & b) {
+    uint32_t m = spreadBits(static_cast<unsigned>(
+        _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ))));
+    std::memcpy(p, &m, sizeof(m));
+}
+
+inline LSST_SPHGEOM_TARGET("avx512f")
+void storeLessEqual(bool * p, Double8 const & a, Double8 const & b) {
+    unsigned k = _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ);
+    uint64_t m = spreadBits(k & 0xf) |
+                 (static_cast<uint64_t>(spreadBits(k >> 4)) << 32);
+    std::memcpy(p, &m, sizeof(m));
+}
+#endif
+
+// `prepare<V>(arg)` converts a kernel argument to the form that kernel
+// steps using V receive. Doubles are broadcast to all lanes of V, and other
+// arguments are copied, unless an overload of `prepare` for them can be
+// found by argument dependent lookup.
+template <typename V, typename T>
+LSST_SPHGEOM_ALWAYS_INLINE T prepare(T const & arg) {
+    return arg;
+}
+
+template <typename V>
+LSST_SPHGEOM_ALWAYS_INLINE V prepare(double const & arg) {
+    return broadcast<V>(arg);
+}
+
+// `VectorKernel` is a base class for kernels that process arrays element
+// by element. The derived class must provide `step<V>(i, args...)`, which
+// processes elements [i, i + lanes<V>()), and inherits a `run<V>(n, args...)`
+// that processes elements [0, n), using V for all but the last few.
+//
+// Arguments are prepared once before stepping through the arrays, since
+// GCC does not move vector broadcasts out of loops. Prepared arguments are
+// local, so the compiler can also tell that stores to the output arrays do
+// not modify them, and keep them in registers.
+template <typename Derived>
+struct VectorKernel {
+    template <typename V, typename... Args>
+    static LSST_SPHGEOM_ALWAYS_INLINE void run(size_t n, Args const & ... args) {
+        size_t i = steps<V>(0, n, prepare<V>(args)...);
+        steps<double>(i, n, prepare<double>(args)...);
+    }
+
+    // `steps` processes elements [i, j) with the largest j <= n such that
+    // j - i is a multiple of lanes<V>(), and returns j.
+    template <typename V, typename... Args>
+    static LSST_SPHGEOM_ALWAYS_INLINE size_t steps(size_t i,
+                                                   size_t n,
+                                                   Args const & ... args)
+    {
+        for (; i + lanes<V>() <= n; i += lanes<V>()) {
+            Derived::template step<V>(i, args...);
+        }
+        return i;
+    }
+};
+
+template <typename Kernel, typename... Args>
+LSST_SPHGEOM_NO_CONTRACT void runScalar(Args const & ... args) {
+    Kernel::template run<double>(args...);
+}
+
+#if LSST_SPHGEOM_X86_DISPATCH
+template <typename Kernel, typename... Args>
+LSST_SPHGEOM_TARGET("avx2") void runAvx2(Args const & ... args) {
+    Kernel::template run<Double4>(args...);
+}
+
+template <typename Kernel, typename... Args>
+LSST_SPHGEOM_TARGET("avx512f") void runAvx512(Args const & ... args) {
+    Kernel::template run<Double8>(args...);
+}
+#endif
+
+// `dispatch` calls Kernel::run<V>(args...), where V is the widest vector
+// type usable with the instruction set in effect.
+template <typename Kernel, typename... Args>
+void dispatch(Args const & ... args) {
+#if LSST_SPHGEOM_X86_DISPATCH
+    switch (getInstructionSet()) {
+        case InstructionSet::AVX512:
+            runAvx512<Kernel>(args...);
+            return;
+        case InstructionSet::AVX2:
+            runAvx2<Kernel>(args...);
+            return;
+        default:
+            break;
+    }
+#endif
+    runScalar<Kernel>(args...);
+}
+
+LSST_SPHGEOM_END_KERNELS
+
+}}} // namespace lsst::sphgeom::detail
+
+#endif // LSST_SPHGEOM_SIMD_H_
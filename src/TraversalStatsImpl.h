@@ -0,0 +1,137 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_SPHGEOM_TRAVERSALSTATSIMPL_H_
+#define LSST_SPHGEOM_TRAVERSALSTATSIMPL_H_
+
+/// \file
+/// \brief This file contains helpers for recording search statistics.
+///
+/// If NO_TRAVERSAL_STATS is defined, all of them do nothing, and
+/// TraversalStats objects passed to searches are left untouched.
+
+#include <cstdint>
+
+#include "lsst/sphgeom/Relationship.h"
+#include "lsst/sphgeom/TraversalStats.h"
+
+
+namespace lsst {
+namespace sphgeom {
+namespace detail {
+
+// `ThreadCounters` counts events inside low-level routines that have no
+// access to the statistics of the search that caused them. The counters are
+// per-thread, so a search can attribute the changes that occur while it
+// runs to itself.
+struct ThreadCounters {
+    uint64_t exactOrientations = 0;
+    uint64_t rangeSetReallocations = 0;
+};
+
+inline ThreadCounters & threadCounters() {
+    static thread_local ThreadCounters counters;
+    return counters;
+}
+
+// `countEvent` increments a per-thread counter.
+inline void countEvent(uint64_t ThreadCounters::* counter) {
+#if !defined(NO_TRAVERSAL_STATS)
+    ++(threadCounters().*counter);
+#else
+    static_cast<void>(counter);
+#endif
+}
+
+// `count` increments a counter of `stats`, if it is not null.
+inline void count(TraversalStats * stats,
+                  uint64_t TraversalStats::* counter)
+{
+#if !defined(NO_TRAVERSAL_STATS)
+    if (stats != nullptr) {
+        ++(stats->*counter);
+    }
+#else
+    static_cast<void>(stats);
+    static_cast<void>(counter);
+#endif
+}
+
+// `countVisit` records a comparison between the region and a node (pixel
+// or chunk) at the given level with relationship r, where r describes the
+// node relative to the region.
+inline void countVisit(TraversalStats * stats, int level, Relationship r) {
+#if !defined(NO_TRAVERSAL_STATS)
+    if (stats != nullptr) {
+        if (level >= 0 && level <= TraversalStats::MAX_LEVEL) {
+            ++stats->nodesVisited[level];
+        }
+        if ((r & DISJOINT) != 0) {
+            ++stats->disjoint;
+        } else if ((r & WITHIN) != 0) {
+            ++stats->within;
+        } else {
+            ++stats->intersects;
+        }
+    }
+#else
+    static_cast<void>(stats);
+    static_cast<void>(level);
+    static_cast<void>(r);
+#endif
+}
+
+// `ThreadCountersScope` adds the per-thread counter increments that occur
+// during its lifetime to `stats`, if it is not null.
+class ThreadCountersScope {
+public:
+    explicit ThreadCountersScope(TraversalStats * stats) : _stats{stats} {
+#if !defined(NO_TRAVERSAL_STATS)
+        if (_stats != nullptr) {
+            _start = threadCounters();
+        }
+#endif
+    }
+
+    ThreadCountersScope(ThreadCountersScope const &) = delete;
+    ThreadCountersScope & operator=(ThreadCountersScope const &) = delete;
+
+    ~ThreadCountersScope() {
+#if !defined(NO_TRAVERSAL_STATS)
+        if (_stats != nullptr) {
+            ThreadCounters const & end = threadCounters();
+            _stats->exactOrientations +=
+                end.exactOrientations - _start.exactOrientations;
+            _stats->rangeSetReallocations +=
+                end.rangeSetReallocations - _start.rangeSetReallocations;
+        }
+#endif
+    }
+
+private:
+    TraversalStats * _stats;
+    ThreadCounters _start;
+};
+
+}}} // namespace lsst::sphgeom::detail
+
+#endif // LSST_SPHGEOM_TRAVERSALSTATSIMPL_H_
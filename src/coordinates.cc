@@ -0,0 +1,272 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains the implementation of the batch coordinate
+///        conversion functions.
+
+#include "lsst/sphgeom/coordinates.h"
+
+#include <cmath>
+
+#include "lsst/sphgeom/LonLat.h"
+#include "lsst/sphgeom/constants.h"
+#include "lsst/sphgeom/UnitVector3d.h"
+
+#if !defined(__clang__) && defined(__GNUC__)
+    // Kernel vectors are only passed by value to inlined functions, so the
+    // warnings about their calling convention are irrelevant. GCC may
+    // report them at the end of the file, so they are ignored for all of it.
+#   pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+#include "Simd.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+using detail::Bits;
+using detail::broadcast;
+using detail::dispatch;
+using detail::fromBits;
+using detail::load;
+using detail::mask;
+using detail::select;
+using detail::squareRoot;
+using detail::store;
+using detail::toBits;
+using detail::VectorKernel;
+
+namespace {
+
+LSST_SPHGEOM_BEGIN_KERNELS
+
+// Fast conversions reduce angles modulo π/2 with a two part approximation
+// of π/2 (see fdlibm). The first part has 33 significant bits, so that its
+// products with integers below 2²⁰ are exact, which limits the magnitude
+// of the angles that can be reduced.
+constexpr double MAX_REDUCIBLE_ANGLE = 1.0e6;
+constexpr double TWO_OVER_PI = 6.36619772367581382433e-01;
+constexpr double PIO2_1 = 1.57079632673412561417e+00;
+constexpr double PIO2_1T = 6.07710050650619224932e-11;
+// Adding 1.5·2⁵² to a double with magnitude below 2⁵¹ rounds it to an
+// integer, and stores that integer in the low bits of the sum.
+constexpr double ROUNDING_SHIFT = 6755399441055744.0;
+
+// Coefficients of the fdlibm polynomial approximations of sin and cos on
+// [-π/4, π/4].
+constexpr double S1 = -1.66666666666666324348e-01;
+constexpr double S2 = 8.33333333332248946124e-03;
+constexpr double S3 = -1.98412698298579493134e-04;
+constexpr double S4 = 2.75573137070700676789e-06;
+constexpr double S5 = -2.50507602534068634195e-08;
+constexpr double S6 = 1.58969099521155010221e-10;
+constexpr double C1 = 4.16666666666666019037e-02;
+constexpr double C2 = -1.38888888888741095749e-03;
+constexpr double C3 = 2.48015872894767294178e-05;
+constexpr double C4 = -2.75573143513906633035e-07;
+constexpr double C5 = 2.08757232129817482790e-09;
+constexpr double C6 = -1.13596475577881948265e-11;
+
+// Coefficients of the Cephes rational approximation of atan on
+// [-0.21, 0.66], and the part of π/4 that PIO4 lacks.
+constexpr double P0 = -8.750608600031904122785e-01;
+constexpr double P1 = -1.615753718733365076637e+01;
+constexpr double P2 = -7.500855792314704667340e+01;
+constexpr double P3 = -1.228866684490136173410e+02;
+constexpr double P4 = -6.485021904942025371773e+01;
+constexpr double Q0 = 2.485846490142306297962e+01;
+constexpr double Q1 = 1.650270098316988542046e+02;
+constexpr double Q2 = 4.328810604912902668951e+02;
+constexpr double Q3 = 4.853903996359136964868e+02;
+constexpr double Q4 = 1.945506571482613964425e+02;
+constexpr double PIO4 = 0.25 * PI;
+constexpr double PIO4_TAIL = 3.061616997868382943065e-17;
+
+constexpr double PIO2 = 0.5 * PI;
+constexpr double TWO_PI = 2.0 * PI;
+constexpr uint64_t SIGN_BIT = uint64_t(1) << 63;
+
+template <typename V>
+LSST_SPHGEOM_ALWAYS_INLINE V magnitude(V const & v) {
+    return fromBits<V>(toBits(v) & ~SIGN_BIT);
+}
+
+// `sinCos` sets s and c to the sines and cosines of the lanes of a, which
+// must have magnitudes of at most MAX_REDUCIBLE_ANGLE. Bits 0 and 1 of the
+// quadrant index k select the reduced function and its sign.
+template <typename V>
+LSST_SPHGEOM_ALWAYS_INLINE void sinCos(V & s, V & c, V const & a) {
+    V shifted = a * TWO_OVER_PI + ROUNDING_SHIFT;
+    Bits<V> q = toBits(shifted);
+    V k = shifted - ROUNDING_SHIFT;
+    V r = (a - k * PIO2_1) - k * PIO2_1T;
+    V z = r * r;
+    V sinR = r + (z * r) * (S1 + z * (S2 + z * (S3 + z * (S4 + z * (
+                 S5 + z * S6)))));
+    V hz = 0.5 * z;
+    V w = 1.0 - hz;
+    V cosR = w + (((1.0 - w) - hz) + z * (z * (C1 + z * (C2 + z * (
+                 C3 + z * (C4 + z * (C5 + z * C6)))))));
+    Bits<V> odd = -(q & 1);
+    s = fromBits<V>(toBits(select(odd, cosR, sinR)) ^ ((q & 2) << 62));
+    c = fromBits<V>(toBits(select(odd, sinR, cosR)) ^ (((q + 1) & 2) << 62));
+}
+
+// `atanRatio` returns the arc tangents of num/den, where 0 ≤ num ≤ den,
+// and 0 where den is 0. Ratios above 0.66 are reduced with
+// atan(t) = π/4 + atan((t - 1)/(t + 1)), where num - den is exact.
+template <typename V>
+LSST_SPHGEOM_ALWAYS_INLINE V atanRatio(V const & num, V const & den) {
+    Bits<V> big = mask<V>(num > 0.66 * den);
+    V d = select(big, num + den, den);
+    V u = select(big, num - den, num) /
+          select(mask<V>(d == 0.0), broadcast<V>(1.0), d);
+    V z = u * u;
+    V p = (((P0 * z + P1) * z + P2) * z + P3) * z + P4;
+    V q = ((((z + Q0) * z + Q1) * z + Q2) * z + Q3) * z + Q4;
+    V a = u * (z * p / q) + u;
+    return select(big, PIO4 + (a + PIO4_TAIL), a);
+}
+
+// `atan2Positive` returns the arc tangents of y/x in [0, π/2] for
+// non-negative y and x.
+template <typename V>
+LSST_SPHGEOM_ALWAYS_INLINE V atan2Positive(V const & y, V const & x) {
+    Bits<V> swap = mask<V>(y > x);
+    V a = atanRatio(select(swap, x, y), select(swap, y, x));
+    return select(swap, PIO2 - a, a);
+}
+
+struct ToUnitVectors : VectorKernel<ToUnitVectors> {
+    template <typename V>
+    static LSST_SPHGEOM_ALWAYS_INLINE void step(size_t i,
+                                                double const * const & lon,
+                                                double const * const & lat,
+                                                double * const & x,
+                                                double * const & y,
+                                                double * const & z)
+    {
+        V vlon, vlat, sinLon, cosLon, sinLat, cosLat;
+        load(vlon, lon + i);
+        load(vlat, lat + i);
+        sinCos(sinLon, cosLon, vlon);
+        sinCos(sinLat, cosLat, vlat);
+        store(x + i, cosLon * cosLat);
+        store(y + i, sinLon * cosLat);
+        store(z + i, sinLat);
+    }
+};
+
+// See LonLat::longitudeOf and LonLat::latitudeOf.
+struct ToLonLats : VectorKernel<ToLonLats> {
+    template <typename V>
+    static LSST_SPHGEOM_ALWAYS_INLINE void step(size_t i,
+                                                double const * const & x,
+                                                double const * const & y,
+                                                double const * const & z,
+                                                double * const & lon,
+                                                double * const & lat)
+    {
+        V vx, vy, vz;
+        load(vx, x + i);
+        load(vy, y + i);
+        load(vz, z + i);
+        V d2 = vx * vx + vy * vy;
+        V a = atan2Positive(magnitude(vy), magnitude(vx));
+        a = select(mask<V>(vx < 0.0), PI - a, a);
+        a = select(mask<V>(vy < 0.0), TWO_PI - a, a);
+        store(lon + i, select(mask<V>(d2 == 0.0), broadcast<V>(0.0), a));
+        V b = atan2Positive(magnitude(vz), squareRoot(d2));
+        store(lat + i, select(mask<V>(vz < 0.0), -b, b));
+    }
+};
+
+void toUnitVector(double lon, double lat, double & x, double & y, double & z) {
+    UnitVector3d v(Angle::fromRadians(lon), Angle::fromRadians(lat));
+    x = v.x();
+    y = v.y();
+    z = v.z();
+}
+
+void toLonLat(double x, double y, double z, double & lon, double & lat) {
+    LonLat p(Vector3d(x, y, z));
+    lon = p.getLon().asRadians();
+    lat = p.getLat().asRadians();
+}
+
+LSST_SPHGEOM_END_KERNELS
+
+} // unnamed namespace
+
+
+void toUnitVectors(double const * lon,
+                   double const * lat,
+                   size_t n,
+                   double * x,
+                   double * y,
+                   double * z,
+                   ConversionMode mode)
+{
+    if (mode == ConversionMode::EXACT) {
+        for (size_t i = 0; i < n; ++i) {
+            toUnitVector(lon[i], lat[i], x[i], y[i], z[i]);
+        }
+        return;
+    }
+    dispatch<ToUnitVectors>(n, lon, lat, x, y, z);
+    // Convert the points with angles that cannot be reduced, including
+    // non-finite ones, exactly.
+    for (size_t i = 0; i < n; ++i) {
+        if (!(std::fabs(lon[i]) <= MAX_REDUCIBLE_ANGLE &&
+              std::fabs(lat[i]) <= MAX_REDUCIBLE_ANGLE)) {
+            toUnitVector(lon[i], lat[i], x[i], y[i], z[i]);
+        }
+    }
+}
+
+void toLonLats(double const * x,
+               double const * y,
+               double const * z,
+               size_t n,
+               double * lon,
+               double * lat,
+               ConversionMode mode)
+{
+    if (mode == ConversionMode::EXACT) {
+        for (size_t i = 0; i < n; ++i) {
+            toLonLat(x[i], y[i], z[i], lon[i], lat[i]);
+        }
+        return;
+    }
+    dispatch<ToLonLats>(n, x, y, z, lon, lat);
+    // Convert the vectors with infinite or NaN components, or for which
+    // intermediate results overflow, exactly.
+    for (size_t i = 0; i < n; ++i) {
+        if (!std::isfinite(x[i] * x[i] + y[i] * y[i] + z[i] * z[i])) {
+            toLonLat(x[i], y[i], z[i], lon[i], lat[i]);
+        }
+    }
+}
+
+}} // namespace lsst::sphgeom
@@ -29,6 +29,8 @@
 
 #include "lsst/sphgeom/BigInteger.h"
 
+#include "TraversalStatsImpl.h"
+
 
 namespace lsst {
 namespace sphgeom {
@@ -77,6 +79,7 @@ int orientationExact(Vector3d const & a,
                      Vector3d const & b,
                      Vector3d const & c)
 {
+    detail::countEvent(&detail::ThreadCounters::exactOrientations);
     // Product mantissa storage buffers.
     uint32_t mantissaBuffers[6][6];
     // Product mantissas.
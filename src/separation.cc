@@ -0,0 +1,293 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains the implementation of the batch separation
+///        functions.
+
+#include "lsst/sphgeom/separation.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "lsst/sphgeom/Circle.h"
+
+#if !defined(__clang__) && defined(__GNUC__)
+    // Kernel vectors are only passed by value to inlined functions, so the
+    // warnings about their calling convention are irrelevant. GCC may
+    // report them at the end of the file, so they are ignored for all of it.
+#   pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+#include "Simd.h"
+
+
+namespace lsst {
+namespace sphgeom {
+
+using detail::dispatch;
+using detail::lanes;
+using detail::load;
+using detail::splat;
+using detail::store;
+using detail::storeLessEqual;
+using detail::VectorKernel;
+
+namespace {
+
+LSST_SPHGEOM_BEGIN_KERNELS
+
+// Angular separations are computed in blocks, so that the intermediate
+// results fit on the stack.
+constexpr size_t BLOCK_SIZE = 256;
+
+// `Points` and `Center` provide uniform access to the components of an
+// array of points, and of a single point broadcast to all lanes.
+struct Points {
+    double const * x;
+    double const * y;
+    double const * z;
+
+    template <typename V>
+    LSST_SPHGEOM_ALWAYS_INLINE void get(V & vx, V & vy, V & vz,
+                                        size_t i) const {
+        load(vx, x + i);
+        load(vy, y + i);
+        load(vz, z + i);
+    }
+
+    Points offset(size_t i) const { return Points{x + i, y + i, z + i}; }
+};
+
+template <typename V>
+struct CenterLanes {
+    V x;
+    V y;
+    V z;
+
+    LSST_SPHGEOM_ALWAYS_INLINE void get(V & vx, V & vy, V & vz,
+                                        size_t) const {
+        vx = x;
+        vy = y;
+        vz = z;
+    }
+};
+
+struct Center {
+    double x;
+    double y;
+    double z;
+
+    Center offset(size_t) const { return *this; }
+};
+
+template <typename V>
+LSST_SPHGEOM_ALWAYS_INLINE CenterLanes<V> prepare(Center const & c) {
+    CenterLanes<V> lanes;
+    splat(lanes.x, c.x);
+    splat(lanes.y, c.y);
+    splat(lanes.z, c.z);
+    return lanes;
+}
+
+Center makeCenter(UnitVector3d const & v) {
+    return Center{v.x(), v.y(), v.z()};
+}
+
+// `squaredChordLength` computes (v - c).getSquaredNorm(), performing the
+// same floating point operations in the same order.
+template <typename V, typename A>
+LSST_SPHGEOM_ALWAYS_INLINE void squaredChordLength(V & d,
+                                                   A const & c,
+                                                   Points const & v,
+                                                   size_t i)
+{
+    V cx, cy, cz, vx, vy, vz;
+    c.get(cx, cy, cz, i);
+    v.get(vx, vy, vz, i);
+    V dx = vx - cx;
+    V dy = vy - cy;
+    V dz = vz - cz;
+    d = dx * dx + dy * dy + dz * dz;
+}
+
+struct SquaredChordLengths : VectorKernel<SquaredChordLengths> {
+    template <typename V, typename A>
+    static LSST_SPHGEOM_ALWAYS_INLINE void step(size_t i,
+                                                A const & c,
+                                                Points const & v,
+                                                double * const & results)
+    {
+        V d;
+        squaredChordLength(d, c, v, i);
+        store(results + i, d);
+    }
+};
+
+struct WithinRadius : VectorKernel<WithinRadius> {
+    template <typename V, typename A>
+    static LSST_SPHGEOM_ALWAYS_INLINE void step(size_t i,
+                                                A const & c,
+                                                Points const & v,
+                                                V const & threshold,
+                                                bool * const & results)
+    {
+        V d;
+        squaredChordLength(d, c, v, i);
+        storeLessEqual(results + i, d, threshold);
+    }
+};
+
+// `CrossAndDot` computes the squared norm of c.cross(v) and c.dot(v),
+// performing the same floating point operations in the same order.
+struct CrossAndDot : VectorKernel<CrossAndDot> {
+    template <typename V, typename A>
+    static LSST_SPHGEOM_ALWAYS_INLINE void step(size_t i,
+                                                A const & c,
+                                                Points const & v,
+                                                double * const & crossNorm2,
+                                                double * const & dot)
+    {
+        V cx, cy, cz, vx, vy, vz;
+        c.get(cx, cy, cz, i);
+        v.get(vx, vy, vz, i);
+        V x = cy * vz - cz * vy;
+        V y = cz * vx - cx * vz;
+        V z = cx * vy - cy * vx;
+        store(crossNorm2 + i, x * x + y * y + z * z);
+        store(dot + i, cx * vx + cy * vy + cz * vz);
+    }
+};
+
+template <typename A>
+void angularSeparations(A const & c,
+                        Points const & v,
+                        size_t n,
+                        double * results)
+{
+    double crossNorm2[BLOCK_SIZE];
+    double dot[BLOCK_SIZE];
+    for (size_t begin = 0; begin < n; begin += BLOCK_SIZE) {
+        size_t m = std::min(n - begin, BLOCK_SIZE);
+        dispatch<CrossAndDot>(m, c.offset(begin), v.offset(begin),
+                              &crossNorm2[0], &dot[0]);
+        // See NormalizedAngle(Vector3d const &, Vector3d const &).
+        for (size_t i = 0; i < m; ++i) {
+            double s = std::sqrt(crossNorm2[i]);
+            results[begin + i] = (s == 0.0 && dot[i] == 0.0) ?
+                                 0.0 : std::atan2(s, dot[i]);
+        }
+    }
+}
+
+template <typename A>
+void withinRadius(A const & c,
+                  Points const & v,
+                  Angle radius,
+                  size_t n,
+                  bool * results)
+{
+    // See Circle::contains(UnitVector3d const &).
+    double threshold = Circle::squaredChordLengthFor(radius);
+    if (threshold >= 4.0) {
+        std::fill(results, results + n, true);
+        return;
+    }
+    dispatch<WithinRadius>(n, c, v, threshold, results);
+}
+
+LSST_SPHGEOM_END_KERNELS
+
+} // unnamed namespace
+
+
+void getSquaredChordLengths(UnitVector3d const & center,
+                            double const * x,
+                            double const * y,
+                            double const * z,
+                            size_t n,
+                            double * results)
+{
+    dispatch<SquaredChordLengths>(n, makeCenter(center), Points{x, y, z},
+                                  results);
+}
+
+void getSquaredChordLengths(double const * x1,
+                            double const * y1,
+                            double const * z1,
+                            double const * x2,
+                            double const * y2,
+                            double const * z2,
+                            size_t n,
+                            double * results)
+{
+    dispatch<SquaredChordLengths>(n, Points{x1, y1, z1}, Points{x2, y2, z2},
+                                  results);
+}
+
+void getAngularSeparations(UnitVector3d const & center,
+                           double const * x,
+                           double const * y,
+                           double const * z,
+                           size_t n,
+                           double * results)
+{
+    angularSeparations(makeCenter(center), Points{x, y, z}, n, results);
+}
+
+void getAngularSeparations(double const * x1,
+                           double const * y1,
+                           double const * z1,
+                           double const * x2,
+                           double const * y2,
+                           double const * z2,
+                           size_t n,
+                           double * results)
+{
+    angularSeparations(Points{x1, y1, z1}, Points{x2, y2, z2}, n, results);
+}
+
+void isWithinRadius(UnitVector3d const & center,
+                    Angle radius,
+                    double const * x,
+                    double const * y,
+                    double const * z,
+                    size_t n,
+                    bool * results)
+{
+    withinRadius(makeCenter(center), Points{x, y, z}, radius, n, results);
+}
+
+void isWithinRadius(double const * x1,
+                    double const * y1,
+                    double const * z1,
+                    double const * x2,
+                    double const * y2,
+                    double const * z2,
+                    Angle radius,
+                    size_t n,
+                    bool * results)
+{
+    withinRadius(Points{x1, y1, z1}, Points{x2, y2, z2}, radius, n, results);
+}
+
+}} // namespace lsst::sphgeom
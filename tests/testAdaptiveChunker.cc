@@ -0,0 +1,201 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains tests for the AdaptiveChunker class.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "lsst/sphgeom/AdaptiveChunker.h"
+#include "lsst/sphgeom/Box.h"
+#include "lsst/sphgeom/Circle.h"
+#include "lsst/sphgeom/HtmPixelization.h"
+#include "lsst/sphgeom/LonLat.h"
+#include "lsst/sphgeom/Q3cPixelization.h"
+
+#include "test.h"
+
+
+using namespace lsst::sphgeom;
+
+namespace {
+
+// `makePoints` returns random points, most of which lie within a few
+// degrees of the equator.
+std::vector<UnitVector3d> makePoints(size_t n) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::normal_distribution<double> normal(0.0, 3.0);
+    std::vector<UnitVector3d> points;
+    for (size_t i = 0; i < n; ++i) {
+        double lon = 360.0 * uniform(generator);
+        double lat = (i % 10 == 0) ?
+            std::asin(2.0 * uniform(generator) - 1.0) * 180.0 / PI :
+            std::max(-89.0, std::min(89.0, normal(generator)));
+        points.push_back(UnitVector3d(LonLat::fromDegrees(lon, lat)));
+    }
+    return points;
+}
+
+AdaptiveChunker makeChunker(Pixelization const & pixelization,
+                            std::vector<UnitVector3d> const & points,
+                            uint64_t maxRowsPerChunk) {
+    std::vector<uint64_t> indexes;
+    for (UnitVector3d const & v: points) {
+        indexes.push_back(pixelization.index(v));
+    }
+    std::vector<uint64_t> counts(indexes.size(), 1);
+    return AdaptiveChunker(pixelization, indexes, counts, maxRowsPerChunk);
+}
+
+} // unnamed namespace
+
+
+TEST_CASE(Partitioning) {
+    HtmPixelization htm(6);
+    std::vector<UnitVector3d> points = makePoints(20000);
+    AdaptiveChunker chunker = makeChunker(htm, points, 100);
+    CHECK(chunker.getNumChunks() >= 200);
+    CHECK(static_cast<int32_t>(chunker.getAllChunks().size()) ==
+          chunker.getNumChunks());
+    uint64_t total = 0;
+    RangeSet pixels;
+    for (int32_t c: chunker.getAllChunks()) {
+        RangeSet p = chunker.getPixels(c);
+        CHECK(p.size() == 1);
+        CHECK(p.isDisjointFrom(pixels));
+        pixels |= p;
+        // Only chunks consisting of a single pixel may exceed the limit.
+        CHECK(chunker.getRowCount(c) <= 100 || p.cardinality() == 1);
+        total += chunker.getRowCount(c);
+    }
+    CHECK(total == points.size());
+    CHECK(pixels == htm.universe());
+    // Points are assigned to the chunks containing their pixels, and chunk
+    // row counts match the points they contain.
+    std::vector<uint64_t> counts(chunker.getNumChunks(), 0);
+    for (UnitVector3d const & v: points) {
+        int32_t c = chunker.getChunk(v);
+        REQUIRE(chunker.valid(c));
+        CHECK(chunker.getPixels(c).contains(htm.index(v)));
+        ++counts[c];
+    }
+    for (int32_t c: chunker.getAllChunks()) {
+        CHECK(counts[c] == chunker.getRowCount(c));
+    }
+    // Any two consecutive chunks hold more than the maximum number of rows,
+    // and chunk areas vary with the density of points.
+    CHECK(chunker.getNumChunks() <= 2 * 20000 / 100 + 1);
+    uint64_t minPixels = htm.universe().cardinality();
+    uint64_t maxPixels = 0;
+    for (int32_t c: chunker.getAllChunks()) {
+        minPixels = std::min(minPixels, chunker.getPixels(c).cardinality());
+        maxPixels = std::max(maxPixels, chunker.getPixels(c).cardinality());
+    }
+    CHECK(maxPixels > 10 * minPixels);
+    CHECK(!chunker.valid(-1));
+    CHECK(!chunker.valid(chunker.getNumChunks()));
+    CHECK_THROW(chunker.getPixels(chunker.getNumChunks()),
+                std::invalid_argument);
+    CHECK_THROW(chunker.getRowCount(-1), std::invalid_argument);
+}
+
+TEST_CASE(EmptyHistogram) {
+    Q3cPixelization q3c(4);
+    AdaptiveChunker chunker(q3c, {}, {}, 10);
+    CHECK(chunker.getNumChunks() == 1);
+    CHECK(chunker.getPixels(0) == q3c.universe());
+    CHECK(chunker.getChunk(UnitVector3d::X()) == 0);
+    CHECK(chunker.getChunksIntersecting(Box::full()) ==
+          std::vector<int32_t>{0});
+    CHECK_THROW(AdaptiveChunker(q3c, {1, 2}, {1}, 10), std::invalid_argument);
+    CHECK_THROW(AdaptiveChunker(q3c, {1}, {1}, 0), std::invalid_argument);
+    CHECK_THROW(AdaptiveChunker(q3c, {6 << 8}, {1}, 10),
+                std::invalid_argument);
+}
+
+TEST_CASE(Queries) {
+    HtmPixelization htm(7);
+    std::vector<UnitVector3d> points = makePoints(20000);
+    AdaptiveChunker chunker = makeChunker(htm, points, 300);
+    Circle c(UnitVector3d(LonLat::fromDegrees(100.0, 2.0)),
+             Angle::fromDegrees(5.0));
+    std::vector<int32_t> chunkIds = chunker.getChunksIntersecting(c);
+    CHECK(std::is_sorted(chunkIds.begin(), chunkIds.end()));
+    CHECK(std::adjacent_find(chunkIds.begin(), chunkIds.end()) ==
+          chunkIds.end());
+    CHECK(chunkIds.size() > 1);
+    std::vector<int32_t> coarse = chunker.getChunksIntersecting(c, 4);
+    CHECK(std::includes(coarse.begin(), coarse.end(),
+                        chunkIds.begin(), chunkIds.end()));
+    for (UnitVector3d const & v: points) {
+        if (c.contains(v)) {
+            CHECK(std::binary_search(chunkIds.begin(), chunkIds.end(),
+                                     chunker.getChunk(v)));
+        }
+        std::vector<int32_t> near =
+            chunker.getChunksNear(v, Angle::fromDegrees(0.1));
+        CHECK(std::binary_search(near.begin(), near.end(),
+                                 chunker.getChunk(v)));
+    }
+    // A chunk is near all points within the overlap distance of it.
+    UnitVector3d v = points[0];
+    std::vector<int32_t> near = chunker.getChunksNear(v, Angle::fromDegrees(1.0));
+    for (UnitVector3d const & w: points) {
+        if (Circle(v, Angle::fromDegrees(1.0)).contains(w)) {
+            CHECK(std::binary_search(near.begin(), near.end(),
+                                     chunker.getChunk(w)));
+        }
+    }
+}
+
+TEST_CASE(Codec) {
+    HtmPixelization htm(5);
+    AdaptiveChunker chunker = makeChunker(htm, makePoints(5000), 200);
+    std::vector<uint8_t> buffer = chunker.encode();
+    AdaptiveChunker decoded = AdaptiveChunker::decode(buffer);
+    CHECK(decoded == chunker);
+    CHECK(decoded.encode() == buffer);
+    CHECK(decoded.getChunk(UnitVector3d::Y()) ==
+          chunker.getChunk(UnitVector3d::Y()));
+    CHECK(dynamic_cast<HtmPixelization const &>(
+              decoded.getPixelization()).getLevel() == 5);
+    CHECK(makeChunker(htm, makePoints(5000), 100) != chunker);
+    std::vector<uint8_t> truncated(buffer.begin(), buffer.end() - 1);
+    CHECK_THROW(AdaptiveChunker::decode(truncated), std::runtime_error);
+    std::vector<uint8_t> wrongType = buffer;
+    wrongType[1] = 'x';
+    CHECK_THROW(AdaptiveChunker::decode(wrongType), std::runtime_error);
+    std::vector<uint8_t> wrongLevel = buffer;
+    wrongLevel[2] = 99;
+    CHECK_THROW(AdaptiveChunker::decode(wrongLevel), std::runtime_error);
+    std::vector<uint8_t> unsorted = buffer;
+    std::swap_ranges(unsorted.begin() + 27, unsorted.begin() + 35,
+                     unsorted.begin() + 43);
+    CHECK_THROW(AdaptiveChunker::decode(unsorted), std::runtime_error);
+    CHECK_THROW(AdaptiveChunker::decode(std::vector<uint8_t>()),
+                std::runtime_error);
+}
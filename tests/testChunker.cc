@@ -23,8 +23,13 @@
 /// \file
 /// \brief This file contains tests for the Chunker class.
 
+#include <memory>
+#include <vector>
+
 #include "lsst/sphgeom/Box.h"
 #include "lsst/sphgeom/Chunker.h"
+#include "lsst/sphgeom/Circle.h"
+#include "lsst/sphgeom/LonLat.h"
 
 #include "test.h"
 
@@ -46,6 +51,12 @@ TEST_CASE(ChunksIntersecting1) {
     for (size_t i = 0; i < chunkIds.size() && i < 21; ++i) {
         CHECK(chunkIds[i] == expectedChunkIds[i]);
     }
+    TraversalStats stats;
+    CHECK(chunker.getChunksIntersecting(box, &stats) == chunkIds);
+    CHECK(stats.disjoint + stats.within + stats.intersects ==
+          stats.nodesVisited[0]);
+    CHECK(stats.nodesVisited[0] >= 21);
+    CHECK(stats.nodesVisited[1] == 0);
 }
 
 TEST_CASE(AllSubChunks) {
@@ -67,3 +78,52 @@ TEST_CASE(AllSubChunks) {
     std::vector<int32_t> subChunkIds = chunker.getAllSubChunks(9630);
     CHECK(subChunkIds == expectedSubChunkIds);
 }
+
+TEST_CASE(BatchIntersecting) {
+    Chunker chunker(85, 12);
+    std::vector<std::unique_ptr<Region>> regions;
+    regions.emplace_back(new Box(Box::fromDegrees(-0.1, -6, 4, 6)));
+    regions.emplace_back(new Box(Box::fromDegrees(359.0, -1, 1.5, 2)));
+    regions.emplace_back(new Box(Box::fromDegrees(10.0, 85, 200.0, 90)));
+    regions.emplace_back(new Circle(UnitVector3d(LonLat::fromDegrees(45, -30)),
+                                    Angle::fromDegrees(3)));
+    regions.emplace_back(new Circle(UnitVector3d::Z(), Angle::fromDegrees(2)));
+    regions.emplace_back(new Circle(
+        UnitVector3d(LonLat::fromDegrees(120, 10)), Angle::fromDegrees(0.01)));
+    regions.emplace_back(new Circle());
+    std::vector<Region const *> pointers;
+    for (auto const & r: regions) {
+        pointers.push_back(r.get());
+    }
+    for (unsigned numThreads = 1; numThreads <= 3; numThreads += 2) {
+        std::vector<RangeSet> chunks =
+            chunker.getChunksIntersecting(pointers, numThreads);
+        std::vector<RangeSet> subChunks =
+            chunker.getSubChunksIntersecting(pointers, numThreads);
+        REQUIRE(chunks.size() == regions.size());
+        REQUIRE(subChunks.size() == regions.size());
+        for (size_t i = 0; i < regions.size(); ++i) {
+            RangeSet expectedChunks;
+            for (int32_t chunkId: chunker.getChunksIntersecting(*regions[i])) {
+                expectedChunks.insert(chunkId);
+            }
+            CHECK(chunks[i] == expectedChunks);
+            RangeSet expectedSubChunks;
+            for (SubChunks const & sc:
+                 chunker.getSubChunksIntersecting(*regions[i])) {
+                for (int32_t subChunkId: sc.subChunkIds) {
+                    expectedSubChunks.insert(
+                        Chunker::getSubChunkKey(sc.chunkId, subChunkId));
+                }
+            }
+            CHECK(subChunks[i] == expectedSubChunks);
+        }
+        CHECK(chunks.back().empty());
+        CHECK(subChunks.back().empty());
+    }
+    CHECK(chunker.getChunksIntersecting(pointers.data(), 0).empty());
+    uint64_t key = Chunker::getSubChunkKey(9630, 759);
+    CHECK(Chunker::getChunkIdFromKey(key) == 9630);
+    CHECK(Chunker::getSubChunkIdFromKey(key) == 759);
+    CHECK(Chunker::getSubChunkKey(1, 0) > Chunker::getSubChunkKey(0, 1000));
+}
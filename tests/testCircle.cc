@@ -24,11 +24,13 @@
 /// \brief This file contains tests for the Box class.
 
 #include <memory>
+#include <random>
 #include <vector>
 
 #include "lsst/sphgeom/Box.h"
 #include "lsst/sphgeom/Box3d.h"
 #include "lsst/sphgeom/Circle.h"
+#include "lsst/sphgeom/ConvexPolygon.h"
 
 #include "test.h"
 #include "relationshipTestUtils.h"
@@ -372,3 +374,63 @@ TEST_CASE(Codec) {
     CHECK(dynamic_cast<Circle *>(r.get()) != nullptr);
     CHECK(*dynamic_cast<Circle *>(r.get()) == c);
 }
+
+TEST_CASE(MinimalEnclosingCircle) {
+    CHECK(Circle::minimalEnclosingCircle({}).isEmpty());
+    Circle c = Circle::minimalEnclosingCircle({UnitVector3d::X()});
+    CHECK(c.getCenter() == UnitVector3d::X());
+    CHECK(c.contains(UnitVector3d::X()));
+    c = Circle::minimalEnclosingCircle({UnitVector3d::X(), UnitVector3d::Y()});
+    CHECK(c.getCenter() == UnitVector3d(1, 1, 0));
+    CHECK(std::fabs(c.getOpeningAngle().asRadians() - 0.25 * PI) < 1.0e-12);
+    // Compare against the smallest circle through 2 or 3 points
+    // that contains all the points, found by brute force.
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> uniform(-0.5, 0.5);
+    for (int trial = 0; trial < 20; ++trial) {
+        std::vector<UnitVector3d> points;
+        for (int i = 0; i < 8; ++i) {
+            points.push_back(UnitVector3d(
+                1.0, uniform(rng), trial * 0.05 * uniform(rng)));
+        }
+        c = Circle::minimalEnclosingCircle(points);
+        double best = 4.0;
+        for (size_t i = 0; i < points.size(); ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                for (size_t k = 0; k <= j; ++k) {
+                    Vector3d n = (k == j) ? points[i] + points[j] :
+                        (points[j] - points[i]).cross(points[k] - points[i]);
+                    if (n.isZero()) {
+                        continue;
+                    }
+                    UnitVector3d center(n);
+                    if (center.dot(points[i]) < 0.0) {
+                        center = -center;
+                    }
+                    double cl2 = 0.0;
+                    for (UnitVector3d const & v: points) {
+                        cl2 = std::max(cl2, (v - center).getSquaredNorm());
+                    }
+                    if (cl2 <= (points[i] - center).getSquaredNorm() + 1.0e-12) {
+                        best = std::min(best, cl2);
+                    }
+                }
+            }
+        }
+        CHECK(std::fabs(c.getSquaredChordLength() - best) < 1.0e-12);
+        for (UnitVector3d const & v: points) {
+            CHECK(c.contains(v));
+        }
+    }
+    // The minimal bounding circle of a polygon is much smaller than its
+    // centroid-based bounding circle when the polygon is skewed.
+    ConvexPolygon p = ConvexPolygon::convexHull({
+        UnitVector3d(1.0, -0.1, 0.0), UnitVector3d(1.0, 0.1, 0.0),
+        UnitVector3d(1.0, 0.1, 0.01), UnitVector3d(1.0, 0.09, 0.02),
+        UnitVector3d(1.0, 0.08, 0.03), UnitVector3d(1.0, 0.07, 0.04)
+    });
+    Circle m = p.getMinimalBoundingCircle();
+    CHECK(m.relate(p) == CONTAINS);
+    CHECK(m.getSquaredChordLength() <
+          0.9 * p.getBoundingCircle().getSquaredChordLength());
+}
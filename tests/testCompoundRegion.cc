@@ -0,0 +1,292 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains tests for the CompoundRegion classes.
+
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "lsst/sphgeom/Box.h"
+#include "lsst/sphgeom/Circle.h"
+#include "lsst/sphgeom/CompoundRegion.h"
+#include "lsst/sphgeom/ConvexPolygon.h"
+#include "lsst/sphgeom/HtmPixelization.h"
+#include "lsst/sphgeom/LonLat.h"
+
+#include "test.h"
+
+
+using namespace lsst::sphgeom;
+
+namespace {
+
+UnitVector3d fromDegrees(double lon, double lat) {
+    return UnitVector3d(LonLat::fromDegrees(lon, lat));
+}
+
+std::unique_ptr<Region> makeCircle(double lon, double lat, double r) {
+    return std::unique_ptr<Region>(
+        new Circle(fromDegrees(lon, lat), Angle::fromDegrees(r)));
+}
+
+std::unique_ptr<Region> makeBox(double lon1, double lat1,
+                                double lon2, double lat2) {
+    return std::unique_ptr<Region>(
+        new Box(LonLat::fromDegrees(lon1, lat1),
+                LonLat::fromDegrees(lon2, lat2)));
+}
+
+// `makeUnion` returns the union of two overlapping circles.
+UnionRegion makeUnion() {
+    std::vector<std::unique_ptr<Region>> operands;
+    operands.push_back(makeCircle(0.0, 0.0, 2.0));
+    operands.push_back(makeCircle(3.0, 0.0, 2.0));
+    return UnionRegion(std::move(operands));
+}
+
+// `makeIntersection` returns the intersection of the same circles.
+IntersectionRegion makeIntersection() {
+    std::vector<std::unique_ptr<Region>> operands;
+    operands.push_back(makeCircle(0.0, 0.0, 2.0));
+    operands.push_back(makeCircle(3.0, 0.0, 2.0));
+    return IntersectionRegion(std::move(operands));
+}
+
+// `makeDifference` returns a box with a circular mask removed.
+DifferenceRegion makeDifference() {
+    return DifferenceRegion(makeBox(0.0, 0.0, 10.0, 10.0),
+                            makeCircle(5.0, 5.0, 2.0));
+}
+
+} // unnamed namespace
+
+
+TEST_CASE(Construction) {
+    UnionRegion u = makeUnion();
+    CHECK(u.getNumOperands() == 2);
+    CHECK(dynamic_cast<Circle const &>(u.getOperand(1)) ==
+          Circle(fromDegrees(3.0, 0.0), Angle::fromDegrees(2.0)));
+    std::unique_ptr<Region> r = u.clone();
+    UnionRegion const * c = dynamic_cast<UnionRegion const *>(r.get());
+    CHECK(c != nullptr);
+    CHECK(c->getNumOperands() == 2);
+    CHECK(&c->getOperand(0) != &u.getOperand(0));
+    CHECK(c->encode() == u.encode());
+    CHECK_THROW(DifferenceRegion(makeCircle(0.0, 0.0, 1.0), nullptr),
+                std::invalid_argument);
+}
+
+TEST_CASE(Containment) {
+    UnionRegion u = makeUnion();
+    IntersectionRegion i = makeIntersection();
+    DifferenceRegion d = makeDifference();
+    CHECK(u.contains(fromDegrees(-1.0, 0.0)));
+    CHECK(u.contains(fromDegrees(4.0, 0.0)));
+    CHECK(!u.contains(fromDegrees(1.5, 3.0)));
+    CHECK(i.contains(fromDegrees(1.5, 0.0)));
+    CHECK(!i.contains(fromDegrees(-1.0, 0.0)));
+    CHECK(d.contains(fromDegrees(1.0, 1.0)));
+    CHECK(!d.contains(fromDegrees(5.0, 5.0)));
+    CHECK(!d.contains(fromDegrees(11.0, 5.0)));
+    CHECK(!UnionRegion({}).contains(fromDegrees(0.0, 0.0)));
+    CHECK(IntersectionRegion({}).contains(fromDegrees(0.0, 0.0)));
+}
+
+TEST_CASE(Bounds) {
+    UnionRegion u = makeUnion();
+    IntersectionRegion i = makeIntersection();
+    DifferenceRegion d = makeDifference();
+    Circle c = u.getBoundingCircle();
+    CHECK(c.contains(fromDegrees(-1.9, 0.0)));
+    CHECK(c.contains(fromDegrees(4.9, 0.0)));
+    for (size_t k = 0; k < 2; ++k) {
+        CHECK(u.getBoundingBox().contains(u.getOperand(k).getBoundingBox()));
+        CHECK(u.getBoundingBox3d().contains(
+            u.getOperand(k).getBoundingBox3d()));
+        CHECK(i.getOperand(k).getBoundingBox().contains(i.getBoundingBox()));
+    }
+    CHECK(i.getBoundingCircle().contains(fromDegrees(1.5, 0.0)));
+    CHECK(i.getBoundingBox().contains(LonLat::fromDegrees(1.5, 0.0)));
+    CHECK(!i.getBoundingBox().contains(LonLat::fromDegrees(-1.0, 0.0)));
+    CHECK(d.getBoundingBox() == d.getOperand(0).getBoundingBox());
+    CHECK(UnionRegion({}).getBoundingBox().isEmpty());
+    CHECK(IntersectionRegion({}).getBoundingCircle().isFull());
+}
+
+TEST_CASE(Relations) {
+    UnionRegion u = makeUnion();
+    IntersectionRegion i = makeIntersection();
+    DifferenceRegion d = makeDifference();
+    Circle inFirst(fromDegrees(-0.5, 0.0), Angle::fromDegrees(1.0));
+    Circle inBoth(fromDegrees(1.5, 0.0), Angle::fromDegrees(0.2));
+    Circle far(fromDegrees(90.0, 0.0), Angle::fromDegrees(1.0));
+    Circle big(fromDegrees(1.5, 0.0), Angle::fromDegrees(10.0));
+    CHECK(u.relate(inFirst) == CONTAINS);
+    CHECK(u.relate(far) == DISJOINT);
+    CHECK(u.relate(big) == WITHIN);
+    CHECK(i.relate(inFirst) == DISJOINT);
+    CHECK(i.relate(Circle(fromDegrees(1.5, 0.0), Angle::fromDegrees(1.0))) ==
+          INTERSECTS);
+    CHECK(i.relate(inBoth) == CONTAINS);
+    CHECK(i.relate(far) == DISJOINT);
+    CHECK(i.relate(big) == WITHIN);
+    // Regions within the mask are disjoint from the difference.
+    CHECK(d.relate(Circle(fromDegrees(5.0, 5.0), Angle::fromDegrees(1.0))) ==
+          DISJOINT);
+    CHECK(d.relate(Circle(fromDegrees(2.0, 2.0), Angle::fromDegrees(0.5))) ==
+          CONTAINS);
+    CHECK(d.relate(Circle(fromDegrees(5.0, 5.0), Angle::fromDegrees(3.0))) ==
+          INTERSECTS);
+    CHECK(d.relate(big) == INTERSECTS);
+    CHECK(d.relate(Circle(fromDegrees(5.0, 5.0), Angle::fromDegrees(20.0))) ==
+          WITHIN);
+    CHECK(d.relate(far) == DISJOINT);
+    CHECK(d.relate(ConvexPolygon(fromDegrees(1.0, 1.0),
+                                 fromDegrees(2.0, 1.0),
+                                 fromDegrees(1.5, 2.0))) == CONTAINS);
+    // Relations are symmetric, including between compound regions.
+    CHECK(inFirst.relate(u) == WITHIN);
+    CHECK(static_cast<Region const &>(far).relate(
+              static_cast<Region const &>(d)) == DISJOINT);
+    CHECK(Box(LonLat::fromDegrees(40.0, 40.0),
+              LonLat::fromDegrees(50.0, 50.0)).relate(u) == DISJOINT);
+    std::vector<std::unique_ptr<Region>> operands;
+    operands.push_back(makeCircle(0.5, 0.0, 1.0));
+    operands.push_back(makeCircle(1.0, 0.0, 1.0));
+    IntersectionRegion small(std::move(operands));
+    CHECK(u.relate(small) == CONTAINS);
+    CHECK(small.relate(u) == WITHIN);
+    CHECK(u.relate(d) == INTERSECTS);
+    operands.clear();
+    operands.push_back(u.clone());
+    operands.push_back(makeCircle(40.0, 0.0, 1.0));
+    UnionRegion nested(std::move(operands));
+    CHECK(nested.relate(inBoth) == CONTAINS);
+    CHECK(nested.relate(Circle(fromDegrees(20.0, 0.0),
+                               Angle::fromDegrees(1.0))) == DISJOINT);
+}
+
+TEST_CASE(Codec) {
+    std::vector<std::unique_ptr<Region>> operands;
+    operands.push_back(makeDifference().clone());
+    operands.push_back(makeIntersection().clone());
+    operands.push_back(makeBox(20.0, -5.0, 30.0, 5.0));
+    UnionRegion u(std::move(operands));
+    std::vector<uint8_t> buffer = u.encode();
+    std::unique_ptr<UnionRegion> v = UnionRegion::decode(buffer);
+    CHECK(v->encode() == buffer);
+    CHECK(v->getNumOperands() == 3);
+    CHECK(dynamic_cast<DifferenceRegion const *>(&v->getOperand(0)) !=
+          nullptr);
+    std::unique_ptr<Region> r = Region::decode(buffer);
+    CHECK(dynamic_cast<UnionRegion *>(r.get()) != nullptr);
+    CHECK(r->encode() == buffer);
+    std::unique_ptr<CompoundRegion> c = CompoundRegion::decode(
+        makeDifference().encode());
+    CHECK(dynamic_cast<DifferenceRegion *>(c.get()) != nullptr);
+    CHECK(UnionRegion::decode(UnionRegion({}).encode())->getNumOperands() ==
+          0);
+    buffer.pop_back();
+    CHECK_THROW(Region::decode(buffer), std::runtime_error);
+    CHECK_THROW(IntersectionRegion::decode(makeUnion().encode()),
+                std::runtime_error);
+    CHECK_THROW(DifferenceRegion::decode(makeUnion().encode()),
+                std::runtime_error);
+    buffer = makeUnion().encode();
+    buffer[0] = DifferenceRegion::TYPE_CODE;
+    buffer.insert(buffer.end(), buffer.begin() + 1, buffer.end());
+    CHECK_THROW(DifferenceRegion::decode(buffer), std::runtime_error);
+}
+
+TEST_CASE(Pixels) {
+    HtmPixelization htm(7);
+    UnionRegion u = makeUnion();
+    DifferenceRegion d = makeDifference();
+    CHECK(htm.envelope(u, 0) == (htm.envelope(u.getOperand(0), 0) |
+                                 htm.envelope(u.getOperand(1), 0)));
+    CHECK((htm.interior(u.getOperand(0), 0) |
+           htm.interior(u.getOperand(1), 0)).isWithin(htm.interior(u, 0)));
+    RangeSet envelope = htm.envelope(d, 0);
+    RangeSet interior = htm.interior(d, 0);
+    CHECK(envelope.isWithin(htm.envelope(d.getOperand(0), 0)));
+    CHECK(envelope.isDisjointFrom(htm.interior(d.getOperand(1), 0)));
+    CHECK(interior.isWithin(htm.interior(d.getOperand(0), 0)));
+    CHECK(interior.isDisjointFrom(htm.envelope(d.getOperand(1), 0)));
+    CHECK((htm.interior(d.getOperand(0), 0) -
+           htm.envelope(d.getOperand(1), 0)).isWithin(interior));
+    // Regions of unknown type are handled by the generic Region overloads.
+    CHECK(htm.envelope(static_cast<Region const &>(d), 0) == envelope);
+    for (auto const & range: interior) {
+        for (uint64_t i = std::get<0>(range); i < std::get<1>(range); ++i) {
+            ConvexPolygon t = htm.triangle(i);
+            for (UnitVector3d const & v: t.getVertices()) {
+                CHECK(d.contains(v));
+            }
+        }
+    }
+}
+
+TEST_CASE(NestedPixels) {
+    // Pixels are found by pruning the operands decided for their ancestors.
+    // Compare the results to those of relating every pixel independently.
+    HtmPixelization htm(8);
+    std::vector<std::unique_ptr<Region>> masks;
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 5; ++j) {
+            masks.push_back(makeCircle(1.0 + 2.0 * i, 1.5 + 1.75 * j, 0.6));
+        }
+    }
+    masks.push_back(makeBox(4.5, 4.5, 5.5, 5.5));
+    DifferenceRegion d(makeBox(0.0, 0.0, 10.0, 10.0),
+                       std::unique_ptr<Region>(
+                           new UnionRegion(std::move(masks))));
+    RangeSet envelope = htm.envelope(d, 0);
+    RangeSet interior = htm.interior(d, 0);
+    RangeSet touching;
+    RangeSet intersecting;
+    RangeSet within;
+    for (auto const & range: htm.envelope(d.getOperand(0), 0)) {
+        for (uint64_t i = std::get<0>(range); i < std::get<1>(range); ++i) {
+            ConvexPolygon t = htm.triangle(i);
+            for (UnitVector3d const & v: t.getVertices()) {
+                if (d.contains(v)) {
+                    touching.insert(i);
+                }
+            }
+            Relationship r = d.relate(t);
+            if ((r & DISJOINT) == 0) {
+                intersecting.insert(i);
+            }
+            if ((r & CONTAINS) != 0) {
+                within.insert(i);
+            }
+        }
+    }
+    CHECK(touching.isWithin(envelope));
+    CHECK(envelope.isWithin(intersecting));
+    CHECK(within.isWithin(interior));
+    CHECK(!within.empty());
+    CHECK(envelope != interior);
+}
@@ -23,6 +23,8 @@
 /// \file
 /// \brief This file contains tests for the ConvexPolygon class.
 
+#include <random>
+#include <stdexcept>
 #include <vector>
 
 #include "lsst/sphgeom/Box.h"
@@ -314,3 +316,54 @@ TEST_CASE(Disjoint) {
     ConvexPolygon poly2(points2);
     CHECK(poly1.relate(poly2) == DISJOINT);
 }
+
+TEST_CASE(FastHull) {
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    // Random points in caps of various sizes, including some of the cap
+    // boundary points, so that most but not all hulls are computed with
+    // the fast algorithm.
+    for (double radius: {1.0e-6, 0.01, 0.5, 1.5}) {
+        for (size_t n: {3u, 10u, 1000u, 20000u}) {
+            UnitVector3d center(uniform(rng), uniform(rng), uniform(rng));
+            std::vector<UnitVector3d> points;
+            while (points.size() < n) {
+                UnitVector3d v = UnitVector3d(center +
+                    radius * Vector3d(uniform(rng), uniform(rng), uniform(rng)));
+                if (v.dot(center) > 0.1) {
+                    points.push_back(v);
+                }
+            }
+            ConvexPolygon hull = ConvexPolygon::convexHull(points);
+            CHECK(ConvexPolygon::fastConvexHull(points) == hull);
+            CHECK(ConvexPolygon::fastConvexHull(points, 4) == hull);
+            points.push_back(points.front());
+            CHECK(ConvexPolygon::fastConvexHull(points, 2) == hull);
+        }
+    }
+    // Points on a circle are all hull vertices.
+    std::vector<UnitVector3d> points;
+    for (int i = 0; i < 10000; ++i) {
+        points.push_back(UnitVector3d::Z().rotatedAround(
+            UnitVector3d::X(), Angle(0.5)).rotatedAround(
+                UnitVector3d::Z(), Angle(0.001 * i)));
+    }
+    ConvexPolygon hull = ConvexPolygon::convexHull(points);
+    CHECK(hull.getVertices().size() == points.size());
+    CHECK(ConvexPolygon::fastConvexHull(points) == hull);
+    CHECK(ConvexPolygon::fastConvexHull(points, 2) == hull);
+    // Collinear points on a hull edge are not hull vertices.
+    points = {UnitVector3d::X(), UnitVector3d(1, 1, 0), UnitVector3d::Y(),
+              UnitVector3d::Z(), UnitVector3d(1, 1, 1)};
+    hull = ConvexPolygon::convexHull(points);
+    CHECK(hull.getVertices().size() == 3);
+    CHECK(ConvexPolygon::fastConvexHull(points) == hull);
+    // Inputs without a hull are rejected.
+    points = {UnitVector3d::X(), UnitVector3d::Y()};
+    CHECK_THROW(ConvexPolygon::fastConvexHull(points), std::invalid_argument);
+    points = {UnitVector3d::X(), UnitVector3d::Y(), UnitVector3d(1, 1, 0)};
+    CHECK_THROW(ConvexPolygon::fastConvexHull(points), std::invalid_argument);
+    points = {UnitVector3d::X(), UnitVector3d::Y(), UnitVector3d::Z(),
+              UnitVector3d(-1, -1, -1)};
+    CHECK_THROW(ConvexPolygon::fastConvexHull(points), std::invalid_argument);
+}
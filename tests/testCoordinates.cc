@@ -0,0 +1,232 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains tests for the batch coordinate conversion
+///        functions.
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "lsst/sphgeom/InstructionSet.h"
+#include "lsst/sphgeom/LonLat.h"
+#include "lsst/sphgeom/UnitVector3d.h"
+#include "lsst/sphgeom/coordinates.h"
+
+#include "test.h"
+
+
+using namespace lsst::sphgeom;
+
+namespace {
+
+std::vector<InstructionSet> const INSTRUCTION_SETS = {
+    InstructionSet::SCALAR, InstructionSet::AVX2, InstructionSet::AVX512
+};
+
+struct Points {
+    std::vector<double> lon;
+    std::vector<double> lat;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+
+    explicit Points(size_t n) : lon(n), lat(n), x(n), y(n), z(n) {}
+
+    size_t size() const { return lon.size(); }
+
+    void toUnitVectors(ConversionMode mode) {
+        lsst::sphgeom::toUnitVectors(lon.data(), lat.data(), size(),
+                                     x.data(), y.data(), z.data(), mode);
+    }
+
+    void toLonLats(ConversionMode mode) {
+        lsst::sphgeom::toLonLats(x.data(), y.data(), z.data(), size(),
+                                 lon.data(), lat.data(), mode);
+    }
+};
+
+// `makePoints` returns random angles, some of which are multiples of π/4
+// or larger than a full turn.
+Points makePoints(size_t n) {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    Points p(n);
+    for (size_t i = 0; i < n; ++i) {
+        if (i % 13 == 0) {
+            p.lon[i] = 0.25 * PI * static_cast<int>(8.0 * uniform(generator));
+            p.lat[i] = 0.25 * PI * static_cast<int>(2.0 * uniform(generator));
+        } else {
+            double scale = (i % 5 == 0) ? 1.0e5 : 4.0;
+            p.lon[i] = scale * uniform(generator);
+            p.lat[i] = scale * uniform(generator);
+        }
+    }
+    return p;
+}
+
+bool same(double a, double b) {
+    return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+bool near(double a, double b) {
+    return std::fabs(a - b) <= MAX_CONVERSION_ERROR;
+}
+
+} // unnamed namespace
+
+
+TEST_CASE(ExactConversions) {
+    Points p = makePoints(1027);
+    p.lon[1] = std::numeric_limits<double>::quiet_NaN();
+    p.lat[2] = std::numeric_limits<double>::infinity();
+    for (InstructionSet s: INSTRUCTION_SETS) {
+        setInstructionSet(s);
+        p.toUnitVectors(ConversionMode::EXACT);
+        for (size_t i = 0; i < p.size(); ++i) {
+            UnitVector3d v(Angle(p.lon[i]), Angle(p.lat[i]));
+            CHECK(same(p.x[i], v.x()));
+            CHECK(same(p.y[i], v.y()));
+            CHECK(same(p.z[i], v.z()));
+        }
+        Points q = p;
+        q.x[3] = 0.0;
+        q.y[3] = 0.0;
+        q.toLonLats(ConversionMode::EXACT);
+        for (size_t i = 0; i < q.size(); ++i) {
+            LonLat ll(Vector3d(q.x[i], q.y[i], q.z[i]));
+            CHECK(same(q.lon[i], ll.getLon().asRadians()));
+            CHECK(same(q.lat[i], ll.getLat().asRadians()));
+        }
+    }
+    setInstructionSet(getSupportedInstructionSet());
+}
+
+TEST_CASE(FastConversions) {
+    // The point count is not a multiple of any vector width.
+    Points p = makePoints(1027);
+    Points exact = p;
+    exact.toUnitVectors(ConversionMode::EXACT);
+    std::vector<Points> results;
+    for (InstructionSet s: INSTRUCTION_SETS) {
+        if (setInstructionSet(s) != s) {
+            continue;
+        }
+        Points q = p;
+        q.toUnitVectors(ConversionMode::FAST);
+        for (size_t i = 0; i < q.size(); ++i) {
+            CHECK(near(q.x[i], exact.x[i]));
+            CHECK(near(q.y[i], exact.y[i]));
+            CHECK(near(q.z[i], exact.z[i]));
+        }
+        // Un-normalized vectors, including the poles.
+        for (size_t i = 0; i < q.size(); i += 3) {
+            q.x[i] *= 0.5;
+            q.y[i] *= 0.5;
+            q.z[i] *= 0.5;
+        }
+        q.x[4] = 0.0;
+        q.y[4] = 0.0;
+        Points e = q;
+        q.toLonLats(ConversionMode::FAST);
+        e.toLonLats(ConversionMode::EXACT);
+        for (size_t i = 0; i < q.size(); ++i) {
+            CHECK(near(q.lon[i], e.lon[i]));
+            CHECK(near(q.lat[i], e.lat[i]));
+            CHECK(q.lon[i] >= 0.0 && q.lon[i] <= 2.0 * PI);
+        }
+        CHECK(q.lat[4] == e.lat[4]);
+        results.push_back(q);
+    }
+    // Results do not depend on the instruction set, even when the build
+    // targets FMA hardware, because no kernel version is contracted.
+    for (Points const & q: results) {
+        CHECK(q.x == results[0].x);
+        CHECK(q.y == results[0].y);
+        CHECK(q.z == results[0].z);
+        CHECK(q.lon == results[0].lon);
+        CHECK(q.lat == results[0].lat);
+    }
+    setInstructionSet(getSupportedInstructionSet());
+}
+
+TEST_CASE(SpecialValues) {
+    double const inf = std::numeric_limits<double>::infinity();
+    double const nan = std::numeric_limits<double>::quiet_NaN();
+    Points p(16);
+    p.lon = {0.0, -0.0, 0.5 * PI, PI, 1.5 * PI, 2.0 * PI, -PI, 1.0e7,
+             -3.0e8, inf, nan, 1.0, 2.0, 3.0, 4.0, 5.0};
+    p.lat = {0.0, 0.5 * PI, -0.5 * PI, 1.0, -1.0, 0.25 * PI, 2.0e6, 1.0,
+             -1.0, 1.0, 1.0, -inf, nan, 1.0e-300, -1.0e-310, 0.0};
+    p.x = {0.0, -0.0, 1.0, -1.0, 0.0, 0.0, 1.0, -1.0,
+           1.0e-200, 1.0e200, inf, -inf, nan, 1.0, 0.0, -2.0};
+    p.y = {0.0, 0.0, -0.0, -0.0, 1.0, -1.0, 1.0, -1.0,
+           -1.0e-200, 1.0e200, 1.0, inf, 0.0, nan, 0.0, 0.0};
+    p.z = {0.0, 1.0, -1.0, 0.0, 0.0, 0.0, 0.0, 1.0,
+           1.0e-200, 1.0, inf, 0.0, 0.0, 0.0, nan, -0.0};
+    Points exact = p;
+    exact.toUnitVectors(ConversionMode::EXACT);
+    for (InstructionSet s: INSTRUCTION_SETS) {
+        if (setInstructionSet(s) != s) {
+            continue;
+        }
+        Points q = p;
+        q.toUnitVectors(ConversionMode::FAST);
+        for (size_t i = 0; i < q.size(); ++i) {
+            if (std::isfinite(exact.x[i])) {
+                CHECK(near(q.x[i], exact.x[i]));
+                CHECK(near(q.y[i], exact.y[i]));
+                CHECK(near(q.z[i], exact.z[i]));
+            } else {
+                CHECK(std::isnan(q.x[i]) && std::isnan(q.y[i]));
+            }
+        }
+        // Angles that cannot be reduced are converted exactly.
+        for (size_t i: {6, 7, 8}) {
+            CHECK(q.x[i] == exact.x[i] && q.y[i] == exact.y[i]);
+        }
+        q = p;
+        Points e = p;
+        q.toLonLats(ConversionMode::FAST);
+        e.toLonLats(ConversionMode::EXACT);
+        for (size_t i = 0; i < q.size(); ++i) {
+            if (std::isnan(e.lon[i])) {
+                CHECK(std::isnan(q.lon[i]) && std::isnan(q.lat[i]));
+            } else {
+                CHECK(near(q.lon[i], e.lon[i]));
+                CHECK(near(q.lat[i], e.lat[i]));
+            }
+        }
+        // Zero vectors, poles and points on the axes are converted exactly.
+        for (size_t i: {0, 1, 2, 3, 4, 5, 15}) {
+            CHECK(q.lon[i] == e.lon[i]);
+            CHECK(q.lat[i] == e.lat[i]);
+        }
+        CHECK(q.lon[9] == e.lon[9] && q.lat[11] == e.lat[11]);
+    }
+    setInstructionSet(getSupportedInstructionSet());
+    lsst::sphgeom::toUnitVectors(nullptr, nullptr, 0,
+                                 nullptr, nullptr, nullptr);
+    lsst::sphgeom::toLonLats(nullptr, nullptr, nullptr, 0, nullptr, nullptr);
+}
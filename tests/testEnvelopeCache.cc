@@ -0,0 +1,271 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains tests for the EnvelopeCache class.
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lsst/sphgeom/Box.h"
+#include "lsst/sphgeom/Circle.h"
+#include "lsst/sphgeom/EnvelopeCache.h"
+#include "lsst/sphgeom/HtmPixelization.h"
+#include "lsst/sphgeom/LonLat.h"
+#include "lsst/sphgeom/Mq3cPixelization.h"
+#include "lsst/sphgeom/Q3cPixelization.h"
+
+#include "test.h"
+
+
+using namespace lsst::sphgeom;
+
+namespace {
+
+Circle makeCircle(double lon, double lat, double r) {
+    return Circle(UnitVector3d(LonLat::fromDegrees(lon, lat)),
+                  Angle::fromDegrees(r));
+}
+
+// `CacheFile` is a test fixture providing the path of a backing file that
+// is removed on tear-down.
+struct CacheFile {
+    std::string path;
+
+    CacheFile() : path("testEnvelopeCache.tmp") { std::remove(path.c_str()); }
+    ~CacheFile() { std::remove(path.c_str()); }
+};
+
+// `PlainPixelization` is a pixelization type unknown to EnvelopeCache.
+struct PlainPixelization : Pixelization {
+    RangeSet universe() const override { return RangeSet(0, 1); }
+    std::unique_ptr<Region> pixel(uint64_t) const override {
+        return Circle::full().clone();
+    }
+    uint64_t index(UnitVector3d const &) const override { return 0; }
+    std::string toString(uint64_t) const override { return "0"; }
+
+private:
+    RangeSet _envelope(Region const &, size_t, Coarsening,
+                       TraversalStats *) const override {
+        return universe();
+    }
+    RangeSet _interior(Region const &, size_t, Coarsening,
+                       TraversalStats *) const override {
+        return universe();
+    }
+};
+
+} // unnamed namespace
+
+
+TEST_CASE(HitsAndMisses) {
+    EnvelopeCache cache(1 << 20);
+    HtmPixelization htm(8);
+    Q3cPixelization q3c(8);
+    Circle c = makeCircle(10.0, 20.0, 1.0);
+    RangeSet e = cache.envelope(htm, c);
+    CHECK(e == htm.envelope(c));
+    CHECK(cache.getMisses() == 1 && cache.getHits() == 0);
+    // Equal regions share entries.
+    CHECK(cache.envelope(htm, makeCircle(10.0, 20.0, 1.0)) == e);
+    CHECK(cache.getMisses() == 1 && cache.getHits() == 1);
+    // Search parameters and pixelizations do not.
+    CHECK(cache.interior(htm, c) == htm.interior(c));
+    CHECK(cache.envelope(htm, c, 4) == htm.envelope(c, 4));
+    CHECK(cache.envelope(htm, c, 4, Coarsening::OPTIMAL) ==
+          htm.envelope(c, 4, Coarsening::OPTIMAL));
+    CHECK(cache.envelope(HtmPixelization(9), c) == HtmPixelization(9).envelope(c));
+    CHECK(cache.envelope(q3c, c) == q3c.envelope(c));
+    CHECK(cache.envelope(Mq3cPixelization(8), c) ==
+          Mq3cPixelization(8).envelope(c));
+    CHECK(cache.getMisses() == 7 && cache.getHits() == 1);
+    CHECK(cache.getSize() == 7);
+    CHECK(cache.getBytes() > 0 && cache.getBytes() <= cache.getMaxBytes());
+    cache.resetCounters();
+    CHECK(cache.getMisses() == 0 && cache.getHits() == 0);
+    cache.clear();
+    CHECK(cache.getSize() == 0 && cache.getBytes() == 0);
+    CHECK_THROW(cache.envelope(PlainPixelization(), c),
+                std::invalid_argument);
+}
+
+TEST_CASE(Eviction) {
+    HtmPixelization htm(6);
+    Circle a = makeCircle(0.0, 0.0, 1.0);
+    Circle b = makeCircle(30.0, 0.0, 1.0);
+    Circle c = makeCircle(60.0, 0.0, 1.0);
+    size_t bytes;
+    {
+        EnvelopeCache cache(1 << 20);
+        cache.envelope(htm, a);
+        bytes = cache.getBytes();
+    }
+    // A cache with room for two entries evicts the least recently used one.
+    EnvelopeCache cache(2 * bytes + bytes / 2);
+    cache.envelope(htm, a);
+    cache.envelope(htm, b);
+    cache.envelope(htm, a);
+    cache.envelope(htm, c);
+    CHECK(cache.getSize() == 2);
+    CHECK(cache.getEvictions() == 1);
+    cache.resetCounters();
+    cache.envelope(htm, a);
+    cache.envelope(htm, c);
+    CHECK(cache.getHits() == 2);
+    cache.envelope(htm, b);
+    CHECK(cache.getMisses() == 1);
+    CHECK(cache.getBytes() <= cache.getMaxBytes());
+    // Results larger than the cache are not cached.
+    EnvelopeCache tiny(bytes / 2);
+    CHECK(tiny.envelope(htm, a) == htm.envelope(a));
+    CHECK(tiny.getSize() == 0 && tiny.getBytes() == 0);
+}
+
+TEST_CASE(Concurrency) {
+    EnvelopeCache cache(1 << 20);
+    HtmPixelization htm(10);
+    std::vector<Circle> circles;
+    std::vector<RangeSet> expected;
+    for (int i = 0; i < 8; ++i) {
+        circles.push_back(makeCircle(i * 40.0, i * 10.0 - 40.0, 0.5));
+        expected.push_back(htm.envelope(circles.back()));
+    }
+    std::vector<std::thread> threads;
+    std::vector<int> failures(4, 0);
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int j = 0; j < 50; ++j) {
+                size_t i = (j * 3 + t) % circles.size();
+                if (cache.envelope(htm, circles[i]) != expected[i]) {
+                    ++failures[t];
+                }
+            }
+        });
+    }
+    for (std::thread & t: threads) {
+        t.join();
+    }
+    for (int f: failures) {
+        CHECK(f == 0);
+    }
+    CHECK(cache.getHits() + cache.getMisses() == 200);
+    CHECK(cache.getSize() == circles.size());
+}
+
+FIXTURE_TEST_CASE(Persistence, CacheFile) {
+    HtmPixelization htm(8);
+    Circle c = makeCircle(10.0, 20.0, 1.0);
+    Box b(LonLat::fromDegrees(0.0, 0.0), LonLat::fromDegrees(2.0, 3.0));
+    {
+        EnvelopeCache cache(1 << 20, path);
+        cache.envelope(htm, c);
+        cache.interior(htm, b);
+        CHECK(cache.getMisses() == 2);
+    }
+    {
+        EnvelopeCache cache(1 << 20, path);
+        CHECK(cache.getSize() == 2);
+        CHECK(cache.envelope(htm, c) == htm.envelope(c));
+        CHECK(cache.interior(htm, b) == htm.interior(b));
+        CHECK(cache.getHits() == 2 && cache.getMisses() == 0);
+    }
+    // A truncated final record is ignored.
+    {
+        std::ifstream is(path, std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(is)),
+                             std::istreambuf_iterator<char>());
+        is.close();
+        std::ofstream os(path, std::ios::binary | std::ios::trunc);
+        os.write(contents.data(), contents.size() - 3);
+    }
+    {
+        EnvelopeCache cache(1 << 20, path);
+        CHECK(cache.getSize() == 1);
+        CHECK(cache.envelope(htm, c) == htm.envelope(c));
+        CHECK(cache.getHits() == 1);
+        // Records appended after loading a truncated file are readable.
+        cache.interior(htm, b);
+        CHECK(cache.getMisses() == 1);
+    }
+    {
+        EnvelopeCache cache(1 << 20, path);
+        CHECK(cache.getSize() == 2);
+        CHECK(cache.envelope(htm, c) == htm.envelope(c));
+        CHECK(cache.interior(htm, b) == htm.interior(b));
+        CHECK(cache.getHits() == 2 && cache.getMisses() == 0);
+        cache.clear();
+    }
+    CHECK(EnvelopeCache(1 << 20, path).getSize() == 0);
+    {
+        std::ofstream os(path, std::ios::binary | std::ios::trunc);
+        os << "not a cache file";
+    }
+    CHECK_THROW(EnvelopeCache(1 << 20, path), std::runtime_error);
+    // Files too short to be cache files are not overwritten either.
+    {
+        std::ofstream os(path, std::ios::binary | std::ios::trunc);
+        os << "short";
+    }
+    CHECK_THROW(EnvelopeCache(1 << 20, path), std::runtime_error);
+    {
+        std::ifstream is(path, std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(is)),
+                             std::istreambuf_iterator<char>());
+        CHECK(contents == "short");
+    }
+    // Empty files are treated like missing ones.
+    {
+        std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    }
+    {
+        EnvelopeCache cache(1 << 20, path);
+        cache.envelope(htm, c);
+    }
+    CHECK(EnvelopeCache(1 << 20, path).getSize() == 1);
+}
+
+FIXTURE_TEST_CASE(FileSize, CacheFile) {
+    HtmPixelization htm(6);
+    size_t bytes;
+    {
+        EnvelopeCache cache(1 << 20);
+        cache.envelope(htm, makeCircle(0.0, 0.0, 1.0));
+        bytes = cache.getBytes();
+    }
+    // Records of evicted entries are dropped as the file grows, so that
+    // its size stays within twice the budget, plus the magic number.
+    EnvelopeCache cache(2 * bytes + bytes / 2, path);
+    for (int i = 0; i < 100; ++i) {
+        cache.envelope(htm, makeCircle(3.0 * i, 0.0, 1.0));
+        std::ifstream is(path, std::ios::binary | std::ios::ate);
+        CHECK(static_cast<size_t>(is.tellg()) <= 2 * cache.getMaxBytes() + 8);
+    }
+    CHECK(cache.getEvictions() + cache.getSize() == 100);
+    CHECK(EnvelopeCache(cache.getMaxBytes(), path).getSize() ==
+          cache.getSize());
+}
@@ -0,0 +1,140 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains tests for the FixedConvexPolygon class.
+
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "lsst/sphgeom/FixedConvexPolygon.h"
+#include "lsst/sphgeom/HtmPixelization.h"
+#include "lsst/sphgeom/LonLat.h"
+#include "lsst/sphgeom/Mq3cPixelization.h"
+#include "lsst/sphgeom/Q3cPixelization.h"
+
+#include "test.h"
+
+
+using namespace lsst::sphgeom;
+
+namespace {
+
+UnitVector3d fromDegrees(double lon, double lat) {
+    return UnitVector3d(LonLat::fromDegrees(lon, lat));
+}
+
+template <size_t N>
+void checkVertices(FixedConvexPolygon<N> const & f, ConvexPolygon const & p) {
+    CHECK(f.getNumVertices() == p.getVertices().size());
+    for (size_t i = 0; i < f.getNumVertices(); ++i) {
+        CHECK(f.getVertices()[i] == p.getVertices()[i]);
+    }
+}
+
+} // unnamed namespace
+
+
+TEST_CASE(Construction) {
+    UnitVector3d v[5] = {
+        fromDegrees(0.0, 0.0), fromDegrees(10.0, 0.0),
+        fromDegrees(12.0, 8.0), fromDegrees(5.0, 12.0),
+        fromDegrees(-2.0, 8.0)
+    };
+    FixedConvexPolygon<3> t(v[0], v[1], v[2]);
+    checkVertices(t, ConvexPolygon(v[0], v[1], v[2]));
+    FixedConvexPolygon<8> q(v[0], v[1], v[2], v[3]);
+    checkVertices(q, ConvexPolygon(v[0], v[1], v[2], v[3]));
+    ConvexPolygon p = ConvexPolygon::convexHull(
+        std::vector<UnitVector3d>(v, v + 5));
+    FixedConvexPolygon<5> f(p);
+    checkVertices(f, p);
+    CHECK(f.toConvexPolygon() == p);
+    CHECK(f.encode() == p.encode());
+    CHECK_THROW(FixedConvexPolygon<4>{p}, std::length_error);
+}
+
+TEST_CASE(Predicates) {
+    ConvexPolygon p = ConvexPolygon::convexHull({
+        fromDegrees(20.0, 0.0), fromDegrees(35.0, 2.0),
+        fromDegrees(33.0, 15.0), fromDegrees(22.0, 14.0),
+        fromDegrees(18.0, 7.0)
+    });
+    FixedConvexPolygon<8> f(p);
+    std::vector<std::unique_ptr<Region>> regions;
+    regions.emplace_back(new Box(LonLat::fromDegrees(25.0, 5.0),
+                                 LonLat::fromDegrees(40.0, 12.0)));
+    regions.emplace_back(new Circle(fromDegrees(30.0, 10.0),
+                                    Angle::fromDegrees(4.0)));
+    regions.emplace_back(new Circle(fromDegrees(27.0, 7.0),
+                                    Angle::fromDegrees(40.0)));
+    regions.emplace_back(new ConvexPolygon(
+        fromDegrees(31.0, 9.0), fromDegrees(32.0, 9.0),
+        fromDegrees(31.5, 10.0)));
+    regions.emplace_back(new ConvexPolygon(
+        fromDegrees(120.0, -5.0), fromDegrees(130.0, -5.0),
+        fromDegrees(125.0, 5.0)));
+    regions.emplace_back(new Ellipse(fromDegrees(30.0, 10.0),
+                                     Angle::fromDegrees(6.0),
+                                     Angle::fromDegrees(2.0),
+                                     Angle::fromDegrees(30.0)));
+    CHECK(f.getCentroid() == p.getCentroid());
+    CHECK(f.getBoundingBox() == p.getBoundingBox());
+    CHECK(f.getBoundingBox3d() == p.getBoundingBox3d());
+    CHECK(f.getBoundingCircle() == p.getBoundingCircle());
+    for (auto const & r: regions) {
+        CHECK(f.relate(*r) == p.relate(*r));
+        CHECK(f.contains(r->getBoundingCircle().getCenter()) ==
+              p.contains(r->getBoundingCircle().getCenter()));
+        if (ConvexPolygon const * q = dynamic_cast<ConvexPolygon const *>(
+                r.get())) {
+            CHECK(f.relate(*q) == p.relate(*q));
+            CHECK(f.relate(FixedConvexPolygon<3>(*q)) == p.relate(*q));
+        }
+    }
+}
+
+TEST_CASE(Pixels) {
+    HtmPixelization htm(3);
+    for (auto const & range: htm.universe()) {
+        for (uint64_t i = std::get<0>(range); i < std::get<1>(range); ++i) {
+            checkVertices(HtmPixelization::fixedTriangle(i),
+                          HtmPixelization::triangle(i));
+        }
+    }
+    Q3cPixelization q3c(2);
+    for (uint64_t i = 0; i < 6 * 16; ++i) {
+        checkVertices(q3c.fixedQuad(i), q3c.quad(i));
+    }
+    Mq3cPixelization mq3c(2);
+    for (auto const & range: mq3c.universe()) {
+        for (uint64_t i = std::get<0>(range); i < std::get<1>(range); ++i) {
+            checkVertices(Mq3cPixelization::fixedQuad(i),
+                          Mq3cPixelization::quad(i));
+        }
+    }
+    CHECK_THROW(HtmPixelization::fixedTriangle(0), std::invalid_argument);
+    CHECK_THROW(q3c.fixedQuad(6 * 16), std::invalid_argument);
+    CHECK_THROW(Mq3cPixelization::fixedQuad(0), std::invalid_argument);
+}
@@ -23,6 +23,11 @@
 /// \file
 /// \brief This file contains tests for HTM indexing.
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "lsst/sphgeom/Box.h"
 #include "lsst/sphgeom/Circle.h"
 #include "lsst/sphgeom/LonLat.h"
 #include "lsst/sphgeom/HtmPixelization.h"
@@ -191,3 +196,216 @@ TEST_CASE(Adaptivity) {
         }
     }
 }
+
+TEST_CASE(OptimalCoarsening) {
+    HtmPixelization p(10);
+    Circle c(UnitVector3d(1.0, 1.0, 1.0), Angle::fromDegrees(5.0));
+    RangeSet envelope = p.envelope(c);
+    RangeSet interior = p.interior(c);
+    // Collect the sizes of the gaps between envelope ranges and of the
+    // interior ranges, in ascending order.
+    std::vector<uint64_t> gaps;
+    std::vector<uint64_t> sizes;
+    for (auto i = envelope.begin() + 1; i != envelope.end(); ++i) {
+        gaps.push_back(std::get<0>(*i) - std::get<1>(*(i - 1)));
+    }
+    for (auto const & t: interior) {
+        sizes.push_back(std::get<1>(t) - std::get<0>(t));
+    }
+    std::sort(gaps.begin(), gaps.end());
+    std::sort(sizes.begin(), sizes.end());
+    for (size_t maxRanges = 1; maxRanges < 2 * envelope.size();
+         maxRanges *= 2) {
+        // The optimal envelope adds exactly the smallest gaps, and is never
+        // larger than the one obtained by lowering the subdivision level.
+        RangeSet s = p.envelope(c, maxRanges, Coarsening::OPTIMAL);
+        CHECK(s.isValid());
+        CHECK(s.size() == std::min(maxRanges, envelope.size()));
+        CHECK(s.contains(envelope));
+        uint64_t added = 0;
+        for (size_t i = 0; i + maxRanges < envelope.size(); ++i) {
+            added += gaps[i];
+        }
+        CHECK(s.cardinality() == envelope.cardinality() + added);
+        CHECK(s.cardinality() <= p.envelope(c, maxRanges).cardinality());
+        // The optimal interior removes exactly the smallest ranges.
+        s = p.interior(c, maxRanges, Coarsening::OPTIMAL);
+        CHECK(s.isValid());
+        CHECK(s.size() == std::min(maxRanges, interior.size()));
+        CHECK(s.isWithin(interior));
+        uint64_t removed = 0;
+        for (size_t i = 0; i + maxRanges < interior.size(); ++i) {
+            removed += sizes[i];
+        }
+        CHECK(s.cardinality() == interior.cardinality() - removed);
+        CHECK(s.cardinality() >= p.interior(c, maxRanges).cardinality());
+    }
+    // A limit of 0 means no limit.
+    CHECK(p.envelope(c, 0, Coarsening::OPTIMAL) == envelope);
+    CHECK(p.interior(c, 0, Coarsening::OPTIMAL) == interior);
+}
+
+TEST_CASE(EnvelopeAndInterior) {
+    // A single traversal must give the same results as separate searches.
+    UnitVector3d center(1.0, -1.0, 0.5);
+    for (int level = 0; level <= 10; level += 2) {
+        HtmPixelization p(level);
+        for (double radius: {0.01, 1.0, 10.0}) {
+            Circle c(center, Angle::fromDegrees(radius));
+            for (size_t maxRanges: {0, 1, 4, 64}) {
+                for (Coarsening coarsening: {Coarsening::LEVEL,
+                                             Coarsening::OPTIMAL}) {
+                    auto ei = p.envelopeAndInterior(c, maxRanges, coarsening);
+                    CHECK(ei.first == p.envelope(c, maxRanges, coarsening));
+                    CHECK(ei.second == p.interior(c, maxRanges, coarsening));
+                }
+            }
+            ConvexPolygon poly = p.triangle(p.index(center));
+            auto ei = p.envelopeAndInterior(poly);
+            CHECK(ei.first == p.envelope(poly));
+            CHECK(ei.second == p.interior(poly));
+        }
+    }
+}
+
+TEST_CASE(StreamEnvelopeAndInterior) {
+    HtmPixelization p(12);
+    Circle c(UnitVector3d(-1.0, 1.0, 1.0), Angle::fromDegrees(3.0));
+    RangeSet envelope;
+    RangeSet interior;
+    uint64_t last = 0;
+    bool ordered = true;
+    p.streamEnvelope(c, [&](uint64_t first, uint64_t l) {
+        // Ranges must be ascending, and adjacent ranges must be merged.
+        ordered = ordered && (envelope.empty() || first > last) && first < l;
+        last = l;
+        envelope.insert(first, l);
+    });
+    CHECK(ordered);
+    CHECK(envelope == p.envelope(c));
+    size_t n = 0;
+    p.streamInterior(c, [&](uint64_t first, uint64_t l) {
+        ++n;
+        interior.insert(first, l);
+    });
+    CHECK(interior == p.interior(c));
+    CHECK(n == interior.size());
+}
+
+TEST_CASE(Prefilter) {
+    // Cheap bounding tests must decide many pixels near a box or polygon,
+    // without changing the search results.
+    HtmPixelization p(8);
+    Box b(LonLat::fromDegrees(10.0, 20.0), LonLat::fromDegrees(13.0, 22.0));
+    std::vector<UnitVector3d> points;
+    for (int i = 0; i < 12; ++i) {
+        points.push_back(UnitVector3d(LonLat::fromDegrees(
+            100.0 + 2.0 * std::cos(i * PI / 6.0),
+            -40.0 + 2.0 * std::sin(i * PI / 6.0))));
+    }
+    ConvexPolygon poly = ConvexPolygon::convexHull(points);
+    TraversalStats stats;
+    RangeSet s = p.envelope(b, 0, Coarsening::LEVEL, &stats);
+    CHECK(s == p.envelope(b));
+    CHECK(stats.capRejected + stats.boxRejected > 0);
+    CHECK(stats.edgeRejected == 0 && stats.capAccepted == 0);
+    CHECK(stats.exactRelated > 0);
+    // Pixels containing points of the box must not be rejected.
+    for (double lon = 10.0; lon <= 13.0; lon += 0.05) {
+        for (double lat = 20.0; lat <= 22.0; lat += 0.05) {
+            CHECK(s.contains(p.index(UnitVector3d(
+                LonLat::fromDegrees(lon, lat)))));
+        }
+    }
+    stats.reset();
+    CHECK(stats.capRejected == 0 && stats.exactRelated == 0);
+    auto ei = p.envelopeAndInterior(poly, 0, Coarsening::LEVEL, &stats);
+    CHECK(ei.first == p.envelope(poly));
+    CHECK(ei.second == p.interior(poly));
+    CHECK(stats.edgeRejected > 0);
+    CHECK(stats.capAccepted > 0);
+    // Pixels containing polygon points must not be rejected, and pixels
+    // accepted by the edge plane tests must be inside the polygon.
+    for (UnitVector3d const & v: points) {
+        CHECK(ei.first.contains(p.index(v)));
+    }
+    CHECK(ei.first.contains(p.index(poly.getCentroid())));
+    for (auto const & t: ei.second) {
+        for (uint64_t i = std::get<0>(t); i != std::get<1>(t); ++i) {
+            ConvexPolygon triangle = p.triangle(i);
+            for (UnitVector3d const & v: triangle.getVertices()) {
+                CHECK(poly.contains(v));
+            }
+        }
+    }
+    // Circles are related to pixels exactly.
+    stats.reset();
+    Circle c(UnitVector3d(1.0, 2.0, -3.0), Angle::fromDegrees(2.0));
+    s = p.envelope(c, 0, Coarsening::LEVEL, &stats);
+    CHECK(s == p.envelope(c));
+    CHECK(stats.capRejected == 0 && stats.boxRejected == 0);
+    CHECK(stats.exactRelated > 0);
+}
+
+TEST_CASE(TraversalStatistics) {
+    HtmPixelization p(10);
+    Circle c(UnitVector3d(1.0, -1.0, 0.5), Angle::fromDegrees(5.0));
+    TraversalStats stats;
+    RangeSet s = p.envelope(c, 0, Coarsening::LEVEL, &stats);
+    CHECK(s == p.envelope(c));
+    // Every visit has exactly one outcome, and all root triangles
+    // are visited.
+    uint64_t visited = 0;
+    for (int level = 0; level <= TraversalStats::MAX_LEVEL; ++level) {
+        CHECK(level <= 10 || stats.nodesVisited[level] == 0);
+        visited += stats.nodesVisited[level];
+    }
+    CHECK(stats.nodesVisited[0] == 8);
+    CHECK(stats.nodesVisited[10] > 0);
+    CHECK(visited == stats.disjoint + stats.within + stats.intersects);
+    CHECK(visited == stats.exactRelated);
+    CHECK(stats.within > 0 && stats.intersects > 0 && stats.disjoint > 0);
+    CHECK(stats.rangeSetReallocations > 0);
+    CHECK(stats.simplifications == 0 && stats.levelReductions == 0);
+    // Limiting the number of ranges reduces the subdivision level.
+    TraversalStats limited;
+    p.envelope(c, 4, Coarsening::LEVEL, &limited);
+    CHECK(limited.levelReductions > 0);
+    CHECK(limited.simplifications == limited.levelReductions);
+    // Relating a pixel to its children involves orientation tests on
+    // nearly coplanar points.
+    TraversalStats degenerate;
+    p.envelope(HtmPixelization(2).triangle(8 * 16), 0, Coarsening::LEVEL,
+               &degenerate);
+    CHECK(degenerate.exactOrientations > 0);
+    // Counts accumulate until reset.
+    uint64_t within = stats.within;
+    p.envelope(c, 0, Coarsening::LEVEL, &stats);
+    CHECK(stats.within == 2 * within);
+    stats.reset();
+    CHECK(stats.within == 0 && stats.nodesVisited[0] == 0);
+}
+
+TEST_CASE(TypedRegions) {
+    // Searches for regions of known type must give the same results as
+    // searches for arbitrary regions.
+    HtmPixelization p(10);
+    Circle c(UnitVector3d(-1.0, 2.0, 0.5), Angle::fromDegrees(1.0));
+    Box b(LonLat::fromDegrees(210.0, 30.0), Angle::fromDegrees(1.0),
+          Angle::fromDegrees(0.5));
+    ConvexPolygon poly = ConvexPolygon::convexHull(std::vector<UnitVector3d>{
+        UnitVector3d(LonLat::fromDegrees(300.0, -10.0)),
+        UnitVector3d(LonLat::fromDegrees(301.0, -10.0)),
+        UnitVector3d(LonLat::fromDegrees(300.5, -9.0))});
+    Pixelization const & generic = p;
+    for (size_t maxRanges: {0, 8}) {
+        CHECK(p.envelope(c, maxRanges) == generic.envelope(c, maxRanges));
+        CHECK(p.interior(c, maxRanges) == generic.interior(c, maxRanges));
+        CHECK(p.envelope(b, maxRanges) == generic.envelope(b, maxRanges));
+        CHECK(p.interior(b, maxRanges) == generic.interior(b, maxRanges));
+        CHECK(p.envelope(poly, maxRanges) ==
+              generic.envelope(poly, maxRanges));
+        CHECK(p.interior(poly, maxRanges) ==
+              generic.interior(poly, maxRanges));
+    }
+}
@@ -0,0 +1,232 @@
+/*
+ * LSST Data Management System
+ * Copyright 2016 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains tests for the HybridRangeSet class.
+
+#include <random>
+#include <sstream>
+
+#include "lsst/sphgeom/Circle.h"
+#include "lsst/sphgeom/HtmPixelization.h"
+#include "lsst/sphgeom/HybridRangeSet.h"
+#include "lsst/sphgeom/Q3cPixelization.h"
+#include "lsst/sphgeom/RangeSet.h"
+
+#include "test.h"
+
+
+using namespace lsst::sphgeom;
+
+namespace {
+
+// `randomRangeSet` returns a set of n random ranges, clustered so that
+// they produce run, array and bitmap containers.
+RangeSet randomRangeSet(std::mt19937_64 & rng, int n) {
+    std::uniform_int_distribution<uint64_t> block(0, 7);
+    std::uniform_int_distribution<uint64_t> offset(0, 0x3ffff);
+    std::uniform_int_distribution<uint64_t> length(1, 40);
+    std::uniform_int_distribution<int> kind(0, 9);
+    RangeSet s;
+    for (int i = 0; i < n; ++i) {
+        uint64_t first = (block(rng) << 32) + offset(rng);
+        switch (kind(rng)) {
+            case 0:
+                // A range spanning several blocks.
+                s.insert(first, first + (length(rng) << 16));
+                break;
+            case 1:
+                // A range at the end of the universe.
+                s.insert(~static_cast<uint64_t>(0) - length(rng), 0);
+                break;
+            default:
+                s.insert(first, first + length(rng));
+                break;
+        }
+    }
+    return s;
+}
+
+} // unnamed namespace
+
+TEST_CASE(DefaultConstructor) {
+    HybridRangeSet s;
+    CHECK(s.isValid());
+    CHECK(s.empty());
+    CHECK(!s.full());
+    CHECK(s.getNumRanges() == 0);
+    s.complement();
+    CHECK(s.isValid());
+    CHECK(s.full());
+    CHECK(s.getNumRanges() == 1);
+    CHECK(s.cardinality() == 0);
+}
+
+TEST_CASE(RangeConstructor) {
+    HybridRangeSet s0(2);
+    s0.insert(1);
+    HybridRangeSet s1(1, 3);
+    CHECK(s0.isValid() && s1.isValid());
+    CHECK(s0 == s1);
+    CHECK(s1.contains(1) && s1.contains(2) && !s1.contains(3));
+    CHECK(HybridRangeSet(0, 0).full());
+    CHECK(HybridRangeSet(5, 5).full());
+    HybridRangeSet s2(3, 1);
+    CHECK(s2.isValid());
+    CHECK(s2 == HybridRangeSet(1, 3).complemented());
+    CHECK(s2.toRangeSet() == RangeSet(3, 1));
+}
+
+TEST_CASE(Encodings) {
+    HybridRangeSet s;
+    // A block with a few long runs uses a run container.
+    s.insert(10, 1000);
+    s.insert(2000, 3000);
+    // A block with sparse integers uses an array container.
+    for (uint64_t i = 0; i < 1000; ++i) {
+        s.insert((1 << 16) + 3 * i);
+    }
+    // A block with dense, fragmented integers uses a bitmap container.
+    for (uint64_t i = 0; i < 30000; ++i) {
+        s.insert((2 << 16) + 2 * i);
+    }
+    // Full blocks are merged into a single container.
+    s.insert(3 << 16, 10 << 16);
+    CHECK(s.isValid());
+    CHECK(s.cardinality() == 990 + 1000 + 1000 + 30000 + (7 << 16));
+    CHECK(s.getNumRanges() == 2 + 1000 + 30000 + 1);
+    CHECK(s.getMemoryUsage() < 2 * 8192 + 2000 + 1000);
+    RangeSet r = s.toRangeSet();
+    CHECK(r.size() == s.getNumRanges());
+    CHECK(HybridRangeSet(r) == s);
+}
+
+TEST_CASE(Insert) {
+    std::mt19937_64 rng(1);
+    for (int trial = 0; trial < 50; ++trial) {
+        RangeSet r;
+        HybridRangeSet s;
+        std::uniform_int_distribution<uint64_t> u(0, 1 << 20);
+        std::uniform_int_distribution<uint64_t> length(1, 100);
+        for (int i = 0; i < 200; ++i) {
+            uint64_t first = u(rng);
+            uint64_t last = first + length(rng);
+            r.insert(first, last);
+            s.insert(first, last);
+            CHECK(s.isValid());
+        }
+        CHECK(s.toRangeSet() == r);
+        CHECK(HybridRangeSet(r) == s);
+        // Appending in ascending order should give the same result.
+        HybridRangeSet a;
+        for (auto const & t: r) {
+            a.insert(std::get<0>(t), std::get<1>(t));
+        }
+        CHECK(a.isValid());
+        CHECK(a == s);
+    }
+}
+
+TEST_CASE(SetOperations) {
+    std::mt19937_64 rng(2);
+    for (int trial = 0; trial < 100; ++trial) {
+        RangeSet r0 = randomRangeSet(rng, 500);
+        RangeSet r1 = randomRangeSet(rng, 500);
+        HybridRangeSet s0(r0);
+        HybridRangeSet s1(r1);
+        CHECK(s0.isValid() && s1.isValid());
+        CHECK(s0.toRangeSet() == r0);
+        CHECK(s0.getNumRanges() == r0.size());
+        CHECK(s0.cardinality() == r0.cardinality());
+        HybridRangeSet i = s0 & s1;
+        HybridRangeSet j = s0 | s1;
+        HybridRangeSet d = s0 - s1;
+        HybridRangeSet x = s0 ^ s1;
+        HybridRangeSet c = ~s0;
+        CHECK(i.isValid() && j.isValid() && d.isValid() &&
+              x.isValid() && c.isValid());
+        CHECK(i.toRangeSet() == (r0 & r1));
+        CHECK(j.toRangeSet() == (r0 | r1));
+        CHECK(d.toRangeSet() == (r0 - r1));
+        CHECK(x.toRangeSet() == (r0 ^ r1));
+        CHECK(c.toRangeSet() == ~r0);
+        CHECK(s0.intersects(s1) == r0.intersects(r1));
+        CHECK(s0.contains(i) && j.contains(s1) && !d.intersects(s1));
+        CHECK(s0.contains(s1) == r0.contains(r1));
+        CHECK(i.isWithin(s1));
+        CHECK(d.isDisjointFrom(i));
+    }
+}
+
+TEST_CASE(RangeQueries) {
+    std::mt19937_64 rng(3);
+    std::uniform_int_distribution<uint64_t> block(0, 7);
+    std::uniform_int_distribution<uint64_t> offset(0, 0x3ffff);
+    std::uniform_int_distribution<uint64_t> length(0, 1 << 17);
+    for (int trial = 0; trial < 20; ++trial) {
+        RangeSet r = randomRangeSet(rng, 1000);
+        HybridRangeSet s(r);
+        for (int i = 0; i < 500; ++i) {
+            uint64_t first = (block(rng) << 32) + offset(rng);
+            uint64_t last = first + length(rng);
+            CHECK(s.contains(first) == r.contains(first));
+            CHECK(s.contains(first, last) == r.contains(first, last));
+            CHECK(s.intersects(first, last) == r.intersects(first, last));
+            CHECK(s.isWithin(first, last) == r.isWithin(first, last));
+            CHECK(s.contains(last, first) == r.contains(last, first));
+            CHECK(s.intersects(last, first) == r.intersects(last, first));
+        }
+    }
+}
+
+TEST_CASE(Erase) {
+    HybridRangeSet s(0, 0);
+    s.erase(100, 1 << 20);
+    s.erase(7);
+    CHECK(s.isValid());
+    RangeSet r(0, 0);
+    r.erase(100, 1 << 20);
+    r.erase(7);
+    CHECK(s.toRangeSet() == r);
+}
+
+TEST_CASE(Stream) {
+    HybridRangeSet s(1, 3);
+    s.insert(5);
+    std::stringstream ss;
+    ss << s;
+    CHECK(ss.str() == "{\"HybridRangeSet\": [[1, 3], [5, 6]]}");
+}
+
+TEST_CASE(Pixelizations) {
+    // Coverage maps of regions with ragged boundaries at high subdivision
+    // levels should survive a round trip.
+    Circle c(UnitVector3d(1, 1, 1), Angle::fromDegrees(0.1));
+    RangeSet htm = HtmPixelization(14).envelope(c);
+    RangeSet q3c = Q3cPixelization(14).interior(c);
+    HybridRangeSet h(htm);
+    HybridRangeSet q(q3c);
+    CHECK(h.isValid() && q.isValid());
+    CHECK(h.toRangeSet() == htm);
+    CHECK(q.toRangeSet() == q3c);
+    CHECK(h.getNumRanges() == htm.size());
+}
@@ -173,6 +173,20 @@ TEST_CASE(Interior) {
 }
 
 
+TEST_CASE(StreamEnvelope) {
+    auto pixelization = Mq3cPixelization(6);
+    auto c = Circle(UnitVector3d(1.0, 2.0, 3.0), Angle::fromDegrees(10.0));
+    RangeSet rs;
+    size_t n = 0;
+    pixelization.streamEnvelope(c, [&](uint64_t first, uint64_t last) {
+        ++n;
+        rs.insert(first, last);
+    });
+    CHECK(rs == pixelization.envelope(c));
+    CHECK(n == rs.size());
+}
+
+
 TEST_CASE(Neighborhood) {
     for (int level = 0; level < 3; ++level) {
         auto pixelization = Mq3cPixelization(level);
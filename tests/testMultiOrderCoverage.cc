@@ -0,0 +1,229 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains tests for the MultiOrderCoverage class.
+
+#include <stdexcept>
+#include <vector>
+
+#include "lsst/sphgeom/Box.h"
+#include "lsst/sphgeom/Circle.h"
+#include "lsst/sphgeom/ConvexPolygon.h"
+#include "lsst/sphgeom/HtmPixelization.h"
+#include "lsst/sphgeom/LonLat.h"
+#include "lsst/sphgeom/MultiOrderCoverage.h"
+#include "lsst/sphgeom/Mq3cPixelization.h"
+#include "lsst/sphgeom/Q3cPixelization.h"
+
+#include "test.h"
+
+
+using namespace lsst::sphgeom;
+
+namespace {
+
+using Cell = MultiOrderCoverage::Cell;
+
+Circle makeCircle(double lon, double lat, double r) {
+    return Circle(UnitVector3d(LonLat::fromDegrees(lon, lat)),
+                  Angle::fromDegrees(r));
+}
+
+} // unnamed namespace
+
+
+TEST_CASE(Normalization) {
+    MultiOrderCoverage c;
+    CHECK(c.empty());
+    CHECK(c.getMaxLevel() == -1);
+    CHECK(c.getCells().empty());
+    // Inserting all children of a cell gives the cell.
+    for (uint64_t i = 0; i < 4; ++i) {
+        c.insert(3, 4 * 37 + i);
+    }
+    CHECK(c.getCells() == std::vector<Cell>{Cell(2, 37)});
+    CHECK(c.getMaxLevel() == 2);
+    CHECK(c == MultiOrderCoverage(2, 37));
+    // Inserting a descendant of a cell has no effect.
+    c.insert(7, 37 << 10);
+    CHECK(c == MultiOrderCoverage(2, 37));
+    c.insert(5, 38 << 6);
+    CHECK(c.getCells() == (std::vector<Cell>{Cell(2, 37), Cell(5, 38 << 6)}));
+    CHECK(c.getNumCells() == 2);
+    CHECK(c.getMaxLevel() == 5);
+    CHECK(c.contains(2, 37));
+    CHECK(c.contains(4, 37 * 16 + 1));
+    CHECK(!c.contains(1, 9));
+    CHECK(c.intersects(1, 9));
+    CHECK(!c.intersects(2, 39));
+    // A full level 0 coverage consists of 16 cells.
+    MultiOrderCoverage full = MultiOrderCoverage::fromRangeSet(
+        RangeSet(0, 16 << 6), 3);
+    CHECK(full.getRanges().full());
+    CHECK(full.getNumCells() == 16);
+    CHECK(full.getMaxLevel() == 0);
+    MultiOrderCoverage finest(MultiOrderCoverage::MAX_LEVEL, 12345);
+    CHECK(finest.getMaxLevel() == MultiOrderCoverage::MAX_LEVEL);
+    CHECK(finest.getCells() ==
+          std::vector<Cell>{Cell(MultiOrderCoverage::MAX_LEVEL, 12345)});
+    CHECK_THROW(MultiOrderCoverage(-1, 0), std::invalid_argument);
+    CHECK_THROW(MultiOrderCoverage(31, 0), std::invalid_argument);
+    CHECK_THROW(MultiOrderCoverage(0, 16), std::invalid_argument);
+    CHECK_THROW(MultiOrderCoverage(2, 256), std::invalid_argument);
+    CHECK_THROW(MultiOrderCoverage::fromRangeSet(RangeSet(0, 257), 2),
+                std::invalid_argument);
+}
+
+TEST_CASE(RangeSetConversion) {
+    HtmPixelization htm(9);
+    RangeSet s = htm.envelope(makeCircle(30.0, 40.0, 12.0));
+    MultiOrderCoverage c = MultiOrderCoverage::fromRangeSet(s, 9);
+    CHECK(c.toRangeSet(9) == s);
+    CHECK(c.toInteriorRangeSet(9) == s);
+    CHECK(c.getMaxLevel() == 9);
+    CHECK(c.getNumCells() < s.cardinality() / 4);
+    // Cells cover the original pixels exactly.
+    RangeSet fromCells;
+    for (Cell const & cell: c.getCells()) {
+        int shift = 2 * (9 - cell.first);
+        fromCells |= RangeSet(cell.second << shift,
+                              (cell.second + 1) << shift);
+    }
+    CHECK(fromCells == s);
+    // Coarser range sets bracket the coverage.
+    RangeSet outer = c.toRangeSet(6);
+    RangeSet inner = c.toInteriorRangeSet(6);
+    CHECK(inner.isWithin(outer));
+    CHECK(inner != outer);
+    MultiOrderCoverage o = MultiOrderCoverage::fromRangeSet(outer, 6);
+    MultiOrderCoverage i = MultiOrderCoverage::fromRangeSet(inner, 6);
+    CHECK(o.contains(c));
+    CHECK(c.contains(i));
+    CHECK(c.degradedTo(6) == o);
+    CHECK(c.degradedTo(6).getMaxLevel() <= 6);
+    CHECK(MultiOrderCoverage::fromRangeSet(c.toRangeSet(12), 12) == c);
+    CHECK(c.toRangeSet(MultiOrderCoverage::MAX_LEVEL) == c.getRanges());
+    // The whole sky converts back to the universe at any level.
+    Mq3cPixelization mq3c(4);
+    MultiOrderCoverage sky = MultiOrderCoverage::fromRangeSet(
+        mq3c.universe(), 4);
+    CHECK(sky.getCells().size() == 6);
+    CHECK(sky.getCells().front() == Cell(0, 10));
+    CHECK(sky.toRangeSet(7) == Mq3cPixelization(7).universe());
+    CHECK(sky.toInteriorRangeSet(2) == Mq3cPixelization(2).universe());
+}
+
+TEST_CASE(SetOperations) {
+    Q3cPixelization q3c(8);
+    RangeSet a = q3c.envelope(makeCircle(0.0, 0.0, 10.0));
+    RangeSet b = q3c.envelope(Box::fromDegrees(5.0, -5.0, 25.0, 20.0));
+    MultiOrderCoverage ca = MultiOrderCoverage::fromRangeSet(a, 8);
+    MultiOrderCoverage cb = MultiOrderCoverage::fromRangeSet(b, 8);
+    CHECK((ca | cb).toRangeSet(8) == (a | b));
+    CHECK((ca & cb).toRangeSet(8) == (a & b));
+    CHECK((ca - cb).toRangeSet(8) == (a - b));
+    CHECK((ca ^ cb).toRangeSet(8) == (a ^ b));
+    MultiOrderCoverage c = ca;
+    c |= cb;
+    CHECK(c == (ca | cb));
+    c &= cb;
+    CHECK(c == cb);
+    c -= ca;
+    CHECK(c == (cb - ca));
+    c ^= ca;
+    CHECK(c == (ca | cb));
+    CHECK(ca.intersects(cb));
+    CHECK(!(ca - cb).intersects(cb));
+    // Coverages of different levels can be combined.
+    MultiOrderCoverage coarse = MultiOrderCoverage::fromRangeSet(
+        Q3cPixelization(3).envelope(makeCircle(0.0, 0.0, 10.0)), 3);
+    CHECK(coarse.contains(ca));
+    CHECK((coarse | ca) == coarse);
+    CHECK((coarse & ca) == ca);
+}
+
+TEST_CASE(PixelizationCoverage) {
+    HtmPixelization htm(10);
+    Q3cPixelization q3c(9);
+    Mq3cPixelization mq3c(9);
+    Circle c = makeCircle(120.0, -30.0, 8.0);
+    Box b = Box::fromDegrees(200.0, 10.0, 230.0, 30.0);
+    ConvexPolygon p(UnitVector3d(LonLat::fromDegrees(10.0, 60.0)),
+                    UnitVector3d(LonLat::fromDegrees(40.0, 65.0)),
+                    UnitVector3d(LonLat::fromDegrees(25.0, 80.0)));
+    for (Region const * r: std::vector<Region const *>{&c, &b, &p}) {
+        CHECK(htm.envelopeCoverage(*r) ==
+              MultiOrderCoverage::fromRangeSet(htm.envelope(*r), 10));
+        CHECK(htm.interiorCoverage(*r) ==
+              MultiOrderCoverage::fromRangeSet(htm.interior(*r), 10));
+        CHECK(q3c.envelopeCoverage(*r) ==
+              MultiOrderCoverage::fromRangeSet(q3c.envelope(*r), 9));
+        CHECK(q3c.interiorCoverage(*r) ==
+              MultiOrderCoverage::fromRangeSet(q3c.interior(*r), 9));
+        CHECK(mq3c.envelopeCoverage(*r) ==
+              MultiOrderCoverage::fromRangeSet(mq3c.envelope(*r), 9));
+        CHECK(mq3c.interiorCoverage(*r) ==
+              MultiOrderCoverage::fromRangeSet(mq3c.interior(*r), 9));
+    }
+    MultiOrderCoverage e = htm.envelopeCoverage(c);
+    CHECK(e.getNumCells() < htm.envelope(c).cardinality() / 4);
+    CHECK(e.getMaxLevel() == 10);
+    CHECK(htm.envelopeCoverage(Box::full()) ==
+          MultiOrderCoverage::fromRangeSet(htm.universe(), 10));
+    CHECK(htm.interiorCoverage(Box()).empty());
+}
+
+TEST_CASE(Codec) {
+    HtmPixelization htm(12);
+    MultiOrderCoverage c = htm.envelopeCoverage(makeCircle(75.0, 15.0, 3.0));
+    std::vector<uint8_t> buffer = c.encode();
+    CHECK(MultiOrderCoverage::decode(buffer) == c);
+    // Cells of a level are close to each other, and take few bytes each.
+    CHECK(buffer.size() < 3 * c.getNumCells() + 8 * 13);
+    CHECK(MultiOrderCoverage::decode(MultiOrderCoverage().encode()).empty());
+    MultiOrderCoverage full = MultiOrderCoverage::fromRangeSet(
+        RangeSet(0, 16), 0);
+    CHECK(MultiOrderCoverage::decode(full.encode()) == full);
+    MultiOrderCoverage finest(MultiOrderCoverage::MAX_LEVEL,
+                              ~static_cast<uint64_t>(0));
+    CHECK(MultiOrderCoverage::decode(finest.encode()) == finest);
+    // Non-normalized encodings are normalized.
+    std::vector<uint8_t> redundant = {'M', 1, 1, 37, 2, 4, 148, 1, 1, 1, 1};
+    CHECK(MultiOrderCoverage::decode(redundant) == MultiOrderCoverage(1, 37));
+    std::vector<uint8_t> truncated(buffer.begin(), buffer.end() - 1);
+    CHECK_THROW(MultiOrderCoverage::decode(truncated), std::runtime_error);
+    CHECK_THROW(MultiOrderCoverage::decode(std::vector<uint8_t>()),
+                std::runtime_error);
+    CHECK_THROW(MultiOrderCoverage::decode(std::vector<uint8_t>{'M', 31, 1, 0}),
+                std::runtime_error);
+    CHECK_THROW(MultiOrderCoverage::decode(
+                    std::vector<uint8_t>{'M', 2, 1, 0, 1, 1, 0}),
+                std::runtime_error);
+    CHECK_THROW(MultiOrderCoverage::decode(std::vector<uint8_t>{'M', 0, 1, 16}),
+                std::runtime_error);
+    CHECK_THROW(MultiOrderCoverage::decode(
+                    std::vector<uint8_t>{'M', 1, 2, 3, 0}),
+                std::runtime_error);
+    CHECK_THROW(MultiOrderCoverage::decode(std::vector<uint8_t>{'M', 1, 0}),
+                std::runtime_error);
+}
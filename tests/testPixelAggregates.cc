@@ -0,0 +1,203 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains tests for the PixelAggregates class.
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "lsst/sphgeom/HtmPixelization.h"
+#include "lsst/sphgeom/LonLat.h"
+#include "lsst/sphgeom/Mq3cPixelization.h"
+#include "lsst/sphgeom/PixelAggregates.h"
+#include "lsst/sphgeom/Q3cPixelization.h"
+
+#include "test.h"
+
+
+using namespace lsst::sphgeom;
+
+namespace {
+
+struct Expected {
+    uint64_t count = 0;
+    double sum = 0.0;
+    double min = 1.0e300;
+    double max = -1.0e300;
+};
+
+std::vector<UnitVector3d> makePoints(size_t n) {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<UnitVector3d> points;
+    for (size_t i = 0; i < n; ++i) {
+        double lon = 360.0 * uniform(generator);
+        double lat = std::asin(2.0 * uniform(generator) - 1.0) * 180.0 / PI;
+        points.push_back(UnitVector3d(LonLat::fromDegrees(lon, lat)));
+    }
+    return points;
+}
+
+std::vector<double> makeWeights(size_t n) {
+    std::vector<double> weights;
+    for (size_t i = 0; i < n; ++i) {
+        weights.push_back(static_cast<double>((i * 7919) % 101) - 50.0);
+    }
+    return weights;
+}
+
+// `checkAggregates` compares the given aggregates to a brute force
+// computation over the points.
+void checkAggregates(PixelAggregates const & a,
+                     Pixelization const & pixelization,
+                     std::vector<UnitVector3d> const & points,
+                     std::vector<double> const & weights) {
+    std::map<uint64_t, Expected> expected;
+    for (size_t i = 0; i < points.size(); ++i) {
+        Expected & e = expected[pixelization.index(points[i])];
+        double w = weights.empty() ? 1.0 : weights[i];
+        ++e.count;
+        e.sum += w;
+        e.min = std::min(e.min, w);
+        e.max = std::max(e.max, w);
+    }
+    REQUIRE(a.size() == expected.size());
+    CHECK(a.getTotalCount() == points.size());
+    size_t i = 0;
+    for (auto const & kv: expected) {
+        CHECK(a.getIndexes()[i] == kv.first);
+        CHECK(a.getCounts()[i] == kv.second.count);
+        CHECK(a.getSums()[i] == kv.second.sum);
+        CHECK(a.getMins()[i] == kv.second.min);
+        CHECK(a.getMaxs()[i] == kv.second.max);
+        ++i;
+    }
+}
+
+} // unnamed namespace
+
+
+TEST_CASE(Aggregation) {
+    std::vector<UnitVector3d> points = makePoints(20000);
+    std::vector<double> weights = makeWeights(points.size());
+    // Small and large pixelizations exercise the dense and sparse
+    // accumulation strategies.
+    HtmPixelization htm4(4);
+    HtmPixelization htm10(10);
+    Q3cPixelization q3c(5);
+    Mq3cPixelization mq3c(9);
+    for (Pixelization const * p: std::vector<Pixelization const *>{
+             &htm4, &htm10, &q3c, &mq3c}) {
+        PixelAggregates a(*p, points, weights);
+        checkAggregates(a, *p, points, weights);
+        PixelAggregates u(*p, points);
+        checkAggregates(u, *p, points, {});
+        CHECK(u.getCounts() == a.getCounts());
+        // Weights are small integers, so sums are exact and do not depend
+        // on the number of threads.
+        PixelAggregates t(*p, points.data(), weights.data(), points.size(), 3);
+        CHECK(t.getIndexes() == a.getIndexes());
+        CHECK(t.getCounts() == a.getCounts());
+        CHECK(t.getSums() == a.getSums());
+        CHECK(t.getMins() == a.getMins());
+        CHECK(t.getMaxs() == a.getMaxs());
+    }
+    PixelAggregates e(q3c);
+    CHECK(e.empty());
+    CHECK(e.getTotalCount() == 0);
+    CHECK(PixelAggregates(q3c, points.data(), nullptr, 0, 4).empty());
+    CHECK_THROW(PixelAggregates(q3c, points, std::vector<double>(3)),
+                std::invalid_argument);
+}
+
+TEST_CASE(Dense) {
+    std::vector<UnitVector3d> points = makePoints(1000);
+    std::vector<double> weights = makeWeights(points.size());
+    HtmPixelization htm(3);
+    PixelAggregates a(htm, points, weights);
+    std::vector<uint64_t> counts = a.getDenseCounts();
+    std::vector<double> sums = a.getDenseSums();
+    std::vector<double> mins = a.getDenseMins();
+    std::vector<double> maxs = a.getDenseMaxs();
+    REQUIRE(counts.size() == 8 * 64);
+    CHECK(sums.size() == counts.size());
+    CHECK(mins.size() == counts.size());
+    CHECK(maxs.size() == counts.size());
+    size_t j = 0;
+    for (uint64_t i = 0; i < counts.size(); ++i) {
+        if (j < a.size() && a.getIndexes()[j] == 8 * 64 + i) {
+            CHECK(counts[i] == a.getCounts()[j]);
+            CHECK(sums[i] == a.getSums()[j]);
+            CHECK(mins[i] == a.getMins()[j]);
+            CHECK(maxs[i] == a.getMaxs()[j]);
+            ++j;
+        } else {
+            CHECK(counts[i] == 0);
+            CHECK(sums[i] == 0.0);
+            CHECK(std::isnan(mins[i]));
+            CHECK(std::isnan(maxs[i]));
+        }
+    }
+    CHECK(j == a.size());
+}
+
+TEST_CASE(RollUp) {
+    std::vector<UnitVector3d> points = makePoints(20000);
+    std::vector<double> weights = makeWeights(points.size());
+    HtmPixelization htm(9);
+    Mq3cPixelization mq3c(8);
+    PixelAggregates a(htm, points, weights);
+    for (int level = 9; level >= 0; level -= 3) {
+        PixelAggregates c = a.coarsened(level);
+        CHECK(c.getLevel() == level);
+        CHECK(dynamic_cast<HtmPixelization const &>(
+                  c.getPixelization()).getLevel() == level);
+        checkAggregates(c, HtmPixelization(level), points, weights);
+    }
+    PixelAggregates m(mq3c, points, weights);
+    checkAggregates(m.coarsened(2), Mq3cPixelization(2), points, weights);
+    CHECK_THROW(a.coarsened(10), std::invalid_argument);
+    CHECK_THROW(a.coarsened(-1), std::invalid_argument);
+}
+
+TEST_CASE(Merging) {
+    std::vector<UnitVector3d> points = makePoints(10000);
+    std::vector<double> weights = makeWeights(points.size());
+    Q3cPixelization q3c(8);
+    std::vector<UnitVector3d> p1(points.begin(), points.begin() + 3000);
+    std::vector<UnitVector3d> p2(points.begin() + 3000, points.end());
+    std::vector<double> w1(weights.begin(), weights.begin() + 3000);
+    std::vector<double> w2(weights.begin() + 3000, weights.end());
+    PixelAggregates a1(q3c, p1, w1);
+    PixelAggregates a2(q3c, p2, w2);
+    checkAggregates(a1.merged(a2), q3c, points, weights);
+    checkAggregates(a2.merged(a1), q3c, points, weights);
+    checkAggregates(a1.merged(PixelAggregates(q3c)), q3c, p1, w1);
+    CHECK_THROW(a1.merged(a2.coarsened(7)), std::invalid_argument);
+    CHECK_THROW(a1.merged(PixelAggregates(Mq3cPixelization(8))),
+                std::invalid_argument);
+}
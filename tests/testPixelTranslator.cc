@@ -0,0 +1,156 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains tests for the PixelTranslator class.
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "lsst/sphgeom/Box.h"
+#include "lsst/sphgeom/Chunker.h"
+#include "lsst/sphgeom/Circle.h"
+#include "lsst/sphgeom/HtmPixelization.h"
+#include "lsst/sphgeom/LonLat.h"
+#include "lsst/sphgeom/Mq3cPixelization.h"
+#include "lsst/sphgeom/PixelTranslator.h"
+#include "lsst/sphgeom/Q3cPixelization.h"
+
+#include "test.h"
+
+
+using namespace lsst::sphgeom;
+
+namespace {
+
+std::vector<UnitVector3d> makePoints(size_t n) {
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<UnitVector3d> points;
+    for (size_t i = 0; i < n; ++i) {
+        double lon = 360.0 * uniform(generator);
+        double lat = std::asin(2.0 * uniform(generator) - 1.0) * 180.0 / PI;
+        points.push_back(UnitVector3d(LonLat::fromDegrees(lon, lat)));
+    }
+    return points;
+}
+
+RangeSet toRangeSet(std::vector<int32_t> const & ids) {
+    RangeSet s;
+    for (int32_t id: ids) {
+        s.insert(static_cast<uint64_t>(id));
+    }
+    return s;
+}
+
+// `checkTranslation` checks that the envelope and interior translations of
+// a source pixel set are consistent with the pixels of random points.
+void checkTranslation(Pixelization const & source,
+                      Pixelization const & target,
+                      RangeSet const & pixels,
+                      std::vector<UnitVector3d> const & points) {
+    PixelTranslator translator(source, target);
+    RangeSet envelope = translator.envelope(pixels);
+    RangeSet interior = translator.interior(pixels);
+    CHECK(interior.isWithin(envelope));
+    CHECK(envelope.isWithin(target.universe()));
+    for (UnitVector3d const & v: points) {
+        if (pixels.contains(source.index(v))) {
+            CHECK(envelope.contains(target.index(v)));
+        }
+        if (interior.contains(target.index(v))) {
+            CHECK(pixels.contains(source.index(v)));
+        }
+    }
+    // Multi-threaded translation and cached results are identical.
+    CHECK(translator.envelope(pixels, 3) == envelope);
+    CHECK(translator.interior(pixels, 2) == interior);
+    PixelTranslator uncached(source, target, -1);
+    CHECK(uncached.envelope(pixels) == envelope);
+    CHECK(uncached.getCacheSize() == 0);
+}
+
+} // unnamed namespace
+
+
+TEST_CASE(PixelizationTranslation) {
+    std::vector<UnitVector3d> points = makePoints(20000);
+    HtmPixelization htm(7);
+    Q3cPixelization q3c(6);
+    Mq3cPixelization mq3c(8);
+    Circle c(UnitVector3d(LonLat::fromDegrees(45.0, 30.0)),
+             Angle::fromDegrees(20.0));
+    Box b = Box::fromDegrees(100.0, -60.0, 180.0, -10.0);
+    checkTranslation(htm, q3c, htm.envelope(c), points);
+    checkTranslation(htm, mq3c, htm.interior(b), points);
+    checkTranslation(q3c, htm, q3c.envelope(b), points);
+    checkTranslation(mq3c, HtmPixelization(9), mq3c.envelope(c), points);
+    // The interior of a large region is non-trivial.
+    PixelTranslator translator(htm, q3c);
+    CHECK(!translator.interior(htm.envelope(c)).empty());
+    CHECK(translator.envelope(htm.universe()) == q3c.universe());
+    CHECK(translator.interior(htm.universe()) == q3c.universe());
+    CHECK(translator.envelope(RangeSet()).empty());
+    CHECK(translator.interior(RangeSet()).empty());
+    CHECK(translator.getCacheSize() > 0);
+    translator.clearCache();
+    CHECK(translator.getCacheSize() == 0);
+    CHECK_THROW(translator.envelope(RangeSet(0, 8)), std::invalid_argument);
+    CHECK_THROW(PixelTranslator(htm, q3c, 25), std::invalid_argument);
+}
+
+TEST_CASE(ChunkerTranslation) {
+    std::vector<UnitVector3d> points = makePoints(2000);
+    HtmPixelization htm(6);
+    Chunker chunker(85, 12);
+    Box b = Box::fromDegrees(10.0, 10.0, 30.0, 25.0);
+    RangeSet pixels = htm.envelope(b);
+    PixelTranslator translator(htm, chunker);
+    RangeSet chunks = translator.envelope(pixels);
+    RangeSet interior = translator.interior(pixels);
+    CHECK(interior.isWithin(chunks));
+    CHECK(!interior.empty());
+    for (UnitVector3d const & v: points) {
+        if (pixels.contains(htm.index(v))) {
+            Circle c(v, Angle(1.0e-9));
+            CHECK(toRangeSet(chunker.getChunksIntersecting(c)).isWithin(chunks));
+        }
+    }
+    CHECK(translator.envelope(htm.universe()) ==
+          toRangeSet(chunker.getAllChunks()));
+    CHECK(translator.envelope(pixels, 4) == chunks);
+    // Sub-chunk keys map back to the chunk IDs.
+    PixelTranslator subTranslator(htm, chunker, true);
+    RangeSet subChunks = subTranslator.envelope(pixels);
+    RangeSet chunkIds;
+    for (auto const & range: subChunks) {
+        for (uint64_t k = std::get<0>(range); k != std::get<1>(range); ++k) {
+            chunkIds.insert(Chunker::getChunkIdFromKey(k));
+        }
+    }
+    CHECK(chunkIds == chunks);
+    RangeSet subInterior = subTranslator.interior(pixels);
+    CHECK(subInterior.isWithin(subChunks));
+    CHECK(!subInterior.empty());
+}
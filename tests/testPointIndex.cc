@@ -0,0 +1,233 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains tests for the PointIndex class.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "lsst/sphgeom/Box.h"
+#include "lsst/sphgeom/Circle.h"
+#include "lsst/sphgeom/ConvexPolygon.h"
+#include "lsst/sphgeom/HtmPixelization.h"
+#include "lsst/sphgeom/LonLat.h"
+#include "lsst/sphgeom/Mq3cPixelization.h"
+#include "lsst/sphgeom/PointIndex.h"
+#include "lsst/sphgeom/Q3cPixelization.h"
+
+#include "test.h"
+
+
+using namespace lsst::sphgeom;
+
+namespace {
+
+std::vector<UnitVector3d> makePoints(size_t n) {
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<UnitVector3d> points;
+    for (size_t i = 0; i < n; ++i) {
+        double lon = 360.0 * uniform(generator);
+        double lat = std::asin(2.0 * uniform(generator) - 1.0) * 180.0 / PI;
+        points.push_back(UnitVector3d(LonLat::fromDegrees(lon, lat)));
+    }
+    return points;
+}
+
+// `bruteForce` returns the IDs of the points in r.
+std::vector<uint64_t> bruteForce(std::vector<UnitVector3d> const & points,
+                                 Region const & r) {
+    std::vector<uint64_t> ids;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (r.contains(points[i])) {
+            ids.push_back(i);
+        }
+    }
+    return ids;
+}
+
+std::vector<uint64_t> sorted(std::vector<uint64_t> ids) {
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+// `IndexFile` is a test fixture providing the path of an index file that
+// is removed on tear-down.
+struct IndexFile {
+    std::string path;
+
+    IndexFile() : path("testPointIndex.tmp") { std::remove(path.c_str()); }
+    ~IndexFile() { std::remove(path.c_str()); }
+};
+
+} // unnamed namespace
+
+
+TEST_CASE(Construction) {
+    std::vector<UnitVector3d> points = makePoints(10000);
+    HtmPixelization htm(8);
+    PointIndex index(htm, points);
+    REQUIRE(index.size() == points.size());
+    CHECK(!index.empty());
+    CHECK(index.getNumPixels() > 1000);
+    std::vector<uint64_t> ids(index.getIds(), index.getIds() + index.size());
+    std::vector<uint64_t> expected(points.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        expected[i] = i;
+    }
+    CHECK(sorted(ids) == expected);
+    for (size_t i = 0; i < index.size(); ++i) {
+        CHECK(index.getPoints()[i] == points[ids[i]]);
+        if (i > 0) {
+            uint64_t p0 = htm.index(index.getPoints()[i - 1]);
+            uint64_t p1 = htm.index(index.getPoints()[i]);
+            CHECK(p0 < p1 || (p0 == p1 && ids[i - 1] < ids[i]));
+        }
+    }
+    // Multi-threaded construction gives the same result.
+    PointIndex threaded(htm, points.data(), points.size(), 3);
+    CHECK(std::equal(ids.begin(), ids.end(), threaded.getIds()));
+    CHECK(threaded.getNumPixels() == index.getNumPixels());
+    PointIndex empty(htm);
+    CHECK(empty.empty());
+    CHECK(empty.find(htm.universe()).empty());
+    CHECK(empty.find(Box::full()).empty());
+    CHECK(empty.getSpans(htm.universe()).empty());
+}
+
+TEST_CASE(PixelQueries) {
+    std::vector<UnitVector3d> points = makePoints(10000);
+    Q3cPixelization q3c(6);
+    PointIndex index(q3c, points);
+    std::vector<PointIndex::Span> all = index.getSpans(q3c.universe());
+    REQUIRE(all.size() == 1);
+    CHECK(all[0] == PointIndex::Span(0, points.size()));
+    Circle c(UnitVector3d(LonLat::fromDegrees(30.0, -20.0)),
+             Angle::fromDegrees(10.0));
+    RangeSet pixels = q3c.envelope(c);
+    std::vector<uint64_t> ids = index.find(pixels);
+    std::vector<uint64_t> expected;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (pixels.contains(q3c.index(points[i]))) {
+            expected.push_back(i);
+        }
+    }
+    CHECK(sorted(ids) == expected);
+    std::vector<PointIndex::Span> spans = index.getSpans(pixels);
+    for (size_t i = 1; i < spans.size(); ++i) {
+        CHECK(spans[i - 1].second < spans[i].first);
+    }
+    CHECK(index.find(RangeSet()).empty());
+}
+
+TEST_CASE(RegionQueries) {
+    std::vector<UnitVector3d> points = makePoints(20000);
+    HtmPixelization htm(7);
+    Mq3cPixelization mq3c(7);
+    Circle c(UnitVector3d(LonLat::fromDegrees(200.0, 45.0)),
+             Angle::fromDegrees(15.0));
+    Box b = Box::fromDegrees(-20.0, -10.0, 20.0, 30.0);
+    ConvexPolygon p(UnitVector3d(LonLat::fromDegrees(90.0, 0.0)),
+                    UnitVector3d(LonLat::fromDegrees(110.0, 5.0)),
+                    UnitVector3d(LonLat::fromDegrees(100.0, 25.0)));
+    for (Pixelization const * pixelization:
+             std::vector<Pixelization const *>{&htm, &mq3c}) {
+        PointIndex index(*pixelization, points);
+        for (Region const * r: std::vector<Region const *>{&c, &b, &p}) {
+            std::vector<uint64_t> ids = index.find(*r);
+            CHECK(sorted(ids) == bruteForce(points, *r));
+            // IDs are returned in sorted position order.
+            std::vector<size_t> positions(points.size());
+            for (size_t i = 0; i < index.size(); ++i) {
+                positions[index.getIds()[i]] = i;
+            }
+            for (size_t i = 1; i < ids.size(); ++i) {
+                CHECK(positions[ids[i - 1]] < positions[ids[i]]);
+            }
+        }
+        CHECK(index.find(Box::full()).size() == points.size());
+        CHECK(index.find(Box()).empty());
+    }
+}
+
+FIXTURE_TEST_CASE(Persistence, IndexFile) {
+    std::vector<UnitVector3d> points = makePoints(5000);
+    HtmPixelization htm(6);
+    PointIndex index(htm, points);
+    index.save(path);
+    {
+        PointIndex mapped = PointIndex::open(path);
+        REQUIRE(mapped.size() == index.size());
+        CHECK(mapped.getNumPixels() == index.getNumPixels());
+        CHECK(dynamic_cast<HtmPixelization const &>(
+                  mapped.getPixelization()).getLevel() == 6);
+        CHECK(std::equal(index.getIds(), index.getIds() + index.size(),
+                         mapped.getIds()));
+        CHECK(std::equal(index.getPoints(), index.getPoints() + index.size(),
+                         mapped.getPoints()));
+        Circle c(UnitVector3d(LonLat::fromDegrees(10.0, 10.0)),
+                 Angle::fromDegrees(20.0));
+        CHECK(mapped.find(c) == index.find(c));
+        // Copies share the mapping.
+        PointIndex copy = mapped;
+        mapped = PointIndex(htm);
+        CHECK(copy.find(c) == index.find(c));
+    }
+    PointIndex(htm).save(path);
+    CHECK(PointIndex::open(path).empty());
+    // Truncated and corrupt files are rejected.
+    index.save(path);
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size() - 8);
+    }
+    CHECK_THROW(PointIndex::open(path), std::runtime_error);
+    {
+        std::string corrupt = bytes;
+        corrupt[9] = 99;
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(corrupt.data(), corrupt.size());
+    }
+    CHECK_THROW(PointIndex::open(path), std::runtime_error);
+    {
+        std::string corrupt = bytes;
+        corrupt[corrupt.size() - 1] ^= 1;
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(corrupt.data(), corrupt.size());
+    }
+    CHECK_THROW(PointIndex::open(path), std::runtime_error);
+    std::remove(path.c_str());
+    CHECK_THROW(PointIndex::open(path), std::runtime_error);
+}
@@ -0,0 +1,259 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains tests for the Polygon class.
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "lsst/sphgeom/Box.h"
+#include "lsst/sphgeom/Circle.h"
+#include "lsst/sphgeom/ConvexPolygon.h"
+#include "lsst/sphgeom/Ellipse.h"
+#include "lsst/sphgeom/HtmPixelization.h"
+#include "lsst/sphgeom/LonLat.h"
+#include "lsst/sphgeom/Polygon.h"
+
+#include "test.h"
+
+
+using namespace lsst::sphgeom;
+
+namespace {
+
+UnitVector3d fromDegrees(double lon, double lat) {
+    return UnitVector3d(LonLat::fromDegrees(lon, lat));
+}
+
+// `makeU` returns the vertices of a U shaped polygon, in clockwise order.
+std::vector<UnitVector3d> makeU() {
+    return {
+        fromDegrees(0.0, 0.0), fromDegrees(0.0, 10.0),
+        fromDegrees(3.0, 10.0), fromDegrees(3.0, 3.0),
+        fromDegrees(7.0, 3.0), fromDegrees(7.0, 10.0),
+        fromDegrees(10.0, 10.0), fromDegrees(10.0, 0.0)
+    };
+}
+
+std::vector<UnitVector3d> makeSquare(double lon, double lat, double size) {
+    return {
+        fromDegrees(lon, lat), fromDegrees(lon + size, lat),
+        fromDegrees(lon + size, lat + size), fromDegrees(lon, lat + size)
+    };
+}
+
+// `makeComb` returns a comb shaped polygon over the equator with 40 teeth
+// of alternating height, along with its decomposition into one convex
+// quadrilateral per tooth.
+Polygon makeComb(std::vector<ConvexPolygon> & teeth) {
+    std::vector<UnitVector3d> v = {fromDegrees(0.0, 0.0),
+                                   fromDegrees(20.0, 0.0)};
+    for (int k = 39; k >= 0; --k) {
+        double lon = 0.5 * k;
+        double height = (k % 2 == 0) ? 10.0 : 5.0;
+        v.push_back(fromDegrees(lon + 0.5, height));
+        v.push_back(fromDegrees(lon, height));
+        teeth.push_back(ConvexPolygon(
+            fromDegrees(lon, 0.0), fromDegrees(lon + 0.5, 0.0),
+            fromDegrees(lon + 0.5, height), fromDegrees(lon, height)));
+    }
+    return Polygon(v);
+}
+
+} // unnamed namespace
+
+
+TEST_CASE(Construction) {
+    Polygon p(makeU());
+    CHECK(p.getBoundary().size() == 8);
+    CHECK(p.getHoles().empty());
+    CHECK(p.getConvexHull() == ConvexPolygon(makeSquare(0.0, 0.0, 10.0)));
+    // The boundary is stored in counter-clockwise order.
+    std::vector<UnitVector3d> u = makeU();
+    std::reverse(u.begin(), u.end());
+    CHECK(Polygon(u) == p);
+    CHECK(p.getBoundary() == u);
+    // Repeated vertices are removed.
+    u.push_back(u[0]);
+    u.insert(u.begin() + 3, u[3]);
+    CHECK(Polygon(u) == p);
+    // Holes are stored in clockwise order.
+    std::vector<UnitVector3d> hole = makeSquare(4.0, 4.0, 2.0);
+    Polygon q(makeSquare(0.0, 0.0, 10.0), {hole});
+    CHECK(q.getHoles().size() == 1);
+    CHECK(q.getHoles()[0] == std::vector<UnitVector3d>(hole.rbegin(),
+                                                         hole.rend()));
+    CHECK(q != Polygon(makeSquare(0.0, 0.0, 10.0)));
+    std::unique_ptr<Region> r = q.clone();
+    CHECK(dynamic_cast<Polygon *>(r.get()) != nullptr);
+    CHECK(*dynamic_cast<Polygon *>(r.get()) == q);
+}
+
+TEST_CASE(ConstructionFailure) {
+    CHECK_THROW(Polygon({fromDegrees(0.0, 0.0), fromDegrees(1.0, 0.0)}),
+                std::invalid_argument);
+    CHECK_THROW(Polygon({fromDegrees(0.0, 0.0), fromDegrees(1.0, 0.0),
+                         fromDegrees(2.0, 0.0)}),
+                std::invalid_argument);
+    CHECK_THROW(Polygon({UnitVector3d::X(), UnitVector3d::Y(),
+                         -UnitVector3d::X(), -UnitVector3d::Y()}),
+                std::invalid_argument);
+    // A bow tie is not simple.
+    CHECK_THROW(Polygon({fromDegrees(0.0, 0.0), fromDegrees(10.0, 10.0),
+                         fromDegrees(10.0, 0.0), fromDegrees(0.0, 10.0)}),
+                std::invalid_argument);
+}
+
+TEST_CASE(Containment) {
+    Polygon p(makeU());
+    CHECK(p.contains(fromDegrees(5.0, 1.0)));
+    CHECK(p.contains(fromDegrees(1.0, 8.0)));
+    CHECK(p.contains(fromDegrees(9.0, 8.0)));
+    CHECK(!p.contains(fromDegrees(5.0, 6.0)));
+    CHECK(!p.contains(fromDegrees(5.0, 11.0)));
+    CHECK(!p.contains(fromDegrees(-1.0, 5.0)));
+    CHECK(!p.contains(-fromDegrees(5.0, 1.0)));
+    Polygon q(makeSquare(0.0, 0.0, 10.0), {makeSquare(4.0, 4.0, 2.0)});
+    CHECK(q.contains(fromDegrees(2.0, 2.0)));
+    CHECK(q.contains(fromDegrees(5.0, 7.0)));
+    CHECK(!q.contains(fromDegrees(5.0, 5.0)));
+    CHECK(!q.contains(fromDegrees(12.0, 5.0)));
+    // Holes are closed, unlike the polygon boundary.
+    CHECK(q.contains(fromDegrees(0.0, 0.0)));
+    CHECK(!q.contains(fromDegrees(4.0, 4.0)));
+    CHECK(!q.contains(fromDegrees(6.0, 6.0)));
+}
+
+TEST_CASE(IndexedContainment) {
+    std::vector<ConvexPolygon> teeth;
+    Polygon p = makeComb(teeth);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> lon(-1.0, 21.0);
+    std::uniform_real_distribution<double> lat(-1.0, 11.0);
+    for (int i = 0; i < 10000; ++i) {
+        UnitVector3d v = fromDegrees(lon(rng), lat(rng));
+        bool expected = std::any_of(
+            teeth.begin(), teeth.end(),
+            [&v](ConvexPolygon const & t) { return t.contains(v); });
+        CHECK(p.contains(v) == expected);
+    }
+}
+
+TEST_CASE(Relations) {
+    Polygon p(makeU());
+    // Regions in the notch of the U are disjoint from it.
+    CHECK(p.relate(Circle(fromDegrees(5.0, 6.0), Angle::fromDegrees(1.0))) ==
+          DISJOINT);
+    CHECK(p.relate(Box(LonLat::fromDegrees(4.0, 4.0),
+                       LonLat::fromDegrees(6.0, 12.0))) == DISJOINT);
+    CHECK(p.relate(ConvexPolygon(makeSquare(4.0, 5.0, 2.0))) == DISJOINT);
+    // Regions in an arm of the U are contained by it.
+    CHECK(p.relate(Circle(fromDegrees(1.5, 6.0), Angle::fromDegrees(1.0))) ==
+          CONTAINS);
+    CHECK(p.relate(ConvexPolygon(makeSquare(7.5, 1.0, 2.0))) == CONTAINS);
+    CHECK(p.relate(Ellipse(fromDegrees(5.0, 1.5), Angle::fromDegrees(0.5),
+                           Angle::fromDegrees(0.25), Angle(0.0))) ==
+          CONTAINS);
+    // The U is within regions containing its convex hull.
+    CHECK(p.relate(Circle(fromDegrees(5.0, 5.0), Angle::fromDegrees(20.0))) ==
+          WITHIN);
+    CHECK(p.relate(ConvexPolygon(makeSquare(-1.0, -1.0, 12.0))) == WITHIN);
+    // ... and intersects regions that straddle its boundary.
+    CHECK(p.relate(Circle(fromDegrees(3.0, 6.0), Angle::fromDegrees(1.0))) ==
+          INTERSECTS);
+    CHECK(p.relate(ConvexPolygon(makeSquare(2.0, 2.0, 6.0))) == INTERSECTS);
+    // Relations are symmetric.
+    Circle c(fromDegrees(1.5, 6.0), Angle::fromDegrees(1.0));
+    CHECK(c.relate(p) == WITHIN);
+    CHECK(static_cast<Region const &>(p).relate(
+              static_cast<Region const &>(c)) == CONTAINS);
+    CHECK(Box(LonLat::fromDegrees(4.0, 4.0),
+              LonLat::fromDegrees(6.0, 12.0)).relate(p) == DISJOINT);
+    CHECK(ConvexPolygon(makeSquare(4.0, 5.0, 2.0)).relate(p) == DISJOINT);
+    // Holes are excluded.
+    Polygon q(makeSquare(0.0, 0.0, 10.0), {makeSquare(4.0, 4.0, 2.0)});
+    CHECK(q.relate(Circle(fromDegrees(5.0, 5.0), Angle::fromDegrees(0.5))) ==
+          DISJOINT);
+    CHECK(q.relate(Circle(fromDegrees(5.0, 5.0), Angle::fromDegrees(1.5))) ==
+          INTERSECTS);
+    CHECK(q.relate(Circle(fromDegrees(2.0, 2.0), Angle::fromDegrees(1.0))) ==
+          CONTAINS);
+    CHECK(q.relate(ConvexPolygon(makeSquare(4.0, 4.0, 2.0))) == DISJOINT);
+    // Polygon-polygon relations.
+    CHECK(p.relate(p) == (CONTAINS | WITHIN));
+    CHECK(Polygon(makeSquare(-1.0, -1.0, 12.0), {makeSquare(4.0, 4.0, 2.0)})
+              .relate(p) == CONTAINS);
+    CHECK(p.relate(Polygon(makeSquare(4.5, 4.5, 1.0))) == DISJOINT);
+    CHECK(p.relate(Polygon(makeSquare(2.5, 4.5, 1.0))) == INTERSECTS);
+    CHECK(q.relate(Polygon(makeSquare(4.5, 4.5, 1.0))) == DISJOINT);
+    CHECK(Polygon(makeSquare(-1.0, -1.0, 12.0)).relate(p) == CONTAINS);
+    CHECK(p.relate(Polygon(makeSquare(4.0, 5.0, 2.0))) == DISJOINT);
+}
+
+TEST_CASE(Codec) {
+    Polygon p(makeSquare(0.0, 0.0, 10.0),
+              {makeSquare(2.0, 2.0, 2.0), makeSquare(6.0, 6.0, 2.0)});
+    std::vector<uint8_t> buffer = p.encode();
+    CHECK(*Polygon::decode(buffer) == p);
+    std::unique_ptr<Region> r = Region::decode(buffer);
+    CHECK(dynamic_cast<Polygon *>(r.get()) != nullptr);
+    CHECK(*dynamic_cast<Polygon *>(r.get()) == p);
+    buffer.pop_back();
+    CHECK_THROW(Polygon::decode(buffer), std::runtime_error);
+    CHECK_THROW(Polygon::decode(Circle().encode()), std::runtime_error);
+    std::ostringstream os;
+    os << Polygon(makeU());
+    CHECK(os.str().compare(0, 13, "{\"Polygon\": [") == 0);
+}
+
+TEST_CASE(Pixels) {
+    std::vector<ConvexPolygon> teeth;
+    Polygon p = makeComb(teeth);
+    HtmPixelization htm(8);
+    RangeSet envelope = htm.envelope(p, 0);
+    RangeSet interior = htm.interior(p, 0);
+    RangeSet teethEnvelope;
+    RangeSet teethInterior;
+    for (ConvexPolygon const & t: teeth) {
+        teethEnvelope |= htm.envelope(t, 0);
+        teethInterior |= htm.interior(t, 0);
+    }
+    CHECK(interior.isWithin(envelope));
+    CHECK(envelope.isWithin(htm.envelope(p.getConvexHull(), 0)));
+    CHECK(envelope.isWithin(teethEnvelope));
+    CHECK(teethInterior.isWithin(interior));
+    CHECK(envelope.cardinality() < htm.envelope(p.getConvexHull(), 0)
+                                       .cardinality());
+    for (auto const & range: interior) {
+        for (uint64_t i = std::get<0>(range); i < std::get<1>(range); ++i) {
+            ConvexPolygon t = htm.triangle(i);
+            for (UnitVector3d const & v: t.getVertices()) {
+                CHECK(p.contains(v));
+            }
+        }
+    }
+}
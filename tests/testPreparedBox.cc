@@ -0,0 +1,115 @@
+/*
+ * LSST Data Management System
+ * Copyright 2016 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains tests for the PreparedBox class.
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "lsst/sphgeom/Box.h"
+#include "lsst/sphgeom/LonLat.h"
+#include "lsst/sphgeom/PreparedBox.h"
+
+#include "test.h"
+
+
+using namespace lsst::sphgeom;
+
+namespace {
+
+void checkBox(Box const & box, std::mt19937_64 & rng) {
+    PreparedBox prepared(box);
+    std::uniform_real_distribution<double> u(-1.0, 1.0);
+    std::vector<UnitVector3d> points;
+    // Random points.
+    for (int i = 0; i < 2000; ++i) {
+        points.push_back(UnitVector3d(u(rng), u(rng), u(rng)));
+    }
+    // Points on and near the box boundaries, and the poles.
+    if (!box.isEmpty()) {
+        double lon[2] = {box.getLon().getA().asRadians(),
+                         box.getLon().getB().asRadians()};
+        double lat[2] = {box.getLat().getA().asRadians(),
+                         box.getLat().getB().asRadians()};
+        for (double dlon: {-1.0e-15, 0.0, 1.0e-15, 1.0e-9}) {
+            for (double dlat: {-1.0e-15, 0.0, 1.0e-15, 1.0e-9}) {
+                for (int i = 0; i < 2; ++i) {
+                    for (int j = 0; j < 2; ++j) {
+                        double b = std::max(-0.5 * PI,
+                                            std::min(0.5 * PI, lat[j] + dlat));
+                        points.push_back(UnitVector3d(LonLat::fromRadians(
+                            lon[i] + dlon, b)));
+                    }
+                }
+            }
+        }
+    }
+    points.push_back(UnitVector3d::Z());
+    points.push_back(-UnitVector3d::Z());
+    std::vector<double> x, y, z;
+    for (UnitVector3d const & v: points) {
+        x.push_back(v.x());
+        y.push_back(v.y());
+        z.push_back(v.z());
+    }
+    std::unique_ptr<bool[]> r1(new bool[points.size()]);
+    std::unique_ptr<bool[]> r2(new bool[points.size()]);
+    prepared.contains(points.data(), points.size(), r1.get());
+    prepared.contains(x.data(), y.data(), z.data(), points.size(), r2.get());
+    for (size_t i = 0; i < points.size(); ++i) {
+        bool expected = box.contains(points[i]);
+        CHECK(prepared.contains(points[i]) == expected);
+        CHECK(r1[i] == expected);
+        CHECK(r2[i] == expected);
+    }
+}
+
+} // unnamed namespace
+
+TEST_CASE(SpecialBoxes) {
+    std::mt19937_64 rng(1);
+    checkBox(Box(), rng);
+    checkBox(Box::full(), rng);
+    checkBox(Box::fromDegrees(0, 80, 360, 90), rng);
+    checkBox(Box::fromDegrees(0, -90, 360, -80), rng);
+    checkBox(Box::fromDegrees(10, -90, 20, 90), rng);
+    checkBox(Box::fromDegrees(350, -10, 10, 10), rng);
+    checkBox(Box::fromDegrees(0, -10, 180, 10), rng);
+    checkBox(Box::fromDegrees(90, -10, 300, 10), rng);
+    checkBox(Box::fromDegrees(45, 30, 45, 30), rng);
+    checkBox(Box(LonLat::fromDegrees(0, 0)), rng);
+}
+
+TEST_CASE(RandomBoxes) {
+    std::mt19937_64 rng(2);
+    std::uniform_real_distribution<double> lon(0.0, 360.0);
+    std::uniform_real_distribution<double> lat(-90.0, 90.0);
+    for (int i = 0; i < 200; ++i) {
+        double lat1 = lat(rng);
+        double lat2 = lat(rng);
+        checkBox(Box::fromDegrees(lon(rng), std::min(lat1, lat2),
+                                  lon(rng), std::max(lat1, lat2)), rng);
+    }
+}
@@ -164,6 +164,35 @@ TEST_CASE(Interior) {
 }
 
 
+TEST_CASE(EnvelopeAndInterior) {
+    auto pixelization = Q3cPixelization(8);
+    for (uint64_t i = 0; i < 6; ++i) {
+        UnitVector3d v = Q3cPixelization(0).quad(i).getCentroid();
+        auto c = Circle(v, Angle::fromDegrees(3.0));
+        for (size_t maxRanges: {0, 2, 16}) {
+            auto ei = pixelization.envelopeAndInterior(c, maxRanges);
+            CHECK(ei.first == pixelization.envelope(c, maxRanges));
+            CHECK(ei.second == pixelization.interior(c, maxRanges));
+            CHECK(ei.first.contains(ei.second));
+        }
+    }
+}
+
+
+TEST_CASE(TypedRegions) {
+    auto pixelization = Q3cPixelization(8);
+    Pixelization const & generic = pixelization;
+    for (uint64_t i = 0; i < 6; ++i) {
+        auto p = Q3cPixelization(2).quad(i * 16 + 5);
+        auto c = p.getBoundingCircle();
+        CHECK(pixelization.envelope(c) == generic.envelope(c));
+        CHECK(pixelization.interior(c) == generic.interior(c));
+        CHECK(pixelization.envelope(p) == generic.envelope(p));
+        CHECK(pixelization.interior(p) == generic.interior(p));
+    }
+}
+
+
 TEST_CASE(Neighborhood) {
     for (int level = 0; level < 3; ++level) {
         auto pixelization = Q3cPixelization(level);
@@ -23,6 +23,8 @@
 /// \file
 /// \brief This file contains tests for the RangeSet class.
 
+#include <random>
+
 #include "lsst/sphgeom/RangeSet.h"
 
 #include "test.h"
@@ -314,3 +316,53 @@ TEST_CASE(Scale) {
     s.scale(10);
     CHECK(s.isValid() && s == RangeSet({{0, 10}, {50, 80}, {90, 0}}));
 }
+
+TEST_CASE(Reductions) {
+    std::mt19937_64 rng(1);
+    std::uniform_int_distribution<uint64_t> u(0, 10000000);
+    std::uniform_int_distribution<uint64_t> length(1, 10000);
+    std::vector<RangeSet> sets(20);
+    for (size_t i = 0; i < sets.size(); ++i) {
+        for (int j = 0; j < 1000; ++j) {
+            uint64_t first = u(rng);
+            sets[i].insert(first, first + length(rng));
+        }
+    }
+    // Exercise the trailing and leading zero bookends.
+    sets[0].insert(0, 10);
+    sets[1].insert(~static_cast<uint64_t>(0) - 10, 0);
+    sets[2].insert(0, 0);
+    RangeSet join;
+    RangeSet intersection(0, 0);
+    for (RangeSet const & s: sets) {
+        join |= s;
+        intersection &= s;
+    }
+    // Large enough inputs are split across threads, which must not
+    // change the results.
+    for (unsigned numThreads: {1u, 4u}) {
+        RangeSet s = RangeSet::unionOf(sets, numThreads);
+        CHECK(s.isValid() && s == join);
+        s = RangeSet::intersectionOf(sets, numThreads);
+        CHECK(s.isValid() && s == intersection);
+        CHECK(RangeSet::coveredBy(sets, 0, numThreads).full());
+        CHECK(RangeSet::coveredBy(sets, 21, numThreads).empty());
+    }
+    // Check the count threshold against explicit counts.
+    std::uniform_int_distribution<uint64_t> v(0, 10010000);
+    for (size_t k = 2; k < 5; ++k) {
+        RangeSet s = RangeSet::coveredBy(sets, k);
+        CHECK(s.isValid());
+        CHECK(RangeSet::coveredBy(sets, k, 4) == s);
+        for (int i = 0; i < 10000; ++i) {
+            uint64_t x = v(rng);
+            size_t count = 0;
+            for (RangeSet const & t: sets) {
+                count += t.contains(x);
+            }
+            CHECK(s.contains(x) == (count >= k));
+        }
+    }
+    CHECK(RangeSet::unionOf(nullptr, 0).empty());
+    CHECK(RangeSet::intersectionOf(nullptr, 0).full());
+}
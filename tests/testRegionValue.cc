@@ -0,0 +1,183 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains tests for the RegionValue class.
+
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "lsst/sphgeom/HtmPixelization.h"
+#include "lsst/sphgeom/LonLat.h"
+#include "lsst/sphgeom/Q3cPixelization.h"
+#include "lsst/sphgeom/RegionValue.h"
+
+#include "test.h"
+
+
+using namespace lsst::sphgeom;
+
+namespace {
+
+std::vector<std::unique_ptr<Region>> makeRegions() {
+    std::vector<std::unique_ptr<Region>> regions;
+    UnitVector3d v(LonLat::fromDegrees(30.0, 10.0));
+    regions.emplace_back(new Box(LonLat::fromDegrees(25.0, 5.0),
+                                 LonLat::fromDegrees(40.0, 12.0)));
+    regions.emplace_back(new Circle(v, Angle::fromDegrees(4.0)));
+    regions.emplace_back(new ConvexPolygon(
+        UnitVector3d(LonLat::fromDegrees(20.0, 0.0)),
+        UnitVector3d(LonLat::fromDegrees(35.0, 2.0)),
+        UnitVector3d(LonLat::fromDegrees(33.0, 15.0)),
+        UnitVector3d(LonLat::fromDegrees(22.0, 14.0))));
+    regions.emplace_back(new Ellipse(v, Angle::fromDegrees(6.0),
+                                     Angle::fromDegrees(2.0),
+                                     Angle::fromDegrees(30.0)));
+    return regions;
+}
+
+} // unnamed namespace
+
+
+TEST_CASE(TypeTraits) {
+    CHECK(std::is_nothrow_move_constructible<RegionValue>::value);
+    CHECK(std::is_nothrow_move_assignable<RegionValue>::value);
+    RegionValue v;
+    CHECK(v.getType() == RegionValue::Type::BOX);
+    CHECK(v.getIf<Box>() != nullptr);
+    CHECK(v.getIf<Box>()->isEmpty());
+    CHECK(v.getIf<Circle>() == nullptr);
+}
+
+TEST_CASE(Interop) {
+    auto regions = makeRegions();
+    RegionValue::Type const types[] = {
+        RegionValue::Type::BOX,
+        RegionValue::Type::CIRCLE,
+        RegionValue::Type::CONVEX_POLYGON,
+        RegionValue::Type::ELLIPSE
+    };
+    for (size_t i = 0; i < regions.size(); ++i) {
+        Region const & r = *regions[i];
+        RegionValue v(r);
+        CHECK(v.getType() == types[i]);
+        CHECK(&v.getRegion() != &r);
+        CHECK(v.encode() == r.encode());
+        CHECK(v.clone()->encode() == r.encode());
+        CHECK(v.getBoundingBox() == r.getBoundingBox());
+        CHECK(v.getBoundingBox3d() == r.getBoundingBox3d());
+        CHECK(v.getBoundingCircle() == r.getBoundingCircle());
+        CHECK(v.contains(UnitVector3d(LonLat::fromDegrees(30.0, 10.0))));
+        CHECK(!v.contains(UnitVector3d(LonLat::fromDegrees(210.0, -10.0))));
+    }
+}
+
+TEST_CASE(Relate) {
+    auto regions = makeRegions();
+    std::vector<RegionValue> values;
+    for (auto const & r: regions) {
+        values.emplace_back(*r);
+    }
+    values.emplace_back(Circle(UnitVector3d::Z(), Angle::fromDegrees(1.0)));
+    regions.emplace_back(values.back().clone());
+    for (size_t i = 0; i < values.size(); ++i) {
+        for (size_t j = 0; j < values.size(); ++j) {
+            Relationship expected = regions[i]->relate(*regions[j]);
+            CHECK(values[i].relate(values[j]) == expected);
+            CHECK(values[i].relate(*regions[j]) == expected);
+        }
+    }
+}
+
+TEST_CASE(CopyAndMove) {
+    auto regions = makeRegions();
+    std::vector<RegionValue> values;
+    for (auto const & r: regions) {
+        values.emplace_back(*r);
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        for (size_t j = 0; j < values.size(); ++j) {
+            RegionValue v(values[i]);
+            CHECK(v == values[i]);
+            v = values[j];
+            CHECK(v == values[j]);
+            CHECK(v.getType() == values[j].getType());
+            RegionValue w(values[i]);
+            w = std::move(v);
+            CHECK(w == values[j]);
+            RegionValue x(std::move(w));
+            CHECK(x == values[j]);
+            CHECK((x != values[i]) == (i != j));
+        }
+    }
+}
+
+TEST_CASE(Decode) {
+    auto regions = makeRegions();
+    RegionValue v;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (auto const & r: regions) {
+            std::vector<uint8_t> s = r->encode();
+            RegionValue d = RegionValue::decode(s);
+            CHECK(d.encode() == s);
+            v.decodeInPlace(s.data(), s.size());
+            CHECK(v == d);
+            CHECK(v.encode() == s);
+        }
+    }
+    // Decoding a polygon into a polygon reuses the vertex storage.
+    std::vector<uint8_t> s = regions[2]->encode();
+    v.decodeInPlace(s.data(), s.size());
+    UnitVector3d const * vertices =
+        v.getIf<ConvexPolygon>()->getVertices().data();
+    v.decodeInPlace(s.data(), s.size());
+    CHECK(v.getIf<ConvexPolygon>()->getVertices().data() == vertices);
+    // Invalid byte strings are rejected.
+    std::vector<uint8_t> bad;
+    CHECK_THROW(RegionValue::decode(bad), std::runtime_error);
+    bad.push_back(0xff);
+    CHECK_THROW(RegionValue::decode(bad), std::runtime_error);
+    s.pop_back();
+    CHECK_THROW(RegionValue::decode(s), std::runtime_error);
+    // A failed decode leaves a valid region in place.
+    RegionValue c(Circle(UnitVector3d::Z(), Angle(0.5)));
+    CHECK_THROW(c.decodeInPlace(s.data(), s.size()), std::runtime_error);
+    CHECK(c.getType() != RegionValue::Type::CONVEX_POLYGON);
+    CHECK(c.getRegion().contains(UnitVector3d::Z()));
+}
+
+TEST_CASE(PixelSearch) {
+    auto regions = makeRegions();
+    HtmPixelization htm(9);
+    Q3cPixelization q3c(9);
+    for (auto const & r: regions) {
+        RegionValue v(*r);
+        CHECK(v.envelope(htm) == htm.envelope(*r));
+        CHECK(v.interior(htm) == htm.interior(*r));
+        CHECK(v.envelope(q3c, 8) == q3c.envelope(*r, 8));
+        CHECK(v.interior(q3c, 8) == q3c.interior(*r, 8));
+        Pixelization const & p = htm;
+        CHECK(v.envelope(p) == p.envelope(*r));
+    }
+}
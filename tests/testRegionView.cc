@@ -0,0 +1,173 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains tests for the RegionView class.
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "lsst/sphgeom/LonLat.h"
+#include "lsst/sphgeom/RegionView.h"
+
+#include "test.h"
+
+
+using namespace lsst::sphgeom;
+
+namespace {
+
+UnitVector3d fromDegrees(double lon, double lat) {
+    return UnitVector3d(LonLat::fromDegrees(lon, lat));
+}
+
+std::vector<std::unique_ptr<Region>> makeRegions() {
+    std::vector<std::unique_ptr<Region>> regions;
+    regions.emplace_back(new Box(LonLat::fromDegrees(25.0, 5.0),
+                                 LonLat::fromDegrees(40.0, 12.0)));
+    regions.emplace_back(new Circle(fromDegrees(30.0, 10.0),
+                                    Angle::fromDegrees(4.0)));
+    regions.emplace_back(new ConvexPolygon(
+        fromDegrees(20.0, 0.0), fromDegrees(35.0, 2.0),
+        fromDegrees(33.0, 15.0), fromDegrees(22.0, 14.0)));
+    regions.emplace_back(new ConvexPolygon(
+        fromDegrees(31.0, 9.0), fromDegrees(32.0, 9.0),
+        fromDegrees(31.5, 10.0)));
+    regions.emplace_back(new ConvexPolygon(
+        fromDegrees(120.0, -5.0), fromDegrees(130.0, -5.0),
+        fromDegrees(125.0, 5.0)));
+    regions.emplace_back(new Ellipse(fromDegrees(30.0, 10.0),
+                                     Angle::fromDegrees(6.0),
+                                     Angle::fromDegrees(2.0),
+                                     Angle::fromDegrees(30.0)));
+    return regions;
+}
+
+// `makeColumn` encodes the given regions as an Arrow-style binary column,
+// with an empty value in between every pair of regions.
+template <typename Offset>
+void makeColumn(std::vector<std::unique_ptr<Region>> const & regions,
+                std::vector<uint8_t> & data,
+                std::vector<Offset> & offsets)
+{
+    offsets.push_back(0);
+    for (auto const & r: regions) {
+        std::vector<uint8_t> s = r->encode();
+        data.insert(data.end(), s.begin(), s.end());
+        offsets.push_back(static_cast<Offset>(data.size()));
+        offsets.push_back(static_cast<Offset>(data.size()));
+    }
+}
+
+} // unnamed namespace
+
+
+TEST_CASE(Construction) {
+    RegionView null;
+    CHECK(null.isNull());
+    CHECK_THROW(RegionView(nullptr, 0), std::runtime_error);
+    std::vector<uint8_t> s = Circle(UnitVector3d::X(), 0.5).encode();
+    RegionView v(s.data(), s.size());
+    CHECK(!v.isNull());
+    CHECK(v.getTypeCode() == Circle::TYPE_CODE);
+    CHECK(v.getNumVertices() == 0);
+    CHECK_THROW(RegionView(s.data(), s.size() - 1), std::runtime_error);
+    s[0] = 'x';
+    CHECK_THROW(RegionView(s.data(), s.size()), std::runtime_error);
+    ConvexPolygon p(UnitVector3d::X(), UnitVector3d::Y(), UnitVector3d::Z());
+    s = p.encode();
+    v = RegionView(s.data(), s.size());
+    CHECK(v.getNumVertices() == 3);
+    for (size_t i = 0; i < 3; ++i) {
+        CHECK(v.getVertex(i) == p.getVertices()[i]);
+    }
+    CHECK_THROW(v.getVertex(3), std::out_of_range);
+    CHECK_THROW(RegionView(s.data(), s.size() - 24), std::runtime_error);
+}
+
+TEST_CASE(Predicates) {
+    auto regions = makeRegions();
+    std::vector<std::vector<uint8_t>> encoded;
+    std::vector<RegionView> views;
+    for (auto const & r: regions) {
+        encoded.push_back(r->encode());
+        views.emplace_back(encoded.back().data(), encoded.back().size());
+    }
+    UnitVector3d const points[] = {
+        fromDegrees(30.0, 10.0),
+        fromDegrees(31.5, 9.5),
+        fromDegrees(125.0, 0.0),
+        fromDegrees(21.0, 1.0),
+        fromDegrees(210.0, -10.0)
+    };
+    for (size_t i = 0; i < regions.size(); ++i) {
+        Region const & r = *regions[i];
+        RegionView const & v = views[i];
+        CHECK(v.decode().encode() == encoded[i]);
+        CHECK(v.getBoundingBox() == r.getBoundingBox());
+        CHECK(v.getBoundingBox3d() == r.getBoundingBox3d());
+        CHECK(v.getBoundingCircle() == r.getBoundingCircle());
+        for (UnitVector3d const & p: points) {
+            CHECK(v.contains(p) == r.contains(p));
+        }
+        for (size_t j = 0; j < regions.size(); ++j) {
+            Relationship expected = r.relate(*regions[j]);
+            CHECK(v.relate(*regions[j]) == expected);
+            CHECK(v.relate(RegionValue(*regions[j])) == expected);
+            CHECK(v.relate(views[j]) == expected);
+        }
+    }
+}
+
+TEST_CASE(Column) {
+    auto regions = makeRegions();
+    std::vector<uint8_t> data;
+    std::vector<int32_t> offsets32;
+    std::vector<int64_t> offsets64;
+    makeColumn(regions, data, offsets32);
+    offsets64.assign(offsets32.begin(), offsets32.end());
+    size_t n = offsets32.size() - 1;
+    std::vector<RegionView> v32 =
+        RegionView::fromColumn(data.data(), offsets32.data(), n);
+    std::vector<RegionView> v64 =
+        RegionView::fromColumn(data.data(), offsets64.data(), n);
+    CHECK(v32.size() == n);
+    CHECK(v64.size() == n);
+    for (size_t i = 0; i < n; ++i) {
+        CHECK(v32[i].data() == v64[i].data());
+        CHECK(v32[i].size() == v64[i].size());
+        if (i % 2 == 1) {
+            CHECK(v32[i].isNull());
+        } else {
+            CHECK(v32[i].data() == data.data() + offsets32[i]);
+            CHECK(v32[i].decode().encode() == regions[i / 2]->encode());
+        }
+    }
+    // Invalid values and decreasing offsets are rejected.
+    offsets32[1] -= 1;
+    CHECK_THROW(RegionView::fromColumn(data.data(), offsets32.data(), n),
+                std::runtime_error);
+    offsets32[1] = offsets32[2] + 1;
+    CHECK_THROW(RegionView::fromColumn(data.data(), offsets32.data(), n),
+                std::runtime_error);
+}
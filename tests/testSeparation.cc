@@ -0,0 +1,194 @@
+/*
+ * LSST Data Management System
+ * See COPYRIGHT file at the top of the source tree.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief This file contains tests for the batch separation functions.
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "lsst/sphgeom/Circle.h"
+#include "lsst/sphgeom/InstructionSet.h"
+#include "lsst/sphgeom/LonLat.h"
+#include "lsst/sphgeom/NormalizedAngle.h"
+#include "lsst/sphgeom/separation.h"
+
+#include "test.h"
+
+
+using namespace lsst::sphgeom;
+
+namespace {
+
+struct Components {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+
+    UnitVector3d operator[](size_t i) const {
+        return UnitVector3d::fromNormalized(x[i], y[i], z[i]);
+    }
+};
+
+// `same` returns true if a batch result a is the same as the scalar result
+// b. Compilers may contract the scalar code into fused multiply-adds when
+// targeting CPUs supporting them, and the results may then differ by the
+// given tolerance (see separation.h).
+bool same(double a, double b, double tolerance) {
+#ifdef __FP_FAST_FMA
+    return std::fabs(a - b) <= tolerance;
+#else
+    static_cast<void>(tolerance);
+    return a == b;
+#endif
+}
+
+// `makePoints` returns random points, some of which are very close to or
+// antipodal to the center.
+Components makePoints(UnitVector3d const & center, size_t n) {
+    std::mt19937 generator(5);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    Components c;
+    for (size_t i = 0; i < n; ++i) {
+        UnitVector3d v;
+        if (i % 7 == 0) {
+            v = UnitVector3d(center + Vector3d(uniform(generator),
+                                               uniform(generator),
+                                               uniform(generator)) * 1.0e-9);
+        } else if (i % 11 == 0) {
+            v = -center;
+        } else {
+            double lon = 360.0 * uniform(generator);
+            double lat = std::asin(2.0 * uniform(generator) - 1.0) * 180.0 / PI;
+            v = UnitVector3d(LonLat::fromDegrees(lon, lat));
+        }
+        c.x.push_back(v.x());
+        c.y.push_back(v.y());
+        c.z.push_back(v.z());
+    }
+    return c;
+}
+
+// `checkSeparations` checks that the batch functions give the same results
+// as the corresponding scalar code.
+void checkSeparations(UnitVector3d const & center,
+                      Components const & p,
+                      Components const & q,
+                      Angle radius) {
+    size_t n = p.x.size();
+    std::vector<double> d(n);
+    std::unique_ptr<bool[]> within(new bool[n]);
+    Circle circle(center, radius);
+    getSquaredChordLengths(center, p.x.data(), p.y.data(), p.z.data(),
+                           n, d.data());
+    for (size_t i = 0; i < n; ++i) {
+        double r = (p[i] - center).getSquaredNorm();
+        CHECK(same(d[i], r, 1.0e-15 * r));
+    }
+    getAngularSeparations(center, p.x.data(), p.y.data(), p.z.data(),
+                          n, d.data());
+    for (size_t i = 0; i < n; ++i) {
+        CHECK(same(d[i], NormalizedAngle(center, p[i]).asRadians(), 1.0e-15));
+    }
+    isWithinRadius(center, radius, p.x.data(), p.y.data(), p.z.data(),
+                   n, within.get());
+    for (size_t i = 0; i < n; ++i) {
+        CHECK(within[i] == circle.contains(p[i]));
+    }
+    // Pairwise separations.
+    getSquaredChordLengths(p.x.data(), p.y.data(), p.z.data(),
+                           q.x.data(), q.y.data(), q.z.data(), n, d.data());
+    for (size_t i = 0; i < n; ++i) {
+        double r = (q[i] - p[i]).getSquaredNorm();
+        CHECK(same(d[i], r, 1.0e-15 * r));
+    }
+    getAngularSeparations(p.x.data(), p.y.data(), p.z.data(),
+                          q.x.data(), q.y.data(), q.z.data(), n, d.data());
+    for (size_t i = 0; i < n; ++i) {
+        CHECK(same(d[i], NormalizedAngle(p[i], q[i]).asRadians(), 1.0e-15));
+    }
+    isWithinRadius(p.x.data(), p.y.data(), p.z.data(),
+                   q.x.data(), q.y.data(), q.z.data(), radius, n, within.get());
+    for (size_t i = 0; i < n; ++i) {
+        CHECK(within[i] == Circle(p[i], radius).contains(q[i]));
+    }
+}
+
+} // unnamed namespace
+
+
+TEST_CASE(InstructionSets) {
+    InstructionSet supported = getSupportedInstructionSet();
+    CHECK(getInstructionSet() == supported);
+    CHECK(setInstructionSet(InstructionSet::SCALAR) == InstructionSet::SCALAR);
+    CHECK(getInstructionSet() == InstructionSet::SCALAR);
+    CHECK(setInstructionSet(InstructionSet::AVX512) == supported);
+    CHECK(getInstructionSet() == supported);
+}
+
+TEST_CASE(Separations) {
+    UnitVector3d center(LonLat::fromDegrees(20.0, -35.0));
+    // The point count is not a multiple of any vector width.
+    Components p = makePoints(center, 1027);
+    Components q = makePoints(UnitVector3d::Z(), 1027);
+    std::vector<InstructionSet> sets = {
+        InstructionSet::SCALAR, InstructionSet::AVX2, InstructionSet::AVX512
+    };
+    std::vector<std::vector<double>> results;
+    for (InstructionSet s: sets) {
+        if (setInstructionSet(s) != s) {
+            continue;
+        }
+        std::vector<double> chords(p.x.size());
+        std::vector<double> angles(p.x.size());
+        getSquaredChordLengths(p.x.data(), p.y.data(), p.z.data(),
+                               q.x.data(), q.y.data(), q.z.data(),
+                               p.x.size(), chords.data());
+        getAngularSeparations(center, p.x.data(), p.y.data(), p.z.data(),
+                              p.x.size(), angles.data());
+        results.push_back(chords);
+        results.push_back(angles);
+        for (double r: {0.0, 1.0e-6, 10.0, 90.0, 179.0, 180.0}) {
+            checkSeparations(center, p, q, Angle::fromDegrees(r));
+        }
+        // Empty circles contain nothing.
+        std::unique_ptr<bool[]> within(new bool[p.x.size()]);
+        isWithinRadius(center, Angle(-1.0), p.x.data(), p.y.data(),
+                       p.z.data(), p.x.size(), within.get());
+        CHECK(std::count(within.get(), within.get() + p.x.size(), true) == 0);
+        // Short arrays only use the scalar code.
+        std::vector<double> d(1);
+        getSquaredChordLengths(center, p.x.data(), p.y.data(), p.z.data(),
+                               1, d.data());
+        double r = (p[0] - center).getSquaredNorm();
+        CHECK(same(d[0], r, 1.0e-15 * r));
+        getSquaredChordLengths(center, nullptr, nullptr, nullptr, 0, nullptr);
+    }
+    // Results do not depend on the instruction set.
+    for (size_t i = 2; i < results.size(); ++i) {
+        CHECK(results[i] == results[i % 2]);
+    }
+    setInstructionSet(getSupportedInstructionSet());
+}
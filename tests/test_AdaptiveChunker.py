@@ -0,0 +1,125 @@
+#
+# LSST Data Management System
+# See COPYRIGHT file at the top of the source tree.
+#
+# This product includes software developed by the
+# LSST Project (http://www.lsst.org/).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the LSST License Statement and
+# the GNU General Public License along with this program.  If not,
+# see <https://www.lsstcorp.org/LegalNotices/>.
+#
+
+import pickle
+
+import math
+import random
+import unittest
+
+from lsst.sphgeom import (AdaptiveChunker, Angle, Box, Circle,
+                          HtmPixelization, LonLat, Q3cPixelization,
+                          UnitVector3d)
+
+
+def makePoints(n):
+    """Return random points, most of which lie near the equator."""
+    rng = random.Random(42)
+    points = []
+    for i in range(n):
+        lon = rng.uniform(0, 360)
+        if i % 10 == 0:
+            lat = math.degrees(math.asin(rng.uniform(-1, 1)))
+        else:
+            lat = max(-89, min(89, rng.gauss(0, 3)))
+        points.append(UnitVector3d(LonLat.fromDegrees(lon, lat)))
+    return points
+
+
+def makeChunker(pixelization, points, maxRowsPerChunk):
+    indexes = [pixelization.index(v) for v in points]
+    return AdaptiveChunker(pixelization, indexes, [1] * len(indexes),
+                           maxRowsPerChunk)
+
+
+class AdaptiveChunkerTestCase(unittest.TestCase):
+
+    def setUp(self):
+        self.points = makePoints(5000)
+
+    def testPartitioning(self):
+        h = HtmPixelization(5)
+        chunker = makeChunker(h, self.points, 100)
+        self.assertEqual(chunker.getAllChunks(),
+                         list(range(chunker.numChunks)))
+        self.assertEqual(chunker.pixelization.universe(), h.universe())
+        total = 0
+        for c in chunker.getAllChunks():
+            pixels = chunker.getPixels(c)
+            self.assertEqual(len(pixels), 1)
+            self.assertTrue(chunker.getRowCount(c) <= 100 or
+                            pixels.cardinality() == 1)
+            total += chunker.getRowCount(c)
+        self.assertEqual(total, len(self.points))
+        for v in self.points[:500]:
+            c = chunker.getChunk(v)
+            self.assertTrue(chunker.valid(c))
+            self.assertTrue(chunker.getPixels(c).contains(h.index(v)))
+        self.assertFalse(chunker.valid(-1))
+        self.assertFalse(chunker.valid(chunker.numChunks))
+        with self.assertRaises(ValueError):
+            chunker.getPixels(chunker.numChunks)
+        with self.assertRaises(ValueError):
+            AdaptiveChunker(h, [1, 2], [1], 10)
+        with self.assertRaises(ValueError):
+            AdaptiveChunker(h, [], [], 0)
+
+    def testEmptyHistogram(self):
+        q = Q3cPixelization(4)
+        chunker = AdaptiveChunker(q, [], [], 10)
+        self.assertEqual(chunker.numChunks, 1)
+        self.assertEqual(chunker.getPixels(0), q.universe())
+        self.assertEqual(chunker.getChunk(UnitVector3d.X()), 0)
+        self.assertEqual(chunker.getChunksIntersecting(Box.full()), [0])
+
+    def testQueries(self):
+        chunker = makeChunker(HtmPixelization(6), self.points, 200)
+        c = Circle(UnitVector3d(LonLat.fromDegrees(100, 2)),
+                   Angle.fromDegrees(5))
+        chunkIds = chunker.getChunksIntersecting(c)
+        self.assertEqual(chunkIds, sorted(set(chunkIds)))
+        self.assertTrue(set(chunkIds).issubset(
+            chunker.getChunksIntersecting(c, maxRanges=4)))
+        for v in self.points:
+            if c.contains(v):
+                self.assertIn(chunker.getChunk(v), chunkIds)
+        v = self.points[0]
+        self.assertIn(chunker.getChunk(v),
+                      chunker.getChunksNear(v, Angle.fromDegrees(0.1)))
+
+    def testCodec(self):
+        chunker = makeChunker(HtmPixelization(4), self.points, 200)
+        s = chunker.encode()
+        self.assertEqual(AdaptiveChunker.decode(s), chunker)
+        self.assertNotEqual(makeChunker(HtmPixelization(4), self.points, 100),
+                            chunker)
+        with self.assertRaises(RuntimeError):
+            AdaptiveChunker.decode(s[:-1])
+
+    def testPickle(self):
+        a = makeChunker(Q3cPixelization(3), self.points, 500)
+        b = pickle.loads(pickle.dumps(a, pickle.HIGHEST_PROTOCOL))
+        self.assertEqual(a, b)
+
+
+if __name__ == '__main__':
+    unittest.main()
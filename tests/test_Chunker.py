@@ -23,7 +23,7 @@
 import pickle
 import unittest
 
-from lsst.sphgeom import Box, Chunker
+from lsst.sphgeom import Box, Chunker, TraversalStats
 
 
 class ChunkerTestCase(unittest.TestCase):
@@ -45,6 +45,12 @@ class ChunkerTestCase(unittest.TestCase):
         self.assertEqual(c.getChunksIntersecting(b), [9630, 9631, 9797])
         self.assertEqual(c.getSubChunksIntersecting(b),
                          [(9630, [770]), (9631, [759]), (9797, [11])])
+        stats = TraversalStats()
+        self.assertEqual(c.getChunksIntersecting(b, stats=stats),
+                         [9630, 9631, 9797])
+        self.assertEqual(stats.nodesVisited[0],
+                         stats.disjoint + stats.within + stats.intersects)
+        self.assertGreaterEqual(stats.nodesVisited[0], 3)
 
     def testString(self):
         chunker = Chunker(85, 12)
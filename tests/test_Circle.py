@@ -90,6 +90,28 @@ class CircleTestCase(unittest.TestCase):
         a.clipTo(UnitVector3d.Z())
         self.assertTrue(a.isEmpty())
 
+    def test_minimal_enclosing_circle(self):
+        self.assertTrue(Circle.minimalEnclosingCircle([]).isEmpty())
+        points = [UnitVector3d.X(), UnitVector3d.Y()]
+        c = Circle.minimalEnclosingCircle(points)
+        for p in points:
+            self.assertTrue(c.contains(p))
+        self.assertAlmostEqual(
+            c.getCenter().dot(UnitVector3d(1, 1, 0)), 1.0)
+        self.assertAlmostEqual(c.getOpeningAngle().asRadians(), math.pi / 4)
+        points.append(UnitVector3d.Z())
+        c = Circle.minimalEnclosingCircle(points)
+        for p in points:
+            self.assertTrue(c.contains(p))
+        self.assertAlmostEqual(
+            c.getCenter().dot(UnitVector3d(1, 1, 1)), 1.0)
+        self.assertAlmostEqual(c.getOpeningAngle().asRadians(),
+                               math.acos(1 / math.sqrt(3)))
+        # Interior points do not change the circle.
+        d = Circle.minimalEnclosingCircle(points + [UnitVector3d(1, 1, 1)])
+        self.assertAlmostEqual(d.getSquaredChordLength(),
+                               c.getSquaredChordLength())
+
     def test_dilation_and_erosion(self):
         a = Angle(math.pi / 2)
         c = Circle(UnitVector3d.X())
@@ -0,0 +1,128 @@
+#
+# LSST Data Management System
+# See COPYRIGHT file at the top of the source tree.
+#
+# This product includes software developed by the
+# LSST Project (http://www.lsst.org/).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the LSST License Statement and
+# the GNU General Public License along with this program.  If not,
+# see <https://www.lsstcorp.org/LegalNotices/>.
+#
+
+import pickle
+
+import unittest
+
+from lsst.sphgeom import (CONTAINS, DISJOINT, INTERSECTS, WITHIN, Angle, Box,
+                          Circle, DifferenceRegion, HtmPixelization,
+                          IntersectionRegion, LonLat, Region, UnionRegion,
+                          UnitVector3d)
+
+
+def fromDegrees(lon, lat):
+    return UnitVector3d(LonLat.fromDegrees(lon, lat))
+
+
+def makeCircle(lon, lat, r):
+    return Circle(fromDegrees(lon, lat), Angle.fromDegrees(r))
+
+
+class CompoundRegionTestCase(unittest.TestCase):
+
+    def setUp(self):
+        self.a = makeCircle(0, 0, 2)
+        self.b = makeCircle(3, 0, 2)
+        self.box = Box(LonLat.fromDegrees(0, 0), LonLat.fromDegrees(10, 10))
+        self.mask = makeCircle(5, 5, 2)
+
+    def testConstruction(self):
+        u = UnionRegion([self.a, self.b])
+        self.assertEqual(len(u), 2)
+        self.assertEqual(u.getNumOperands(), 2)
+        self.assertEqual(u.getOperand(0), self.a)
+        self.assertEqual(u.getOperand(1), self.b)
+        with self.assertRaises(IndexError):
+            u.getOperand(2)
+        d = DifferenceRegion(self.box, self.mask)
+        self.assertEqual(d.getOperand(0), self.box)
+        self.assertEqual(d.getOperand(1), self.mask)
+
+    def testContains(self):
+        u = UnionRegion([self.a, self.b])
+        i = IntersectionRegion([self.a, self.b])
+        d = DifferenceRegion(self.box, self.mask)
+        self.assertTrue(u.contains(fromDegrees(-1, 0)))
+        self.assertFalse(i.contains(fromDegrees(-1, 0)))
+        self.assertTrue(i.contains(fromDegrees(1.5, 0)))
+        self.assertTrue(fromDegrees(1, 1) in d)
+        self.assertFalse(fromDegrees(5, 5) in d)
+
+    def testRelationships(self):
+        u = UnionRegion([self.a, self.b])
+        i = IntersectionRegion([self.a, self.b])
+        d = DifferenceRegion(self.box, self.mask)
+        self.assertEqual(u.relate(makeCircle(1.5, 0, 0.1)), CONTAINS)
+        self.assertEqual(u.relate(makeCircle(1.5, 0, 5)), WITHIN)
+        self.assertEqual(u.relate(makeCircle(1.5, 10, 1)), DISJOINT)
+        self.assertEqual(i.relate(makeCircle(1, 0, 0.5)), INTERSECTS)
+        self.assertEqual(i.relate(makeCircle(-1.5, 0, 0.1)), DISJOINT)
+        self.assertEqual(d.relate(makeCircle(5, 5, 1)), DISJOINT)
+        self.assertEqual(d.relate(makeCircle(1, 1, 0.5)), CONTAINS)
+        self.assertEqual(d.relate(makeCircle(5, 5, 3)), INTERSECTS)
+        # Compound regions can be nested.
+        n = DifferenceRegion(self.box, UnionRegion([self.mask, self.a]))
+        self.assertEqual(n.relate(makeCircle(0.5, 0.5, 0.1)), DISJOINT)
+        self.assertEqual(n.relate(makeCircle(9, 9, 0.5)), CONTAINS)
+
+    def testPixels(self):
+        h = HtmPixelization(7)
+        d = DifferenceRegion(self.box, UnionRegion([self.mask, self.a]))
+        envelope = h.envelope(d)
+        interior = h.interior(d)
+        self.assertTrue(interior.isWithin(envelope))
+        self.assertTrue(envelope.isWithin(h.envelope(self.box)))
+        self.assertTrue(envelope.isDisjointFrom(h.interior(self.mask)))
+        self.assertTrue(interior.isDisjointFrom(h.envelope(self.a)))
+
+    def testCodec(self):
+        n = DifferenceRegion(self.box, UnionRegion([self.mask, self.a]))
+        s = n.encode()
+        m = DifferenceRegion.decode(s)
+        self.assertIsInstance(m, DifferenceRegion)
+        self.assertEqual(m.encode(), s)
+        self.assertEqual(m.getOperand(0), self.box)
+        self.assertIsInstance(m.getOperand(1), UnionRegion)
+        self.assertEqual(m.getOperand(1).getOperand(0), self.mask)
+        r = Region.decode(s)
+        self.assertIsInstance(r, DifferenceRegion)
+        self.assertEqual(r.encode(), s)
+        for c in (UnionRegion([self.a, self.b]),
+                  IntersectionRegion([self.a, self.b])):
+            s = c.encode()
+            self.assertEqual(type(c).decode(s).encode(), s)
+            self.assertIsInstance(Region.decode(s), type(c))
+        with self.assertRaises(RuntimeError):
+            DifferenceRegion.decode(s)
+        with self.assertRaises(RuntimeError):
+            UnionRegion.decode(n.encode()[:-1])
+
+    def testPickle(self):
+        a = UnionRegion([self.a, self.b])
+        b = pickle.loads(pickle.dumps(a, pickle.HIGHEST_PROTOCOL))
+        self.assertIsInstance(b, UnionRegion)
+        self.assertEqual(a.encode(), b.encode())
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -69,6 +69,10 @@ class ConvexPolygonTestCase(unittest.TestCase):
         self.assertTrue(p.intersects(tinyCircle))
         self.assertFalse(p.isDisjointFrom(tinyCircle))
         self.assertTrue(p.contains(tinyCircle))
+        minimalCircle = p.getMinimalBoundingCircle()
+        self.assertEqual(minimalCircle.relate(p), CONTAINS)
+        self.assertLessEqual(minimalCircle.getSquaredChordLength(),
+                             boundingCircle.getSquaredChordLength())
 
     def testString(self):
         p = ConvexPolygon([UnitVector3d.Z(),
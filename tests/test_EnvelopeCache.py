@@ -0,0 +1,96 @@
+#
+# LSST Data Management System
+# See COPYRIGHT file at the top of the source tree.
+#
+# This product includes software developed by the
+# LSST Project (http://www.lsst.org/).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the LSST License Statement and
+# the GNU General Public License along with this program.  If not,
+# see <https://www.lsstcorp.org/LegalNotices/>.
+#
+
+import os
+import shutil
+import tempfile
+import unittest
+
+from lsst.sphgeom import (Angle, Circle, EnvelopeCache, HtmPixelization,
+                          LonLat, Q3cPixelization, UnitVector3d)
+
+
+def makeCircle(lon, lat, r):
+    return Circle(UnitVector3d(LonLat.fromDegrees(lon, lat)),
+                  Angle.fromDegrees(r))
+
+
+class EnvelopeCacheTestCase(unittest.TestCase):
+
+    def setUp(self):
+        self.dir = tempfile.mkdtemp()
+        self.path = os.path.join(self.dir, "cache.bin")
+
+    def tearDown(self):
+        shutil.rmtree(self.dir, ignore_errors=True)
+
+    def testHitsAndMisses(self):
+        cache = EnvelopeCache(1 << 20)
+        h = HtmPixelization(8)
+        c = makeCircle(10, 20, 1)
+        self.assertEqual(cache.envelope(h, c), h.envelope(c))
+        self.assertEqual((cache.hits, cache.misses), (0, 1))
+        # Equal regions share entries.
+        self.assertEqual(cache.envelope(h, makeCircle(10, 20, 1)),
+                         h.envelope(c))
+        self.assertEqual((cache.hits, cache.misses), (1, 1))
+        self.assertEqual(cache.interior(h, c), h.interior(c))
+        self.assertEqual(cache.envelope(h, c, maxRanges=4),
+                         h.envelope(c, 4))
+        q = Q3cPixelization(8)
+        self.assertEqual(cache.envelope(q, c), q.envelope(c))
+        self.assertEqual((cache.hits, cache.misses), (1, 4))
+        self.assertEqual(len(cache), 4)
+        self.assertGreater(cache.bytes, 0)
+        self.assertLessEqual(cache.bytes, cache.maxBytes)
+        self.assertEqual(cache.evictions, 0)
+        cache.resetCounters()
+        self.assertEqual((cache.hits, cache.misses), (0, 0))
+        cache.clear()
+        self.assertEqual(len(cache), 0)
+        self.assertEqual(cache.bytes, 0)
+
+    def testPersistence(self):
+        h = HtmPixelization(8)
+        c = makeCircle(10, 20, 1)
+        d = makeCircle(40, -20, 2)
+        cache = EnvelopeCache(1 << 20, self.path)
+        cache.envelope(h, c)
+        cache.interior(h, d)
+        self.assertEqual(cache.misses, 2)
+        del cache
+        cache = EnvelopeCache(1 << 20, self.path)
+        self.assertEqual(len(cache), 2)
+        self.assertEqual(cache.envelope(h, c), h.envelope(c))
+        self.assertEqual(cache.interior(h, d), h.interior(d))
+        self.assertEqual((cache.hits, cache.misses), (2, 0))
+        cache.compact()
+        del cache
+        self.assertEqual(len(EnvelopeCache(1 << 20, self.path)), 2)
+        with open(self.path, "wb") as f:
+            f.write(b"not a cache file")
+        with self.assertRaises(RuntimeError):
+            EnvelopeCache(1 << 20, self.path)
+
+
+if __name__ == '__main__':
+    unittest.main()
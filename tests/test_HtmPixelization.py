@@ -23,7 +23,8 @@
 import pickle
 import unittest
 
-from lsst.sphgeom import Angle, Circle, HtmPixelization, RangeSet, UnitVector3d, ConvexPolygon
+from lsst.sphgeom import (Angle, Circle, Coarsening, HtmPixelization, RangeSet,
+                          TraversalStats, UnitVector3d, ConvexPolygon)
 
 
 class HtmPixelizationTestCase(unittest.TestCase):
@@ -66,6 +67,68 @@ class HtmPixelizationTestCase(unittest.TestCase):
         rs = pixelization.interior(c)
         self.assertTrue(rs.empty())
 
+    def test_envelope_and_interior_pair(self):
+        pixelization = HtmPixelization(8)
+        c = Circle(UnitVector3d(1, 1, 1), Angle.fromDegrees(5))
+        envelope, interior = pixelization.envelopeAndInterior(c)
+        self.assertEqual(envelope, pixelization.envelope(c))
+        self.assertEqual(interior, pixelization.interior(c))
+        envelope, interior = pixelization.envelopeAndInterior(c, 8)
+        self.assertEqual(envelope, pixelization.envelope(c, 8))
+        self.assertEqual(interior, pixelization.interior(c, 8))
+
+    def test_traversal_stats(self):
+        pixelization = HtmPixelization(8)
+        c = Circle(UnitVector3d(1, 1, 1), Angle.fromDegrees(2))
+        poly = ConvexPolygon([UnitVector3d(1, 0, 0.1),
+                              UnitVector3d(1, 0.1, 0),
+                              UnitVector3d(1, 0, -0.1)])
+        stats = TraversalStats()
+        rs = pixelization.envelope(poly, stats=stats)
+        self.assertEqual(rs, pixelization.envelope(poly))
+        self.assertGreater(stats.edgeRejected, 0)
+        self.assertGreater(stats.capAccepted, 0)
+        self.assertGreater(stats.exactRelated, 0)
+        exact = stats.exactRelated
+        pixelization.interior(c, stats=stats)
+        self.assertGreater(stats.exactRelated, exact)
+        self.assertEqual(len(stats.nodesVisited), 31)
+        self.assertEqual(sum(stats.nodesVisited),
+                         stats.disjoint + stats.within + stats.intersects)
+        pixelization.envelope(c, 4, stats=stats)
+        self.assertGreater(stats.levelReductions, 0)
+        self.assertGreater(stats.simplifications, 0)
+        self.assertGreater(stats.rangeSetReallocations, 0)
+        self.assertGreaterEqual(stats.exactOrientations, 0)
+        stats.reset()
+        self.assertEqual(stats.exactRelated, 0)
+        self.assertEqual(sum(stats.nodesVisited), 0)
+
+    def test_stream(self):
+        pixelization = HtmPixelization(8)
+        c = Circle(UnitVector3d(1, 1, 1), Angle.fromDegrees(5))
+        ranges = []
+        pixelization.streamEnvelope(c, lambda first, last: ranges.append((first, last)))
+        self.assertEqual(RangeSet(ranges), pixelization.envelope(c))
+        self.assertEqual(len(ranges), len(pixelization.envelope(c)))
+        ranges = []
+        pixelization.streamInterior(c, lambda first, last: ranges.append((first, last)))
+        self.assertEqual(RangeSet(ranges), pixelization.interior(c))
+
+    def test_optimal_coarsening(self):
+        pixelization = HtmPixelization(8)
+        c = Circle(UnitVector3d(1, 1, 1), Angle.fromDegrees(5))
+        rs = pixelization.envelope(c)
+        coarse = pixelization.envelope(c, 4, coarsening=Coarsening.OPTIMAL)
+        self.assertEqual(len(coarse), 4)
+        self.assertTrue(coarse.contains(rs))
+        self.assertLessEqual(coarse.cardinality(),
+                             pixelization.envelope(c, 4).cardinality())
+        rs = pixelization.interior(c)
+        coarse = pixelization.interior(c, 4, Coarsening.OPTIMAL)
+        self.assertEqual(len(coarse), 4)
+        self.assertTrue(coarse.isWithin(rs))
+
     def test_index_to_string(self):
         strings = ['S0', 'S1', 'S2', 'S3', 'N0', 'N1', 'N2', 'N3']
         for i in range(8, 16):
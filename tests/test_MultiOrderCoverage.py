@@ -0,0 +1,113 @@
+#
+# LSST Data Management System
+# See COPYRIGHT file at the top of the source tree.
+#
+# This product includes software developed by the
+# LSST Project (http://www.lsst.org/).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the LSST License Statement and
+# the GNU General Public License along with this program.  If not,
+# see <https://www.lsstcorp.org/LegalNotices/>.
+#
+
+import pickle
+
+import unittest
+
+from lsst.sphgeom import (Angle, Circle, HtmPixelization, LonLat,
+                          MultiOrderCoverage, Q3cPixelization, RangeSet,
+                          UnitVector3d)
+
+
+class MultiOrderCoverageTestCase(unittest.TestCase):
+
+    def testCells(self):
+        m = MultiOrderCoverage()
+        self.assertTrue(m.empty())
+        self.assertEqual(m.getMaxLevel(), -1)
+        # Siblings are replaced by their parent.
+        for i in range(520, 524):
+            m.insert(3, i)
+        self.assertEqual(m.getCells(), [(2, 130)])
+        self.assertEqual(m, MultiOrderCoverage(2, 130))
+        self.assertEqual(m.getNumCells(), 1)
+        self.assertEqual(m.getMaxLevel(), 2)
+        self.assertEqual(m.toRangeSet(3), RangeSet(520, 524))
+        self.assertEqual(MultiOrderCoverage.fromRangeSet(RangeSet(520, 524), 3),
+                         m)
+        # Covered cells are dropped.
+        m.insert(4, 2080)
+        self.assertEqual(m.getNumCells(), 1)
+        m.insert(4, 2100)
+        self.assertEqual(m.getCells(), [(2, 130), (4, 2100)])
+        self.assertTrue(m.contains(3, 521))
+        self.assertFalse(m.contains(1, 32))
+        self.assertTrue(m.intersects(1, 32))
+        self.assertEqual(m.toRangeSet(2), RangeSet(130, 132))
+        self.assertEqual(m.toInteriorRangeSet(2), RangeSet(130))
+        self.assertEqual(m.degradedTo(2), MultiOrderCoverage.fromRangeSet(
+            RangeSet(130, 132), 2))
+        with self.assertRaises(ValueError):
+            m.insert(MultiOrderCoverage.MAX_LEVEL + 1, 0)
+        with self.assertRaises(ValueError):
+            MultiOrderCoverage(1, 64)
+
+    def testSetOperations(self):
+        a = MultiOrderCoverage.fromRangeSet(RangeSet(520, 528), 3)
+        b = MultiOrderCoverage(2, 131)
+        c = MultiOrderCoverage(2, 130)
+        self.assertEqual(a & b, b)
+        self.assertEqual(a - b, c)
+        self.assertEqual(a ^ b, c)
+        self.assertEqual(b | c, a)
+        self.assertTrue(a.contains(b))
+        self.assertFalse(b.contains(a))
+        self.assertTrue(a.intersects(b))
+        self.assertFalse(b.intersects(c))
+        d = MultiOrderCoverage(a)
+        d -= c
+        self.assertEqual(d, b)
+        d |= c
+        self.assertEqual(d, a)
+
+    def testPixelizations(self):
+        c = Circle(UnitVector3d(LonLat.fromDegrees(30, 40)),
+                   Angle.fromDegrees(5))
+        for p in (HtmPixelization(8), Q3cPixelization(8)):
+            envelope = p.envelopeCoverage(c)
+            interior = p.interiorCoverage(c)
+            self.assertEqual(envelope.toRangeSet(8), p.envelope(c))
+            self.assertEqual(interior.toRangeSet(8), p.interior(c))
+            self.assertTrue(envelope.contains(interior))
+            # Interior pixels are kept at coarser levels.
+            self.assertLess(interior.getNumCells(),
+                            p.interior(c).cardinality())
+            self.assertTrue(any(level < 8 for level, _ in
+                                interior.getCells()))
+
+    def testCodec(self):
+        m = HtmPixelization(7).envelopeCoverage(
+            Circle(UnitVector3d.Z(), Angle.fromDegrees(3)))
+        s = m.encode()
+        self.assertEqual(MultiOrderCoverage.decode(s), m)
+        with self.assertRaises(RuntimeError):
+            MultiOrderCoverage.decode(s[:-1])
+
+    def testPickle(self):
+        a = MultiOrderCoverage.fromRangeSet(RangeSet(520, 600), 3)
+        b = pickle.loads(pickle.dumps(a, pickle.HIGHEST_PROTOCOL))
+        self.assertEqual(a, b)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,103 @@
+#
+# LSST Data Management System
+# See COPYRIGHT file at the top of the source tree.
+#
+# This product includes software developed by the
+# LSST Project (http://www.lsst.org/).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the LSST License Statement and
+# the GNU General Public License along with this program.  If not,
+# see <https://www.lsstcorp.org/LegalNotices/>.
+#
+
+import math
+import unittest
+
+from lsst.sphgeom import (HtmPixelization, LonLat, PixelAggregates,
+                          Q3cPixelization, UnitVector3d)
+
+
+def makePoints():
+    return [UnitVector3d(LonLat.fromDegrees(lon, lat))
+            for lon in range(0, 360, 15) for lat in range(-80, 90, 20)]
+
+
+class PixelAggregatesTestCase(unittest.TestCase):
+
+    def setUp(self):
+        self.points = makePoints()
+        self.weights = [float(i % 7) for i in range(len(self.points))]
+
+    def testAggregation(self):
+        q = Q3cPixelization(5)
+        a = PixelAggregates(q, self.points, self.weights)
+        self.assertEqual(a.level, 5)
+        self.assertFalse(a.empty())
+        self.assertEqual(a.getTotalCount(), len(self.points))
+        expected = {}
+        for v, w in zip(self.points, self.weights):
+            expected.setdefault(q.index(v), []).append(w)
+        self.assertEqual(len(a), len(expected))
+        self.assertEqual(a.getIndexes(), sorted(expected))
+        for i, c, s, lo, hi in zip(a.getIndexes(), a.getCounts(),
+                                   a.getSums(), a.getMins(), a.getMaxs()):
+            self.assertEqual(c, len(expected[i]))
+            self.assertAlmostEqual(s, sum(expected[i]))
+            self.assertEqual(lo, min(expected[i]))
+            self.assertEqual(hi, max(expected[i]))
+        # Points have unit weights by default, and may be aggregated
+        # concurrently.
+        b = PixelAggregates(q, self.points, numThreads=3)
+        self.assertEqual(b.getIndexes(), a.getIndexes())
+        self.assertEqual(b.getCounts(), a.getCounts())
+        self.assertEqual(b.getSums(), [float(c) for c in a.getCounts()])
+        self.assertTrue(PixelAggregates(q).empty())
+        with self.assertRaises(ValueError):
+            PixelAggregates(q, self.points, [1.0])
+
+    def testDense(self):
+        h = HtmPixelization(2)
+        a = PixelAggregates(h, self.points, self.weights)
+        counts = a.getDenseCounts()
+        self.assertEqual(len(counts), 8 * 4**2)
+        self.assertEqual(sum(counts), len(self.points))
+        first = 8 * 4**2
+        mins = a.getDenseMins()
+        for i, c in zip(a.getIndexes(), a.getCounts()):
+            self.assertEqual(counts[i - first], c)
+        for c, lo in zip(counts, mins):
+            self.assertEqual(c == 0, math.isnan(lo))
+
+    def testRollUpAndMerging(self):
+        h = HtmPixelization(6)
+        a = PixelAggregates(h, self.points, self.weights)
+        b = a.coarsened(2)
+        self.assertEqual(b.level, 2)
+        self.assertEqual(b.getTotalCount(), a.getTotalCount())
+        self.assertEqual(b.getCounts(),
+                         PixelAggregates(HtmPixelization(2), self.points,
+                                         self.weights).getCounts())
+        with self.assertRaises(ValueError):
+            a.coarsened(7)
+        half = len(self.points) // 2
+        a1 = PixelAggregates(h, self.points[:half], self.weights[:half])
+        a2 = PixelAggregates(h, self.points[half:], self.weights[half:])
+        m = a1.merged(a2)
+        self.assertEqual(m.getIndexes(), a.getIndexes())
+        self.assertEqual(m.getCounts(), a.getCounts())
+        with self.assertRaises(ValueError):
+            a1.merged(b)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,105 @@
+#
+# LSST Data Management System
+# See COPYRIGHT file at the top of the source tree.
+#
+# This product includes software developed by the
+# LSST Project (http://www.lsst.org/).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the LSST License Statement and
+# the GNU General Public License along with this program.  If not,
+# see <https://www.lsstcorp.org/LegalNotices/>.
+#
+
+import random
+import unittest
+
+from lsst.sphgeom import (Angle, Box, Chunker, Circle, HtmPixelization,
+                          LonLat, Mq3cPixelization, PixelTranslator,
+                          Q3cPixelization, RangeSet, UnitVector3d)
+
+
+def makePoints(n):
+    rng = random.Random(11)
+    return [UnitVector3d(LonLat.fromDegrees(rng.uniform(0, 360),
+                                            rng.uniform(-90, 90)))
+            for _ in range(n)]
+
+
+class PixelTranslatorTestCase(unittest.TestCase):
+
+    def setUp(self):
+        self.points = makePoints(2000)
+
+    def checkTranslation(self, source, target, pixels):
+        translator = PixelTranslator(source, target)
+        envelope = translator.envelope(pixels)
+        interior = translator.interior(pixels)
+        self.assertTrue(interior.isWithin(envelope))
+        self.assertTrue(envelope.isWithin(target.universe()))
+        for v in self.points:
+            if pixels.contains(source.index(v)):
+                self.assertTrue(envelope.contains(target.index(v)))
+            if interior.contains(target.index(v)):
+                self.assertTrue(pixels.contains(source.index(v)))
+        self.assertEqual(translator.envelope(pixels, numThreads=3),
+                         envelope)
+        self.assertEqual(translator.interior(pixels, numThreads=2),
+                         interior)
+        uncached = PixelTranslator(source, target, maxCacheLevel=-1)
+        self.assertEqual(uncached.envelope(pixels), envelope)
+        self.assertEqual(uncached.getCacheSize(), 0)
+
+    def testPixelizations(self):
+        h = HtmPixelization(6)
+        q = Q3cPixelization(5)
+        c = Circle(UnitVector3d(LonLat.fromDegrees(45, 30)),
+                   Angle.fromDegrees(20))
+        b = Box.fromDegrees(100, -60, 180, -10)
+        self.checkTranslation(h, q, h.envelope(c))
+        self.checkTranslation(q, h, q.interior(b))
+        self.checkTranslation(h, Mq3cPixelization(7), h.envelope(b))
+        translator = PixelTranslator(h, q)
+        self.assertEqual(translator.envelope(h.universe()), q.universe())
+        self.assertEqual(translator.interior(h.universe()), q.universe())
+        self.assertTrue(translator.envelope(RangeSet()).empty())
+        self.assertGreater(translator.getCacheSize(), 0)
+        translator.clearCache()
+        self.assertEqual(translator.getCacheSize(), 0)
+        with self.assertRaises(ValueError):
+            translator.envelope(RangeSet(0, 8))
+        with self.assertRaises(ValueError):
+            PixelTranslator(h, q, PixelTranslator.MAX_CACHE_LEVEL + 1)
+
+    def testChunker(self):
+        h = HtmPixelization(6)
+        chunker = Chunker(85, 12)
+        pixels = h.envelope(Box.fromDegrees(10, 10, 30, 25))
+        translator = PixelTranslator(h, chunker)
+        chunks = translator.envelope(pixels)
+        interior = translator.interior(pixels)
+        self.assertTrue(interior.isWithin(chunks))
+        self.assertFalse(interior.empty())
+        self.assertEqual(translator.envelope(h.universe()),
+                         RangeSet(chunker.getAllChunks()))
+        # Sub-chunk keys map back to the chunk IDs.
+        subChunks = PixelTranslator(h, chunker, subChunks=True).envelope(
+            pixels)
+        chunkIds = RangeSet()
+        for first, last in subChunks:
+            for key in range(first, last):
+                chunkIds.insert(Chunker.getChunkIdFromKey(key))
+        self.assertEqual(chunkIds, chunks)
+
+
+if __name__ == '__main__':
+    unittest.main()
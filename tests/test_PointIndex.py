@@ -0,0 +1,105 @@
+#
+# LSST Data Management System
+# See COPYRIGHT file at the top of the source tree.
+#
+# This product includes software developed by the
+# LSST Project (http://www.lsst.org/).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the LSST License Statement and
+# the GNU General Public License along with this program.  If not,
+# see <https://www.lsstcorp.org/LegalNotices/>.
+#
+
+import os
+import random
+import shutil
+import tempfile
+import unittest
+
+from lsst.sphgeom import (Angle, Box, Circle, HtmPixelization, LonLat,
+                          PointIndex, Q3cPixelization, RangeSet,
+                          UnitVector3d)
+
+
+def makePoints(n):
+    rng = random.Random(7)
+    return [UnitVector3d(LonLat.fromDegrees(rng.uniform(0, 360),
+                                            rng.uniform(-60, 60)))
+            for _ in range(n)]
+
+
+class PointIndexTestCase(unittest.TestCase):
+
+    def setUp(self):
+        self.points = makePoints(2000)
+
+    def testSorting(self):
+        h = HtmPixelization(7)
+        index = PointIndex(h, self.points)
+        self.assertEqual(len(index), len(self.points))
+        self.assertFalse(index.empty())
+        ids = index.getIds()
+        self.assertEqual(sorted(ids), list(range(len(self.points))))
+        pixels = [h.index(self.points[i]) for i in ids]
+        self.assertEqual(pixels, sorted(pixels))
+        self.assertEqual(index.getNumPixels(), len(set(pixels)))
+        self.assertEqual(index.getPoints(), [self.points[i] for i in ids])
+        self.assertEqual(index.getSpans(h.universe()),
+                         [(0, len(self.points))])
+        self.assertEqual(index.getSpans(RangeSet()), [])
+        # Concurrent indexing gives the same order.
+        self.assertEqual(PointIndex(h, self.points, numThreads=4).getIds(),
+                         ids)
+        self.assertTrue(PointIndex(h).empty())
+
+    def testFind(self):
+        q = Q3cPixelization(8)
+        index = PointIndex(q, self.points)
+        c = Circle(UnitVector3d(LonLat.fromDegrees(50, 10)),
+                   Angle.fromDegrees(20))
+        expected = {i for i, v in enumerate(self.points) if c.contains(v)}
+        ids = index.find(c)
+        self.assertEqual(len(ids), len(expected))
+        self.assertEqual(set(ids), expected)
+        pixels = q.envelope(c)
+        inPixels = {i for i, v in enumerate(self.points)
+                    if pixels.contains(q.index(v))}
+        self.assertEqual(set(index.find(pixels)), inPixels)
+        self.assertTrue(expected.issubset(inPixels))
+        self.assertEqual(len(index.find(Box.full())), len(self.points))
+        self.assertEqual(index.find(Box()), [])
+
+    def testSaveAndOpen(self):
+        d = tempfile.mkdtemp()
+        try:
+            path = os.path.join(d, "points.idx")
+            index = PointIndex(HtmPixelization(6), self.points)
+            index.save(path)
+            mapped = PointIndex.open(path)
+            self.assertEqual(mapped.getIds(), index.getIds())
+            self.assertEqual(mapped.getPoints(), index.getPoints())
+            c = Circle(UnitVector3d(LonLat.fromDegrees(200, -30)),
+                       Angle.fromDegrees(10))
+            self.assertEqual(mapped.find(c), index.find(c))
+            # Release the mapping before overwriting the file.
+            del mapped
+            with open(path, "wb") as f:
+                f.write(b"not an index")
+            with self.assertRaises(RuntimeError):
+                PointIndex.open(path)
+        finally:
+            shutil.rmtree(d, ignore_errors=True)
+
+
+if __name__ == '__main__':
+    unittest.main()
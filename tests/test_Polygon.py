@@ -0,0 +1,125 @@
+#
+# LSST Data Management System
+# See COPYRIGHT file at the top of the source tree.
+#
+# This product includes software developed by the
+# LSST Project (http://www.lsst.org/).
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the LSST License Statement and
+# the GNU General Public License along with this program.  If not,
+# see <https://www.lsstcorp.org/LegalNotices/>.
+#
+
+import pickle
+
+import unittest
+
+from lsst.sphgeom import (CONTAINS, DISJOINT, INTERSECTS, WITHIN, Angle,
+                          Circle, ConvexPolygon, LonLat, Polygon, Region,
+                          UnitVector3d)
+
+
+def fromDegrees(lon, lat):
+    return UnitVector3d(LonLat.fromDegrees(lon, lat))
+
+
+def makeSquare(lon, lat, size):
+    return [fromDegrees(lon, lat), fromDegrees(lon + size, lat),
+            fromDegrees(lon + size, lat + size), fromDegrees(lon, lat + size)]
+
+
+def makeU():
+    return [fromDegrees(0, 0), fromDegrees(0, 10), fromDegrees(3, 10),
+            fromDegrees(3, 3), fromDegrees(7, 3), fromDegrees(7, 10),
+            fromDegrees(10, 10), fromDegrees(10, 0)]
+
+
+class PolygonTestCase(unittest.TestCase):
+
+    def testConstruction(self):
+        p = Polygon(makeU())
+        self.assertEqual(len(p.getBoundary()), 8)
+        self.assertEqual(p.getHoles(), [])
+        square = makeSquare(0, 0, 10)
+        hull = p.getConvexHull().getVertices()
+        self.assertEqual(len(hull), 4)
+        for v in hull:
+            self.assertIn(v, square)
+        hole = makeSquare(4, 4, 2)
+        q = Polygon(makeSquare(0, 0, 10), [hole])
+        # Holes are stored in clockwise order.
+        self.assertEqual(q.getHoles(), [list(reversed(hole))])
+        self.assertEqual(Polygon(q), q)
+        self.assertNotEqual(Polygon(makeSquare(0, 0, 10)), q)
+        with self.assertRaises(ValueError):
+            Polygon([UnitVector3d.X(), UnitVector3d.Y()])
+
+    def testContains(self):
+        p = Polygon(makeU())
+        self.assertTrue(p.contains(fromDegrees(5, 1)))
+        self.assertTrue(p.contains(fromDegrees(1, 8)))
+        self.assertFalse(p.contains(fromDegrees(5, 6)))
+        self.assertTrue(fromDegrees(9, 8) in p)
+        q = Polygon(makeSquare(0, 0, 10), [makeSquare(4, 4, 2)])
+        self.assertTrue(q.contains(fromDegrees(2, 2)))
+        self.assertFalse(q.contains(fromDegrees(5, 5)))
+        # Holes are closed.
+        self.assertFalse(q.contains(fromDegrees(4, 4)))
+
+    def testRelationships(self):
+        p = Polygon(makeU())
+        notch = Circle(fromDegrees(5, 6), Angle.fromDegrees(1))
+        arm = Circle(fromDegrees(1.5, 6), Angle.fromDegrees(1))
+        self.assertEqual(p.relate(notch), DISJOINT)
+        self.assertEqual(p.relate(arm), CONTAINS)
+        self.assertEqual(arm.relate(p), WITHIN)
+        self.assertEqual(p.relate(ConvexPolygon(makeSquare(-1, -1, 12))),
+                         WITHIN)
+        self.assertEqual(p.relate(ConvexPolygon(makeSquare(2, 2, 6))),
+                         INTERSECTS)
+        self.assertEqual(p.relate(Polygon(makeSquare(4.5, 4.5, 1))),
+                         DISJOINT)
+        # Regions in a hole are disjoint from the polygon, even if they
+        # touch the hole edges.
+        q = Polygon(makeSquare(0, 0, 10), [makeSquare(4, 4, 2)])
+        center = fromDegrees(5, 5)
+        self.assertEqual(q.relate(Circle(center, Angle.fromDegrees(0.5))),
+                         DISJOINT)
+        self.assertEqual(q.relate(Circle(center, Angle.fromDegrees(1.5))),
+                         INTERSECTS)
+        self.assertEqual(q.relate(ConvexPolygon(makeSquare(4, 4, 2))),
+                         DISJOINT)
+
+    def testCodec(self):
+        p = Polygon(makeSquare(0, 0, 10),
+                    [makeSquare(2, 2, 2), makeSquare(6, 6, 2)])
+        s = p.encode()
+        self.assertEqual(Polygon.decode(s), p)
+        self.assertEqual(Region.decode(s), p)
+        with self.assertRaises(RuntimeError):
+            Polygon.decode(s[:-1])
+
+    def testString(self):
+        p = Polygon(makeSquare(0, 0, 10), [makeSquare(4, 4, 2)])
+        self.assertEqual(str(p), repr(p))
+        self.assertEqual(p, eval(repr(p), dict(Polygon=Polygon,
+                                               UnitVector3d=UnitVector3d)))
+
+    def testPickle(self):
+        a = Polygon(makeU(), [])
+        b = pickle.loads(pickle.dumps(a, pickle.HIGHEST_PROTOCOL))
+        self.assertEqual(a, b)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -74,6 +74,15 @@ class RangeSetTestCase(unittest.TestCase):
         c ^= c
         self.assertTrue(c.empty())
 
+    def testReductions(self):
+        sets = [RangeSet(0, 4), RangeSet(2, 6), RangeSet(3, 8)]
+        self.assertEqual(RangeSet.unionOf(sets), RangeSet(0, 8))
+        self.assertEqual(RangeSet.intersectionOf(sets), RangeSet(3, 4))
+        self.assertEqual(RangeSet.coveredBy(sets, 2), RangeSet(2, 6))
+        self.assertEqual(RangeSet.coveredBy(sets, 2, numThreads=2),
+                         RangeSet(2, 6))
+        self.assertTrue(RangeSet.intersectionOf([]).full())
+
     def testRanges(self):
         s = RangeSet()
         s.insert(0, 1)